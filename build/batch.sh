@@ -0,0 +1,7 @@
+#!/bin/bash
+
+# headless batch tool (src/batch.c), for linux boxes without a display. Doesn't link SDL or GL:
+# function/data sections + gc-sections throw out everything in snooze/ui that would need them, see src/headless.h
+
+gcc src/batch.c -o out/adder_batch -O2 -g -Wall -pedantic -Wextra -Werror -Iexternal -Isrc -ffunction-sections -fdata-sections -Wl,--gc-sections -lm -lpthread
+echo "batch built"
@@ -2,6 +2,7 @@
 
 uniform mat4 uVP;
 uniform mat4 uModel;
+uniform mat4 uInstances[32]; // size has to match REN3D_MAX_INSTANCES_PER_DRAW
 
 layout(location = 0) in vec4 color;
 layout(location = 1) in vec3 position;
@@ -11,7 +12,8 @@ out vec3 vNormal;
 out vec4 vColor;
 
 void main() {
-    gl_Position = uVP * uModel * vec4(position, 1);
-    vNormal = normal;
+    mat4 instance = uInstances[gl_InstanceID];
+    gl_Position = uVP * uModel * instance * vec4(position, 1);
+    vNormal = mat3(instance) * normal;
     vColor = color;
 }
\ No newline at end of file
@@ -67,7 +67,7 @@ void poolAllocDeinit(PoolAlloc* pool) {
 static void* _poolAllocReallocZeroed(void* ptr, uint64_t oldSize, uint64_t newSize) {
     void* outPtr = realloc(ptr, newSize);
     memset((char*)outPtr + oldSize, 0, newSize - oldSize);
-    SNZ_ASSERTF(outPtr != NULL, "realloc failed. New size: %lld, old size: %lld", newSize, oldSize);
+    SNZ_ASSERTF(outPtr != NULL, "realloc failed. New size: %" PRId64 ", old size: %" PRId64, newSize, oldSize);
     return outPtr;
 }
 
@@ -83,7 +83,7 @@ static PoolAllocNode* _poolAllocFindAlloc(PoolAlloc* pool, void* alloc) {
 
 // FIXME: macro
 void* poolAllocAlloc(PoolAlloc* pool, int64_t size) {
-    SNZ_ASSERTF(size >= 0, "new allocation with size < 0, was: %lld", size);
+    SNZ_ASSERTF(size >= 0, "new allocation with size < 0, was: %" PRId64, size);
 
     PoolAllocNode* node = NULL;
     for (int i = 0; i < pool->nodeCount; i++) {
@@ -124,10 +124,10 @@ void* poolAllocGrow(PoolAlloc* pool, void* alloc, int64_t newSize) {
     SNZ_ASSERTF(node != NULL, "Allocation to grow could not be found, ptr: %p", alloc);
     SNZ_ASSERTF(node->allocated, "Trying to grow non allocated node. ptr: %p", alloc);
 
-    SNZ_ASSERTF(newSize > node->capacity, "Grow fails, new size (%d) <= old (%d).", newSize, node->capacity);
+    SNZ_ASSERTF(newSize > node->capacity, "Grow fails, new size (%" PRId64 ") <= old (%" PRId64 ").", newSize, node->capacity);
     node->allocation = realloc(node->allocation, newSize);
     node->capacity = newSize;
-    SNZ_ASSERTF(node->allocation, "Realloc returned a null ptr. requested size: %d", newSize);
+    SNZ_ASSERTF(node->allocation, "Realloc returned a null ptr. requested size: %" PRId64, newSize);
     return node->allocation;
 }
 
@@ -153,7 +153,7 @@ void _poolAllocPushArray(PoolAlloc* pool, void** array, int64_t* count, int64_t
         (*count)++;
 
         node->allocation = realloc(node->allocation, newSize);
-        SNZ_ASSERTF(node->allocation != NULL, "Realloc returned NULL. ptr: %d", *array);
+        SNZ_ASSERTF(node->allocation != NULL, "Realloc returned NULL. ptr: %p", *array);
         *array = node->allocation;  // write to the output :) // FIXME: this shit very dangerous, typecheck at least
     } else {
         SNZ_ASSERT(*count == 0, "uninitialized arr with non-zero count.");
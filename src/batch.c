@@ -0,0 +1,282 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "headless.h" // has to be first, see the top of it
+#include "snooze.h"
+#include "mesh.h"
+#include "ser.h"
+#include "jobs.h"
+#include "solvecache.h"
+#include "timeline.h"
+
+/*
+BATCH:
+adder without a window, for regenerating parts from saved timelines on machines that don't have a display.
+Loads a timeline written by tl_timelineWrite or kept by a tl_Journal, solves one op of it (+ everything it depends on),
+writes the result as an STL and prints how long each op took as JSON. Doesn't link SDL or GL, see headless.h and build.sh.
+
+usage: adder_batch <timeline file> <out stl> [--op uid] [--jobs n] [--json path] [--log path] [--cache dir]
+    --op    which op to export. Defaults to the one that was active when saved, then the newest one
+    --jobs  extra solver threads. Defaults to one per core minus this one, 0 solves everything on this thread
+    --json  where the timings go, stdout by default
+    --log   where SNZ_LOGs go on top of stderr, nowhere by default
+    --cache solve cache directory, shared w/ other runs (and the app, if pointed at the same place). None by default
+
+exit codes: 0 ok, 1 bad args/files, 2 the op or something it depends on has an error (still in the JSON)
+*/
+
+#define BATCH_SCRATCH_SIZE TL_SOLVE_SCRATCH_SIZE
+#define BATCH_JOB_SCRATCH_SIZE 16000000  // first block, worker scratch grows past it as needed
+#define BATCH_TIMELINE_BLOCK_SIZE 10000000
+#define BATCH_CACHE_MAX_BYTES 2000000000
+
+typedef struct {
+    const char* timelinePath;
+    const char* stlPath;
+    const char* jsonPath;
+    const char* logPath;
+    const char* cachePath; // null for no cache
+    int64_t opUid; // zero for default
+    int jobThreads; // -1 for default
+} batch_Args;
+
+static void _batch_printUsage() {
+    fprintf(stderr, "usage: adder_batch <timeline file> <out stl> [--op uid] [--jobs n] [--json path] [--log path] [--cache dir]\n");
+}
+
+// false if str isn't entirely a base 10 number
+static bool _batch_parseInt(const char* str, int64_t* out) {
+    char* end = NULL;
+    *out = strtoll(str, &end, 10);
+    return end != str && *end == '\0';
+}
+
+// false on anything malformed, usage already printed
+static bool _batch_parseArgs(int argc, char** argv, batch_Args* out) {
+    *out = (batch_Args){ .jobThreads = -1 };
+    int positionalCount = 0;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* next = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strncmp(arg, "--", 2) != 0) {
+            if (positionalCount == 0) {
+                out->timelinePath = arg;
+            } else if (positionalCount == 1) {
+                out->stlPath = arg;
+            } else {
+                fprintf(stderr, "unexpected arg '%s'\n", arg);
+                _batch_printUsage();
+                return false;
+            }
+            positionalCount++;
+            continue;
+        }
+
+        if (!next) {
+            fprintf(stderr, "'%s' needs a value\n", arg);
+            _batch_printUsage();
+            return false;
+        }
+        i++;
+
+        bool valid = true;
+        if (strcmp(arg, "--op") == 0) {
+            valid = _batch_parseInt(next, &out->opUid) && out->opUid > 0;
+        } else if (strcmp(arg, "--jobs") == 0) {
+            int64_t threads = 0;
+            valid = _batch_parseInt(next, &threads) && threads >= 0 && threads < JOB_MAX_WORKERS;
+            out->jobThreads = (int)threads;
+        } else if (strcmp(arg, "--json") == 0) {
+            out->jsonPath = next;
+        } else if (strcmp(arg, "--log") == 0) {
+            out->logPath = next;
+        } else if (strcmp(arg, "--cache") == 0) {
+            out->cachePath = next;
+        } else {
+            fprintf(stderr, "unknown option '%s'\n", arg);
+            _batch_printUsage();
+            return false;
+        }
+
+        if (!valid) {
+            fprintf(stderr, "bad value for '%s': '%s'\n", arg, next);
+            _batch_printUsage();
+            return false;
+        }
+    }
+
+    if (positionalCount != 2) {
+        _batch_printUsage();
+        return false;
+    }
+    return true;
+}
+
+static tl_Op* _batch_targetOp(tl_Timeline* t, int64_t opUid) {
+    if (opUid != 0) {
+        return tl_timelineGetOpByUID(t, opUid);
+    } else if (t->activeOp) {
+        return t->activeOp;
+    }
+
+    tl_Op* newest = NULL;
+    for (tl_Op* op = t->firstOp; op; op = op->next) {
+        if (!newest || op->uniqueId > newest->uniqueId) {
+            newest = op;
+        }
+    }
+    return newest;
+}
+
+// paths don't get escaped beyond quotes + backslashes, control chars in a path are on whoever did that
+static void _batch_writeJSONStr(FILE* f, const char* str) {
+    fputc('"', f);
+    for (const char* c = str; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            fputc('\\', f);
+        }
+        fputc(*c, f);
+    }
+    fputc('"', f);
+}
+
+static void _batch_writeJSON(FILE* f, const batch_Args* args, tl_Timeline* t, tl_Op* target, bool solved, double totalSeconds) {
+    fprintf(f, "{\n  \"timeline\": ");
+    _batch_writeJSONStr(f, args->timelinePath);
+    fprintf(f, ",\n  \"stl\": ");
+    _batch_writeJSONStr(f, args->stlPath);
+    fprintf(f, ",\n  \"target\": %lld,\n", (long long)target->uniqueId);
+    fprintf(f, "  \"ok\": %s,\n", solved ? "true" : "false");
+    fprintf(f, "  \"jobWorkers\": %d,\n", t->jobs ? t->jobs->workerCount : 1);
+    fprintf(f, "  \"totalSeconds\": %.6f,\n", totalSeconds);
+    fprintf(f, "  \"ops\": [");
+
+    // ops that weren't part of this solve don't get listed
+    bool first = true;
+    for (tl_Op* op = t->firstOp; op; op = op->next) {
+        if (!op->solve.stats.valid && op->error.kind == TL_OPEK_NONE) {
+            continue;
+        }
+        fprintf(f, "%s\n    {", first ? "" : ",");
+        first = false;
+        fprintf(f, "\"uid\": %lld, \"kind\": \"%s\", ", (long long)op->uniqueId, tl_opKindNames[op->kind]);
+        fprintf(f, "\"error\": \"%s\"", tl_opErrorKindNames[op->error.kind]);
+        if (op->solve.stats.valid) {
+            fprintf(f, ", \"seconds\": %.6f, \"faces\": %lld, \"tris\": %lld, \"bytes\": %lld, \"cached\": %s",
+                    op->solve.stats.seconds,
+                    (long long)op->solve.stats.faceCount,
+                    (long long)op->solve.stats.triCount,
+                    (long long)op->solve.stats.bytes,
+                    op->solve.stats.fromCache ? "true" : "false");
+        }
+        fprintf(f, "}");
+    }
+    fprintf(f, "\n  ]\n}\n");
+}
+
+int main(int argc, char** argv) {
+    // everything that logs prints to stdout too, so the real one gets kept for the JSON and stdout gets pointed at stderr
+    FILE* stdoutFile = fdopen(dup(STDOUT_FILENO), "w");
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+
+    batch_Args args = { 0 };
+    if (!_batch_parseArgs(argc, argv, &args)) {
+        return 1;
+    }
+
+    _snz_logFile = fopen(args.logPath ? args.logPath : "/dev/null", "w");
+    if (!_snz_logFile) {
+        fprintf(stderr, "opening log file '%s' failed\n", args.logPath);
+        return 1;
+    }
+
+    snz_Arena specArena = snz_arenaInit(1000000, "batch spec arena");
+    ser_begin(&specArena);
+    tl_timelineSpec(&specArena);
+    ser_end();
+
+    snz_Arena scratch = snz_arenaInit(BATCH_SCRATCH_SIZE, "batch scratch");
+    snz_Arena timelineArena = snz_arenaInitGrowable(BATCH_TIMELINE_BLOCK_SIZE, "batch timeline arena");
+    tl_Timeline t = { 0 };
+    {
+        FILE* f = fopen(args.timelinePath, "rb");
+        if (!f) {
+            fprintf(stderr, "opening timeline '%s' failed\n", args.timelinePath);
+            return 1;
+        }
+        ser_ReadError err = tl_timelineRead(f, &timelineArena, &scratch, &t);
+        fclose(f);
+        if (err != SER_RE_OK) {
+            fprintf(stderr, "reading timeline '%s' failed, code: %d\n", args.timelinePath, err);
+            return 1;
+        }
+    }
+
+    tl_Op* target = _batch_targetOp(&t, args.opUid);
+    if (!target) {
+        fprintf(stderr, "no op to export in '%s'\n", args.timelinePath);
+        return 1;
+    }
+
+    int jobThreads = args.jobThreads;
+    if (jobThreads < 0) {
+        jobThreads = SNZ_MIN(SDL_GetCPUCount() - 1, JOB_MAX_WORKERS - 1);
+    }
+    job_System* jobs = NULL;
+    if (jobThreads > 0) {
+        jobs = job_systemInit(jobThreads, BATCH_JOB_SCRATCH_SIZE);
+        t.jobs = jobs;
+    }
+    t.recordSolveStats = true;
+    scache_Cache cache = { 0 };
+    if (args.cachePath) {
+        scache_init(&cache, args.cachePath, BATCH_CACHE_MAX_BYTES);
+        t.solveCache = &cache;
+    }
+
+    snz_arenaClear(&scratch);
+    uint64_t startTick = SDL_GetPerformanceCounter();
+    bool solved = tl_solveOp(&t, target, &scratch);
+    double totalSeconds = (double)(SDL_GetPerformanceCounter() - startTick) / SDL_GetPerformanceFrequency();
+
+    if (solved) {
+        FILE* f = fopen(args.stlPath, "w");
+        if (!f) {
+            fprintf(stderr, "opening stl '%s' failed\n", args.stlPath);
+            return 1;
+        }
+        mesh_facesWriteSTL(*target->solve.faces, f);
+        bool ok = !ferror(f);
+        ok &= fclose(f) == 0;
+        if (!ok) {
+            fprintf(stderr, "writing stl '%s' failed\n", args.stlPath);
+            return 1;
+        }
+    }
+
+    FILE* jsonFile = stdoutFile;
+    if (args.jsonPath) {
+        jsonFile = fopen(args.jsonPath, "w");
+        if (!jsonFile) {
+            fprintf(stderr, "opening json file '%s' failed\n", args.jsonPath);
+            return 1;
+        }
+    }
+    _batch_writeJSON(jsonFile, &args, &t, target, solved, totalSeconds);
+    fclose(jsonFile);
+
+    tl_timelineDeinit(&t);
+    if (args.cachePath) {
+        scache_deinit(&cache);
+    }
+    if (jobs) {
+        job_systemDeinit(jobs);
+    }
+    snz_arenaDeinit(&timelineArena);
+    snz_arenaDeinit(&scratch);
+    snz_arenaDeinit(&specArena);
+    fclose(_snz_logFile);
+    return solved ? 0 : 2;
+}
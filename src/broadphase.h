@@ -0,0 +1,194 @@
+#pragma once
+
+#include <stdlib.h>
+
+#include "geometry.h"
+#include "snooze.h"
+
+/*
+BROAD PHASE:
+sweep and prune over AABBs, for anything that would otherwise compare every elt of a set with every other one.
+Boxes get sorted by their min along whichever axis the set is most spread out on, then each box only gets
+tested against the boxes that start before it ends on that axis. Output is the list of overlapping pairs,
+which callers then run their actual (expensive) test on.
+
+This doesn't know about faces/edges/tris at all, just boxes and indices, so a BVH or anything else that
+produces candidate pairs can be dropped in in place of it later without callers changing.
+
+fns:
+bp_sweepAndPrune() - all overlapping pairs within one set of boxes
+bp_sweepAndPruneBetween() - only overlapping pairs with one box from each of two sets
+*/
+
+typedef struct {
+    int64_t a;
+    int64_t b;
+} bp_Pair;
+
+SNZ_SLICE(bp_Pair);
+
+typedef struct {
+    float min;
+    float max;
+    int64_t idx;
+    bool fromB;
+} _bp_Entry;
+
+static int _bp_entryCompare(const void* a, const void* b) {
+    float minA = ((const _bp_Entry*)a)->min;
+    float minB = ((const _bp_Entry*)b)->min;
+    return (minA > minB) - (minA < minB);
+}
+
+static int _bp_pairCompare(const void* a, const void* b) {
+    const bp_Pair* pa = (const bp_Pair*)a;
+    const bp_Pair* pb = (const bp_Pair*)b;
+    if (pa->a != pb->a) {
+        return (pa->a > pb->a) - (pa->a < pb->a);
+    }
+    return (pa->b > pb->b) - (pa->b < pb->b);
+}
+
+// axis where the centers of all boxes are the most spread out
+static int _bp_sweepAxis(geo_AABBSlice as, geo_AABBSlice bs) {
+    HMM_Vec3 min = HMM_V3(INFINITY, INFINITY, INFINITY);
+    HMM_Vec3 max = HMM_V3(-INFINITY, -INFINITY, -INFINITY);
+    geo_AABBSlice sets[2] = { as, bs };
+    for (int setIdx = 0; setIdx < 2; setIdx++) {
+        for (int64_t i = 0; i < sets[setIdx].count; i++) {
+            geo_AABB box = sets[setIdx].elems[i];
+            for (int ax = 0; ax < 3; ax++) {
+                float center = (box.min.Elements[ax] + box.max.Elements[ax]) / 2;
+                min.Elements[ax] = SNZ_MIN(min.Elements[ax], center);
+                max.Elements[ax] = SNZ_MAX(max.Elements[ax], center);
+            }
+        }
+    }
+
+    int axis = 0;
+    for (int ax = 1; ax < 3; ax++) {
+        if (max.Elements[ax] - min.Elements[ax] > max.Elements[axis] - min.Elements[axis]) {
+            axis = ax;
+        }
+    }
+    return axis;
+}
+
+// bipartite means only pairs with one from as and one from bs are output, and pair.a always indexes into as
+static bp_PairSlice _bp_sweep(geo_AABBSlice as, geo_AABBSlice bs, bool bipartite, float epsilon, snz_Arena* arena, snz_Arena* scratch) {
+    int axis = _bp_sweepAxis(as, bs);
+
+    int64_t entryCount = as.count + bs.count;
+    _bp_Entry* entries = SNZ_ARENA_PUSH_ARR(scratch, entryCount, _bp_Entry);
+    for (int64_t i = 0; i < entryCount; i++) {
+        bool fromB = i >= as.count;
+        int64_t idx = fromB ? (i - as.count) : i;
+        geo_AABB box = fromB ? bs.elems[idx] : as.elems[idx];
+        entries[i] = (_bp_Entry){
+            .min = box.min.Elements[axis],
+            .max = box.max.Elements[axis],
+            .idx = idx,
+            .fromB = fromB,
+        };
+    }
+    qsort(entries, entryCount, sizeof(*entries), _bp_entryCompare);
+
+    SNZ_ARENA_ARR_BEGIN(arena, bp_Pair);
+    for (int64_t i = 0; i < entryCount; i++) {
+        _bp_Entry* e = &entries[i];
+        geo_AABB box = e->fromB ? bs.elems[e->idx] : as.elems[e->idx];
+        for (int64_t j = i + 1; j < entryCount; j++) {
+            _bp_Entry* other = &entries[j];
+            if (other->min > e->max + epsilon) {
+                break;  // sorted by min, so nothing after this can overlap either
+            } else if (bipartite && (other->fromB == e->fromB)) {
+                continue;
+            }
+
+            geo_AABB otherBox = other->fromB ? bs.elems[other->idx] : as.elems[other->idx];
+            if (!geo_aabbOverlap(box, otherBox, epsilon)) {
+                continue;
+            }
+
+            bp_Pair* p = SNZ_ARENA_PUSH(arena, bp_Pair);
+            if (bipartite) {
+                *p = e->fromB ? (bp_Pair) { other->idx, e->idx } : (bp_Pair) { e->idx, other->idx };
+            } else {
+                *p = (bp_Pair){ SNZ_MIN(e->idx, other->idx), SNZ_MAX(e->idx, other->idx) };
+            }
+        }
+    }
+    bp_PairSlice out = SNZ_ARENA_ARR_END(arena, bp_Pair);
+
+    // so callers see the same order a pair of nested loops would have given them
+    qsort(out.elems, out.count, sizeof(*out.elems), _bp_pairCompare);
+    return out;
+}
+
+// every pair of boxes that overlap (or are within epsilon of it), pair.a < pair.b, sorted by a then b
+bp_PairSlice bp_sweepAndPrune(geo_AABBSlice boxes, float epsilon, snz_Arena* arena, snz_Arena* scratch) {
+    return _bp_sweep(boxes, (geo_AABBSlice) { 0 }, false, epsilon, arena, scratch);
+}
+
+// every pair of an as box and a bs box that overlap, pair.a indexes as and pair.b indexes bs, sorted by a then b
+bp_PairSlice bp_sweepAndPruneBetween(geo_AABBSlice as, geo_AABBSlice bs, float epsilon, snz_Arena* arena, snz_Arena* scratch) {
+    return _bp_sweep(as, bs, true, epsilon, arena, scratch);
+}
+
+static bool _bp_pairsMatchBruteForce(geo_AABBSlice boxes, bp_PairSlice pairs, float epsilon) {
+    int64_t pairIdx = 0;
+    for (int64_t i = 0; i < boxes.count; i++) {
+        for (int64_t j = i + 1; j < boxes.count; j++) {
+            if (!geo_aabbOverlap(boxes.elems[i], boxes.elems[j], epsilon)) {
+                continue;
+            } else if (pairIdx >= pairs.count) {
+                return false;
+            }
+            bp_Pair p = pairs.elems[pairIdx++];
+            if (p.a != i || p.b != j) {
+                return false;
+            }
+        }
+    }
+    return pairIdx == pairs.count;
+}
+
+void bp_tests() {
+    snz_testPrintSection("broad phase");
+    snz_Arena arena = snz_arenaInit(10000000, "bp test arena");
+    snz_Arena scratch = snz_arenaInit(10000000, "bp test scratch arena");
+
+    {
+        geo_AABBSlice boxes = { .count = 2000, .elems = SNZ_ARENA_PUSH_ARR(&arena, 2000, geo_AABB) };
+        srand(1);
+        for (int64_t i = 0; i < boxes.count; i++) {
+            HMM_Vec3 pos = HMM_V3((float)(rand() % 1000), (float)(rand() % 100), (float)(rand() % 10));
+            HMM_Vec3 size = HMM_V3((float)(rand() % 20), (float)(rand() % 20), (float)(rand() % 20));
+            boxes.elems[i] = (geo_AABB){ .min = pos, .max = HMM_Add(pos, size) };
+        }
+        bp_PairSlice pairs = bp_sweepAndPrune(boxes, geo_EPSILON, &arena, &scratch);
+        snz_testPrint(_bp_pairsMatchBruteForce(boxes, pairs, geo_EPSILON), "SAP matches brute force");
+    }
+
+    {
+        geo_AABB as[] = {
+            { .min = HMM_V3(0, 0, 0), .max = HMM_V3(1, 1, 1) },
+            { .min = HMM_V3(5, 0, 0), .max = HMM_V3(6, 1, 1) },
+            { .min = HMM_V3(0, 0, 0), .max = HMM_V3(0.5, 0.5, 0.5) }, // overlaps as[0], but same set shouldn't pair
+        };
+        geo_AABB bs[] = {
+            { .min = HMM_V3(1, 1, 1), .max = HMM_V3(2, 2, 2) }, // touching as[0]
+            { .min = HMM_V3(5.5, 0.5, 0.5), .max = HMM_V3(5.6, 0.6, 0.6) }, // inside as[1]
+        };
+        geo_AABBSlice aSlice = { .elems = as, .count = 3 };
+        geo_AABBSlice bSlice = { .elems = bs, .count = 2 };
+        bp_PairSlice pairs = bp_sweepAndPruneBetween(aSlice, bSlice, geo_EPSILON, &arena, &scratch);
+        bool correct = pairs.count == 2;
+        correct &= pairs.elems[0].a == 0 && pairs.elems[0].b == 0;
+        correct &= pairs.elems[1].a == 1 && pairs.elems[1].b == 1;
+        snz_testPrint(correct, "SAP between two sets");
+    }
+
+    snz_arenaDeinit(&arena);
+    snz_arenaDeinit(&scratch);
+}
@@ -114,8 +114,8 @@ csg_Node* csg_facesToNodes(const mesh_FaceSlice* faces, snz_Arena* arena) {
     return firstNode;
 }
 
-bool csg_nodesContainPoint(csg_Node* tree, HMM_Vec3 point) {
-    csg_Node* node = tree;
+bool csg_nodesContainPoint(const csg_Node* tree, HMM_Vec3 point) {
+    const csg_Node* node = tree;
     while (true) {  // FIXME: failsafe here :)
         HMM_Vec3 diff = HMM_SubV3(point, node->origin);
         float dot = HMM_DotV3(diff, node->normal);
@@ -318,6 +318,7 @@ typedef struct _csg_TempFace _csg_TempFace;
 struct _csg_TempFace {
     _csg_TempFace* next;
     mesh_Face face;
+    bool trisInArena;  // false while tris still point at the operand they came from, which can't be touched or kept
 };
 
 static _csg_TempFace* _csg_tempFacesFindLast(_csg_TempFace* first) {
@@ -350,26 +351,111 @@ static mesh_FaceSlice _csg_tempFacesToFaces(_csg_TempFace* firstFace, snz_Arena*
     return SNZ_ARENA_ARR_END(arena, mesh_Face);
 }
 
+static geo_AABB _csg_facesBounds(const mesh_FaceSlice* faces) {
+    geo_AABB out = geo_aabbEmpty();
+    for (int64_t faceIdx = 0; faceIdx < faces->count; faceIdx++) {
+        geo_TriSlice tris = faces->elems[faceIdx].tris;
+        for (int64_t triIdx = 0; triIdx < tris.count; triIdx++) {
+            for (int i = 0; i < 3; i++) {
+                geo_aabbAddPt(&out, tris.elems[triIdx].elems[i]);
+            }
+        }
+    }
+    return out;
+}
+
+// clips one tri against the whole tree, pushing whatever's left of it to arena
+static void _csg_tempFaceClipTri(geo_Tri t, const csg_Node* tree, bool removeWithin, snz_Arena* arena, snz_Arena* scratch) {
+    int64_t scratchStart = snz_arenaUsedBytes(scratch);
+    bool anyClipped = _csg_clipTri(&t, removeWithin, tree, arena, scratch);
+    if (!anyClipped) {
+        *SNZ_ARENA_PUSH(arena, geo_Tri) = t;
+    }
+    snz_arenaPop(scratch, snz_arenaUsedBytes(scratch) - scratchStart);
+}
+
 // destructive to OG face list - reuses nodes in output
+// treeFaces should be the faces that made tree. Only faces + tris that come near one of them (per the broad phase)
+// get clipped, everything else can't cross the trees surface so is kept or removed whole based on one pt in it.
 // FIXME: handle the case where a face gets split and we need new faceIds
 // FIXME: put new faceIDs on to everything that changes
-static _csg_TempFace* _csg_tempFacesClip(_csg_TempFace* faces, const csg_Node* tree, bool removeWithin, snz_Arena* arena, snz_Arena* scratch) {
+static _csg_TempFace* _csg_tempFacesClip(_csg_TempFace* faces, const csg_Node* tree, const mesh_FaceSlice* treeFaces, bool removeWithin, snz_Arena* arena, snz_Arena* scratch) {
+    int64_t faceCount = 0;
+    for (_csg_TempFace* f = faces; f; f = f->next) {
+        faceCount++;
+    }
+    geo_AABBSlice faceBounds = {
+        .count = faceCount,
+        .elems = SNZ_ARENA_PUSH_ARR(scratch, faceCount, geo_AABB),
+    };
+    int64_t faceIdx = 0;
+    for (_csg_TempFace* f = faces; f; f = f->next) {
+        faceBounds.elems[faceIdx++] = geo_aabbFromTris(f->face.tris);
+    }
+    geo_AABBSlice treeFaceBounds = {
+        .count = treeFaces->count,
+        .elems = SNZ_ARENA_PUSH_ARR(scratch, treeFaces->count, geo_AABB),
+    };
+    for (int64_t i = 0; i < treeFaces->count; i++) {
+        treeFaceBounds.elems[i] = geo_aabbFromTris(treeFaces->elems[i].tris);
+    }
+    // sorted by a, so each faces pairs are one run
+    bp_PairSlice pairs = bp_sweepAndPruneBetween(faceBounds, treeFaceBounds, geo_EPSILON, scratch, scratch);
+
     _csg_TempFace* firstOutFace = NULL;
-    int faceIdx = 0;
+    int64_t pairIdx = 0;
+    faceIdx = 0;
     for (_csg_TempFace* f = faces; f; faceIdx++) {
+        if (mesh_cancelRequested()) {
+            break;
+        }
+        int64_t firstPair = pairIdx;
+        while (pairIdx < pairs.count && pairs.elems[pairIdx].a == faceIdx) {
+            pairIdx++;
+        }
+
+        if (firstPair == pairIdx) {
+            // no face of the tree comes near, so the whole face is either kept or removed
+            bool keep = true;
+            if (f->face.tris.count > 0) {
+                geo_Tri t = f->face.tris.elems[0];
+                HMM_Vec3 center = HMM_DivV3F(HMM_Add(HMM_Add(t.a, t.b), t.c), 3);
+                keep = csg_nodesContainPoint(tree, center) != removeWithin;
+            }
+
+            _csg_TempFace* next = f->next;
+            if (keep && f->face.tris.count > 0) {
+                if (!f->trisInArena) {
+                    f->face.tris = geo_triSliceDuplicate(&f->face.tris, arena);
+                    f->trisInArena = true;
+                }
+                f->next = firstOutFace;
+                firstOutFace = f;
+            }
+            f = next;
+            continue;
+        }
+
         SNZ_ARENA_ARR_BEGIN(arena, geo_Tri);
         for (int64_t i = 0; i < f->face.tris.count; i++) {
-            void* scratchStart = scratch->end;
-
             geo_Tri t = f->face.tris.elems[i];
-            bool anyClipped = _csg_clipTri(&t, removeWithin, tree, arena, scratch);
-            if (!anyClipped) {
-                *SNZ_ARENA_PUSH(arena, geo_Tri) = t;
+            geo_AABB triBounds = geo_aabbFromTri(t);
+            bool nearTree = false;
+            for (int64_t j = firstPair; j < pairIdx && !nearTree; j++) {
+                nearTree = geo_aabbOverlap(triBounds, treeFaceBounds.elems[pairs.elems[j].b], geo_EPSILON);
             }
 
-            scratch->end = scratchStart;
+            if (nearTree) {
+                _csg_tempFaceClipTri(t, tree, removeWithin, arena, scratch);
+            } else {
+                HMM_Vec3 center = HMM_DivV3F(HMM_Add(HMM_Add(t.a, t.b), t.c), 3);
+                if (csg_nodesContainPoint(tree, center) != removeWithin) {
+                    *SNZ_ARENA_PUSH(arena, geo_Tri) = t;
+                }
+            }
         }
         f->face.tris = SNZ_ARENA_ARR_END(arena, geo_Tri);
+        f->trisInArena = true;
 
         _csg_TempFace* next = f->next;
         // don't push to out list if nothing made it past clipping
@@ -388,9 +474,15 @@ mesh_FaceSlice csg_facesUnion(const mesh_FaceSlice* a, const mesh_FaceSlice* b,
     csg_Node* aNodes = csg_facesToNodes(a, scratch);
     csg_Node* bNodes = csg_facesToNodes(b, scratch);
 
-    aFaces = _csg_tempFacesClip(aFaces, bNodes, true, arena, scratch);
-    bFaces = _csg_tempFacesClip(bFaces, aNodes, true, arena, scratch);
+    aFaces = _csg_tempFacesClip(aFaces, bNodes, b, true, arena, scratch);
+    bFaces = _csg_tempFacesClip(bFaces, aNodes, a, true, arena, scratch);
 
+    if (mesh_cancelRequested()) {
+        return (mesh_FaceSlice){ 0 };
+    }
+    if (!aFaces) {  // all of a got clipped, ex. intersecting with something that's inside it
+        return _csg_tempFacesToFaces(bFaces, arena);
+    }
     _csg_TempFace* last = _csg_tempFacesFindLast(aFaces);
     last->next = bFaces;
     return _csg_tempFacesToFaces(aFaces, arena);
@@ -402,12 +494,18 @@ mesh_FaceSlice csg_facesDifference(const mesh_FaceSlice* a, const mesh_FaceSlice
     csg_Node* aNodes = csg_facesToNodes(a, scratch);
     csg_Node* bNodes = csg_facesToNodes(b, scratch);
 
-    aFaces = _csg_tempFacesClip(aFaces, bNodes, true, arena, scratch);
-    bFaces = _csg_tempFacesClip(bFaces, aNodes, false, arena, scratch);
+    aFaces = _csg_tempFacesClip(aFaces, bNodes, b, true, arena, scratch);
+    bFaces = _csg_tempFacesClip(bFaces, aNodes, a, false, arena, scratch);
     for (_csg_TempFace* f = bFaces; f; f = f->next) {
         geo_triSliceInvert(&f->face.tris);
     }
 
+    if (mesh_cancelRequested()) {
+        return (mesh_FaceSlice){ 0 };
+    }
+    if (!aFaces) {  // all of a got clipped, ex. intersecting with something that's inside it
+        return _csg_tempFacesToFaces(bFaces, arena);
+    }
     _csg_TempFace* last = _csg_tempFacesFindLast(aFaces);
     last->next = bFaces;
     return _csg_tempFacesToFaces(aFaces, arena);
@@ -419,20 +517,186 @@ mesh_FaceSlice csg_facesIntersection(const mesh_FaceSlice* a, const mesh_FaceSli
     csg_Node* aNodes = csg_facesToNodes(a, scratch);
     csg_Node* bNodes = csg_facesToNodes(b, scratch);
 
-    aFaces = _csg_tempFacesClip(aFaces, bNodes, false, arena, scratch);
+    aFaces = _csg_tempFacesClip(aFaces, bNodes, b, false, arena, scratch);
     for (_csg_TempFace* f = bFaces; f; f = f->next) {
+        // b is the callers, so flip a copy. clipping moves whatever survives into arena
+        f->face.tris = geo_triSliceDuplicate(&f->face.tris, scratch);
         geo_triSliceInvert(&f->face.tris);
     }
-    bFaces = _csg_tempFacesClip(bFaces, aNodes, false, arena, scratch);
+    bFaces = _csg_tempFacesClip(bFaces, aNodes, a, false, arena, scratch);
     for (_csg_TempFace* f = bFaces; f; f = f->next) {
         geo_triSliceInvert(&f->face.tris);
     }
 
+    if (mesh_cancelRequested()) {
+        return (mesh_FaceSlice){ 0 };
+    }
+    if (!aFaces) {  // all of a got clipped, ex. intersecting with something that's inside it
+        return _csg_tempFacesToFaces(bFaces, arena);
+    }
     _csg_TempFace* last = _csg_tempFacesFindLast(aFaces);
     last->next = bFaces;
     return _csg_tempFacesToFaces(aFaces, arena);
 }
 
+// unions every operand at once, same result as doing csg_facesUnion on them one after another, but each operand only
+// gets clipped against the ones its bounds overlap, and trees only get built for operands that overlap something.
+// So a bunch of copies that don't touch (see the pattern ops in timeline.h) are just a copy each, no BSP at all.
+mesh_FaceSlice csg_facesUnionMany(const mesh_FaceSlice* operands, int64_t operandCount, snz_Arena* arena, snz_Arena* scratch) {
+    geo_AABBSlice bounds = {
+        .count = operandCount,
+        .elems = SNZ_ARENA_PUSH_ARR(scratch, operandCount, geo_AABB),
+    };
+    for (int64_t i = 0; i < operandCount; i++) {
+        bounds.elems[i] = _csg_facesBounds(&operands[i]);
+    }
+    bp_PairSlice pairs = bp_sweepAndPrune(bounds, geo_EPSILON, scratch, scratch);
+
+    // CSR style list of the operands that overlap each one, pairs only come out once so both ends get it
+    int64_t* overlapStarts = SNZ_ARENA_PUSH_ARR(scratch, operandCount + 1, int64_t);
+    for (int64_t i = 0; i < pairs.count; i++) {
+        overlapStarts[pairs.elems[i].a + 1]++;
+        overlapStarts[pairs.elems[i].b + 1]++;
+    }
+    for (int64_t i = 0; i < operandCount; i++) {
+        overlapStarts[i + 1] += overlapStarts[i];
+    }
+    int64_t* overlaps = SNZ_ARENA_PUSH_ARR(scratch, overlapStarts[operandCount], int64_t);
+    int64_t* fillCounts = SNZ_ARENA_PUSH_ARR(scratch, operandCount, int64_t);
+    for (int64_t i = 0; i < pairs.count; i++) {
+        bp_Pair p = pairs.elems[i];
+        overlaps[overlapStarts[p.a] + fillCounts[p.a]++] = p.b;
+        overlaps[overlapStarts[p.b] + fillCounts[p.b]++] = p.a;
+    }
+
+    csg_Node** trees = SNZ_ARENA_PUSH_ARR(scratch, operandCount, csg_Node*);  // built on first use
+    _csg_TempFace* firstFace = NULL;
+    for (int64_t i = 0; i < operandCount; i++) {
+        _csg_TempFace* faces = _csg_facesToTempFaces(&operands[i], scratch);
+        for (int64_t j = overlapStarts[i]; j < overlapStarts[i + 1] && faces; j++) {
+            int64_t other = overlaps[j];
+            if (!trees[other]) {
+                trees[other] = csg_facesToNodes(&operands[other], scratch);
+            }
+            faces = _csg_tempFacesClip(faces, trees[other], &operands[other], true, arena, scratch);
+        }
+
+        if (mesh_cancelRequested()) {
+            return (mesh_FaceSlice){ 0 };
+        }
+        // operands that didn't overlap anything never went thru a clip, so still need copying
+        for (_csg_TempFace* f = faces; f; f = f->next) {
+            if (!f->trisInArena) {
+                f->face.tris = geo_triSliceDuplicate(&f->face.tris, arena);
+                f->trisInArena = true;
+            }
+        }
+        if (faces) {
+            _csg_TempFace* last = _csg_tempFacesFindLast(faces);
+            last->next = firstFace;
+            firstFace = faces;
+        }
+    }
+    return _csg_tempFacesToFaces(firstFace, arena);
+}
+
+// every tri split into 4 at its midpoints, levels times
+static mesh_FaceSlice _csg_testSubdivide(mesh_FaceSlice faces, int levels, snz_Arena* arena) {
+    for (int level = 0; level < levels; level++) {
+        mesh_FaceSlice out = {
+            .count = faces.count,
+            .elems = SNZ_ARENA_PUSH_ARR(arena, faces.count, mesh_Face),
+        };
+        for (int64_t faceIdx = 0; faceIdx < faces.count; faceIdx++) {
+            out.elems[faceIdx] = faces.elems[faceIdx];
+            SNZ_ARENA_ARR_BEGIN(arena, geo_Tri);
+            for (int64_t i = 0; i < faces.elems[faceIdx].tris.count; i++) {
+                geo_Tri t = faces.elems[faceIdx].tris.elems[i];
+                HMM_Vec3 ab = HMM_DivV3F(HMM_Add(t.a, t.b), 2);
+                HMM_Vec3 bc = HMM_DivV3F(HMM_Add(t.b, t.c), 2);
+                HMM_Vec3 ca = HMM_DivV3F(HMM_Add(t.c, t.a), 2);
+                *SNZ_ARENA_PUSH(arena, geo_Tri) = geo_triInit(t.a, ab, ca);
+                *SNZ_ARENA_PUSH(arena, geo_Tri) = geo_triInit(ab, t.b, bc);
+                *SNZ_ARENA_PUSH(arena, geo_Tri) = geo_triInit(ca, bc, t.c);
+                *SNZ_ARENA_PUSH(arena, geo_Tri) = geo_triInit(ab, bc, ca);
+            }
+            out.elems[faceIdx].tris = SNZ_ARENA_ARR_END(arena, geo_Tri);
+        }
+        faces = out;
+    }
+    return faces;
+}
+
+static float _csg_testTempFacesArea(_csg_TempFace* faces) {
+    float area = 0;
+    for (_csg_TempFace* f = faces; f; f = f->next) {
+        for (int64_t i = 0; i < f->face.tris.count; i++) {
+            area += geo_triArea(f->face.tris.elems[i]);
+        }
+    }
+    return area;
+}
+
+static mesh_FaceSlice _csg_testFacesCopy(const mesh_FaceSlice* faces, snz_Arena* arena) {
+    mesh_FaceSlice out = {
+        .count = faces->count,
+        .elems = SNZ_ARENA_PUSH_ARR(arena, faces->count, mesh_Face),
+    };
+    for (int64_t i = 0; i < faces->count; i++) {
+        out.elems[i] = faces->elems[i];
+        out.elems[i].tris = geo_triSliceDuplicate(&faces->elems[i].tris, arena);
+    }
+    return out;
+}
+
+static bool _csg_testFacesIdentical(const mesh_FaceSlice* a, const mesh_FaceSlice* b) {
+    if (a->count != b->count) {
+        return false;
+    }
+    for (int64_t i = 0; i < a->count; i++) {
+        geo_TriSlice ta = a->elems[i].tris;
+        geo_TriSlice tb = b->elems[i].tris;
+        if (ta.count != tb.count || memcmp(ta.elems, tb.elems, ta.count * sizeof(geo_Tri)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// whether any tri in the result is the same memory as one in the operand
+static bool _csg_testFacesShareTris(const mesh_FaceSlice* result, const mesh_FaceSlice* operand) {
+    for (int64_t i = 0; i < result->count; i++) {
+        geo_TriSlice r = result->elems[i].tris;
+        for (int64_t j = 0; j < operand->count; j++) {
+            geo_TriSlice o = operand->elems[j].tris;
+            if (r.count > 0 && o.count > 0 && r.elems < o.elems + o.count && o.elems < r.elems + r.count) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// broad phase clipping vs. running every tri thru the tree, which is what it did before
+static bool _csg_testClipMatchesClippingEverything(const mesh_FaceSlice* a, const mesh_FaceSlice* b, bool removeWithin, snz_Arena* arena, snz_Arena* scratch) {
+    csg_Node* tree = csg_facesToNodes(b, scratch);
+    _csg_TempFace* clipped = _csg_tempFacesClip(_csg_facesToTempFaces(a, scratch), tree, b, removeWithin, arena, scratch);
+
+    float expectedArea = 0;
+    for (int64_t faceIdx = 0; faceIdx < a->count; faceIdx++) {
+        SNZ_ARENA_ARR_BEGIN(arena, geo_Tri);
+        for (int64_t i = 0; i < a->elems[faceIdx].tris.count; i++) {
+            _csg_tempFaceClipTri(a->elems[faceIdx].tris.elems[i], tree, removeWithin, arena, scratch);
+        }
+        geo_TriSlice tris = SNZ_ARENA_ARR_END(arena, geo_Tri);
+        for (int64_t i = 0; i < tris.count; i++) {
+            expectedArea += geo_triArea(tris.elems[i]);
+        }
+    }
+    float area = _csg_testTempFacesArea(clipped);
+    return fabsf(area - expectedArea) < 0.0001f * SNZ_MAX(1, expectedArea);
+}
+
 void csg_tests() {
     snz_testPrintSection("csg");
 
@@ -533,6 +797,93 @@ void csg_tests() {
         mesh_facesToSTLFile(faces, "testing/difference.stl");
     }
 
+    snz_arenaClear(&arena);
+    snz_arenaClear(&scratch);
+
+    {
+        // finely split so some tris of a face are near the other mesh and some aren't
+        srand(7);
+        bool correct = true;
+        for (int i = 0; i < 20; i++) {
+            mesh_FaceSlice cubeA = _csg_testSubdivide(mesh_cube(&arena), 3, &arena);
+            mesh_FaceSlice cubeB = _csg_testSubdivide(mesh_cube(&arena), 1, &arena);
+            HMM_Vec3 axis = HMM_V3((float)(rand() % 100 + 1), (float)(rand() % 100), (float)(rand() % 100));
+            mesh_facesTransform(cubeB, HMM_Rotate_RH(HMM_AngleDeg((float)(rand() % 90)), HMM_Norm(axis)));
+            mesh_facesTranslate(cubeB, HMM_V3((float)(rand() % 200) / 100, (float)(rand() % 200) / 100, (float)(rand() % 200) / 100));
+            correct &= _csg_testClipMatchesClippingEverything(&cubeA, &cubeB, true, &arena, &scratch);
+            correct &= _csg_testClipMatchesClippingEverything(&cubeA, &cubeB, false, &arena, &scratch);
+            correct &= _csg_testClipMatchesClippingEverything(&cubeB, &cubeA, true, &arena, &scratch);
+            snz_arenaClear(&arena);
+            snz_arenaClear(&scratch);
+        }
+        snz_testPrint(correct, "broad phase clipping matches clipping every tri");
+    }
+
+    {
+        // a + b overlap, c is off by itself
+        mesh_FaceSlice cubes[3] = { 0 };
+        for (int i = 0; i < 3; i++) {
+            cubes[i] = mesh_cube(&arena);
+        }
+        mesh_facesTransform(cubes[1], HMM_Rotate_RH(HMM_AngleDeg(30), HMM_V3(1, 1, 1)));
+        mesh_facesTranslate(cubes[1], HMM_V3(1, 1, 1));
+        mesh_facesTranslate(cubes[2], HMM_V3(10, 0, 0));
+
+        mesh_FaceSlice many = csg_facesUnionMany(cubes, 3, &arena, &scratch);
+        mesh_FaceSlice ab = csg_facesUnion(&cubes[0], &cubes[1], &arena, &scratch);
+        mesh_FaceSlice pairwise = csg_facesUnion(&ab, &cubes[2], &arena, &scratch);
+
+        float manyArea = 0;
+        float pairwiseArea = 0;
+        int64_t untouchedFaces = 0;
+        for (int64_t i = 0; i < many.count; i++) {
+            for (int64_t j = 0; j < many.elems[i].tris.count; j++) {
+                manyArea += geo_triArea(many.elems[i].tris.elems[j]);
+            }
+            untouchedFaces += many.elems[i].tris.count == cubes[2].elems[0].tris.count &&
+                memcmp(many.elems[i].tris.elems, cubes[2].elems[0].tris.elems, cubes[2].elems[0].tris.count * sizeof(geo_Tri)) == 0;
+        }
+        for (int64_t i = 0; i < pairwise.count; i++) {
+            for (int64_t j = 0; j < pairwise.elems[i].tris.count; j++) {
+                pairwiseArea += geo_triArea(pairwise.elems[i].tris.elems[j]);
+            }
+        }
+        snz_testPrint(fabsf(manyArea - pairwiseArea) < 0.001f, "union many matches unioning one at a time");
+        snz_testPrint(untouchedFaces == 1, "union many doesn't clip operands that don't overlap");
+        snz_testPrint(!_csg_testFacesShareTris(&many, &cubes[2]), "union many copies operands that don't overlap");
+    }
+
+    snz_arenaClear(&arena);
+    snz_arenaClear(&scratch);
+
+    {
+        // small cube inside a big one, so every face of the big one is kept whole without clipping
+        mesh_FaceSlice big = mesh_cube(&arena);
+        mesh_facesTransform(big, HMM_Scale(HMM_V3(10, 10, 10)));
+        mesh_FaceSlice small = mesh_cube(&arena);
+        mesh_FaceSlice bigBefore = _csg_testFacesCopy(&big, &arena);
+        mesh_FaceSlice smallBefore = _csg_testFacesCopy(&small, &arena);
+
+        bool unchanged = true;
+        bool shared = false;
+        mesh_FaceSlice results[] = {
+            csg_facesUnion(&big, &small, &arena, &scratch),
+            csg_facesDifference(&big, &small, &arena, &scratch),
+            csg_facesIntersection(&big, &small, &arena, &scratch),
+            csg_facesUnion(&small, &big, &arena, &scratch),
+            csg_facesDifference(&small, &big, &arena, &scratch),
+            csg_facesIntersection(&small, &big, &arena, &scratch),
+        };
+        for (int i = 0; i < (int)(sizeof(results) / sizeof(*results)); i++) {
+            shared |= _csg_testFacesShareTris(&results[i], &big);
+            shared |= _csg_testFacesShareTris(&results[i], &small);
+        }
+        unchanged &= _csg_testFacesIdentical(&big, &bigBefore);
+        unchanged &= _csg_testFacesIdentical(&small, &smallBefore);
+        snz_testPrint(unchanged, "union, difference and intersection leave both operands alone");
+        snz_testPrint(!shared, "csg results don't point into their operands");
+    }
+
     snz_arenaDeinit(&arena);
     snz_arenaDeinit(&scratch);
     poolAllocDeinit(&pool);
@@ -88,6 +88,58 @@ bool geo_v3Equal(HMM_Vec3 a, HMM_Vec3 b) {
     return geo_floatEqual(a.X, b.X) && geo_floatEqual(a.Y, b.Y) && geo_floatEqual(a.Z, b.Z);
 }
 
+typedef struct {
+    HMM_Vec3 min;
+    HMM_Vec3 max;
+} geo_AABB;
+
+SNZ_SLICE(geo_AABB);
+
+// inverted so that adding any point makes it valid
+geo_AABB geo_aabbEmpty() {
+    return (geo_AABB) {
+        .min = HMM_V3(INFINITY, INFINITY, INFINITY),
+        .max = HMM_V3(-INFINITY, -INFINITY, -INFINITY),
+    };
+}
+
+void geo_aabbAddPt(geo_AABB* box, HMM_Vec3 pt) {
+    for (int ax = 0; ax < 3; ax++) {
+        box->min.Elements[ax] = SNZ_MIN(box->min.Elements[ax], pt.Elements[ax]);
+        box->max.Elements[ax] = SNZ_MAX(box->max.Elements[ax], pt.Elements[ax]);
+    }
+}
+
+geo_AABB geo_aabbFromTri(geo_Tri t) {
+    geo_AABB out = geo_aabbEmpty();
+    for (int i = 0; i < 3; i++) {
+        geo_aabbAddPt(&out, t.elems[i]);
+    }
+    return out;
+}
+
+geo_AABB geo_aabbFromTris(geo_TriSlice tris) {
+    geo_AABB out = geo_aabbEmpty();
+    for (int64_t triIdx = 0; triIdx < tris.count; triIdx++) {
+        for (int i = 0; i < 3; i++) {
+            geo_aabbAddPt(&out, tris.elems[triIdx].elems[i]);
+        }
+    }
+    return out;
+}
+
+// boxes that are within epsilon of touching count as overlapping
+bool geo_aabbOverlap(geo_AABB a, geo_AABB b, float epsilon) {
+    for (int ax = 0; ax < 3; ax++) {
+        if (a.min.Elements[ax] > b.max.Elements[ax] + epsilon) {
+            return false;
+        } else if (b.min.Elements[ax] > a.max.Elements[ax] + epsilon) {
+            return false;
+        }
+    }
+    return true;
+}
+
 typedef struct {
     HMM_Vec3 pt;
     HMM_Vec3 normal;
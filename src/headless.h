@@ -0,0 +1,170 @@
+#pragma once
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+// msvc-isms in snooze that gcc on linux doesn't have, these need to be in before it gets included
+#ifndef _WIN32
+#define vsprintf_s(buf, size, fmt, args) vsnprintf((buf), (size), (fmt), (args))
+#define _STATIC_ASSERT(cond) _Static_assert((cond), #cond)
+#endif
+
+#include "snooze.h"
+
+/*
+HEADLESS:
+posix stand ins for the little bit of SDL that the solving side of adder (jobs, timeline, mesh cancel tokens) uses,
+so that tools like batch.c can run it without linking SDL or GL at all.
+
+The SDL headers still get included thru snooze.h, only the definitions are swapped out. Everything else in
+snooze/ui/render3d that calls into SDL or GL is never called from a headless tool and gets thrown out by the linker,
+see the batch line in build.sh (-ffunction-sections + --gc-sections is what makes that work).
+
+Include this once, first thing in the file with main in it, and never in the same program as the real SDL.
+Posix only for now.
+*/
+
+struct SDL_Thread {
+    pthread_t thread;
+    SDL_ThreadFunction fn;
+    void* data;
+};
+
+struct SDL_semaphore {
+    sem_t sem;
+};
+
+static void* _headless_threadMain(void* data) {
+    SDL_Thread* t = (SDL_Thread*)data;
+    t->fn(t->data);
+    return NULL;
+}
+
+SDL_Thread* SDL_CreateThread(SDL_ThreadFunction fn, const char* name, void* data) {
+    (void)name;  // only for debuggers in SDL, unused here
+    SDL_Thread* t = calloc(1, sizeof(*t));
+    if (!t) {
+        return NULL;
+    }
+    t->fn = fn;
+    t->data = data;
+    if (pthread_create(&t->thread, NULL, _headless_threadMain, t) != 0) {
+        free(t);
+        return NULL;
+    }
+    return t;
+}
+
+// the threads return val is dropped, nothing in adder uses it
+void SDL_WaitThread(SDL_Thread* t, int* status) {
+    pthread_join(t->thread, NULL);
+    if (status) {
+        *status = 0;
+    }
+    free(t);
+}
+
+int SDL_AtomicGet(SDL_atomic_t* a) {
+    return __atomic_load_n(&a->value, __ATOMIC_SEQ_CST);
+}
+
+// returns the old value, same as SDL
+int SDL_AtomicSet(SDL_atomic_t* a, int v) {
+    return __atomic_exchange_n(&a->value, v, __ATOMIC_SEQ_CST);
+}
+
+// returns the old value, same as SDL
+int SDL_AtomicAdd(SDL_atomic_t* a, int v) {
+    return __atomic_fetch_add(&a->value, v, __ATOMIC_SEQ_CST);
+}
+
+void SDL_AtomicLock(SDL_SpinLock* lock) {
+    while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE)) {
+        sched_yield();
+    }
+}
+
+void SDL_AtomicUnlock(SDL_SpinLock* lock) {
+    __atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+}
+
+SDL_sem* SDL_CreateSemaphore(Uint32 initialValue) {
+    SDL_sem* s = calloc(1, sizeof(*s));
+    if (!s) {
+        return NULL;
+    }
+    if (sem_init(&s->sem, 0, initialValue) != 0) {
+        free(s);
+        return NULL;
+    }
+    return s;
+}
+
+void SDL_DestroySemaphore(SDL_sem* s) {
+    sem_destroy(&s->sem);
+    free(s);
+}
+
+int SDL_SemPost(SDL_sem* s) {
+    return sem_post(&s->sem);
+}
+
+// 0 when it got the semaphore, SDL_MUTEX_TIMEDOUT when it didn't in time
+int SDL_SemWaitTimeout(SDL_sem* s, Uint32 ms) {
+    struct timespec until = { 0 };
+    clock_gettime(CLOCK_REALTIME, &until);
+    until.tv_sec += ms / 1000;
+    until.tv_nsec += (long)(ms % 1000) * 1000000L;
+    if (until.tv_nsec >= 1000000000L) {
+        until.tv_sec++;
+        until.tv_nsec -= 1000000000L;
+    }
+    while (sem_timedwait(&s->sem, &until) != 0) {
+        if (errno != EINTR) {
+            return SDL_MUTEX_TIMEDOUT;
+        }
+    }
+    return 0;
+}
+
+// solve threads only ask for low priority, which is a nice to have, so everything just runs at whatever it got
+int SDL_SetThreadPriority(SDL_ThreadPriority priority) {
+    (void)priority;
+    return 0;
+}
+
+const char* SDL_GetError() {
+    return strerror(errno);
+}
+
+// zero ms just gives up the rest of the time slice, which is what job_wait wants
+void SDL_Delay(Uint32 ms) {
+    if (ms == 0) {
+        sched_yield();
+        return;
+    }
+    struct timespec t = { .tv_sec = ms / 1000, .tv_nsec = (long)(ms % 1000) * 1000000L };
+    while (nanosleep(&t, &t) != 0 && errno == EINTR) {
+    }
+}
+
+int SDL_GetCPUCount() {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+}
+
+// in nanoseconds
+Uint64 SDL_GetPerformanceCounter() {
+    struct timespec t = { 0 };
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (Uint64)t.tv_sec * 1000000000ULL + (Uint64)t.tv_nsec;
+}
+
+Uint64 SDL_GetPerformanceFrequency() {
+    return 1000000000ULL;
+}
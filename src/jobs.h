@@ -0,0 +1,302 @@
+#pragma once
+
+#include <stdlib.h>
+
+#include "snooze.h"
+
+/*
+JOBS:
+small work stealing job system. Each worker thread has it's own deque of jobs and it's own (growable) scratch arena.
+A worker pushes + pops from the bottom of it's own deque (so it keeps working on whatever it just made,
+while that's still in cache), and when it runs out it steals from the top of somebody else's.
+
+Worker 0 doesn't get a thread, it's whichever one thread is currently driving the system (main, the
+timeline solve thread, a test...). That thread pushes the first jobs onto worker 0 and then helps run
+them from inside job_wait. Only one thread can be driving a system at a time.
+
+Jobs can push more jobs (onto the worker passed to them) and wait on them, so anything that can be split up
+(timeline ops, the loops of a sketch being triangulated) can go thru here without knowing about the others.
+Scratch given to a job is only good until it returns, anything it allocates there gets popped after.
+
+fns:
+job_systemInit() - starts the worker threads, zero threads is fine and just runs everything in job_wait
+job_systemDeinit() - stops + waits on every thread, then frees the system
+job_systemCaller() - the worker for the driving thread to push to / wait with
+job_push() - queue a job on a worker, counter gets incremented now and decremented once the job is done
+job_wait() - runs jobs until counter hits zero
+*/
+
+typedef struct job_Worker job_Worker;
+typedef struct job_System job_System;
+
+// scratch is w->scratch, and only lives as long as the call
+typedef void (*job_Fn)(job_Worker* w, void* data);
+
+typedef struct {
+    job_Fn fn;
+    void* data;
+    SDL_atomic_t* counter;
+} job_Job;
+
+// ring buffer, everything is behind the lock
+// FIXME: lock free (chase-lev) deque if contention ever actually shows up in a profile
+typedef struct {
+    SDL_SpinLock lock;
+    job_Job* elems;
+    int64_t capacity; // always a power of two
+    int64_t top; // thieves take from here
+    int64_t bottom; // owner pushes/pops here
+} _job_Deque;
+
+struct job_Worker {
+    job_System* system;
+    int idx;
+    SDL_Thread* thread; // null for worker 0
+    _job_Deque deque;
+    snz_Arena scratch;
+    uint64_t rngState; // for picking who to steal from
+};
+
+struct job_System {
+    job_Worker* workers;
+    int workerCount; // includes worker 0
+    SDL_atomic_t quit;
+    SDL_sem* wake; // posted once per push, idle threads sleep on it
+};
+
+#define JOB_MAX_WORKERS 64
+
+static void _job_dequePush(_job_Deque* d, job_Job job) {
+    SDL_AtomicLock(&d->lock);
+    if (d->bottom - d->top == d->capacity) {
+        int64_t newCapacity = d->capacity ? d->capacity * 2 : 256;
+        job_Job* newElems = calloc(newCapacity, sizeof(*newElems));
+        SNZ_ASSERT(newElems, "job deque alloc failed.");
+        for (int64_t i = d->top; i < d->bottom; i++) {
+            newElems[i & (newCapacity - 1)] = d->elems[i & (d->capacity - 1)];
+        }
+        free(d->elems);
+        d->elems = newElems;
+        d->capacity = newCapacity;
+    }
+    d->elems[d->bottom & (d->capacity - 1)] = job;
+    d->bottom++;
+    SDL_AtomicUnlock(&d->lock);
+}
+
+static bool _job_dequePop(_job_Deque* d, job_Job* out) {
+    SDL_AtomicLock(&d->lock);
+    bool found = d->bottom > d->top;
+    if (found) {
+        d->bottom--;
+        *out = d->elems[d->bottom & (d->capacity - 1)];
+    }
+    SDL_AtomicUnlock(&d->lock);
+    return found;
+}
+
+static bool _job_dequeSteal(_job_Deque* d, job_Job* out) {
+    SDL_AtomicLock(&d->lock);
+    bool found = d->bottom > d->top;
+    if (found) {
+        *out = d->elems[d->top & (d->capacity - 1)];
+        d->top++;
+    }
+    SDL_AtomicUnlock(&d->lock);
+    return found;
+}
+
+// runs one job, from w's deque if it has any, or stolen from someone else's. false if there was nothing anywhere.
+static bool _job_runOne(job_Worker* w) {
+    job_Job job = { 0 };
+    bool found = _job_dequePop(&w->deque, &job);
+    if (!found) {
+        job_System* sys = w->system;
+        w->rngState ^= w->rngState << 13;
+        w->rngState ^= w->rngState >> 7;
+        w->rngState ^= w->rngState << 17;
+        int startIdx = (int)(w->rngState % (uint64_t)sys->workerCount);
+        for (int i = 0; i < sys->workerCount && !found; i++) {
+            job_Worker* victim = &sys->workers[(startIdx + i) % sys->workerCount];
+            if (victim != w) {
+                found = _job_dequeSteal(&victim->deque, &job);
+            }
+        }
+    }
+    if (!found) {
+        return false;
+    }
+
+    // jobs can wait on other jobs, which run on this same worker, so scratch gets rolled back instead of cleared
+    int64_t scratchMark = snz_arenaUsedBytes(&w->scratch);
+    job.fn(w, job.data);
+    snz_arenaPop(&w->scratch, snz_arenaUsedBytes(&w->scratch) - scratchMark);
+
+    if (job.counter) {
+        SDL_AtomicAdd(job.counter, -1);
+    }
+    return true;
+}
+
+static int _job_workerThread(void* data) {
+    job_Worker* w = (job_Worker*)data;
+    while (!SDL_AtomicGet(&w->system->quit)) {
+        if (!_job_runOne(w)) {
+            SDL_SemWaitTimeout(w->system->wake, 1);
+        }
+    }
+    return 0;
+}
+
+// threadCount is on top of the driving thread, so 0 is valid and runs everything serially in job_wait
+// every worker (including 0) gets a growable scratch arena, scratchSize is just it's first block.
+// blocks a job grows into get freed when it returns, so a worker only holds onto more while it needs it
+// heap allocated so that workers can keep a pointer back to it, free w/ job_systemDeinit
+job_System* job_systemInit(int threadCount, int64_t scratchSize) {
+    SNZ_ASSERTF(threadCount >= 0 && threadCount < JOB_MAX_WORKERS, "invalid job thread count: %d", threadCount);
+    job_System* sys = calloc(1, sizeof(*sys));
+    SNZ_ASSERT(sys, "job system alloc failed.");
+    sys->workerCount = threadCount + 1;
+    sys->workers = calloc(sys->workerCount, sizeof(*sys->workers));
+    SNZ_ASSERT(sys->workers, "job worker alloc failed.");
+    sys->wake = SDL_CreateSemaphore(0);
+    SNZ_ASSERTF(sys->wake, "creating job semaphore failed: %s", SDL_GetError());
+
+    for (int i = 0; i < sys->workerCount; i++) {
+        job_Worker* w = &sys->workers[i];
+        w->system = sys;
+        w->idx = i;
+        w->scratch = snz_arenaInitGrowable(scratchSize, "job worker scratch");
+        w->rngState = 0x9E3779B97F4A7C15ULL * (uint64_t)(i + 1);
+    }
+    for (int i = 1; i < sys->workerCount; i++) {
+        job_Worker* w = &sys->workers[i];
+        w->thread = SDL_CreateThread(_job_workerThread, "job worker", w);
+        SNZ_ASSERTF(w->thread, "creating job worker thread failed: %s", SDL_GetError());
+    }
+    return sys;
+}
+
+void job_systemDeinit(job_System* sys) {
+    SDL_AtomicSet(&sys->quit, 1);
+    for (int i = 1; i < sys->workerCount; i++) {
+        SDL_SemPost(sys->wake);
+    }
+    for (int i = 0; i < sys->workerCount; i++) {
+        job_Worker* w = &sys->workers[i];
+        if (w->thread) {
+            SDL_WaitThread(w->thread, NULL);
+        }
+        snz_arenaDeinit(&w->scratch);
+        free(w->deque.elems);
+    }
+    SDL_DestroySemaphore(sys->wake);
+    free(sys->workers);
+    free(sys);
+}
+
+job_Worker* job_systemCaller(job_System* sys) {
+    return &sys->workers[0];
+}
+
+// counter may be null, when it isn't it gets incremented here and decremented when the job finishes
+void job_push(job_Worker* w, job_Fn fn, void* data, SDL_atomic_t* counter) {
+    if (counter) {
+        SDL_AtomicAdd(counter, 1);
+    }
+    _job_dequePush(&w->deque, (job_Job) { .fn = fn, .data = data, .counter = counter });
+    SDL_SemPost(w->system->wake);
+}
+
+// helps run jobs (not only ones under counter) until counter is zero
+void job_wait(job_Worker* w, SDL_atomic_t* counter) {
+    while (SDL_AtomicGet(counter) > 0) {
+        if (!_job_runOne(w)) {
+            SDL_Delay(0);  // whatever's left is running on another thread
+        }
+    }
+}
+
+// way more than the test systems first scratch block
+static void _job_testBigScratch(job_Worker* w, void* data) {
+    SDL_atomic_t* sum = (SDL_atomic_t*)data;
+    char* big = SNZ_ARENA_PUSH_ARR(&w->scratch, 5000000, char);
+    big[4999999] = 1;
+    SDL_AtomicAdd(sum, big[4999999]);
+}
+
+static void _job_testAdd(job_Worker* w, void* data) {
+    SDL_atomic_t* sum = (SDL_atomic_t*)data;
+    int* scratchInt = SNZ_ARENA_PUSH(&w->scratch, int);  // just to make sure scratch is usable and gets rolled back
+    *scratchInt = 1;
+    SDL_AtomicAdd(sum, *scratchInt);
+}
+
+typedef struct {
+    SDL_atomic_t* sum;
+    int depth;
+} _job_TestSplit;
+
+// makes two more of itself until depth runs out, each waits on it's children
+static void _job_testSplit(job_Worker* w, void* data) {
+    _job_TestSplit* split = (_job_TestSplit*)data;
+    if (split->depth == 0) {
+        SDL_AtomicAdd(split->sum, 1);
+        return;
+    }
+    _job_TestSplit* children = SNZ_ARENA_PUSH_ARR(&w->scratch, 2, _job_TestSplit);
+    SDL_atomic_t counter = { 0 };
+    for (int i = 0; i < 2; i++) {
+        children[i] = (_job_TestSplit){ .sum = split->sum, .depth = split->depth - 1 };
+        job_push(w, _job_testSplit, &children[i], &counter);
+    }
+    job_wait(w, &counter);
+}
+
+void job_tests() {
+    snz_testPrintSection("jobs");
+
+    job_System* sys = job_systemInit(3, 1000000);
+    job_Worker* caller = job_systemCaller(sys);
+
+    {
+        SDL_atomic_t sum = { 0 };
+        SDL_atomic_t counter = { 0 };
+        for (int i = 0; i < 10000; i++) {
+            job_push(caller, _job_testAdd, &sum, &counter);
+        }
+        job_wait(caller, &counter);
+        bool scratchClean = true;
+        for (int i = 0; i < sys->workerCount; i++) {
+            scratchClean &= sys->workers[i].scratch.end == sys->workers[i].scratch.start;
+        }
+        snz_testPrint(SDL_AtomicGet(&sum) == 10000 && scratchClean, "flat jobs all run once");
+    }
+
+    {
+        SDL_atomic_t sum = { 0 };
+        SDL_atomic_t counter = { 0 };
+        _job_TestSplit root = { .sum = &sum, .depth = 12 };
+        job_push(caller, _job_testSplit, &root, &counter);
+        job_wait(caller, &counter);
+        snz_testPrint(SDL_AtomicGet(&sum) == (1 << 12), "nested jobs waiting on jobs");
+    }
+
+    {
+        SDL_atomic_t sum = { 0 };
+        SDL_atomic_t counter = { 0 };
+        for (int i = 0; i < 20; i++) {
+            job_push(caller, _job_testBigScratch, &sum, &counter);
+        }
+        job_wait(caller, &counter);
+        bool scratchBack = true;
+        for (int i = 0; i < sys->workerCount; i++) {
+            snz_Arena* scratch = &sys->workers[i].scratch;
+            scratchBack &= scratch->end == scratch->start && _snz_arenaBlockHeader(scratch->start)->prevBlock == NULL;
+            scratchBack &= scratch->reserved == 1000000;
+        }
+        snz_testPrint(SDL_AtomicGet(&sum) == 20 && scratchBack, "jobs can outgrow scratch, and it shrinks back after");
+    }
+
+    job_systemDeinit(sys);
+}
@@ -8,16 +8,20 @@
 #include "sketchTriangulation.h"
 #include "sketchui.h"
 #include "snooze.h"
+#include "solvecache.h"
 #include "sound.h"
 #include "stb/stb_image.h"
 #include "timeline.h"
 #include "timelineui.h"
+#include "timelineundo.h"
 #include "ui.h"
 #include "mesh.h"
+#include "meshio.h"
 #include "meshui.h"
 #include "geometry.h"
 #include "ser.h"
 #include "csg2.h"
+#include "jobs.h"
 
 snz_Arena main_appLifetimeArena;
 snz_Arena main_fontArena;
@@ -27,8 +31,12 @@ snz_Arena main_sketchArena;
 
 tl_Timeline main_timeline;
 snz_Arena main_tlArena;
-PoolAlloc main_tlGeneratedPool;
-snz_Arena main_tlGeneratedArena;
+tl_Journal main_timelineJournal;
+float main_timeSinceAutosave;
+job_System* main_jobs;
+scache_Cache main_solveCache;
+tlu_History main_undo;
+bool main_undoPending; // some input happened that could have edited the timeline, gets committed once it's over
 mesh_Scene main_timelineScene;
 
 snzu_Instance main_uiInstance;
@@ -41,10 +49,16 @@ tl_Op* main_argBarFocusOverride = NULL;
 set_Settings main_settings;
 
 #define MAIN_SETTINGS_PATH "settings.adder"
+#define MAIN_TIMELINE_PATH "timeline.adder"
+#define MAIN_AUTOSAVE_INTERVAL 1.0f // seconds, each one only writes what changed, see tl_journalAppend
+#define MAIN_UNDO_BUDGET_BYTES 100000000
+#define MAIN_SOLVE_CACHE_PATH "solvecache"
+#define MAIN_SOLVE_CACHE_MAX_BYTES 2000000000
 
 void main_init(snz_Arena* scratch, SDL_Window* window) {
     SNZ_ASSERT(window || !window, "huh"); //  getting rid of unused arg warning
 
+    snz_arenaTests();
     _poolAllocTests();
     sk_tests();
     fflush(_snz_logFile);
@@ -52,8 +66,24 @@ void main_init(snz_Arena* scratch, SDL_Window* window) {
     fflush(_snz_logFile);
     ser_tests();
     fflush(_snz_logFile);
+    mesh_tests();
+    fflush(_snz_logFile);
+    scache_tests();
+    fflush(_snz_logFile);
     csg_tests();
     fflush(_snz_logFile);
+    bp_tests();
+    fflush(_snz_logFile);
+    meshio_tests();
+    fflush(_snz_logFile);
+    job_tests();
+    fflush(_snz_logFile);
+    tl_tests();
+    fflush(_snz_logFile);
+    tlu_tests();
+    fflush(_snz_logFile);
+    sku_tests();
+    fflush(_snz_logFile);
 
     main_appLifetimeArena = snz_arenaInit(100000, "main app lifetime arena");
     main_fontArena = snz_arenaInit(10000000, "main font arena");
@@ -61,9 +91,7 @@ void main_init(snz_Arena* scratch, SDL_Window* window) {
     main_baseMeshArena = snz_arenaInit(1000000000, "main base mesh arena");
     main_baseMeshPool = poolAllocInit();
 
-    main_tlArena = snz_arenaInit(10000000, "main tl arena");
-    main_tlGeneratedArena = snz_arenaInit(1000000000, "main tl gen arena");
-    main_tlGeneratedPool = poolAllocInit();
+    main_tlArena = snz_arenaInitGrowable(10000000, "main tl arena");
 
     main_uiInstance = snzu_instanceInit();
     snzu_instanceSelect(&main_uiInstance);
@@ -79,6 +107,7 @@ void main_init(snz_Arena* scratch, SDL_Window* window) {
     {
         ser_begin(&main_appLifetimeArena);
         set_settingsSpec();
+        tl_timelineSpec(&main_appLifetimeArena);
         ser_end();
 
         FILE* f = fopen(MAIN_SETTINGS_PATH, "r");
@@ -99,8 +128,14 @@ void main_init(snz_Arena* scratch, SDL_Window* window) {
 
     main_sceneFB = snzr_frameBufferInit(snzr_textureInitRBGA(500, 500, NULL));
 
-    main_timeline = tl_timelineInit(&main_tlArena, &main_tlGeneratedArena, &main_tlGeneratedPool);
-    {
+    // worker scratch is growable, this is just what each one starts with
+    main_jobs = job_systemInit(SNZ_MIN(SDL_GetCPUCount() - 1, JOB_MAX_WORKERS - 1), 16000000);
+    ser_ReadError timelineErr = tl_journalOpen(&main_timelineJournal, MAIN_TIMELINE_PATH, &main_tlArena, &main_timeline);
+    if (timelineErr != SER_RE_OK) {
+        if (timelineErr != SER_RE_READ_FAILED) {
+            SNZ_LOGF("Loading timeline file failed, starting from the demo one. Code: %d.", timelineErr);
+        }
+        main_timeline = tl_timelineInit(&main_tlArena);
         mesh_FaceSlice faces = mesh_stlFileToFaces("res/demos/bracket.stl", &main_baseMeshArena, scratch, &main_baseMeshPool);
         tl_timelinePushBaseGeometry(&main_timeline, HMM_V2(0, -200), faces);
 
@@ -114,7 +149,15 @@ void main_init(snz_Arena* scratch, SDL_Window* window) {
 
         faces = mesh_cube(&main_baseMeshArena);
         tl_timelinePushBaseGeometry(&main_timeline, HMM_V2(0, 0), faces);
+
+        snz_arenaClear(scratch);
+        tl_journalCreate(&main_timelineJournal, MAIN_TIMELINE_PATH, &main_timeline);
     }
+    main_timeline.jobs = main_jobs;
+    scache_init(&main_solveCache, MAIN_SOLVE_CACHE_PATH, MAIN_SOLVE_CACHE_MAX_BYTES);
+    main_timeline.solveCache = &main_solveCache;
+    main_undo = tlu_historyInit(MAIN_UNDO_BUDGET_BYTES);
+    tlu_commit(&main_undo, &main_timeline, scratch);
 }
 
 // returns the normal of the ray starting at cameraPos
@@ -131,7 +174,7 @@ HMM_Vec3 main_rayFromCamera(float fov, HMM_Mat4 cameraTransform, HMM_Vec2 mouseP
     return HMM_Norm(v);
 }
 
-void main_drawTimelineMeshPreview(float dt, HMM_Vec2 panelSize, const ren3d_Mesh* mesh) {
+void main_drawTimelineMeshPreview(float dt, HMM_Vec2 panelSize, const mesh_Scene* scene) {
     HMM_Mat4 model = HMM_M4D(1.0f);
 
     HMM_Mat4 view = HMM_M4D(1.0f);
@@ -163,7 +206,8 @@ void main_drawTimelineMeshPreview(float dt, HMM_Vec2 panelSize, const ren3d_Mesh
         ren3d_drawSkybox(vp, *ui_skyBox);
     }
 
-    ren3d_drawMesh(mesh, vp, model, HMM_V4(1, 1, 1, 1), HMM_V3(-1, -1, -1), ui_lightAmbient);
+    // preview sits behind the timeline and is never looked at closely, so always the coarsest LOD
+    mesh_sceneDrawLod(scene, MESH_LOD_COUNT - 1, vp, model, HMM_V3(-1, -1, -1), ui_lightAmbient);
 
     // put a transparent thing over the preview to aid contrast
     snzr_drawRect(
@@ -293,16 +337,43 @@ void main_frame(float dt, snz_Arena* scratch, snzu_Input inputs, HMM_Vec2 screen
         tl_Op* op = main_timeline.activeOp;
         if (op->kind == TL_OPK_SKETCH) {
             sk_Sketch* sketch = &op->val.sketch;
-            sk_sketchClearElementsMarkedForDelete(sketch);
-            sk_sketchSolve(sketch);
+            // frames where nothing got edited (orbiting, hovering, idling) don't solve at all
+            if (sk_sketchChangedSinceSolve(sketch)) {
+                sk_sketchClearElementsMarkedForDelete(sketch);
+                sk_sketchSolve(sketch, scratch);
+            }
         }
     }
 
     if (main_argBarFocusOverride && main_argBarFocusOverride->markedForDeletion) {
         main_argBarFocusOverride = NULL;
     }
+    main_timeline.recordSolveStats = main_settings.solveStats;
+    main_timeline.speculate.enabled = main_settings.speculativeSolve;
     tl_timelineCullOpsMarkedForDelete(&main_timeline);
 
+    // commits wait until whatever input caused the edit is done, so a drag is one undo and not one per frame
+    bool mouseDown = false;
+    for (int i = 0; i < SNZU_MB_COUNT; i++) {
+        mouseDown |= inputs.mouseStates[i];
+    }
+    if (main_undoPending && !mouseDown) {
+        main_undoPending = false;
+        tlu_commit(&main_undo, &main_timeline, scratch);
+    }
+    main_undoPending |= mouseDown || inputs.keyAction != SNZU_ACT_NONE || inputs.charsEntered[0];
+
+    main_timeSinceAutosave += dt;
+    if (main_timeSinceAutosave > MAIN_AUTOSAVE_INTERVAL) {
+        main_timeSinceAutosave = 0;
+        tl_journalAppend(&main_timelineJournal, &main_timeline, false);
+    }
+    tl_timelineCheckDependencies(&main_timeline, scratch);
+    tl_solvePoll(&main_timeline, &main_timelineScene);
+    // hover state is from the last frame, and stale when the timeline isn't up
+    tl_Op* hovered = main_currentView == SC_VIEW_TIMELINE ? tl_timelineHoveredOp(&main_timeline) : NULL;
+    tl_solveSpeculate(&main_timeline, hovered, dt);
+
     if (main_settings.darkMode) {
         ui_setThemeDark();
     } else {
@@ -398,7 +469,7 @@ void main_frame(float dt, snz_Arena* scratch, snzu_Input inputs, HMM_Vec2 screen
                     }
                 } else if (main_currentView == SC_VIEW_TIMELINE) {
                     if (main_timeline.activeOp) {
-                        main_drawTimelineMeshPreview(dt, HMM_V2(w, h), &main_timelineScene.renderMesh);
+                        main_drawTimelineMeshPreview(dt, HMM_V2(w, h), &main_timelineScene);
                     }
                     HMM_Mat4 vp = { 0 };
                     snzu_Input inputCopy = inputs;
@@ -541,6 +612,7 @@ void main_frame(float dt, snz_Arena* scratch, snzu_Input inputs, HMM_Vec2 screen
             &main_currentGeoFilter,
             &main_timelineScene,
             &main_argBarFocusOverride,
+            &main_undo,
             scratch,
             openHintWindow);
 
@@ -562,17 +634,39 @@ void main_frame(float dt, snz_Arena* scratch, snzu_Input inputs, HMM_Vec2 screen
                 snzu_boxSetSizeFromEndAx(SNZU_AX_Y, ui_borderThickness);
             }
         }
+
+        if (activeSketch && main_settings.solveStats) {
+            sk_SolveStats* stats = &activeSketch->solveStats;
+            snzu_boxNew("sketchSolveStats");
+            snzu_boxSetDisplayStr(&ui_lightLabelFont, stats->violatedCount ? ui_colorErr : ui_colorText,
+                                  snz_arenaFormatStr(scratch, "%" PRId64 " dof, %" PRId64 " iters (%s), max residual %.6f, %" PRId64 " violated | last frame: %d solves, %d triangulations",
+                                                     stats->dof, stats->iterations, stats->coldStart ? "cold" : "warm",
+                                                     stats->maxResidual, stats->violatedCount,
+                                                     prof_lastFrameCounts[PROF_CK_SKETCH_SOLVES],
+                                                     prof_lastFrameCounts[PROF_CK_SKETCH_TRIANGULATIONS]));
+            snzu_boxSetSizeFitText(ui_padding);
+            snzu_boxAlignInParent(SNZU_AX_X, SNZU_ALIGN_CENTER);
+            snzu_boxAlignInParent(SNZU_AX_Y, SNZU_ALIGN_TOP);
+        }
     }
 
     snzr_callGLFnOrError(glBindFramebuffer(GL_FRAMEBUFFER, 0));
     snzr_callGLFnOrError(glViewport(0, 0, screenSize.X, screenSize.Y));
     HMM_Mat4 vp = HMM_Orthographic_RH_NO(0, screenSize.X, screenSize.Y, 0, 0, 1000000);
     snzu_frameDrawAndGenInteractions(inputs, vp);
+
+    prof_countersFrameEnd();
 }
 
 int main() {
     snz_main("ADDER V0.0", "res/textures/icon.bmp", main_init, main_frame);
     sound_deinit();
+    tl_solveCancel(&main_timeline);  // solve thread could still be running jobs
+    job_systemDeinit(main_jobs);
+    scache_deinit(&main_solveCache);
+
+    tl_journalAppend(&main_timelineJournal, &main_timeline, true);
+    tl_journalClose(&main_timelineJournal);
     poolAllocDeinit(&main_baseMeshPool);
 
     // saving settings to file
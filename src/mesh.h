@@ -2,6 +2,7 @@
 
 #include <inttypes.h>
 #include <stdio.h>
+#include <time.h>
 
 #include "HMM/HandmadeMath.h"
 #include "PoolAlloc.h"
@@ -9,6 +10,15 @@
 #include "snooze.h"
 #include "ui.h"
 #include "geometry.h"
+#include "broadphase.h"
+
+// set by the timelines solve thread while it runs. When whatever it points at goes nonzero, the long loops in here and
+// in csg bail early and hand back partial/empty results, which the caller is expected to throw out.
+SDL_atomic_t* mesh_cancelToken = NULL;
+
+bool mesh_cancelRequested() {
+    return mesh_cancelToken && SDL_AtomicGet(mesh_cancelToken);
+}
 
 typedef enum {
     MESH_GK_DOES_NOT_EXIST,
@@ -43,15 +53,15 @@ typedef struct {
 
 SNZ_SLICE(mesh_Face);
 
-ren3d_Mesh mesh_facesToRenderMesh(const mesh_FaceSlice* faces, snz_Arena* scratch) {
-    SNZ_ARENA_ARR_BEGIN(scratch, ren3d_Vert);
+static ren3d_VertSlice _mesh_facesToVerts(const mesh_FaceSlice* faces, snz_Arena* arena) {
+    SNZ_ARENA_ARR_BEGIN(arena, ren3d_Vert);
     for (int64_t faceIdx = 0; faceIdx < faces->count; faceIdx++) {
         mesh_Face f = faces->elems[faceIdx];
         for (int64_t triIdx = 0; triIdx < f.tris.count; triIdx++) {
             geo_Tri tri = f.tris.elems[triIdx];
             HMM_Vec3 normal = geo_triNormal(tri);
             for (int i = 0; i < 3; i++) {
-                *SNZ_ARENA_PUSH(scratch, ren3d_Vert) = (ren3d_Vert){
+                *SNZ_ARENA_PUSH(arena, ren3d_Vert) = (ren3d_Vert){
                     .pos = tri.elems[i],
                     .normal = normal,
                     .color = HMM_V4(1, 1, 1, 1),
@@ -59,10 +69,170 @@ ren3d_Mesh mesh_facesToRenderMesh(const mesh_FaceSlice* faces, snz_Arena* scratc
             } // vert loop
         } // tris loop
     } // face loop
-    ren3d_VertSlice s = SNZ_ARENA_ARR_END(scratch, ren3d_Vert);
+    return SNZ_ARENA_ARR_END(arena, ren3d_Vert);
+}
+
+ren3d_Mesh mesh_facesToRenderMesh(const mesh_FaceSlice* faces, snz_Arena* scratch) {
+    ren3d_VertSlice s = _mesh_facesToVerts(faces, scratch);
     return ren3d_meshInit(s.elems, s.count);
 }
 
+// LOD 0 is always full detail, every level after is coarser
+#define MESH_LOD_COUNT 3
+
+// how many clustering cells fit across the bounding sphere of a mesh for each LOD, 0 means don't simplify
+static const int64_t _mesh_lodCellCounts[MESH_LOD_COUNT] = { 0, 48, 12 };
+// smallest projected diameter (in px) of a mesh's bounding sphere that each LOD is drawn at
+static const float _mesh_lodMinPixelSizes[MESH_LOD_COUNT] = { 300, 60, 0 };
+
+// sphere is fit around the AABB of all tris, not tight but good enough for picking LODs
+void mesh_facesBoundingSphere(const mesh_FaceSlice* faces, HMM_Vec3* outCenter, float* outRadius) {
+    geo_AABB box = geo_aabbEmpty();
+    for (int64_t faceIdx = 0; faceIdx < faces->count; faceIdx++) {
+        geo_TriSlice tris = faces->elems[faceIdx].tris;
+        for (int64_t triIdx = 0; triIdx < tris.count; triIdx++) {
+            for (int i = 0; i < 3; i++) {
+                geo_aabbAddPt(&box, tris.elems[triIdx].elems[i]);
+            }
+        }
+    }
+
+    if (isinf(box.min.X)) {  // no tris
+        *outCenter = HMM_V3(0, 0, 0);
+        *outRadius = 0;
+        return;
+    }
+    *outCenter = HMM_DivV3F(HMM_Add(box.min, box.max), 2);
+    *outRadius = HMM_Len(HMM_Sub(box.max, box.min)) / 2;
+}
+
+typedef struct {
+    bool occupied;
+    int64_t cell[3];
+    HMM_Vec3 sum;
+    int64_t count;
+} _mesh_LODCluster;
+
+// open addressing, linear probe. capacity must be a power of 2 and larger than the total number of cells ever looked up.
+static _mesh_LODCluster* _mesh_lodClusterGet(_mesh_LODCluster* clusters, int64_t capacity, HMM_Vec3 pt, float cellSize) {
+    int64_t cell[3] = { 0 };
+    uint64_t hash = 14695981039346656037ULL;
+    for (int ax = 0; ax < 3; ax++) {
+        cell[ax] = (int64_t)floorf(pt.Elements[ax] / cellSize);
+        hash = (hash ^ (uint64_t)cell[ax]) * 1099511628211ULL;
+    }
+    hash = snz_hashMix64(hash);
+    uint64_t idx = hash & (capacity - 1);
+    while (true) {
+        _mesh_LODCluster* c = &clusters[idx];
+        if (!c->occupied) {
+            c->occupied = true;
+            memcpy(c->cell, cell, sizeof(cell));
+            return c;
+        } else if (!memcmp(c->cell, cell, sizeof(cell))) {
+            return c;
+        }
+        idx = (idx + 1) & (capacity - 1);
+    }
+}
+
+// vertex clustering simplification, every point gets snapped to the average of all points sharing its grid cell
+// and tris that collapse are dropped. Face boundaries aren't respected, so this is only for drawing.
+// returned verts are allocated in arena, clusters in scratch
+static ren3d_VertSlice _mesh_facesToClusteredVerts(const mesh_FaceSlice* faces, float cellSize, snz_Arena* arena, snz_Arena* scratch) {
+    int64_t triCount = 0;
+    for (int64_t i = 0; i < faces->count; i++) {
+        triCount += faces->elems[i].tris.count;
+    }
+
+    int64_t capacity = 16;
+    while (capacity < triCount * 3 * 2) {
+        capacity *= 2;
+    }
+    _mesh_LODCluster* clusters = SNZ_ARENA_PUSH_ARR(scratch, capacity, _mesh_LODCluster);
+
+    for (int64_t faceIdx = 0; faceIdx < faces->count; faceIdx++) {
+        mesh_Face* f = &faces->elems[faceIdx];
+        for (int64_t triIdx = 0; triIdx < f->tris.count; triIdx++) {
+            for (int i = 0; i < 3; i++) {
+                HMM_Vec3 pt = f->tris.elems[triIdx].elems[i];
+                _mesh_LODCluster* c = _mesh_lodClusterGet(clusters, capacity, pt, cellSize);
+                c->sum = HMM_Add(c->sum, pt);
+                c->count++;
+            }
+        }
+    }
+
+    SNZ_ARENA_ARR_BEGIN(arena, ren3d_Vert);
+    for (int64_t faceIdx = 0; faceIdx < faces->count; faceIdx++) {
+        mesh_Face* f = &faces->elems[faceIdx];
+        for (int64_t triIdx = 0; triIdx < f->tris.count; triIdx++) {
+            geo_Tri tri = f->tris.elems[triIdx];
+            _mesh_LODCluster* cs[3] = { 0 };
+            for (int i = 0; i < 3; i++) {
+                cs[i] = _mesh_lodClusterGet(clusters, capacity, tri.elems[i], cellSize);
+                tri.elems[i] = HMM_DivV3F(cs[i]->sum, (float)cs[i]->count);
+            }
+
+            if (cs[0] == cs[1] || cs[1] == cs[2] || cs[0] == cs[2]) {
+                continue;
+            } else if (geo_floatZero(geo_triArea(tri))) {
+                continue;
+            }
+
+            HMM_Vec3 normal = geo_triNormal(tri);
+            for (int i = 0; i < 3; i++) {
+                *SNZ_ARENA_PUSH(arena, ren3d_Vert) = (ren3d_Vert){
+                    .pos = tri.elems[i],
+                    .normal = normal,
+                    .color = HMM_V4(1, 1, 1, 1),
+                };
+            }
+        }
+    }
+    return SNZ_ARENA_ARR_END(arena, ren3d_Vert);
+}
+
+// fills outLods with MESH_LOD_COUNT meshes, index 0 being full detail
+// boundingRadius should come from mesh_facesBoundingSphere
+// no GL in here, so this is fine to call off of the main thread
+void mesh_facesToLodVerts(const mesh_FaceSlice* faces, float boundingRadius, ren3d_VertSlice* outLods, snz_Arena* arena, snz_Arena* scratch) {
+    outLods[0] = _mesh_facesToVerts(faces, arena);
+    for (int lod = 1; lod < MESH_LOD_COUNT; lod++) {
+        if (geo_floatZero(boundingRadius)) {
+            outLods[lod] = outLods[0];
+            continue;
+        }
+        float cellSize = (boundingRadius * 2) / _mesh_lodCellCounts[lod];
+        outLods[lod] = _mesh_facesToClusteredVerts(faces, cellSize, arena, scratch);
+    }
+}
+
+void mesh_facesToRenderMeshLods(const mesh_FaceSlice* faces, float boundingRadius, ren3d_Mesh* outLods, snz_Arena* scratch) {
+    ren3d_VertSlice verts[MESH_LOD_COUNT] = { 0 };
+    mesh_facesToLodVerts(faces, boundingRadius, verts, scratch, scratch);
+    for (int lod = 0; lod < MESH_LOD_COUNT; lod++) {
+        outLods[lod] = ren3d_meshInit(verts[lod].elems, verts[lod].count);
+    }
+}
+
+// picks the coarsest LOD that still looks right given how large the mesh's bounding sphere is on screen
+// fov is vertical, in radians, panelHeight in px
+int mesh_lodForProjectedSize(float boundingRadius, float distToCamera, float fov, float panelHeight) {
+    float pxSize = INFINITY;
+    if (distToCamera > boundingRadius) {
+        float angularSize = 2 * asinf(boundingRadius / distToCamera);
+        pxSize = (angularSize / fov) * panelHeight;
+    }
+
+    for (int lod = MESH_LOD_COUNT - 1; lod > 0; lod--) {
+        if (pxSize < _mesh_lodMinPixelSizes[lod - 1]) {
+            return lod;
+        }
+    }
+    return 0;
+}
+
 mesh_FaceSlice mesh_facesDuplicate(mesh_FaceSlice faces, snz_Arena* arena) {
     SNZ_ARENA_ARR_BEGIN(arena, geo_Tri);
     for (int64_t faceIdx = 0; faceIdx < faces.count; faceIdx++) {
@@ -92,7 +262,7 @@ mesh_FaceSlice mesh_facesDuplicate(mesh_FaceSlice faces, snz_Arena* arena) {
 
 void mesh_faceAssertValid(const mesh_Face* face) {
     SNZ_ASSERT(face->id.geoKind == MESH_GK_FACE, "Face has a geoid that isn't a face.");
-    SNZ_ASSERTF(face->tris.count > 0, "Face with %lld tris", face->tris.count);
+    SNZ_ASSERTF(face->tris.count > 0, "Face with %" PRId64 " tris", face->tris.count);
     for (int64_t i = 0; i < face->tris.count; i++) {
         geo_Tri t = face->tris.elems[i];
         SNZ_ASSERT(!geo_floatZero(geo_triArea(t)), "Zero area triangle.");
@@ -107,7 +277,7 @@ void mesh_facesAssertValid(const mesh_FaceSlice* faces) {
 }
 
 bool mesh_faceFlat(const mesh_Face* f) {
-    SNZ_ASSERTF(f->tris.count > 0, "face with %lld tris.", f->tris.count);
+    SNZ_ASSERTF(f->tris.count > 0, "face with %" PRId64 " tris.", f->tris.count);
     HMM_Vec3 normal = geo_triNormal(f->tris.elems[0]);
     for (int64_t i = 1; i < f->tris.count; i++) {
         geo_Tri t = f->tris.elems[i];
@@ -140,7 +310,7 @@ void mesh_facesTransform(mesh_FaceSlice faces, HMM_Mat4 transform) {
         for (int64_t triIdx = 0; triIdx < f->tris.count; triIdx++) {
             geo_Tri* tri = &f->tris.elems[triIdx];
             for (int i = 0; i < 3; i++) {
-                HMM_Vec4 tmp = HMM_V4(0, 0, 0, 0);
+                HMM_Vec4 tmp = HMM_V4(0, 0, 0, 1);  // w of 1 so translations go thru too
                 tmp.XYZ = tri->elems[i];
                 tri->elems[i] = HMM_Mul(transform, tmp).XYZ;
             } // verts
@@ -196,6 +366,7 @@ struct mesh_Edge {
 };
 
 SNZ_SLICE(mesh_Edge);
+SNZ_SLICE_NAMED(mesh_Edge*, mesh_EdgePtrSlice);
 
 typedef struct mesh_Corner mesh_Corner;
 struct mesh_Corner {
@@ -419,30 +590,40 @@ static HMM_Vec3Slice _mesh_orderedPointsFromLineSet(geo_LineSlice lines, snz_Are
 // expects valid face tris on the mesh
 // no issue if out and scratch are the same arena
 // opUid to make a correct geoId on the outputted edge
-// FIXME: time complexity is horrifying
 mesh_Edge mesh_facesToEdge(const mesh_Face* faceA, const mesh_Face* faceB, int64_t opUid, snz_Arena* arena, snz_Arena* scratch) {
+    bp_PairSlice triPairs = { 0 };
+    { // only tris that touch can share a segment
+        geo_AABBSlice boxesA = { .count = faceA->tris.count, .elems = SNZ_ARENA_PUSH_ARR(scratch, faceA->tris.count, geo_AABB) };
+        geo_AABBSlice boxesB = { .count = faceB->tris.count, .elems = SNZ_ARENA_PUSH_ARR(scratch, faceB->tris.count, geo_AABB) };
+        for (int64_t i = 0; i < boxesA.count; i++) {
+            boxesA.elems[i] = geo_aabbFromTri(faceA->tris.elems[i]);
+        }
+        for (int64_t i = 0; i < boxesB.count; i++) {
+            boxesB.elems[i] = geo_aabbFromTri(faceB->tris.elems[i]);
+        }
+        triPairs = bp_sweepAndPruneBetween(boxesA, boxesB, geo_EPSILON, scratch, scratch);
+    }
+
     SNZ_ARENA_ARR_BEGIN(scratch, _mesh_LinePair);
-    for (int aIdx = 0; aIdx < faceA->tris.count; aIdx++) {
-        for (int bIdx = 0; bIdx < faceB->tris.count; bIdx++) {
-            geo_Tri aTri = faceA->tris.elems[aIdx];
-            geo_Tri bTri = faceB->tris.elems[bIdx];
+    for (int64_t pairIdx = 0; pairIdx < triPairs.count; pairIdx++) {
+        geo_Tri aTri = faceA->tris.elems[triPairs.elems[pairIdx].a];
+        geo_Tri bTri = faceB->tris.elems[triPairs.elems[pairIdx].b];
 
-            for (int i = 0; i < 3; i++) {
-                for (int j = 0; j < 3; j++) {
-                    _mesh_LinePair pair = (_mesh_LinePair){
-                        .a = (geo_Line) {
-                            .a = aTri.elems[i],
-                            .b = aTri.elems[(i + 1) % 3],
-                        },
-                        .b = (geo_Line) {
-                            .a = bTri.elems[j],
-                            .b = bTri.elems[(j + 1) % 3],
-                        },
-                    };
-                    *SNZ_ARENA_PUSH(scratch, _mesh_LinePair) = pair;
-                } // end 2nd tri edge loop
-            } // end 1st tri edge loop
-        }
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                _mesh_LinePair pair = (_mesh_LinePair){
+                    .a = (geo_Line) {
+                        .a = aTri.elems[i],
+                        .b = aTri.elems[(i + 1) % 3],
+                    },
+                    .b = (geo_Line) {
+                        .a = bTri.elems[j],
+                        .b = bTri.elems[(j + 1) % 3],
+                    },
+                };
+                *SNZ_ARENA_PUSH(scratch, _mesh_LinePair) = pair;
+            } // end 2nd tri edge loop
+        } // end 1st tri edge loop
     }
     _mesh_LinePairSlice pairs = SNZ_ARENA_ARR_END(scratch, _mesh_LinePair);
 
@@ -493,113 +674,348 @@ mesh_EdgeSlice mesh_tempGeoFindAllAdjacentEdges(const mesh_TempGeo* tempGeo, con
     return SNZ_ARENA_ARR_END(arena, mesh_Edge);
 }
 
-// given a set of edges, this figures out which need to flip so that they all point clockwise around the face
+// one entry per distinct point (anything within geo_EPSILON is the same point), each with a list of the segments
+// that end there. Entries are filed under the cell of their position, so finding a point is a probe in the few cells
+// within geo_EPSILON of it, no matter how long the segments touching it are.
+// used for the tri corners of a face and for the ends of the edges being flipped, see mesh_edgesGetFlipsToMatchFace
+typedef struct _mesh_VertLink _mesh_VertLink;
+struct _mesh_VertLink {
+    _mesh_VertLink* next;
+    HMM_Vec3 other; // far end of the segment
+    int64_t idx; // whatever the caller filed the segment with
+};
+
+typedef struct {
+    bool occupied;
+    int64_t cell[3];
+    HMM_Vec3 pos;
+    _mesh_VertLink* firstLink;
+    int64_t linkCount;
+} _mesh_VertEntry;
+
+typedef struct {
+    _mesh_VertEntry* entries;
+    int64_t capacity; // power of 2
+    int64_t count;
+} _mesh_VertTable;
+
+#define _MESH_VERT_CELL_SIZE (geo_EPSILON * 8)
+
+static uint64_t _mesh_cellHash(const int64_t* cell) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (int ax = 0; ax < 3; ax++) {
+        hash = (hash ^ (uint64_t)cell[ax]) * 1099511628211ULL;
+    }
+    return snz_hashMix64(hash);
+}
+
+static void _mesh_cellRange(float cellSize, HMM_Vec3 a, HMM_Vec3 b, int64_t* outMin, int64_t* outMax) {
+    for (int ax = 0; ax < 3; ax++) {
+        float min = SNZ_MIN(a.Elements[ax], b.Elements[ax]) - geo_EPSILON;
+        float max = SNZ_MAX(a.Elements[ax], b.Elements[ax]) + geo_EPSILON;
+        outMin[ax] = (int64_t)floorf(min / cellSize);
+        outMax[ax] = (int64_t)floorf(max / cellSize);
+    }
+}
+
+// maxPointCount is the most distinct points that could go in, 2 per segment is always enough
+static _mesh_VertTable _mesh_vertTableInit(int64_t maxPointCount, snz_Arena* scratch) {
+    _mesh_VertTable table = { .capacity = 16 };
+    while (table.capacity < maxPointCount * 2) {
+        table.capacity *= 2;
+    }
+    table.entries = SNZ_ARENA_PUSH_ARR(scratch, table.capacity, _mesh_VertEntry);
+    return table;
+}
+
+// NULL if nothing within geo_EPSILON of pt has been filed
+static _mesh_VertEntry* _mesh_vertTableGet(const _mesh_VertTable* table, HMM_Vec3 pt) {
+    int64_t min[3] = { 0 };
+    int64_t max[3] = { 0 };
+    _mesh_cellRange(_MESH_VERT_CELL_SIZE, pt, pt, min, max);
+    int64_t cell[3] = { 0 };
+    for (cell[0] = min[0]; cell[0] <= max[0]; cell[0]++) {
+        for (cell[1] = min[1]; cell[1] <= max[1]; cell[1]++) {
+            for (cell[2] = min[2]; cell[2] <= max[2]; cell[2]++) {
+                uint64_t slot = _mesh_cellHash(cell) & (table->capacity - 1);
+                for (; table->entries[slot].occupied; slot = (slot + 1) & (table->capacity - 1)) {
+                    _mesh_VertEntry* e = &table->entries[slot];
+                    if (!memcmp(e->cell, cell, sizeof(cell)) && geo_v3Equal(e->pos, pt)) {
+                        return e;
+                    }
+                }
+            }
+        }
+    }
+    return NULL;
+}
+
+static _mesh_VertEntry* _mesh_vertTableGetOrInsert(_mesh_VertTable* table, HMM_Vec3 pt) {
+    _mesh_VertEntry* e = _mesh_vertTableGet(table, pt);
+    if (e) {
+        return e;
+    }
+    SNZ_ASSERTF(table->count * 2 < table->capacity, "Vert table over half full, %" PRId64 " of %" PRId64 ".", table->count, table->capacity);
+    int64_t cell[3] = { 0 };
+    for (int ax = 0; ax < 3; ax++) {
+        cell[ax] = (int64_t)floorf(pt.Elements[ax] / _MESH_VERT_CELL_SIZE);
+    }
+    uint64_t slot = _mesh_cellHash(cell) & (table->capacity - 1);
+    while (table->entries[slot].occupied) {
+        slot = (slot + 1) & (table->capacity - 1);
+    }
+    e = &table->entries[slot];
+    *e = (_mesh_VertEntry){
+        .occupied = true,
+        .cell = { cell[0], cell[1], cell[2] },
+        .pos = pt,
+    };
+    table->count++;
+    return e;
+}
+
+static void _mesh_vertTableLink(_mesh_VertTable* table, HMM_Vec3 at, HMM_Vec3 other, int64_t idx, snz_Arena* scratch) {
+    _mesh_VertEntry* e = _mesh_vertTableGetOrInsert(table, at);
+    _mesh_VertLink* link = SNZ_ARENA_PUSH(scratch, _mesh_VertLink);
+    *link = (_mesh_VertLink){
+        .next = e->firstLink,
+        .other = other,
+        .idx = idx,
+    };
+    e->firstLink = link;
+    e->linkCount++;
+}
+
+// every tri edge of f, filed under both of its corners. idx is 0 on the corner the edge starts at, 1 on the one it ends at
+static _mesh_VertTable _mesh_faceEdgeTableInit(const mesh_Face* f, snz_Arena* scratch) {
+    _mesh_VertTable table = _mesh_vertTableInit(f->tris.count * 3, scratch);
+    for (int64_t triIdx = 0; triIdx < f->tris.count; triIdx++) {
+        geo_Tri t = f->tris.elems[triIdx];
+        for (int i = 0; i < 3; i++) {
+            HMM_Vec3 a = t.elems[i];
+            HMM_Vec3 b = t.elems[(i + 1) % 3];
+            if (!geo_v3Equal(a, b)) {
+                _mesh_vertTableLink(&table, a, b, 0, scratch);
+                _mesh_vertTableLink(&table, b, a, 1, scratch);
+            }
+        }
+    }
+    return table;
+}
+
+// finds the tri edge at pt heading towards dir (normalized), false if there isn't one
+// incoming is set if the tri edge ends at pt instead of starting there
+static bool _mesh_faceEdgeTableFind(const _mesh_VertTable* table, HMM_Vec3 pt, HMM_Vec3 dir, bool* outIncoming) {
+    const _mesh_VertEntry* e = _mesh_vertTableGet(table, pt);
+    if (!e) {
+        return false;
+    }
+
+    float bestDot = 1 - geo_EPSILON;
+    bool found = false;
+    for (const _mesh_VertLink* link = e->firstLink; link; link = link->next) {
+        float dot = HMM_Dot(HMM_Norm(HMM_Sub(link->other, e->pos)), dir);
+        if (dot > bestDot) {
+            bestDot = dot;
+            *outIncoming = link->idx;
+            found = true;
+        }
+    }
+    return found;
+}
+
+// whether a tri edge runs from -> to, checked from whichever end has less filed at it so that the hub of a fan
+// doesn't get walked for every spoke
+static bool _mesh_faceEdgeTableHasEdge(const _mesh_VertTable* table, HMM_Vec3 from, HMM_Vec3 to) {
+    const _mesh_VertEntry* fromEntry = _mesh_vertTableGet(table, from);
+    const _mesh_VertEntry* toEntry = _mesh_vertTableGet(table, to);
+    if (!fromEntry || !toEntry) {
+        return false;
+    }
+    bool fromSide = fromEntry->linkCount <= toEntry->linkCount;
+    const _mesh_VertEntry* e = fromSide ? fromEntry : toEntry;
+    HMM_Vec3 other = fromSide ? to : from;
+    for (const _mesh_VertLink* link = e->firstLink; link; link = link->next) {
+        if (link->idx == !fromSide && geo_v3Equal(link->other, other)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// tri edges of f that no other tri runs back along, ie. the ones on the boundary. The only ones a segment that
+// starts and ends in the middle of a tri edge (a T junction) can be sitting on. Pushed as pairs of points.
+static HMM_Vec3Slice _mesh_faceBoundaryEdges(const mesh_Face* f, const _mesh_VertTable* table, snz_Arena* scratch) {
+    SNZ_ARENA_ARR_BEGIN(scratch, HMM_Vec3);
+    for (int64_t triIdx = 0; triIdx < f->tris.count; triIdx++) {
+        geo_Tri t = f->tris.elems[triIdx];
+        for (int i = 0; i < 3; i++) {
+            HMM_Vec3 a = t.elems[i];
+            HMM_Vec3 b = t.elems[(i + 1) % 3];
+            if (!geo_v3Equal(a, b) && !_mesh_faceEdgeTableHasEdge(table, b, a)) {
+                *SNZ_ARENA_PUSH(scratch, HMM_Vec3) = a;
+                *SNZ_ARENA_PUSH(scratch, HMM_Vec3) = b;
+            }
+        }
+    }
+    return SNZ_ARENA_ARR_END(scratch, HMM_Vec3);
+}
+
+// for segments that don't start or end on any tri corner, finds the boundary edge that has the segment on it
+// FIXME: a scan of the whole boundary, fine as long as edges that are all T junction stay rare
+static bool _mesh_faceEdgeFindContaining(const HMM_Vec3Slice* boundaryEdges, HMM_Vec3 a, HMM_Vec3 b, bool* outFlip) {
+    HMM_Vec3 mid = HMM_DivV3F(HMM_Add(a, b), 2);
+    HMM_Vec3 dir = HMM_Norm(HMM_Sub(b, a));
+    for (int64_t i = 0; i < boundaryEdges->count; i += 2) {
+        HMM_Vec3 triA = boundaryEdges->elems[i];
+        HMM_Vec3 triEdge = HMM_Sub(boundaryEdges->elems[i + 1], triA);
+        float len = HMM_Len(triEdge);
+        if (geo_floatZero(len)) {
+            continue;
+        }
+        float dot = HMM_Dot(HMM_DivV3F(triEdge, len), dir);
+        if (fabsf(dot) < 1 - geo_EPSILON) {
+            continue;
+        }
+        float along = HMM_Dot(HMM_Sub(mid, triA), triEdge) / (len * len);
+        HMM_Vec3 closest = HMM_Add(triA, HMM_Mul(triEdge, along));
+        if (along < 0 || along > 1 || !geo_v3Equal(closest, mid)) {
+            continue;
+        }
+        *outFlip = dot < 0;
+        return true;
+    }
+    return false;
+}
+
+static int64_t _mesh_loopRoot(int64_t* parents, int64_t idx) {
+    while (parents[idx] != idx) {
+        parents[idx] = parents[parents[idx]];
+        idx = parents[idx];
+    }
+    return idx;
+}
+
+// given a set of edges on the boundary of f, figures out which need to flip so that each closed loop of them runs
+// counter clockwise around the normal of f, holes included
+// FIXME: holes running the same way as the outside means walls extruded off of them face inward
 // useful for any operation that is creating new geometry from edges
 // return elems with a true value indicate they should be reversed to be correct
+// each edge is oriented to match the tris of f with one lookup in a table over f's tri edges, then edges are joined
+// into loops by their ends and loops that came out clockwise (holes) get turned around.
 boolSlice mesh_edgesGetFlipsToMatchFace(const mesh_Face* f, const mesh_EdgeSlice edges, snz_Arena* arena, snz_Arena* scratch) {
-    SNZ_ASSERT(mesh_faceFlat(f), "Face wasn't flat"); // FIXME: this fn should be able to handle other faces
-    SNZ_ASSERTF(f->tris.count > 0, "Face with %lld tris", f->tris.count);
-    SNZ_ASSERTF(edges.count > 0, "%lld edges", edges.count);
+    SNZ_ASSERTF(f->tris.count > 0, "Face with %" PRId64 " tris", f->tris.count);
+    SNZ_ASSERTF(edges.count > 0, "%" PRId64 " edges", edges.count);
 
     boolSlice outFlips = (boolSlice){
         .count = edges.count,
         .elems = SNZ_ARENA_PUSH_ARR(arena, edges.count, bool),
     };
+    int64_t scratchStart = snz_arenaUsedBytes(scratch);
+    _mesh_VertTable table = _mesh_faceEdgeTableInit(f, scratch);
+    HMM_Vec3Slice boundaryEdges = { 0 };
+    bool boundaryEdgesBuilt = false;
 
-    boolSlice culled = (boolSlice){
-        .count = edges.count,
-        .elems = SNZ_ARENA_PUSH_ARR(scratch, edges.count, bool),
-    };
-    while (true) { // FIXME: cutoff
-        const mesh_Edge* firstEdge = NULL;
-        for (int64_t i = 0; i < edges.count; i++) {
-            if (culled.elems[i]) {
+    for (int64_t edgeIdx = 0; edgeIdx < edges.count; edgeIdx++) {
+        const mesh_Edge* e = &edges.elems[edgeIdx];
+        SNZ_ASSERTF(e->points.count > 1, "Edge with %" PRId64 " points", e->points.count);
+
+        // usually the first segment of the edge gets it, the rest are for edges that start on a T junction
+        bool found = false;
+        for (int64_t i = 0; i < e->points.count - 1 && !found; i++) {
+            HMM_Vec3 a = e->points.elems[i];
+            HMM_Vec3 b = e->points.elems[i + 1];
+            if (geo_v3Equal(a, b)) {
                 continue;
             }
-            firstEdge = &edges.elems[i];
-            break;
+            HMM_Vec3 dir = HMM_Norm(HMM_Sub(b, a));
+            bool incoming = false;
+            if (_mesh_faceEdgeTableFind(&table, a, dir, &incoming)) {
+                outFlips.elems[edgeIdx] = incoming;  // the tri edge ending at a comes from b, so it runs b -> a
+                found = true;
+            } else if (_mesh_faceEdgeTableFind(&table, b, HMM_Mul(dir, -1.0f), &incoming)) {
+                outFlips.elems[edgeIdx] = !incoming;
+                found = true;
+            }
         }
-        if (!firstEdge) {
-            break; // no more edges to process, we can exit
+
+        if (!found && !boundaryEdgesBuilt) {
+            boundaryEdges = _mesh_faceBoundaryEdges(f, &table, scratch);
+            boundaryEdgesBuilt = true;
         }
-        SNZ_ASSERTF(firstEdge->points.count > 0, "Edge with %lld points", firstEdge->points.count);
-        SNZ_LOG("EDGE SEEDED");
-        for (int64_t i = 0; i < firstEdge->points.count; i++) {
-            HMM_Vec3 pt = firstEdge->points.elems[i];
-            SNZ_LOGF("\t%f, %f, %f", pt.X, pt.Y, pt.Z);
+        for (int64_t i = 0; i < e->points.count - 1 && !found; i++) {
+            HMM_Vec3 a = e->points.elems[i];
+            HMM_Vec3 b = e->points.elems[i + 1];
+            if (!geo_v3Equal(a, b)) {
+                found = _mesh_faceEdgeFindContaining(&boundaryEdges, a, b, &outFlips.elems[edgeIdx]);
+            }
         }
+        if (!found) {
+            SNZ_LOGF("Edge %" PRId64 " isn't on the boundary of the face, left unflipped.", edgeIdx);
+        }
+    }
 
-        // loop until we have gone around the edge loop
-        HMM_Vec3 crossProdSum = HMM_V3(0, 0, 0);
-        HMM_Vec3 pos = firstEdge->points.elems[0];
-        HMM_Vec3 startPos = pos;
-        SNZ_ARENA_ARR_BEGIN(scratch, int64_t);
-        while (true) { // FIXME: cutoff
-            bool anyFound = false;
-            for (int64_t edgeIdx = 0; edgeIdx < edges.count; edgeIdx++) {
-                if (culled.elems[edgeIdx]) {
-                    continue;
-                }
-                const mesh_Edge* newEdge = &edges.elems[edgeIdx];
-                HMM_Vec3 firstPoint = newEdge->points.elems[0];
-                HMM_Vec3 lastPoint = newEdge->points.elems[newEdge->points.count - 1];
-
-                bool startMatches = geo_v3Equal(firstPoint, pos);
-                if (!startMatches && !geo_v3Equal(lastPoint, pos)) {
-                    continue; // start and end both don't match current edge, it can't be adjacent, move on
-                }
-                culled.elems[edgeIdx] = true;
-                anyFound = true;
-                pos = (startMatches) ? lastPoint : firstPoint;
-                outFlips.elems[edgeIdx] = !startMatches; // indicate flipping if we matched with the end
-                *SNZ_ARENA_PUSH(scratch, int64_t) = edgeIdx; // record visited
-                SNZ_LOGF("Moving to: %f, %f, %f", pos.X, pos.Y, pos.Z);
+    // join edges into loops at their ends, ends are filed as idx = edgeIdx * 2 + (0 first point, 1 last point)
+    _mesh_VertTable ends = _mesh_vertTableInit(edges.count * 2, scratch);
+    for (int64_t edgeIdx = 0; edgeIdx < edges.count; edgeIdx++) {
+        HMM_Vec3Slice pts = edges.elems[edgeIdx].points;
+        HMM_Vec3 first = pts.elems[0];
+        HMM_Vec3 last = pts.elems[pts.count - 1];
+        _mesh_vertTableLink(&ends, first, last, edgeIdx * 2 + 0, scratch);
+        _mesh_vertTableLink(&ends, last, first, edgeIdx * 2 + 1, scratch);
+    }
 
-                for (int64_t i = 0; i < newEdge->points.count - 1; i++) {
-                    // flip direction if we entered the edge from the back
-                    HMM_Vec3 p1 = HMM_Sub(newEdge->points.elems[i + !startMatches], startPos);
-                    p1 = HMM_Norm(p1);
-                    HMM_Vec3 p2 = HMM_Sub(newEdge->points.elems[i + startMatches], startPos);
-                    p2 = HMM_Norm(p2);
-                    if (isnan(p1.X) || isnan(p2.X)) {
-                        SNZ_LOG("got a nan here");
-                        continue;
-                    }
-                    HMM_Vec3 cross = HMM_Cross(p1, p2);
-                    SNZ_LOGF("cross:\t\t%f, %f, %f", cross.X, cross.Y, cross.Z);
-                    crossProdSum = HMM_Add(crossProdSum, cross);
-                }
-            }
-            if (!anyFound) {
-                break;
+    int64_t* parents = SNZ_ARENA_PUSH_ARR(scratch, edges.count, int64_t);
+    bool* openEnds = SNZ_ARENA_PUSH_ARR(scratch, edges.count, bool);
+    for (int64_t edgeIdx = 0; edgeIdx < edges.count; edgeIdx++) {
+        parents[edgeIdx] = edgeIdx;
+    }
+    for (int64_t slot = 0; slot < ends.capacity; slot++) {
+        const _mesh_VertEntry* e = &ends.entries[slot];
+        if (!e->occupied) {
+            continue;
+        }
+        for (const _mesh_VertLink* link = e->firstLink; link; link = link->next) {
+            if (e->linkCount == 1) {
+                openEnds[link->idx / 2] = true;
+            } else {
+                parents[_mesh_loopRoot(parents, link->idx / 2)] = _mesh_loopRoot(parents, e->firstLink->idx / 2);
             }
         }
-        int64_tSlice visitedEdges = SNZ_ARENA_ARR_END(scratch, int64_t);
+    }
 
-        HMM_Vec3 faceNormal = geo_triNormal(f->tris.elems[0]);
-        float dot = HMM_Dot(crossProdSum, faceNormal);
-        SNZ_LOGF("Face normal: %f, %f, %f", faceNormal.X, faceNormal.Y, faceNormal.Z);
-        SNZ_LOGF("dot: %f", dot);
-        if (dot < 0) { // if new loop would have the wrong normal, invert all
-            for (int64_t visitIdx = 0; visitIdx < visitedEdges.count; visitIdx++) {
-                int64_t edgeIdx = visitedEdges.elems[visitIdx];
-                outFlips.elems[edgeIdx] = !outFlips.elems[edgeIdx];
-            }
+    // twice the area of each loop as it runs after the flips above, summed onto the root edge of the loop
+    HMM_Vec3* areas = SNZ_ARENA_PUSH_ARR(scratch, edges.count, HMM_Vec3);
+    bool* loopOpen = SNZ_ARENA_PUSH_ARR(scratch, edges.count, bool);
+    for (int64_t edgeIdx = 0; edgeIdx < edges.count; edgeIdx++) {
+        int64_t root = _mesh_loopRoot(parents, edgeIdx);
+        loopOpen[root] |= openEnds[edgeIdx];
+        HMM_Vec3 origin = edges.elems[root].points.elems[0];
+        HMM_Vec3Slice pts = edges.elems[edgeIdx].points;
+        bool flip = outFlips.elems[edgeIdx];
+        for (int64_t i = 0; i < pts.count - 1; i++) {
+            HMM_Vec3 p1 = HMM_Sub(pts.elems[i + flip], origin);
+            HMM_Vec3 p2 = HMM_Sub(pts.elems[i + !flip], origin);
+            areas[root] = HMM_Add(areas[root], HMM_Cross(p1, p2));
         }
-    } // end loop to seed new edge loops
+    }
 
-    SNZ_LOG("NEW EDGE FLIPPERS");
-    for (int64_t i = 0; i < outFlips.count; i++) {
-        SNZ_LOGF("idx: %lld,\tflipped: %d", i, outFlips.elems[i]);
+    HMM_Vec3 faceNormal = geo_triNormal(f->tris.elems[0]);
+    for (int64_t edgeIdx = 0; edgeIdx < edges.count; edgeIdx++) {
+        int64_t root = _mesh_loopRoot(parents, edgeIdx);
+        if (!loopOpen[root] && HMM_Dot(areas[root], faceNormal) < 0) {
+            outFlips.elems[edgeIdx] = !outFlips.elems[edgeIdx];
+        }
     }
 
+    snz_arenaPop(scratch, snz_arenaUsedBytes(scratch) - scratchStart);
     return outFlips;
 }
 
 // uid for correct geoId on the corner
 mesh_Corner* mesh_edgesToCorner(const mesh_Edge* a, const mesh_Edge* b, int64_t opUid, snz_Arena* arena) {
-    SNZ_ASSERTF(a->points.count > 0, "edge with only %lld points.", a->points.count);
-    SNZ_ASSERTF(b->points.count > 0, "edge with only %lld points.", b->points.count);
+    SNZ_ASSERTF(a->points.count > 0, "edge with only %" PRId64 " points.", a->points.count);
+    SNZ_ASSERTF(b->points.count > 0, "edge with only %" PRId64 " points.", b->points.count);
 
     HMM_Vec3 aStart = a->points.elems[0];
     HMM_Vec3 aEnd = a->points.elems[a->points.count - 1];
@@ -632,20 +1048,6 @@ mesh_Corner* mesh_edgesToCorner(const mesh_Edge* a, const mesh_Edge* b, int64_t
     return corner;
 }
 
-typedef struct {
-    mesh_Face* a;
-    mesh_Face* b;
-} _mesh_FacePair;
-
-SNZ_SLICE(_mesh_FacePair);
-
-typedef struct {
-    mesh_Edge* a;
-    mesh_Edge* b;
-} _mesh_EdgePair;
-
-SNZ_SLICE(_mesh_EdgePair);
-
 // generates all edges and corners for the given faces, opui to correctly create geoIds
 mesh_TempGeo* mesh_facesToTempGeo(const mesh_FaceSlice* faces, int64_t opUid, snz_Arena* arena, snz_Arena* scratch) {
     mesh_TempGeo* out = SNZ_ARENA_PUSH(arena, mesh_TempGeo);
@@ -654,23 +1056,22 @@ mesh_TempGeo* mesh_facesToTempGeo(const mesh_FaceSlice* faces, int64_t opUid, sn
         .firstEdge = NULL,
     };
 
-    SNZ_ARENA_ARR_BEGIN(scratch, _mesh_FacePair);
-    for (int64_t aIdx = 0; aIdx < faces->count; aIdx++) {
-        mesh_Face* faceA = &faces->elems[aIdx];
-        for (int64_t bIdx = aIdx + 1; bIdx < faces->count; bIdx++) {
-            mesh_Face* faceB = &faces->elems[bIdx];
-            *SNZ_ARENA_PUSH(scratch, _mesh_FacePair) = (_mesh_FacePair){
-                .a = faceA,
-                .b = faceB,
-            };
-        }
+    geo_AABBSlice faceBoxes = {
+        .count = faces->count,
+        .elems = SNZ_ARENA_PUSH_ARR(scratch, faces->count, geo_AABB),
+    };
+    for (int64_t i = 0; i < faces->count; i++) {
+        faceBoxes.elems[i] = geo_aabbFromTris(faces->elems[i].tris);
     }
-    _mesh_FacePairSlice facePairs = SNZ_ARENA_ARR_END(scratch, _mesh_FacePair);
+    bp_PairSlice facePairs = bp_sweepAndPrune(faceBoxes, geo_EPSILON, scratch, scratch);
 
     // generate edges from face pairs
     for (int64_t i = 0; i < facePairs.count; i++) {
-        _mesh_FacePair pair = facePairs.elems[i];
-        mesh_Edge e = mesh_facesToEdge(pair.a, pair.b, opUid, arena, scratch);
+        if (mesh_cancelRequested()) {
+            return out;
+        }
+        bp_Pair pair = facePairs.elems[i];
+        mesh_Edge e = mesh_facesToEdge(&faces->elems[pair.a], &faces->elems[pair.b], opUid, arena, scratch);
         if (!e.points.count) {
             continue;
         }
@@ -681,22 +1082,29 @@ mesh_TempGeo* mesh_facesToTempGeo(const mesh_FaceSlice* faces, int64_t opUid, sn
         out->firstEdge = edgeCopy;
     }
 
-    SNZ_ARENA_ARR_BEGIN(scratch, _mesh_EdgePair);
+    SNZ_ARENA_ARR_BEGIN(scratch, mesh_Edge*);
     for (mesh_Edge* edge = out->firstEdge; edge; edge = edge->next) {
-        for (mesh_Edge* other = edge->next; other; other = other->next) {
-            *SNZ_ARENA_PUSH(scratch, _mesh_EdgePair) = (_mesh_EdgePair){
-                .a = edge,
-                .b = other,
-            };
-        }
+        *SNZ_ARENA_PUSH(scratch, mesh_Edge*) = edge;
+    }
+    mesh_EdgePtrSlice edges = SNZ_ARENA_ARR_END_NAMED(scratch, mesh_Edge*, mesh_EdgePtrSlice);
+
+    // corners only come from shared endpoints, so boxes only need those
+    geo_AABBSlice edgeBoxes = {
+        .count = edges.count,
+        .elems = SNZ_ARENA_PUSH_ARR(scratch, edges.count, geo_AABB),
+    };
+    for (int64_t i = 0; i < edges.count; i++) {
+        HMM_Vec3Slice pts = edges.elems[i]->points;
+        edgeBoxes.elems[i] = geo_aabbEmpty();
+        geo_aabbAddPt(&edgeBoxes.elems[i], pts.elems[0]);
+        geo_aabbAddPt(&edgeBoxes.elems[i], pts.elems[pts.count - 1]);
     }
-    _mesh_EdgePairSlice edgePairs = SNZ_ARENA_ARR_END(scratch, _mesh_EdgePair);
+    bp_PairSlice edgePairs = bp_sweepAndPrune(edgeBoxes, geo_EPSILON, scratch, scratch);
 
     // generating corners
     for (int64_t i = 0; i < edgePairs.count; i++) {
-        _mesh_EdgePair pair = edgePairs.elems[i];
-
-        mesh_Corner* corner = mesh_edgesToCorner(pair.a, pair.b, opUid, arena);
+        bp_Pair pair = edgePairs.elems[i];
+        mesh_Corner* corner = mesh_edgesToCorner(edges.elems[pair.a], edges.elems[pair.b], opUid, arena);
         if (!corner) {
             continue;
         }
@@ -727,7 +1135,7 @@ static mesh_FaceSlice _mesh_groupTrisToFaces(geo_TriSlice tris, PoolAlloc* pool,
     bool* triTakenFlags = SNZ_ARENA_PUSH_ARR(scratch, tris.count, bool);
 
     // FIXME: the two while trues in here should really have cutoffs
-    while (true) {
+    while (!mesh_cancelRequested()) {
         { // find and seed a new face
             geo_Tri tri = { 0 };
             bool anyFound = false;
@@ -758,7 +1166,7 @@ static mesh_FaceSlice _mesh_groupTrisToFaces(geo_TriSlice tris, PoolAlloc* pool,
                 for (int64_t i = 0; i < tris.count; i++) {
                     sectioned += triTakenFlags[i];
                 }
-                SNZ_LOGF("pushed a new face! %lld/%lld", sectioned, tris.count);
+                SNZ_LOGF("pushed a new face! %" PRId64 "/%" PRId64, sectioned, tris.count);
             }
 
             _mesh_TriSliceLLNode* node = SNZ_ARENA_PUSH(scratch, _mesh_TriSliceLLNode);
@@ -929,9 +1337,8 @@ mesh_FaceSlice mesh_stlFileToFaces(const char* path, snz_Arena* arena, snz_Arena
     return _mesh_groupTrisToFaces(tris, pool, arena, scratch);
 }
 
-void mesh_facesToSTLFile(mesh_FaceSlice faces, const char* path) {
-    FILE* f = fopen(path, "w");
-    SNZ_ASSERTF(f, "Opening file '%s' failed.", path);
+// f has to be open for writing already, doesn't close it
+void mesh_facesWriteSTL(mesh_FaceSlice faces, FILE* f) {
     fprintf(f, "solid object\n");
 
     for (int64_t faceIdx = 0; faceIdx < faces.count; faceIdx++) {
@@ -950,6 +1357,12 @@ void mesh_facesToSTLFile(mesh_FaceSlice faces, const char* path) {
     }
 
     fprintf(f, "endsolid object\n");
+}
+
+void mesh_facesToSTLFile(mesh_FaceSlice faces, const char* path) {
+    FILE* f = fopen(path, "w");
+    SNZ_ASSERTF(f, "Opening file '%s' failed.", path);
+    mesh_facesWriteSTL(faces, f);
     fclose(f);
 }
 
@@ -988,7 +1401,15 @@ typedef struct {
     geo_Align orbitOrigin;
     HMM_Vec2 orbitAngle;
     float orbitDist;
-    ren3d_Mesh renderMesh;
+
+    // 0 is full detail, see mesh_lodForProjectedSize for picking one
+    // these are zeroed until mesh_sceneUploadRenderMeshes, lodVerts are the CPU side copies that get uploaded
+    ren3d_Mesh renderMeshLods[MESH_LOD_COUNT];
+    ren3d_VertSlice lodVerts[MESH_LOD_COUNT];
+    HMM_Vec3 boundsCenter;
+    float boundsRadius;
+    // empty unless made w/ mesh_sceneInitInstanced. When it isn't, lod meshes are only one copy and get drawn at each of these
+    HMM_Mat4Slice instances;
 
     mesh_SceneGeoSlice corners;
     mesh_SceneGeoSlice edges;
@@ -996,16 +1417,32 @@ typedef struct {
     mesh_SceneGeoPtrSlice allGeo; // overlaps with corners, edges, faces
 } mesh_Scene;
 
-// copies faces and tempgeo elts to a new arena with space for ui data for them
-// scene returned is valid for the length of arenas life
-// FIXME: array content isn't getting copied rn so the above isn't actually true
-mesh_Scene mesh_sceneInit(const mesh_FaceSlice* faces, const mesh_TempGeo* tempGeo, snz_Arena* arena, snz_Arena* scratch) {
+// same as mesh_sceneInit, except render meshes only get made from instanceFaces, and get drawn once per transform in
+// instances. faces + tempGeo still have to be everything (all the copies, already merged), picking goes off of those.
+// GPU side this is the size of one copy no matter how many there are.
+mesh_Scene mesh_sceneInitInstanced(const mesh_FaceSlice* faces, const mesh_TempGeo* tempGeo,
+                                   const mesh_FaceSlice* instanceFaces, HMM_Mat4Slice instances,
+                                   snz_Arena* arena, snz_Arena* scratch) {
     // FIXME: initialize camera to always be outside mesh based on faces
     mesh_Scene out = (mesh_Scene){
         .orbitDist = 5,
         .orbitOrigin = geo_alignZero(),
-        .renderMesh = mesh_facesToRenderMesh(faces, scratch),
     };
+    mesh_facesBoundingSphere(faces, &out.boundsCenter, &out.boundsRadius);
+    if (instanceFaces) {
+        // FIXME: LODs get picked off of the bounds of everything, so each copy is drawn finer than it needs to be
+        HMM_Vec3 instanceCenter = HMM_V3(0, 0, 0);
+        float instanceRadius = 0;
+        mesh_facesBoundingSphere(instanceFaces, &instanceCenter, &instanceRadius);
+        mesh_facesToLodVerts(instanceFaces, instanceRadius, out.lodVerts, arena, scratch);
+        out.instances = (HMM_Mat4Slice){
+            .count = instances.count,
+            .elems = SNZ_ARENA_PUSH_ARR_ALIGNED(arena, instances.count, HMM_Mat4),
+        };
+        memcpy(out.instances.elems, instances.elems, sizeof(*instances.elems) * instances.count);
+    } else {
+        mesh_facesToLodVerts(faces, out.boundsRadius, out.lodVerts, arena, scratch);
+    }
 
     out.faces = (mesh_SceneGeoSlice){
         .count = faces->count,
@@ -1014,38 +1451,58 @@ mesh_Scene mesh_sceneInit(const mesh_FaceSlice* faces, const mesh_TempGeo* tempG
     for (int64_t i = 0; i < faces->count; i++) {
         mesh_Face* face = &faces->elems[i];
         out.faces.elems[i] = (mesh_SceneGeo){
-            .id = face->id,
-            .faceTris = face->tris,
+            .id = *mesh_geoIdDuplicate(&face->id, arena),
+            .faceTris = geo_triSliceDuplicate(&face->tris, arena),
         };
         mesh_faceAssertValid(face);
     }
 
-    SNZ_ARENA_ARR_BEGIN(arena, mesh_SceneGeo);
+    int64_t edgeCount = 0;
+    for (mesh_Edge* e = tempGeo->firstEdge; e; e = e->next) {
+        edgeCount++;
+    }
+    // point arrays get pushed to the same arena, so this can't be built in array mode
+    out.edges = (mesh_SceneGeoSlice){
+        .count = edgeCount,
+        .elems = SNZ_ARENA_PUSH_ARR(arena, edgeCount, mesh_SceneGeo),
+    };
+    int64_t edgeIdx = 0;
     for (mesh_Edge* e = tempGeo->firstEdge; e; e = e->next) {
-        *SNZ_ARENA_PUSH(arena, mesh_SceneGeo) = (mesh_SceneGeo){
-            .id = e->id,
-            .edgePoints = e->points,
+        HMM_Vec3Slice points = {
+            .count = e->points.count,
+            .elems = SNZ_ARENA_PUSH_ARR(arena, e->points.count, HMM_Vec3),
+        };
+        memcpy(points.elems, e->points.elems, sizeof(*points.elems) * points.count);
+        out.edges.elems[edgeIdx++] = (mesh_SceneGeo){
+            .id = *mesh_geoIdDuplicate(&e->id, arena),
+            .edgePoints = points,
         };
         SNZ_ASSERT(e->id.geoKind == MESH_GK_EDGE, "Edge has a geoid that isn't an edge.");
 
-        SNZ_ASSERTF(e->points.count > 0, "Edge with %lld points", e->points.count);
+        SNZ_ASSERTF(e->points.count > 0, "Edge with %" PRId64 " points", e->points.count);
         for (int64_t i = 0; i < e->points.count - 1; i++) {
             HMM_Vec3 a = e->points.elems[i];
             HMM_Vec3 b = e->points.elems[i + 1];
             SNZ_ASSERT(!geo_v3Equal(a, b), "Segment with zero length;");
         }
     }
-    out.edges = SNZ_ARENA_ARR_END(arena, mesh_SceneGeo);
 
-    SNZ_ARENA_ARR_BEGIN(arena, mesh_SceneGeo);
+    int64_t cornerCount = 0;
     for (mesh_Corner* c = tempGeo->firstCorner; c; c = c->next) {
-        *SNZ_ARENA_PUSH(arena, mesh_SceneGeo) = (mesh_SceneGeo){
-            .id = c->id,
+        cornerCount++;
+    }
+    out.corners = (mesh_SceneGeoSlice){
+        .count = cornerCount,
+        .elems = SNZ_ARENA_PUSH_ARR(arena, cornerCount, mesh_SceneGeo),
+    };
+    int64_t cornerIdx = 0;
+    for (mesh_Corner* c = tempGeo->firstCorner; c; c = c->next) {
+        out.corners.elems[cornerIdx++] = (mesh_SceneGeo){
+            .id = *mesh_geoIdDuplicate(&c->id, arena),
             .cornerPos = c->position,
         };
         SNZ_ASSERT(c->id.geoKind == MESH_GK_CORNER, "Corner has a geoid that isn't a corner.");
     }
-    out.corners = SNZ_ARENA_ARR_END(arena, mesh_SceneGeo);
 
     SNZ_ARENA_ARR_BEGIN(arena, mesh_SceneGeo*);
     for (int64_t i = 0; i < out.faces.count; i++) {
@@ -1062,6 +1519,409 @@ mesh_Scene mesh_sceneInit(const mesh_FaceSlice* faces, const mesh_TempGeo* tempG
     return out;
 }
 
+// copies faces and tempgeo elts (ids included) to a new arena with space for ui data for them
+// scene returned is valid for the length of arenas life, and doesn't point into faces or tempGeo at all
+// doesn't touch GL, so can run on any thread, see mesh_sceneUploadRenderMeshes for the rest
+mesh_Scene mesh_sceneInit(const mesh_FaceSlice* faces, const mesh_TempGeo* tempGeo, snz_Arena* arena, snz_Arena* scratch) {
+    return mesh_sceneInitInstanced(faces, tempGeo, NULL, (HMM_Mat4Slice) { 0 }, arena, scratch);
+}
+
+// draws every lod mesh at the given lod, however many instances there are
+void mesh_sceneDrawLod(const mesh_Scene* scene, int lod, HMM_Mat4 vp, HMM_Mat4 model, HMM_Vec3 lightDir, float ambient) {
+    const ren3d_Mesh* mesh = &scene->renderMeshLods[lod];
+    if (scene->instances.count) {
+        ren3d_drawMeshInstanced(mesh, vp, model, scene->instances.elems, scene->instances.count, HMM_V4(1, 1, 1, 1), lightDir, ambient);
+    } else {
+        ren3d_drawMesh(mesh, vp, model, HMM_V4(1, 1, 1, 1), lightDir, ambient);
+    }
+}
+
+// main thread only, creates render meshes from lodVerts
+void mesh_sceneUploadRenderMeshes(mesh_Scene* scene) {
+    for (int lod = 0; lod < MESH_LOD_COUNT; lod++) {
+        scene->renderMeshLods[lod] = ren3d_meshInit(scene->lodVerts[lod].elems, scene->lodVerts[lod].count);
+    }
+}
+
+// main thread only, fine to call on a scene that was never uploaded
+void mesh_sceneDeinitRenderMeshes(mesh_Scene* scene) {
+    for (int lod = 0; lod < MESH_LOD_COUNT; lod++) {
+        if (scene->renderMeshLods[lod].vaId) {
+            ren3d_meshDeinit(&scene->renderMeshLods[lod]);
+        }
+    }
+}
+
+// what mesh_edgesGetFlipsToMatchFace used to be, walks each loop of edges and makes it wind counter clockwise.
+// kept to check the table version against
+static boolSlice _mesh_testEdgeFlipsByWalking(const mesh_Face* f, const mesh_EdgeSlice edges, snz_Arena* arena, snz_Arena* scratch) {
+    SNZ_ASSERT(mesh_faceFlat(f), "Face wasn't flat"); // FIXME: this fn should be able to handle other faces
+    SNZ_ASSERTF(f->tris.count > 0, "Face with %" PRId64 " tris", f->tris.count);
+    SNZ_ASSERTF(edges.count > 0, "%" PRId64 " edges", edges.count);
+
+    boolSlice outFlips = (boolSlice){
+        .count = edges.count,
+        .elems = SNZ_ARENA_PUSH_ARR(arena, edges.count, bool),
+    };
+
+    boolSlice culled = (boolSlice){
+        .count = edges.count,
+        .elems = SNZ_ARENA_PUSH_ARR(scratch, edges.count, bool),
+    };
+    while (true) { // FIXME: cutoff
+        const mesh_Edge* firstEdge = NULL;
+        for (int64_t i = 0; i < edges.count; i++) {
+            if (culled.elems[i]) {
+                continue;
+            }
+            firstEdge = &edges.elems[i];
+            break;
+        }
+        if (!firstEdge) {
+            break; // no more edges to process, we can exit
+        }
+        SNZ_ASSERTF(firstEdge->points.count > 0, "Edge with %" PRId64 " points", firstEdge->points.count);
+
+        // loop until we have gone around the edge loop
+        HMM_Vec3 crossProdSum = HMM_V3(0, 0, 0);
+        HMM_Vec3 pos = firstEdge->points.elems[0];
+        HMM_Vec3 startPos = pos;
+        SNZ_ARENA_ARR_BEGIN(scratch, int64_t);
+        while (true) { // FIXME: cutoff
+            bool anyFound = false;
+            for (int64_t edgeIdx = 0; edgeIdx < edges.count; edgeIdx++) {
+                if (culled.elems[edgeIdx]) {
+                    continue;
+                }
+                const mesh_Edge* newEdge = &edges.elems[edgeIdx];
+                HMM_Vec3 firstPoint = newEdge->points.elems[0];
+                HMM_Vec3 lastPoint = newEdge->points.elems[newEdge->points.count - 1];
+
+                bool startMatches = geo_v3Equal(firstPoint, pos);
+                if (!startMatches && !geo_v3Equal(lastPoint, pos)) {
+                    continue; // start and end both don't match current edge, it can't be adjacent, move on
+                }
+                culled.elems[edgeIdx] = true;
+                anyFound = true;
+                pos = (startMatches) ? lastPoint : firstPoint;
+                outFlips.elems[edgeIdx] = !startMatches; // indicate flipping if we matched with the end
+                *SNZ_ARENA_PUSH(scratch, int64_t) = edgeIdx; // record visited
+
+                for (int64_t i = 0; i < newEdge->points.count - 1; i++) {
+                    // flip direction if we entered the edge from the back
+                    HMM_Vec3 p1 = HMM_Sub(newEdge->points.elems[i + !startMatches], startPos);
+                    p1 = HMM_Norm(p1);
+                    HMM_Vec3 p2 = HMM_Sub(newEdge->points.elems[i + startMatches], startPos);
+                    p2 = HMM_Norm(p2);
+                    if (isnan(p1.X) || isnan(p2.X)) {
+                        continue;
+                    }
+                    HMM_Vec3 cross = HMM_Cross(p1, p2);
+                    crossProdSum = HMM_Add(crossProdSum, cross);
+                }
+            }
+            if (!anyFound) {
+                break;
+            }
+        }
+        int64_tSlice visitedEdges = SNZ_ARENA_ARR_END(scratch, int64_t);
+
+        HMM_Vec3 faceNormal = geo_triNormal(f->tris.elems[0]);
+        float dot = HMM_Dot(crossProdSum, faceNormal);
+        if (dot < 0) { // if new loop would have the wrong normal, invert all
+            for (int64_t visitIdx = 0; visitIdx < visitedEdges.count; visitIdx++) {
+                int64_t edgeIdx = visitedEdges.elems[visitIdx];
+                outFlips.elems[edgeIdx] = !outFlips.elems[edgeIdx];
+            }
+        }
+    } // end loop to seed new edge loops
+
+    return outFlips;
+}
+
+
+#define _MESH_TEST_MAX_LOOP_PTS 200
+
+// boundary of a circle-ish convex loop around center, in the xy plane, with a corner at each of the angles. Some
+// segments get extra points along them so that edges can start somewhere that isn't a tri corner. corners get
+// marked in outIsCorner.
+static int64_t _mesh_testLoopPoints(HMM_Vec3 center, float radius, const float* angles, int64_t cornerCount, HMM_Vec3* outPts, bool* outIsCorner) {
+    int64_t count = 0;
+    for (int64_t i = 0; i < cornerCount; i++) {
+        float angle = angles[i];
+        outPts[count] = HMM_Add(center, HMM_V3(cosf(angle) * radius, sinf(angle) * radius, 0));
+        outIsCorner[count] = true;
+        count++;
+        int64_t extraCount = rand() % 4 == 0 ? 1 + rand() % 2 : 0;
+        for (int64_t j = 0; j < extraCount; j++) {
+            outPts[count] = HMM_V3(NAN, 0, 0);  // filled in once the next corner is known
+            outIsCorner[count] = false;
+            count++;
+        }
+    }
+    for (int64_t i = 0; i < count; i++) {
+        if (outIsCorner[i]) {
+            continue;
+        }
+        int64_t prev = i - 1;
+        while (!outIsCorner[prev]) {
+            prev--;
+        }
+        int64_t next = (i + 1) % count;
+        while (!outIsCorner[next]) {
+            next = (next + 1) % count;
+        }
+        int64_t stepsBetween = ((next - prev + count) % count);
+        float t = (float)(i - prev) / stepsBetween;
+        outPts[i] = HMM_Lerp(outPts[prev], t, outPts[next]);
+    }
+    return count;
+}
+
+// a face made of 1-3 convex loops, each either fanned from its center or a ring around a hole, and its boundary cut
+// up into edges that are randomly reversed and shuffled. Rotated + moved somewhere random.
+static void _mesh_testRandomFace(mesh_Face* outFace, mesh_EdgeSlice* outEdges, snz_Arena* arena) {
+    HMM_Vec3 axis = HMM_V3((float)(rand() % 200 - 100), (float)(rand() % 200 - 100), (float)(rand() % 100 + 1));
+    HMM_Mat4 transform = HMM_Mul(
+        HMM_Translate(HMM_V3((float)(rand() % 100), (float)(rand() % 100), (float)(rand() % 100))),
+        HMM_Rotate_RH((float)(rand() % 628) / 100, HMM_Norm(axis)));
+    bool invert = rand() % 2;
+
+    // loops past loopCount are the holes, loopCount + i is the hole in loop i when hasHole[i]
+    int64_t loopCount = 1 + rand() % 3;
+    HMM_Vec3 pts[6][_MESH_TEST_MAX_LOOP_PTS] = { 0 };
+    bool isCorner[6][_MESH_TEST_MAX_LOOP_PTS] = { 0 };
+    int64_t ptCounts[6] = { 0 };
+    HMM_Vec3 centers[3] = { 0 };
+    bool hasHole[3] = { 0 };
+    for (int64_t loop = 0; loop < loopCount; loop++) {
+        int64_t cornerCount = 3 + rand() % 30;
+        float angles[33] = { 0 };
+        for (int64_t i = 0; i < cornerCount; i++) {
+            angles[i] = (2 * HMM_PI32 / cornerCount) * (i + (float)(rand() % 40) / 100);
+        }
+        float radius = 1 + (float)(rand() % 300) / 100;
+        centers[loop] = HMM_V3(loop * 10.0f, 0, 0);
+        ptCounts[loop] = _mesh_testLoopPoints(centers[loop], radius, angles, cornerCount, pts[loop], isCorner[loop]);
+        hasHole[loop] = rand() % 2;
+        if (hasHole[loop]) {
+            int64_t hole = loopCount + loop;
+            float holeRadius = radius * (float)(50 + rand() % 30) / 100;  // any thinner and tris stop being flat in floats
+            ptCounts[hole] = _mesh_testLoopPoints(centers[loop], holeRadius, angles, cornerCount, pts[hole], isCorner[hole]);
+        }
+    }
+    for (int64_t loop = 0; loop < loopCount * 2; loop++) {
+        for (int64_t i = 0; i < ptCounts[loop]; i++) {
+            pts[loop][i] = HMM_Mul(transform, HMM_V4V(pts[loop][i], 1)).XYZ;
+        }
+    }
+    for (int64_t loop = 0; loop < loopCount; loop++) {
+        centers[loop] = HMM_Mul(transform, HMM_V4V(centers[loop], 1)).XYZ;
+    }
+
+    SNZ_ARENA_ARR_BEGIN(arena, geo_Tri);
+    for (int64_t loop = 0; loop < loopCount; loop++) {
+        int64_t hole = loopCount + loop;
+        // corners of the hole line up with corners of the outside, so they get walked together
+        int64_t prevCorner = -1;
+        int64_t prevHoleCorner = -1;
+        int64_t holeIdx = 0;
+        for (int64_t i = 0; i <= ptCounts[loop]; i++) {
+            int64_t idx = i % ptCounts[loop];
+            if (!isCorner[loop][idx]) {
+                continue;
+            }
+            int64_t holeCorner = -1;
+            if (hasHole[loop]) {
+                while (!isCorner[hole][holeIdx % ptCounts[hole]]) {
+                    holeIdx++;
+                }
+                holeCorner = holeIdx % ptCounts[hole];
+                holeIdx++;
+            }
+            if (prevCorner >= 0) {
+                geo_Tri tris[2] = { 0 };
+                int64_t triCount = 0;
+                if (hasHole[loop]) {
+                    tris[triCount++] = geo_triInit(pts[loop][prevCorner], pts[loop][idx], pts[hole][holeCorner]);
+                    tris[triCount++] = geo_triInit(pts[loop][prevCorner], pts[hole][holeCorner], pts[hole][prevHoleCorner]);
+                } else {
+                    tris[triCount++] = geo_triInit(centers[loop], pts[loop][prevCorner], pts[loop][idx]);
+                }
+                for (int64_t triIdx = 0; triIdx < triCount; triIdx++) {
+                    geo_Tri t = tris[triIdx];
+                    if (invert) {
+                        t = geo_triInit(t.a, t.c, t.b);
+                    }
+                    *SNZ_ARENA_PUSH(arena, geo_Tri) = t;
+                }
+            }
+            prevCorner = idx;
+            prevHoleCorner = holeCorner;
+        }
+    }
+    *outFace = (mesh_Face){ .tris = SNZ_ARENA_ARR_END(arena, geo_Tri) };
+
+    // cuts are where one edge stops and the next starts
+    bool cuts[6][_MESH_TEST_MAX_LOOP_PTS] = { 0 };
+    int64_t edgeCount = 0;
+    for (int64_t loop = 0; loop < loopCount * 2; loop++) {
+        if (ptCounts[loop] == 0) {
+            continue;  // hole that isn't there
+        }
+        int64_t cutCount = 1 + rand() % 5;
+        for (int64_t i = 0; i < cutCount; i++) {
+            int64_t idx = rand() % ptCounts[loop];
+            edgeCount += !cuts[loop][idx];
+            cuts[loop][idx] = true;
+        }
+    }
+
+    *outEdges = (mesh_EdgeSlice){ .count = edgeCount, .elems = SNZ_ARENA_PUSH_ARR(arena, edgeCount, mesh_Edge) };
+    int64_t edgeIdx = 0;
+    for (int64_t loop = 0; loop < loopCount * 2; loop++) {
+        if (ptCounts[loop] == 0) {
+            continue;
+        }
+        int64_t firstCut = 0;
+        while (!cuts[loop][firstCut]) {
+            firstCut++;
+        }
+        int64_t start = firstCut;
+        do {
+            int64_t end = (start + 1) % ptCounts[loop];
+            while (!cuts[loop][end]) {
+                end = (end + 1) % ptCounts[loop];
+            }
+            int64_t count = ((end - start + ptCounts[loop] - 1) % ptCounts[loop]) + 2;
+            HMM_Vec3Slice edgePts = { .count = count, .elems = SNZ_ARENA_PUSH_ARR(arena, count, HMM_Vec3) };
+            bool reverse = rand() % 2;
+            for (int64_t i = 0; i < count; i++) {
+                edgePts.elems[reverse ? count - 1 - i : i] = pts[loop][(start + i) % ptCounts[loop]];
+            }
+            outEdges->elems[edgeIdx] = (mesh_Edge){ .points = edgePts };
+            edgeIdx++;
+            start = end;
+        } while (start != firstCut);
+    }
+
+    for (int64_t i = outEdges->count - 1; i > 0; i--) {
+        int64_t other = rand() % (i + 1);
+        mesh_Edge temp = outEdges->elems[i];
+        outEdges->elems[i] = outEdges->elems[other];
+        outEdges->elems[other] = temp;
+    }
+}
+
+// convex n-gon fanned from its center, which is what a convex sketch loop turns into, with one shuffled edge per side
+static void _mesh_testFanFace(int64_t sideCount, mesh_Face* outFace, mesh_EdgeSlice* outEdges, snz_Arena* arena) {
+    HMM_Vec3* pts = SNZ_ARENA_PUSH_ARR(arena, sideCount, HMM_Vec3);
+    for (int64_t i = 0; i < sideCount; i++) {
+        float angle = 2 * HMM_PI32 * i / sideCount;
+        pts[i] = HMM_V3(cosf(angle) * 100, sinf(angle) * 100, 0);
+    }
+
+    SNZ_ARENA_ARR_BEGIN(arena, geo_Tri);
+    for (int64_t i = 0; i < sideCount; i++) {
+        *SNZ_ARENA_PUSH(arena, geo_Tri) = geo_triInit(HMM_V3(0, 0, 0), pts[i], pts[(i + 1) % sideCount]);
+    }
+    *outFace = (mesh_Face){ .tris = SNZ_ARENA_ARR_END(arena, geo_Tri) };
+
+    *outEdges = (mesh_EdgeSlice){ .count = sideCount, .elems = SNZ_ARENA_PUSH_ARR(arena, sideCount, mesh_Edge) };
+    for (int64_t i = 0; i < sideCount; i++) {
+        HMM_Vec3* edgePts = SNZ_ARENA_PUSH_ARR(arena, 2, HMM_Vec3);
+        bool reverse = rand() % 2;
+        edgePts[reverse] = pts[i];
+        edgePts[!reverse] = pts[(i + 1) % sideCount];
+        outEdges->elems[i] = (mesh_Edge){ .points = (HMM_Vec3Slice){ .elems = edgePts, .count = 2 } };
+    }
+    for (int64_t i = sideCount - 1; i > 0; i--) {
+        int64_t other = rand() % (i + 1);
+        mesh_Edge temp = outEdges->elems[i];
+        outEdges->elems[i] = outEdges->elems[other];
+        outEdges->elems[other] = temp;
+    }
+}
+
+// best of a few runs, so that one slow run doesn't fail the scaling test
+static double _mesh_testFanFaceFlipSeconds(int64_t sideCount, snz_Arena* arena, snz_Arena* scratch) {
+    mesh_Face face = { 0 };
+    mesh_EdgeSlice edges = { 0 };
+    _mesh_testFanFace(sideCount, &face, &edges, arena);
+    double best = INFINITY;
+    for (int i = 0; i < 5; i++) {
+        clock_t start = clock();
+        mesh_edgesGetFlipsToMatchFace(&face, edges, arena, scratch);
+        best = SNZ_MIN(best, (double)(clock() - start) / CLOCKS_PER_SEC);
+    }
+    snz_arenaClear(arena);
+    snz_arenaClear(scratch);
+    return best;
+}
+
+void mesh_tests() {
+    snz_testPrintSection("mesh");
+    srand(2);
+
+    snz_Arena arena = snz_arenaInit(10000000, "mesh test arena");
+    snz_Arena scratch = snz_arenaInit(50000000, "mesh test scratch");
+
+    {
+        bool allMatch = true;
+        for (int64_t caseIdx = 0; caseIdx < 500; caseIdx++) {
+            mesh_Face face = { 0 };
+            mesh_EdgeSlice edges = { 0 };
+            _mesh_testRandomFace(&face, &edges, &arena);
+            boolSlice flips = mesh_edgesGetFlipsToMatchFace(&face, edges, &arena, &scratch);
+            boolSlice walked = _mesh_testEdgeFlipsByWalking(&face, edges, &arena, &scratch);
+            for (int64_t i = 0; i < edges.count; i++) {
+                allMatch &= flips.elems[i] == walked.elems[i];
+            }
+            snz_arenaClear(&arena);
+            snz_arenaClear(&scratch);
+        }
+        snz_testPrint(allMatch, "edge flips from the face table match walking the loops");
+    }
+
+    {
+        // 4x the sides should be about 4x the time, quadratic would be 16x. Some slack for the bigger table falling out
+        // of cache, and floored so clock() resolution doesn't count
+        double small = SNZ_MAX(_mesh_testFanFaceFlipSeconds(4000, &arena, &scratch), 0.001);
+        double big = _mesh_testFanFaceFlipSeconds(16000, &arena, &scratch);
+        snz_testPrint(big < small * 10, "edge flips on a fanned face scale linearly");
+    }
+
+    {  // 2x2 square with a 1x1 hole, edges all given going the same way around
+        HMM_Vec3 outer[4] = { HMM_V3(-2, -2, 0), HMM_V3(2, -2, 0), HMM_V3(2, 2, 0), HMM_V3(-2, 2, 0) };
+        HMM_Vec3 inner[4] = { HMM_V3(-1, -1, 0), HMM_V3(1, -1, 0), HMM_V3(1, 1, 0), HMM_V3(-1, 1, 0) };
+        geo_Tri tris[8] = { 0 };
+        mesh_Edge edges[8] = { 0 };
+        for (int i = 0; i < 4; i++) {
+            int next = (i + 1) % 4;
+            tris[i * 2 + 0] = geo_triInit(outer[i], outer[next], inner[next]);
+            tris[i * 2 + 1] = geo_triInit(outer[i], inner[next], inner[i]);
+            HMM_Vec3* outerPts = SNZ_ARENA_PUSH_ARR(&arena, 2, HMM_Vec3);
+            outerPts[0] = outer[i];
+            outerPts[1] = outer[next];
+            HMM_Vec3* innerPts = SNZ_ARENA_PUSH_ARR(&arena, 2, HMM_Vec3);
+            innerPts[0] = inner[i];
+            innerPts[1] = inner[next];
+            edges[i] = (mesh_Edge){ .points = (HMM_Vec3Slice){ .elems = outerPts, .count = 2 } };
+            edges[i + 4] = (mesh_Edge){ .points = (HMM_Vec3Slice){ .elems = innerPts, .count = 2 } };
+        }
+        mesh_Face face = (mesh_Face){ .tris = (geo_TriSlice){ .elems = tris, .count = 8 } };
+        boolSlice flips = mesh_edgesGetFlipsToMatchFace(&face, (mesh_EdgeSlice){ .elems = edges, .count = 8 }, &arena, &scratch);
+        bool correct = true;
+        for (int i = 0; i < 8; i++) {
+            correct &= !flips.elems[i];
+        }
+        snz_testPrint(correct, "edge flips run holes the same way as the outside");
+    }
+
+    snz_arenaDeinit(&arena);
+    snz_arenaDeinit(&scratch);
+}
+
 // void _mesh_triToFile(const char* path, geo_Tri t) {
 //     geo_TriSlice tris = {
 //         .count = 1,
@@ -0,0 +1,757 @@
+#pragma once
+
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "PoolAlloc.h"
+#include "geometry.h"
+#include "mesh.h"
+#include "snooze.h"
+
+/*
+MESH IO:
+OBJ and binary PLY readers/writers that keep face boundaries. Every mesh_Face gets written as its own group
+('g face<N>' in OBJ, a 'face_group' property per polygon in PLY) where N is the faces baseNodeId, and reading
+makes one mesh_Face per run of polys with the same group. Files without any groups fall back to _mesh_groupTrisToFaces.
+
+Verts are deduplicated and referenced by index when writing. All file access goes through the buffered
+reader/writer below instead of a stdio call per token.
+
+fns:
+meshio_facesToOBJFile() / meshio_objFileToFaces()
+meshio_facesToPLYFile() / meshio_plyFileToFaces() - binary little endian only
+*/
+
+#define _MESHIO_BUFFER_SIZE (1 << 16)
+
+typedef struct {
+    FILE* file;
+    char* buf;
+    int64_t used;
+} _meshio_Writer;
+
+static _meshio_Writer _meshio_writerInit(FILE* f, snz_Arena* scratch) {
+    return (_meshio_Writer){
+        .file = f,
+        .buf = SNZ_ARENA_PUSH_ARR(scratch, _MESHIO_BUFFER_SIZE, char),
+    };
+}
+
+static void _meshio_writerFlush(_meshio_Writer* w) {
+    if (w->used) {
+        SNZ_ASSERT(fwrite(w->buf, 1, w->used, w->file) == (size_t)w->used, "fwrite failed.");
+    }
+    w->used = 0;
+}
+
+static void _meshio_writerBytes(_meshio_Writer* w, const void* bytes, int64_t size) {
+    if (w->used + size > _MESHIO_BUFFER_SIZE) {
+        _meshio_writerFlush(w);
+    }
+    if (size > _MESHIO_BUFFER_SIZE) {
+        SNZ_ASSERT(fwrite(bytes, 1, size, w->file) == (size_t)size, "fwrite failed.");
+        return;
+    }
+    memcpy(w->buf + w->used, bytes, size);
+    w->used += size;
+}
+
+static void _meshio_writerPrintf(_meshio_Writer* w, const char* fmt, ...) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        va_list args;
+        va_start(args, fmt);
+        int64_t remaining = _MESHIO_BUFFER_SIZE - w->used;
+        int64_t len = vsnprintf(w->buf + w->used, remaining, fmt, args);
+        va_end(args);
+        SNZ_ASSERT(len >= 0 && len < _MESHIO_BUFFER_SIZE, "meshio formatted write too long.");
+
+        if (len < remaining) {
+            w->used += len;
+            return;
+        }
+        _meshio_writerFlush(w);
+    }
+}
+
+typedef struct {
+    FILE* file;
+    char* buf;
+    int64_t pos;
+    int64_t len;
+} _meshio_Reader;
+
+static _meshio_Reader _meshio_readerInit(FILE* f, snz_Arena* scratch) {
+    return (_meshio_Reader){
+        .file = f,
+        .buf = SNZ_ARENA_PUSH_ARR(scratch, _MESHIO_BUFFER_SIZE, char),
+    };
+}
+
+// false if there was nothing left to read
+static bool _meshio_readerRefill(_meshio_Reader* r) {
+    int64_t leftover = r->len - r->pos;
+    memmove(r->buf, r->buf + r->pos, leftover);
+    r->len = leftover;
+    r->pos = 0;
+    int64_t read = fread(r->buf + r->len, 1, _MESHIO_BUFFER_SIZE - r->len, r->file);
+    r->len += read;
+    return read > 0;
+}
+
+// out is null terminated, without the newline. lines longer than outSize - 1 are truncated.
+// returns false at the end of the file
+static bool _meshio_readerLine(_meshio_Reader* r, char* out, int64_t outSize) {
+    int64_t outLen = 0;
+    bool anyRead = false;
+    while (true) {
+        if (r->pos == r->len && !_meshio_readerRefill(r)) {
+            break;
+        }
+        anyRead = true;
+        char c = r->buf[r->pos++];
+        if (c == '\n') {
+            break;
+        } else if (c == '\r') {
+            continue;
+        }
+        if (outLen < outSize - 1) {
+            out[outLen++] = c;
+        }
+    }
+    out[outLen] = '\0';
+    return anyRead;
+}
+
+static void _meshio_readerBytes(_meshio_Reader* r, void* out, int64_t size) {
+    if (r->len - r->pos < size) {
+        _meshio_readerRefill(r);
+    }
+    SNZ_ASSERTF(r->len - r->pos >= size, "unexpected end of file, wanted %" PRId64 " more bytes.", size);
+    memcpy(out, r->buf + r->pos, size);
+    r->pos += size;
+}
+
+typedef struct {
+    bool occupied;
+    HMM_Vec3 pos;
+    int64_t index;
+} _meshio_VertEntry;
+
+typedef struct {
+    HMM_Vec3Slice verts;   // unique positions
+    int64_tSlice indices;  // 3 per tri, in the same order as the faces tris
+} _meshio_IndexedMesh;
+
+// verts are compared bitwise, so this only merges exact duplicates
+static _meshio_IndexedMesh _meshio_facesToIndexed(const mesh_FaceSlice* faces, snz_Arena* scratch) {
+    int64_t triCount = 0;
+    for (int64_t i = 0; i < faces->count; i++) {
+        triCount += faces->elems[i].tris.count;
+    }
+
+    int64_t capacity = 16;
+    while (capacity < triCount * 3 * 2) {
+        capacity *= 2;
+    }
+    _meshio_VertEntry* table = SNZ_ARENA_PUSH_ARR(scratch, capacity, _meshio_VertEntry);
+    _meshio_IndexedMesh out = {
+        .indices = {
+            .count = triCount * 3,
+            .elems = SNZ_ARENA_PUSH_ARR(scratch, triCount * 3, int64_t),
+        },
+    };
+
+    int64_t indexCount = 0;
+    SNZ_ARENA_ARR_BEGIN(scratch, HMM_Vec3);
+    for (int64_t faceIdx = 0; faceIdx < faces->count; faceIdx++) {
+        mesh_Face* f = &faces->elems[faceIdx];
+        for (int64_t triIdx = 0; triIdx < f->tris.count; triIdx++) {
+            for (int i = 0; i < 3; i++) {
+                HMM_Vec3 pt = f->tris.elems[triIdx].elems[i];
+                uint64_t hash = 14695981039346656037ULL;
+                for (int ax = 0; ax < 3; ax++) {
+                    uint32_t bits = 0;
+                    memcpy(&bits, &pt.Elements[ax], sizeof(bits));
+                    hash = (hash ^ bits) * 1099511628211ULL;
+                }
+                hash = snz_hashMix64(hash);
+                uint64_t slot = hash & (capacity - 1);
+                while (table[slot].occupied && memcmp(&table[slot].pos, &pt, sizeof(pt))) {
+                    slot = (slot + 1) & (capacity - 1);
+                }
+                _meshio_VertEntry* e = &table[slot];
+                if (!e->occupied) {
+                    e->occupied = true;
+                    e->pos = pt;
+                    e->index = scratch->arrModeElemCount;
+                    *SNZ_ARENA_PUSH(scratch, HMM_Vec3) = pt;
+                }
+                out.indices.elems[indexCount++] = e->index;
+            }
+        }
+    }
+    out.verts = SNZ_ARENA_ARR_END(scratch, HMM_Vec3);
+    return out;
+}
+
+static int64_t _meshio_faceGroup(const mesh_Face* f, int64_t faceIdx) {
+    if (f->id.baseNodeId) {
+        return f->id.baseNodeId;
+    }
+    return faceIdx + 1;
+}
+
+typedef struct {
+    int64_t group;
+    int64_t firstTri;
+} _meshio_GroupStart;
+
+// tris in [starts[i].firstTri, starts[i + 1].firstTri) become face i
+static mesh_FaceSlice _meshio_facesFromGroups(geo_TriSlice tris, _meshio_GroupStart* starts, int64_t startCount, snz_Arena* arena) {
+    SNZ_ARENA_ARR_BEGIN(arena, mesh_Face);
+    for (int64_t i = 0; i < startCount; i++) {
+        int64_t end = (i + 1 < startCount) ? starts[i + 1].firstTri : tris.count;
+        if (end == starts[i].firstTri) {
+            continue;  // group with no tris in it
+        }
+        *SNZ_ARENA_PUSH(arena, mesh_Face) = (mesh_Face){
+            .id = (mesh_GeoID){
+                .geoKind = MESH_GK_FACE,
+                .baseNodeId = starts[i].group,
+            },
+            .tris = (geo_TriSlice){
+                .elems = &tris.elems[starts[i].firstTri],
+                .count = end - starts[i].firstTri,
+            },
+        };
+    }
+    return SNZ_ARENA_ARR_END(arena, mesh_Face);
+}
+
+// FIXME: error handling without the asserts
+void meshio_facesToOBJFile(const mesh_FaceSlice* faces, const char* path, snz_Arena* scratch) {
+    FILE* f = fopen(path, "wb");
+    SNZ_ASSERTF(f, "Opening file '%s' failed.", path);
+    _meshio_Writer w = _meshio_writerInit(f, scratch);
+    _meshio_IndexedMesh indexed = _meshio_facesToIndexed(faces, scratch);
+
+    _meshio_writerPrintf(&w, "# adder mesh, %lld faces\n", faces->count);
+    for (int64_t i = 0; i < indexed.verts.count; i++) {
+        HMM_Vec3 v = indexed.verts.elems[i];
+        _meshio_writerPrintf(&w, "v %.9g %.9g %.9g\n", v.X, v.Y, v.Z);
+    }
+
+    int64_t indexIdx = 0;
+    for (int64_t faceIdx = 0; faceIdx < faces->count; faceIdx++) {
+        const mesh_Face* face = &faces->elems[faceIdx];
+        _meshio_writerPrintf(&w, "g face%lld\n", _meshio_faceGroup(face, faceIdx));
+        for (int64_t triIdx = 0; triIdx < face->tris.count; triIdx++) {
+            int64_t* idx = &indexed.indices.elems[indexIdx];
+            indexIdx += 3;
+            // obj indices are 1 based
+            _meshio_writerPrintf(&w, "f %lld %lld %lld\n", idx[0] + 1, idx[1] + 1, idx[2] + 1);
+        }
+    }
+
+    _meshio_writerFlush(&w);
+    fclose(f);
+}
+
+// group number is the trailing digits of the group name, or sequential if there aren't any
+static int64_t _meshio_objGroupFromName(const char* name, int64_t fallback) {
+    int64_t len = strlen(name);
+    int64_t digitsStart = len;
+    while (digitsStart > 0 && name[digitsStart - 1] >= '0' && name[digitsStart - 1] <= '9') {
+        digitsStart--;
+    }
+    if (digitsStart == len) {
+        return fallback;
+    }
+    return strtoll(&name[digitsStart], NULL, 10);
+}
+
+// polys with more than 3 verts are fanned, texture/normal indices are ignored
+// FIXME: error handling without the asserts
+mesh_FaceSlice meshio_objFileToFaces(const char* path, snz_Arena* arena, snz_Arena* scratch, PoolAlloc* pool) {
+    SNZ_LOGF("Loading mesh from %s.", path);
+    FILE* f = fopen(path, "rb");
+    SNZ_ASSERTF(f, "opening file '%s' failed.", path);
+    _meshio_Reader r = _meshio_readerInit(f, scratch);
+    char* line = SNZ_ARENA_PUSH_ARR(scratch, 4096, char);
+
+    _meshio_GroupStart* starts = poolAllocAlloc(pool, 0);
+    int64_t startCount = 0;
+    int64_t polyIndices[64] = { 0 };
+
+    // verts and tris are built at the same time, in different arenas
+    SNZ_ARENA_ARR_BEGIN(scratch, HMM_Vec3);
+    SNZ_ARENA_ARR_BEGIN(arena, geo_Tri);
+    while (_meshio_readerLine(&r, line, 4096)) {
+        char* c = line;
+        while (*c == ' ' || *c == '\t') {
+            c++;
+        }
+
+        if (c[0] == 'v' && (c[1] == ' ' || c[1] == '\t')) {
+            HMM_Vec3* v = SNZ_ARENA_PUSH(scratch, HMM_Vec3);
+            c++;
+            for (int ax = 0; ax < 3; ax++) {
+                char* end = NULL;
+                v->Elements[ax] = strtof(c, &end);
+                SNZ_ASSERTF(end != c, "malformed vertex in '%s': %s", path, line);
+                c = end;
+            }
+        } else if (c[0] == 'g' && (c[1] == ' ' || c[1] == '\t' || c[1] == '\0')) {
+            c++;
+            while (*c == ' ' || *c == '\t') {
+                c++;
+            }
+            if (startCount == 0 && arena->arrModeElemCount > 0) {
+                // tris from before the first group get their own
+                *poolAllocPushArray(pool, starts, startCount, _meshio_GroupStart) = (_meshio_GroupStart){ 0 };
+            }
+            *poolAllocPushArray(pool, starts, startCount, _meshio_GroupStart) = (_meshio_GroupStart){
+                .group = _meshio_objGroupFromName(c, startCount + 1),
+                .firstTri = arena->arrModeElemCount,
+            };
+        } else if (c[0] == 'f' && (c[1] == ' ' || c[1] == '\t')) {
+            c++;
+            // from where the array is now, a growable scratch moves it when it fills up
+            int64_t vertCount = scratch->arrModeElemCount;
+            HMM_Vec3* verts = (HMM_Vec3*)(scratch->end) - vertCount;
+            int polyCount = 0;
+            while (true) {
+                char* end = NULL;
+                int64_t idx = strtoll(c, &end, 10);
+                if (end == c) {
+                    break;
+                }
+                c = end;
+                while (*c && *c != ' ' && *c != '\t') {
+                    c++;  // skip over /vt/vn
+                }
+
+                idx = (idx < 0) ? (vertCount + idx) : (idx - 1);
+                SNZ_ASSERTF(idx >= 0 && idx < vertCount, "face index out of range in '%s': %s", path, line);
+                SNZ_ASSERTF(polyCount < 64, "face with too many verts in '%s'.", path);
+                polyIndices[polyCount++] = idx;
+            }
+            SNZ_ASSERTF(polyCount >= 3, "face with less than 3 verts in '%s': %s", path, line);
+
+            for (int i = 1; i < polyCount - 1; i++) {
+                *SNZ_ARENA_PUSH(arena, geo_Tri) = geo_triInit(verts[polyIndices[0]], verts[polyIndices[i]], verts[polyIndices[i + 1]]);
+            }
+        }
+        // everything else (vn, vt, o, s, usemtl, comments) is ignored
+    }
+    geo_TriSlice tris = SNZ_ARENA_ARR_END(arena, geo_Tri);
+    SNZ_ARENA_ARR_END(scratch, HMM_Vec3);
+    fclose(f);
+
+    mesh_FaceSlice out = { 0 };
+    if (startCount == 0) {
+        out = _mesh_groupTrisToFaces(tris, pool, arena, scratch);
+    } else {
+        out = _meshio_facesFromGroups(tris, starts, startCount, arena);
+    }
+    poolAllocFree(pool, starts);
+    return out;
+}
+
+// FIXME: error handling without the asserts
+void meshio_facesToPLYFile(const mesh_FaceSlice* faces, const char* path, snz_Arena* scratch) {
+    FILE* f = fopen(path, "wb");
+    SNZ_ASSERTF(f, "Opening file '%s' failed.", path);
+    _meshio_Writer w = _meshio_writerInit(f, scratch);
+    _meshio_IndexedMesh indexed = _meshio_facesToIndexed(faces, scratch);
+
+    _meshio_writerPrintf(&w, "ply\nformat binary_little_endian 1.0\ncomment adder mesh\n");
+    _meshio_writerPrintf(&w, "element vertex %lld\n", indexed.verts.count);
+    _meshio_writerPrintf(&w, "property float x\nproperty float y\nproperty float z\n");
+    _meshio_writerPrintf(&w, "element face %lld\n", indexed.indices.count / 3);
+    _meshio_writerPrintf(&w, "property list uchar int vertex_indices\nproperty int face_group\nend_header\n");
+
+    // FIXME: assumes a little endian host
+    for (int64_t i = 0; i < indexed.verts.count; i++) {
+        HMM_Vec3 v = indexed.verts.elems[i];
+        _meshio_writerBytes(&w, v.Elements, sizeof(v.Elements));
+    }
+
+    int64_t indexIdx = 0;
+    for (int64_t faceIdx = 0; faceIdx < faces->count; faceIdx++) {
+        const mesh_Face* face = &faces->elems[faceIdx];
+        int32_t group = (int32_t)_meshio_faceGroup(face, faceIdx);
+        for (int64_t triIdx = 0; triIdx < face->tris.count; triIdx++) {
+            uint8_t count = 3;
+            int32_t idx[3] = { 0 };
+            for (int i = 0; i < 3; i++) {
+                idx[i] = (int32_t)indexed.indices.elems[indexIdx++];
+            }
+            _meshio_writerBytes(&w, &count, sizeof(count));
+            _meshio_writerBytes(&w, idx, sizeof(idx));
+            _meshio_writerBytes(&w, &group, sizeof(group));
+        }
+    }
+
+    _meshio_writerFlush(&w);
+    fclose(f);
+}
+
+typedef enum {
+    _MESHIO_PT_INVALID,
+    _MESHIO_PT_INT8,
+    _MESHIO_PT_UINT8,
+    _MESHIO_PT_INT16,
+    _MESHIO_PT_UINT16,
+    _MESHIO_PT_INT32,
+    _MESHIO_PT_UINT32,
+    _MESHIO_PT_FLOAT32,
+    _MESHIO_PT_FLOAT64,
+    _MESHIO_PT_COUNT,
+} _meshio_PLYType;
+
+static const char* _meshio_plyTypeNames[_MESHIO_PT_COUNT][2] = {
+    [_MESHIO_PT_INT8] = { "char", "int8" },
+    [_MESHIO_PT_UINT8] = { "uchar", "uint8" },
+    [_MESHIO_PT_INT16] = { "short", "int16" },
+    [_MESHIO_PT_UINT16] = { "ushort", "uint16" },
+    [_MESHIO_PT_INT32] = { "int", "int32" },
+    [_MESHIO_PT_UINT32] = { "uint", "uint32" },
+    [_MESHIO_PT_FLOAT32] = { "float", "float32" },
+    [_MESHIO_PT_FLOAT64] = { "double", "float64" },
+};
+
+static const int _meshio_plyTypeSizes[_MESHIO_PT_COUNT] = {
+    [_MESHIO_PT_INT8] = 1,
+    [_MESHIO_PT_UINT8] = 1,
+    [_MESHIO_PT_INT16] = 2,
+    [_MESHIO_PT_UINT16] = 2,
+    [_MESHIO_PT_INT32] = 4,
+    [_MESHIO_PT_UINT32] = 4,
+    [_MESHIO_PT_FLOAT32] = 4,
+    [_MESHIO_PT_FLOAT64] = 8,
+};
+
+static _meshio_PLYType _meshio_plyTypeFromStr(const char* str) {
+    for (int i = 1; i < _MESHIO_PT_COUNT; i++) {
+        if (!strcmp(str, _meshio_plyTypeNames[i][0]) || !strcmp(str, _meshio_plyTypeNames[i][1])) {
+            return i;
+        }
+    }
+    return _MESHIO_PT_INVALID;
+}
+
+static double _meshio_plyReadScalar(_meshio_Reader* r, _meshio_PLYType t) {
+    char bytes[8] = { 0 };
+    _meshio_readerBytes(r, bytes, _meshio_plyTypeSizes[t]);
+    switch (t) {
+        case _MESHIO_PT_INT8: return *(int8_t*)bytes;
+        case _MESHIO_PT_UINT8: return *(uint8_t*)bytes;
+        case _MESHIO_PT_INT16: return *(int16_t*)bytes;
+        case _MESHIO_PT_UINT16: return *(uint16_t*)bytes;
+        case _MESHIO_PT_INT32: return *(int32_t*)bytes;
+        case _MESHIO_PT_UINT32: return *(uint32_t*)bytes;
+        case _MESHIO_PT_FLOAT32: return *(float*)bytes;
+        case _MESHIO_PT_FLOAT64: return *(double*)bytes;
+        default: SNZ_ASSERTF(false, "unreachable. type: %d", t);
+    }
+    return 0;
+}
+
+#define _MESHIO_PLY_MAX_ELEMENTS 8
+#define _MESHIO_PLY_MAX_PROPS 16
+
+typedef struct {
+    char name[64];
+    _meshio_PLYType type;
+    _meshio_PLYType listCountType; // invalid if not a list
+} _meshio_PLYProp;
+
+typedef struct {
+    char name[64];
+    int64_t count;
+    _meshio_PLYProp props[_MESHIO_PLY_MAX_PROPS];
+    int64_t propCount;
+} _meshio_PLYElement;
+
+// elements other than 'vertex' and 'face' are skipped, as are unknown properties on those two.
+// FIXME: error handling without the asserts
+mesh_FaceSlice meshio_plyFileToFaces(const char* path, snz_Arena* arena, snz_Arena* scratch, PoolAlloc* pool) {
+    SNZ_LOGF("Loading mesh from %s.", path);
+    FILE* f = fopen(path, "rb");
+    SNZ_ASSERTF(f, "opening file '%s' failed.", path);
+    _meshio_Reader r = _meshio_readerInit(f, scratch);
+
+    _meshio_PLYElement elements[_MESHIO_PLY_MAX_ELEMENTS] = { 0 };
+    int64_t elementCount = 0;
+    { // header
+        char line[256] = { 0 };
+        SNZ_ASSERT(_meshio_readerLine(&r, line, sizeof(line)) && !strcmp(line, "ply"), "expected 'ply' at start of file.");
+        while (true) {
+            SNZ_ASSERTF(_meshio_readerLine(&r, line, sizeof(line)), "unexpected end of header in '%s'.", path);
+            char word[64] = { 0 };
+            if (sscanf(line, "%63s", word) != 1) {
+                continue;
+            }
+
+            if (!strcmp(word, "end_header")) {
+                break;
+            } else if (!strcmp(word, "format")) {
+                char format[64] = { 0 };
+                SNZ_ASSERT(sscanf(line, "%*s %63s", format) == 1, "malformed format line.");
+                SNZ_ASSERTF(!strcmp(format, "binary_little_endian"), "unsupported ply format '%s'.", format);
+            } else if (!strcmp(word, "element")) {
+                SNZ_ASSERT(elementCount < _MESHIO_PLY_MAX_ELEMENTS, "too many ply elements.");
+                _meshio_PLYElement* e = &elements[elementCount++];
+                SNZ_ASSERT(sscanf(line, "%*s %63s %" SCNd64, e->name, &e->count) == 2, "malformed element line.");
+            } else if (!strcmp(word, "property")) {
+                SNZ_ASSERT(elementCount > 0, "ply property before any element.");
+                _meshio_PLYElement* e = &elements[elementCount - 1];
+                SNZ_ASSERT(e->propCount < _MESHIO_PLY_MAX_PROPS, "too many ply properties.");
+                _meshio_PLYProp* p = &e->props[e->propCount++];
+
+                char type[64] = { 0 };
+                SNZ_ASSERT(sscanf(line, "%*s %63s", type) == 1, "malformed property line.");
+                if (!strcmp(type, "list")) {
+                    char countType[64] = { 0 };
+                    SNZ_ASSERT(sscanf(line, "%*s %*s %63s %63s %63s", countType, type, p->name) == 3, "malformed list property.");
+                    p->listCountType = _meshio_plyTypeFromStr(countType);
+                    SNZ_ASSERTF(p->listCountType != _MESHIO_PT_INVALID, "unknown ply type '%s'.", countType);
+                } else {
+                    SNZ_ASSERT(sscanf(line, "%*s %*s %63s", p->name) == 1, "malformed property line.");
+                }
+                p->type = _meshio_plyTypeFromStr(type);
+                SNZ_ASSERTF(p->type != _MESHIO_PT_INVALID, "unknown ply type '%s'.", type);
+            }
+            // comments and obj_info are ignored
+        }
+    }
+
+    HMM_Vec3Slice verts = { 0 };
+    geo_TriSlice tris = { 0 };
+    _meshio_GroupStart* starts = poolAllocAlloc(pool, 0);
+    int64_t startCount = 0;
+    bool anyGroups = false;
+
+    for (int64_t elemIdx = 0; elemIdx < elementCount; elemIdx++) {
+        _meshio_PLYElement* e = &elements[elemIdx];
+        bool isVertex = !strcmp(e->name, "vertex");
+        bool isFace = !strcmp(e->name, "face");
+        if (isVertex) {
+            verts = (HMM_Vec3Slice){
+                .count = e->count,
+                .elems = SNZ_ARENA_PUSH_ARR(scratch, e->count, HMM_Vec3),
+            };
+        } else if (isFace) {
+            SNZ_ASSERTF(verts.elems || e->count == 0, "faces before verts in '%s'.", path);
+            SNZ_ARENA_ARR_BEGIN(arena, geo_Tri);
+        }
+
+        for (int64_t i = 0; i < e->count; i++) {
+            int64_t group = 0;
+            int64_t trisBefore = isFace ? arena->arrModeElemCount : 0;
+            for (int64_t propIdx = 0; propIdx < e->propCount; propIdx++) {
+                _meshio_PLYProp* p = &e->props[propIdx];
+                if (p->listCountType != _MESHIO_PT_INVALID) {
+                    int64_t count = (int64_t)_meshio_plyReadScalar(&r, p->listCountType);
+                    bool isIndices = isFace && (!strcmp(p->name, "vertex_indices") || !strcmp(p->name, "vertex_index"));
+                    int64_t first = 0;
+                    int64_t prev = 0;
+                    for (int64_t j = 0; j < count; j++) {
+                        int64_t idx = (int64_t)_meshio_plyReadScalar(&r, p->type);
+                        if (!isIndices) {
+                            continue;
+                        }
+                        SNZ_ASSERTF(idx >= 0 && idx < verts.count, "face index out of range in '%s'.", path);
+                        if (j == 0) {
+                            first = idx;
+                        } else if (j >= 2) {
+                            *SNZ_ARENA_PUSH(arena, geo_Tri) = geo_triInit(verts.elems[first], verts.elems[prev], verts.elems[idx]);
+                        }
+                        prev = idx;
+                    }
+                } else {
+                    double val = _meshio_plyReadScalar(&r, p->type);
+                    if (isVertex) {
+                        int ax = (p->name[1] == '\0') ? (p->name[0] - 'x') : -1;
+                        if (ax >= 0 && ax < 3) {
+                            verts.elems[i].Elements[ax] = (float)val;
+                        }
+                    } else if (isFace && !strcmp(p->name, "face_group")) {
+                        group = (int64_t)val;
+                        anyGroups = true;
+                    }
+                }
+            }  // end prop loop
+
+            // group is only known after the polys tris are pushed, so the group starts before them
+            if (isFace && (startCount == 0 || starts[startCount - 1].group != group)) {
+                *poolAllocPushArray(pool, starts, startCount, _meshio_GroupStart) = (_meshio_GroupStart){
+                    .group = group,
+                    .firstTri = trisBefore,
+                };
+            }
+        }  // end element instance loop
+
+        if (isFace) {
+            tris = SNZ_ARENA_ARR_END(arena, geo_Tri);
+        }
+    }
+    fclose(f);
+
+    mesh_FaceSlice out = { 0 };
+    if (!anyGroups) {
+        out = _mesh_groupTrisToFaces(tris, pool, arena, scratch);
+    } else {
+        out = _meshio_facesFromGroups(tris, starts, startCount, arena);
+    }
+    poolAllocFree(pool, starts);
+    return out;
+}
+
+static bool _meshio_facesEqual(const mesh_FaceSlice* a, const mesh_FaceSlice* b) {
+    if (a->count != b->count) {
+        return false;
+    }
+    for (int64_t faceIdx = 0; faceIdx < a->count; faceIdx++) {
+        const mesh_Face* fa = &a->elems[faceIdx];
+        const mesh_Face* fb = &b->elems[faceIdx];
+        if (fa->id.baseNodeId != fb->id.baseNodeId || fa->tris.count != fb->tris.count) {
+            return false;
+        }
+        for (int64_t triIdx = 0; triIdx < fa->tris.count; triIdx++) {
+            for (int i = 0; i < 3; i++) {
+                if (!geo_v3Equal(fa->tris.elems[triIdx].elems[i], fb->tris.elems[triIdx].elems[i])) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static mesh_FaceSlice _meshio_benchMesh(int64_t faceCount, int64_t trisPerFace, snz_Arena* arena);
+
+void meshio_tests() {
+    snz_testPrintSection("mesh io");
+
+    snz_Arena arena = snz_arenaInit(10000000, "meshio test arena");
+    snz_Arena scratch = snz_arenaInit(10000000, "meshio test scratch arena");
+    PoolAlloc pool = poolAllocInit();
+
+    mesh_FaceSlice cube = mesh_cube(&arena);
+    for (int64_t i = 0; i < cube.count; i++) {
+        cube.elems[i].id.baseNodeId = 10 + i;
+    }
+
+    {
+        meshio_facesToOBJFile(&cube, "testing/cube.obj", &scratch);
+        mesh_FaceSlice loaded = meshio_objFileToFaces("testing/cube.obj", &arena, &scratch, &pool);
+        snz_testPrint(_meshio_facesEqual(&cube, &loaded), "OBJ round trip keeps faces");
+    }
+    snz_arenaClear(&scratch);
+
+    {
+        meshio_facesToPLYFile(&cube, "testing/cube.ply", &scratch);
+        mesh_FaceSlice loaded = meshio_plyFileToFaces("testing/cube.ply", &arena, &scratch, &pool);
+        snz_testPrint(_meshio_facesEqual(&cube, &loaded), "PLY round trip keeps faces");
+    }
+    snz_arenaClear(&scratch);
+
+    {
+        _meshio_IndexedMesh indexed = _meshio_facesToIndexed(&cube, &scratch);
+        snz_testPrint(indexed.verts.count == 8, "Cube verts shared through indices");
+    }
+
+    {
+        // small blocks so the vert array gets moved a bunch of times while faces are still reading from it
+        snz_Arena growable = snz_arenaInitGrowable(4096, "meshio test growable scratch");
+        mesh_FaceSlice strips = _meshio_benchMesh(20, 400, &arena);
+        meshio_facesToOBJFile(&strips, "testing/strips.obj", &scratch);
+        mesh_FaceSlice loaded = meshio_objFileToFaces("testing/strips.obj", &arena, &growable, &pool);
+        snz_testPrint(_meshio_facesEqual(&strips, &loaded), "OBJ load into a growable scratch");
+        snz_arenaDeinit(&growable);
+    }
+    snz_arenaClear(&scratch);
+
+    snz_arenaDeinit(&arena);
+    snz_arenaDeinit(&scratch);
+    poolAllocDeinit(&pool);
+}
+
+// grid of faceCount strips, each with trisPerFace tris, all in one plane
+static mesh_FaceSlice _meshio_benchMesh(int64_t faceCount, int64_t trisPerFace, snz_Arena* arena) {
+    mesh_FaceSlice out = {
+        .count = faceCount,
+        .elems = SNZ_ARENA_PUSH_ARR(arena, faceCount, mesh_Face),
+    };
+    for (int64_t faceIdx = 0; faceIdx < faceCount; faceIdx++) {
+        SNZ_ARENA_ARR_BEGIN(arena, geo_Tri);
+        for (int64_t i = 0; i < trisPerFace / 2; i++) {
+            HMM_Vec3 a = HMM_V3((float)i, (float)faceIdx, 0);
+            HMM_Vec3 b = HMM_V3((float)i + 1, (float)faceIdx, 0);
+            HMM_Vec3 c = HMM_V3((float)i + 1, (float)faceIdx + 1, 0);
+            HMM_Vec3 d = HMM_V3((float)i, (float)faceIdx + 1, 0);
+            *SNZ_ARENA_PUSH(arena, geo_Tri) = geo_triInit(a, b, c);
+            *SNZ_ARENA_PUSH(arena, geo_Tri) = geo_triInit(a, c, d);
+        }
+        out.elems[faceIdx] = (mesh_Face){
+            .id.baseNodeId = faceIdx + 1,
+            .tris = SNZ_ARENA_ARR_END(arena, geo_Tri),
+        };
+    }
+    return out;
+}
+
+static double _meshio_secondsSince(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static int64_t _meshio_fileSize(const char* path) {
+    FILE* f = fopen(path, "rb");
+    SNZ_ASSERTF(f, "opening file '%s' failed.", path);
+    fseek(f, 0L, SEEK_END);
+    int64_t size = ftell(f);
+    fclose(f);
+    return size;
+}
+
+// not run with the tests because it takes a while. writes to testing/
+void meshio_bench() {
+    snz_Arena arena = snz_arenaInit(1000000000, "meshio bench arena");
+    snz_Arena scratch = snz_arenaInit(1000000000, "meshio bench scratch arena");
+    PoolAlloc pool = poolAllocInit();
+
+    mesh_FaceSlice faces = _meshio_benchMesh(1000, 1000, &arena);
+    const char* paths[] = { "testing/bench.obj", "testing/bench.ply" };
+    for (int i = 0; i < 2; i++) {
+        clock_t start = clock();
+        if (i == 0) {
+            meshio_facesToOBJFile(&faces, paths[i], &scratch);
+        } else {
+            meshio_facesToPLYFile(&faces, paths[i], &scratch);
+        }
+        double writeTime = _meshio_secondsSince(start);
+        snz_arenaClear(&scratch);
+
+        start = clock();
+        mesh_FaceSlice loaded = { 0 };
+        if (i == 0) {
+            loaded = meshio_objFileToFaces(paths[i], &arena, &scratch, &pool);
+        } else {
+            loaded = meshio_plyFileToFaces(paths[i], &arena, &scratch, &pool);
+        }
+        double readTime = _meshio_secondsSince(start);
+        snz_arenaClear(&scratch);
+
+        double mb = _meshio_fileSize(paths[i]) / 1000000.0;
+        SNZ_LOGF("%s: %.1f MB, write %.3fs (%.1f MB/s), read %.3fs (%.1f MB/s), faces match: %d",
+                 paths[i], mb, writeTime, mb / writeTime, readTime, mb / readTime, _meshio_facesEqual(&faces, &loaded));
+    }
+
+    snz_arenaDeinit(&arena);
+    snz_arenaDeinit(&scratch);
+    poolAllocDeinit(&pool);
+}
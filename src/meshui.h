@@ -130,10 +130,9 @@ void meshu_sceneBuild(mesh_GeoKind filter, const mesh_Scene* scene, HMM_Mat4 vp,
     }
 
     { // render
-        ren3d_drawMesh(
-            &scene->renderMesh,
-            vp, HMM_M4D(1.0f),
-            HMM_V4(1, 1, 1, 1), HMM_V3(-1, -1, -1), ui_lightAmbient);
+        float distToCamera = HMM_Len(HMM_Sub(scene->boundsCenter, cameraPos));
+        int lod = mesh_lodForProjectedSize(scene->boundsRadius, distToCamera, HMM_AngleDeg(90), panelSize.Y);
+        mesh_sceneDrawLod(scene, lod, vp, HMM_M4D(1.0f), HMM_V3(-1, -1, -1), ui_lightAmbient);
 
         if (faceMeshVerts.count && faceMeshVerts.elems) {
             HMM_Mat4 model = HMM_Translate(HMM_V3(0, 0, 0));
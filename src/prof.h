@@ -1,3 +1,5 @@
+#pragma once
+
 #include "snooze.h"
 #include "ser.h"
 
@@ -54,6 +56,29 @@ void _prof_callEnd() {
 // put before a block to profile it - changes block into a for loop, which does the defered call to callEnd
 #define PROF_BLOCK() for(int _i_ = (_prof_callStart(__FILE__, __LINE__), 0); !_i_; (_prof_callEnd(), _i_++))
 
+// counts of work that should only happen when something changed, so idle frames can be checked for doing none of it.
+// solve workers bump these too, so they're atomic. prof_countersFrameEnd moves them into prof_lastFrameCounts.
+typedef enum {
+    PROF_CK_SKETCH_SOLVES,
+    PROF_CK_SKETCH_SOLVE_ITERATIONS,
+    PROF_CK_SKETCH_TRIANGULATIONS,
+    PROF_CK_COUNT,
+} prof_CounterKind;
+
+SDL_atomic_t _prof_counters[PROF_CK_COUNT];
+int prof_lastFrameCounts[PROF_CK_COUNT];
+
+void prof_count(prof_CounterKind kind, int amount) {
+    SDL_AtomicAdd(&_prof_counters[kind], amount);
+}
+
+// once a frame, after everything that counts
+void prof_countersFrameEnd() {
+    for (int i = 0; i < PROF_CK_COUNT; i++) {
+        prof_lastFrameCounts[i] = SDL_AtomicSet(&_prof_counters[i], 0);
+    }
+}
+
 void prof_start(snz_Arena* arena) {
     _prof_globs.arena = arena;
     SNZ_ARENA_ARR_BEGIN(arena, prof_Sample);
@@ -67,6 +92,7 @@ prof_SampleSlice prof_end() {
 }
 
 void prof_sampleSliceBuild(prof_SampleSlice samples) {
+    (void)samples;  // FIXME: draw them
     snzu_boxNew("sample build");
     snzu_boxFillParent();
     snzu_boxScope() {
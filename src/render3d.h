@@ -154,7 +154,11 @@ void ren3d_init(snz_Arena* scratch) {
     }
 }
 
-void ren3d_drawMesh(const ren3d_Mesh* mesh, HMM_Mat4 vp, HMM_Mat4 model, HMM_Vec4 color, HMM_Vec3 lightDir, float ambient) {
+// has to match the size of uInstances in res/shaders/3d.vert
+#define REN3D_MAX_INSTANCES_PER_DRAW 32
+
+// everything but the instance transforms + the draw call itself
+static void _ren3d_meshDrawBegin(const ren3d_Mesh* mesh, HMM_Mat4 vp, HMM_Mat4 model, HMM_Vec4 color, HMM_Vec3 lightDir, float ambient) {
     snzr_callGLFnOrError(glUseProgram(_ren3d_shaderId));
 
     // // FIXME: gl safe uniform loc calls
@@ -178,9 +182,30 @@ void ren3d_drawMesh(const ren3d_Mesh* mesh, HMM_Mat4 vp, HMM_Mat4 model, HMM_Vec
 
     snzr_callGLFnOrError(glBindVertexArray(mesh->vaId));
     snzr_callGLFnOrError(glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBufferId));
+}
+
+void ren3d_drawMesh(const ren3d_Mesh* mesh, HMM_Mat4 vp, HMM_Mat4 model, HMM_Vec4 color, HMM_Vec3 lightDir, float ambient) {
+    _ren3d_meshDrawBegin(mesh, vp, model, color, lightDir, ambient);
+
+    // non instanced draws still read the first instance transform
+    HMM_Mat4 identity = HMM_M4D(1.0f);
+    int loc = glGetUniformLocation(_ren3d_shaderId, "uInstances");
+    snzr_callGLFnOrError(glUniformMatrix4fv(loc, 1, false, (float*)&identity));
     snzr_callGLFnOrError(glDrawArrays(GL_TRIANGLES, 0, mesh->vertCount));
 }
 
+// draws mesh once per instance transform, each is applied before model. Goes out in batches of REN3D_MAX_INSTANCES_PER_DRAW
+void ren3d_drawMeshInstanced(const ren3d_Mesh* mesh, HMM_Mat4 vp, HMM_Mat4 model, const HMM_Mat4* instances, int64_t instanceCount, HMM_Vec4 color, HMM_Vec3 lightDir, float ambient) {
+    _ren3d_meshDrawBegin(mesh, vp, model, color, lightDir, ambient);
+
+    int loc = glGetUniformLocation(_ren3d_shaderId, "uInstances");
+    for (int64_t i = 0; i < instanceCount; i += REN3D_MAX_INSTANCES_PER_DRAW) {
+        int batchCount = (int)SNZ_MIN(instanceCount - i, REN3D_MAX_INSTANCES_PER_DRAW);
+        snzr_callGLFnOrError(glUniformMatrix4fv(loc, batchCount, false, (float*)&instances[i]));
+        snzr_callGLFnOrError(glDrawArraysInstanced(GL_TRIANGLES, 0, mesh->vertCount, batchCount));
+    }
+}
+
 // https://learnopengl.com/Advanced-OpenGL/Cubemaps
 // where would I be without this website
 // texture expected to be long/lat
@@ -1,7 +1,6 @@
 #pragma once
 
 #include "snooze.h"
-#include "settings.h"
 /*
 
 open qs:
@@ -145,7 +144,7 @@ typedef struct {
 void _ser_enumValuePush(snz_Arena* arena, const char* name, int32_t value, int64_t size) {
     SNZ_ASSERTF(
         size == sizeof(int32_t),
-        "Enums are expected to always be 32 bit values, adding '%s' failed because it has %lld bits.",
+        "Enums are expected to always be 32 bit values, adding '%s' failed because it has %" PRId64 " bits.",
         name, size * 8);
     *SNZ_ARENA_PUSH(arena, ser_EnumValue) = (ser_EnumValue){
         .name = name,
@@ -241,6 +240,11 @@ _ser_T* _ser_tPtr(const char* innerName) {
     return out;
 }
 
+// these two are for when the tag in files isn't the C name anymore, ex. after the struct that was saved changed shape
+#define ser_addStructAs(T, tag, pointable) _ser_addStruct(#tag, sizeof(T), pointable)
+#define ser_addStructFieldAs(structT, tag, type, name) \
+    _ser_addStructField(#tag, type, #name, offsetof(structT, name))
+
 #define ser_addStruct(T, pointable) _ser_addStruct(#T, sizeof(T), pointable)
 void _ser_addStruct(const char* name, int64_t size, bool pointable) {
     _ser_assertInstanceValidForAddingToSpec();
@@ -300,7 +304,7 @@ void _ser_addStructFieldSlice(
 #define ser_addEnum(name, values) _ser_addEnum(#name, sizeof(name), values)
 void _ser_addEnum(const char* tag, int64_t sizeOfEnum, ser_EnumValueSlice values) {
     _ser_assertInstanceValidForAddingToSpec();
-    SNZ_ASSERTF(sizeOfEnum == sizeof(int32_t), "Enum '%s' wasn't 32bits (was %lld). Ser isn't build to handle that.", tag, sizeOfEnum);
+    SNZ_ASSERTF(sizeOfEnum == sizeof(int32_t), "Enum '%s' wasn't 32bits (was %" PRId64 "). Ser isn't build to handle that.", tag, sizeOfEnum);
     _ser_SpecEnum* spec = SNZ_ARENA_PUSH(_ser_globs.specArena, _ser_SpecEnum);
     _ser_globs.spec.enumSpecCount++;
     *spec = (_ser_SpecEnum){
@@ -461,80 +465,85 @@ void ser_end() {
     _ser_globs.validated = true;
 }
 
-typedef struct _ser_PtrTranslation _ser_PtrTranslation;
-struct _ser_PtrTranslation {
-    uint64_t key;
-    uint64_t value;
-    _ser_PtrTranslation* nextCollided;
-};
-
-#define _SER_PTR_TRANSLATION_BUCKET_COUNT 2048
-#define _SER_PTR_TRANSLATION_MAX 2048
-#define _SER_PTR_TRANSLATION_STUB_MAX 2048
+// throws out the global spec so that another can be built, for tests/tools that need more than one
+void ser_reset() {
+    memset(&_ser_globs, 0, sizeof(_ser_globs));
+}
 
 typedef struct {
-    _ser_PtrTranslation* translationBuckets[_SER_PTR_TRANSLATION_BUCKET_COUNT];
+    uint64_t key; // zero for an empty slot, written addresses and read file positions never are
+    uint64_t value;
+} _ser_PtrTranslation;
 
-    struct {
-        _ser_PtrTranslation elems[_SER_PTR_TRANSLATION_MAX];
-        int64_t count;
-    } translations;
+// open addressing w/ linear probing. Grows by pushing a bigger copy of everything to arena, the old ones are just left there.
+typedef struct {
+    snz_Arena* arena;
+    _ser_PtrTranslation* slots;
+    int64_t capacity; // always a power of two
+    int64_t count;
 
     struct {
-        uint64_t locationsToPatch[_SER_PTR_TRANSLATION_STUB_MAX];
-        uint64_t keyOfValue[_SER_PTR_TRANSLATION_STUB_MAX];
+        uint64_t* locationsToPatch;
+        uint64_t* keyOfValue;
         int64_t count;
+        int64_t capacity;
     } stubs;
 } _ser_PtrTranslationTable;
-// FIXME: dyn sizing
-
-// https://zimbry.blogspot.com/2011/09/better-bit-mixing-improving-on.html
-uint64_t _ser_addressHash(uint64_t address) {
-    address ^= (address >> 33);
-    address *= 0xff51afd7ed558ccd;
-    address ^= (address >> 33);
-    address *= 0xc4ceb9fe1a85ec53;
-    address ^= (address >> 33);
-    return address;
+
+#define _SER_PTR_TRANSLATION_INITIAL_CAPACITY 1024
+
+static _ser_PtrTranslation* _ser_ptrTranslationSlot(_ser_PtrTranslationTable* table, uint64_t key) {
+    int64_t mask = table->capacity - 1;
+    int64_t i = snz_hashMix64(key) & mask;
+    while (table->slots[i].key != 0 && table->slots[i].key != key) {
+        i = (i + 1) & mask;
+    }
+    return &table->slots[i];
 }
 
 // return indicates whether the key didn't exist before & and the val was added
 bool _ser_ptrTranslationSet(_ser_PtrTranslationTable* table, uint64_t key, uint64_t value) {
-    int64_t bucket = _ser_addressHash(key) % _SER_PTR_TRANSLATION_BUCKET_COUNT;
-    _ser_PtrTranslation* initial = table->translationBuckets[bucket];
-    for (_ser_PtrTranslation* node = initial; node; node = node->nextCollided) {
-        if (node->key == key) {
-            node->value = value;
-            return false;
+    SNZ_ASSERT(key != 0, "null ptr/zero position in ser translation table.");
+    if ((table->count + 1) * 2 > table->capacity) {
+        _ser_PtrTranslationTable old = *table;
+        table->capacity = old.capacity ? old.capacity * 2 : _SER_PTR_TRANSLATION_INITIAL_CAPACITY;
+        table->slots = SNZ_ARENA_PUSH_ARR(table->arena, table->capacity, _ser_PtrTranslation);
+        for (int64_t i = 0; i < old.capacity; i++) {
+            if (old.slots[i].key != 0) {
+                *_ser_ptrTranslationSlot(table, old.slots[i].key) = old.slots[i];
+            }
         }
     }
 
-    SNZ_ASSERT(table->translations.count < _SER_PTR_TRANSLATION_MAX, "Too many addresses to serialize. see the fixme.");
-    _ser_PtrTranslation* node = &table->translations.elems[table->translations.count];
-    table->translations.count++;
-    *node = (_ser_PtrTranslation){
-        .key = key,
-        .value = value,
-        .nextCollided = initial,
-    };
-    table->translationBuckets[bucket] = node;
-    return true;
+    _ser_PtrTranslation* slot = _ser_ptrTranslationSlot(table, key);
+    bool added = slot->key == 0;
+    table->count += added;
+    *slot = (_ser_PtrTranslation){ .key = key, .value = value };
+    return added;
 }
 
 // null if not in table
 uint64_t* _ser_ptrTranslationGet(_ser_PtrTranslationTable* table, uint64_t key) {
-    int64_t bucket = _ser_addressHash(key) % _SER_PTR_TRANSLATION_BUCKET_COUNT;
-    for (_ser_PtrTranslation* node = table->translationBuckets[bucket]; node; node = node->nextCollided) {
-        if (node->key == key) {
-            return &node->value;
-        }
+    if (!table->capacity) {
+        return NULL;
     }
-    return NULL;
+    _ser_PtrTranslation* slot = _ser_ptrTranslationSlot(table, key);
+    return slot->key ? &slot->value : NULL;
 }
 
 void _ser_ptrTranslationStubAdd(_ser_PtrTranslationTable* table, uint64_t addressToPatchAt, uint64_t keyOfPatchValue) {
-    SNZ_ASSERTF(table->stubs.count < _SER_PTR_TRANSLATION_STUB_MAX,
-                "Too many ptr stubs: %d", table->stubs.count);
+    if (table->stubs.count == table->stubs.capacity) {
+        int64_t newCapacity = table->stubs.capacity ? table->stubs.capacity * 2 : _SER_PTR_TRANSLATION_INITIAL_CAPACITY;
+        uint64_t* locations = SNZ_ARENA_PUSH_ARR(table->arena, newCapacity, uint64_t);
+        uint64_t* keys = SNZ_ARENA_PUSH_ARR(table->arena, newCapacity, uint64_t);
+        if (table->stubs.count) {
+            memcpy(locations, table->stubs.locationsToPatch, table->stubs.count * sizeof(uint64_t));
+            memcpy(keys, table->stubs.keyOfValue, table->stubs.count * sizeof(uint64_t));
+        }
+        table->stubs.locationsToPatch = locations;
+        table->stubs.keyOfValue = keys;
+        table->stubs.capacity = newCapacity;
+    }
 
     table->stubs.locationsToPatch[table->stubs.count] = addressToPatchAt;
     table->stubs.keyOfValue[table->stubs.count] = keyOfPatchValue;
@@ -560,6 +569,7 @@ typedef struct {
     _ser_PtrTranslationTable ptrTable;
 
     FILE* file;
+    uint64_t startInFile; // where in the file this write started, everything else is relative to it
     uint64_t positionIntoFile;
     snz_Arena* scratch;
 } _serw_WriteInst;
@@ -706,7 +716,9 @@ ser_WriteError _ser_write(FILE* f, const char* typename, int64_t size, void* see
 
     _serw_WriteInst write = { 0 };
     write.file = f;
+    write.startInFile = ftell(f);
     write.scratch = scratch;
+    write.ptrTable.arena = scratch;
 
     write.nextStruct = SNZ_ARENA_PUSH(scratch, _serw_QueuedStruct);
     write.nextStruct->obj = seedObj;
@@ -714,7 +726,7 @@ ser_WriteError _ser_write(FILE* f, const char* typename, int64_t size, void* see
     SNZ_ASSERTF(write.nextStruct->spec, "No definition for struct '%s'", typename);
     SNZ_ASSERTF(
         write.nextStruct->spec->size == size,
-        "Size of type '%s' was %lld, didn't match expected size of %lld.",
+        "Size of type '%s' was %" PRId64 ", didn't match expected size of %" PRId64 ".",
         typename, size, write.nextStruct->spec->size);
 
     { // writing spec
@@ -787,11 +799,12 @@ ser_WriteError _ser_write(FILE* f, const char* typename, int64_t size, void* see
         }
     }
 
+    uint64_t endOfWrite = write.positionIntoFile;  // patching moves this forward
     { // patch ptrs
         _ser_PtrTranslationTable* t = &write.ptrTable;
         for (int64_t i = 0; i < t->stubs.count; i++) {
             int64_t fileLoc = t->stubs.locationsToPatch[i];
-            fseek(write.file, fileLoc, SEEK_SET);
+            fseek(write.file, write.startInFile + fileLoc, SEEK_SET);
 
             uint64_t* otherLoc = _ser_ptrTranslationGet(&write.ptrTable, t->stubs.keyOfValue[i]);
             if (!otherLoc) {
@@ -801,6 +814,8 @@ ser_WriteError _ser_write(FILE* f, const char* typename, int64_t size, void* see
         }
     }
 
+    // leave the file at the end of this write, not wherever the last ptr was
+    fseek(write.file, write.startInFile + endOfWrite, SEEK_SET);
     return SER_WE_OK;
 }
 
@@ -809,6 +824,7 @@ typedef struct {
 
     FILE* file;
     uint64_t positionIntoFile;
+    int64_t byteCount; // objs stop being read after this many bytes, -1 to read until the end of the file
 
     snz_Arena* outArena;
     snz_Arena* scratch;
@@ -829,7 +845,7 @@ typedef enum {
     do { \
         ser_ReadError err = _serr_readBytes(read, out, size, swapWithEndianness); \
         if(err != SER_RE_OK) { \
-            SNZ_LOGF("Read bytes failed. File pos: %llu", (read)->positionIntoFile); \
+            SNZ_LOGF("Read bytes failed. File pos: %" PRIu64, (read)->positionIntoFile); \
             return err; \
         } \
     } while(0)
@@ -959,23 +975,27 @@ ser_ReadError _serr_readField(_serr_ReadInst* read, _ser_SpecField* field, void*
 }
 
 // FIXME: typeof macro instead of doing a separate type param?
-#define ser_read(f, T, arena, scratch, outObj) _ser_read(f, #T, sizeof(T), arena, scratch, outObj)
-ser_ReadError _ser_read(FILE* file, const char* typename, int64_t typeSize, snz_Arena* outArena, snz_Arena* scratch, void** outObj) {
+#define ser_read(f, T, arena, scratch, outObj) _ser_read(f, #T, sizeof(T), -1, arena, scratch, outObj)
+// for when whatever ser_write wrote isn't the only thing in the file. Starts wherever f is now and reads at most byteCount bytes.
+#define ser_readSized(f, T, byteCount, arena, scratch, outObj) _ser_read(f, #T, sizeof(T), byteCount, arena, scratch, outObj)
+ser_ReadError _ser_read(FILE* file, const char* typename, int64_t typeSize, int64_t byteCount, snz_Arena* outArena, snz_Arena* scratch, void** outObj) {
     _ser_assertInstanceValidated();
     SNZ_ASSERT(outObj, "Expected a non-null out object");
     _ser_SpecStruct* checkSpec = _ser_specGetStructSpecByName(&_ser_globs.spec, typename);
     SNZ_ASSERTF(checkSpec, "Read would fail, there is no defined spec for struct '%s'", typename);
     SNZ_ASSERTF(
         checkSpec->size == typeSize,
-        "Declared and actual size of struct '%s' differ. Was: %lld, expected: %lld",
-        typeSize, checkSpec->size);
+        "Declared and actual size of struct '%s' differ. Was: %" PRId64 ", expected: %" PRId64,
+        typename, typeSize, checkSpec->size);
     // SNZ_LOG("\t\tBEGINNING READ");
 
     _serr_ReadInst read = (_serr_ReadInst){
         .file = file,
         .positionIntoFile = 0,
+        .byteCount = byteCount,
         .outArena = outArena,
         .scratch = scratch,
+        .ptrTable.arena = scratch,
     };
 
     _ser_Spec spec = { 0 };
@@ -1151,6 +1171,9 @@ ser_ReadError _ser_read(FILE* file, const char* typename, int64_t typeSize, snz_
     _ser_SpecStruct* firstObjSpec = NULL;
     { // parse objs while any left
         while (true) { // FIXME: cutoff?
+            if (read.byteCount >= 0 && (int64_t)read.positionIntoFile >= read.byteCount) {
+                break;
+            }
             int64_t kind = 0;
             _serr_readBytes(&read, &kind, sizeof(kind), true);
             if (feof(read.file)) { // here instead of the loop because this only triggers when you read over the bounds of the file
@@ -1316,7 +1339,7 @@ void ser_tests() {
         ser_ReadError err = ser_read(f, geo_TriSlice, &testArena, &testArena, (void**)&obj);
         SNZ_ASSERTF(err == SER_RE_OK, "Read failed, code: %d.", err);
 
-        SNZ_ASSERTF(obj->count == slice.count, "Read slice has different length (%lld) than original (%lld)", obj->count, slice.count);
+        SNZ_ASSERTF(obj->count == slice.count, "Read slice has different length (%" PRId64 ") than original (%" PRId64 ")", obj->count, slice.count);
         for (int i = 0; i < obj->count; i++) {
             geo_Tri newTri = obj->elems[i];
             geo_Tri ogTri = slice.elems[i];
@@ -1366,7 +1389,7 @@ void ser_tests() {
     snz_arenaDeinit(&testArena);
 
     // reset globals so everything else works right
-    memset(&_ser_globs, 0, sizeof(_ser_globs));
+    ser_reset();
 }
 
 // FIXME: a fuzzing system for this lib is 100000% possible, do that please
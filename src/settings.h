@@ -18,6 +18,8 @@ typedef struct {
 
     // non serialized
     bool debugMode;
+    bool solveStats;
+    bool speculativeSolve;
 } set_Settings;
 // NOTE: this is not meant to be a global anywhere, pass specific settings as flags down from wherever this
 // is being persisted betw frames.
@@ -48,6 +50,8 @@ set_Settings set_settingsDefault() {
         .geometryFilter = true,
 
         .debugMode = true,
+        .solveStats = false,
+        .speculativeSolve = true,
     };
     return out;
 }
@@ -73,7 +77,9 @@ void set_build(set_Settings* settings) {
             "squishy camera",
             "crosshair",
             "geometry filter",
-            "debug mode"
+            "debug mode",
+            "solve stats on timeline nodes",
+            "pre-solve hovered timeline nodes",
         };
 
         snzu_boxNew("holder");
@@ -127,6 +133,8 @@ void set_build(set_Settings* settings) {
                 ui_switch("crosshair", &settings->crosshair);
                 ui_switch("geometryFilter", &settings->geometryFilter);
                 ui_switch("debug mode", &settings->debugMode);
+                ui_switch("solve stats", &settings->solveStats);
+                ui_switch("pre-solve", &settings->speculativeSolve);
             }
             snzu_boxOrderChildrenInRowRecurse(2 * ui_padding, SNZU_AX_Y, SNZU_ALIGN_LEFT);
         }
@@ -6,6 +6,7 @@
 #include "snooze.h"
 #include "ui.h"
 #include "timeline.h"
+#include "timelineundo.h"
 
 typedef enum {
     SC_VIEW_NONE = 0,
@@ -40,6 +41,7 @@ typedef struct {
     sc_View* currentView;  // read/write
     mesh_GeoKind* outGeoFilter; // read/write
     tl_Op** argBarFocusOverride; // read/write
+    tlu_History* undo;
 } _sc_CommandFuncArgs;
 
 typedef bool (*sc_CommandFunc)(_sc_CommandFuncArgs args);
@@ -105,21 +107,22 @@ bool _scc_goToTimeline(_sc_CommandFuncArgs args) {
 }
 
 bool _scc_sketchDelete(_sc_CommandFuncArgs args) {
-    for (sk_Point* p = args.activeSketch->firstPoint; p; p = p->next) {
-        if (p->sel.selected) {
+    for (sk_Point* p = sk_sketchFirstPoint(args.activeSketch); p; p = sk_sketchNextPoint(args.activeSketch, p)) {
+        if (sk_pointUi(args.activeSketch, p)->sel.selected) {
             p->markedForDelete = true;
         }
     }
-    for (sk_Line* l = args.activeSketch->firstLine; l; l = l->next) {
-        if (l->sel.selected) {
+    for (sk_Line* l = sk_sketchFirstLine(args.activeSketch); l; l = sk_sketchNextLine(args.activeSketch, l)) {
+        if (sk_lineUi(args.activeSketch, l)->sel.selected) {
             l->markedForDelete = true;
         }
     }
-    for (sk_Constraint* c = args.activeSketch->firstConstraint; c; c = c->nextAllocated) {
-        if (c->uiInfo.sel.selected) {
+    for (sk_Constraint* c = sk_sketchFirstConstraint(args.activeSketch); c; c = sk_sketchNextConstraint(args.activeSketch, c)) {
+        if (sk_constraintUi(args.activeSketch, c)->sel.selected) {
             c->markedForDelete = true;
         }
     }
+    sk_sketchMarkChanged(args.activeSketch);
     return true;
 }
 
@@ -127,8 +130,8 @@ bool _scc_sketchAddDistanceConstraint(_sc_CommandFuncArgs args) {
     int selectedCount = 0;
     sk_Line* firstLine = NULL;
 
-    for (sk_Line* line = args.activeSketch->firstLine; line; line = line->next) {
-        if (line->sel.selected) {
+    for (sk_Line* line = sk_sketchFirstLine(args.activeSketch); line; line = sk_sketchNextLine(args.activeSketch, line)) {
+        if (sk_lineUi(args.activeSketch, line)->sel.selected) {
             firstLine = line;
             selectedCount++;
         }
@@ -140,9 +143,9 @@ bool _scc_sketchAddDistanceConstraint(_sc_CommandFuncArgs args) {
 
     float currentLength = HMM_Len(HMM_Sub(firstLine->p2->pos, firstLine->p1->pos));
     sk_Constraint* c = sk_sketchAddConstraintDistance(args.activeSketch, firstLine, currentLength);
-    c->uiInfo.shouldStartFocus = true;
+    sk_constraintUi(args.activeSketch, c)->shouldStartFocus = true;
     const char* str = sk_constraintLabelStr(c, args.scratch);
-    ui_textAreaSetStr(&c->uiInfo.textArea, str, strlen(str));
+    ui_textAreaSetStr(&sk_constraintUi(args.activeSketch, c)->textArea, str, strlen(str));
     return true;
 }
 
@@ -150,8 +153,8 @@ bool _scc_sketchAddDistanceConstraint(_sc_CommandFuncArgs args) {
 bool _scc_sketchAddAngleConstraint(_sc_CommandFuncArgs args) {
     int selectedCount = 0;
     sk_Line* lines[2] = { NULL, NULL };
-    for (sk_Line* line = args.activeSketch->firstLine; line; line = line->next) {
-        if (line->sel.selected) {
+    for (sk_Line* line = sk_sketchFirstLine(args.activeSketch); line; line = sk_sketchNextLine(args.activeSketch, line)) {
+        if (sk_lineUi(args.activeSketch, line)->sel.selected) {
             selectedCount++;
             if (selectedCount > 2) {
                 return true;
@@ -197,9 +200,9 @@ bool _scc_sketchAddAngleConstraint(_sc_CommandFuncArgs args) {
     } else {
         c = sk_sketchAddConstraintAngle(args.activeSketch, lines[0], !isP1OnLine1, lines[1], !isP1OnLine2, diff);
     }
-    c->uiInfo.shouldStartFocus = true;
+    sk_constraintUi(args.activeSketch, c)->shouldStartFocus = true;
     const char* str = sk_constraintLabelStr(c, args.scratch);
-    ui_textAreaSetStr(&c->uiInfo.textArea, str, strlen(str));
+    ui_textAreaSetStr(&sk_constraintUi(args.activeSketch, c)->textArea, str, strlen(str));
     return true;
 }
 
@@ -207,8 +210,8 @@ bool scc_sketchLineMode(_sc_CommandFuncArgs args) {
     if (args.firstFrame) {  // creating a line between two selected pts
         int ptCount = 0;
         sk_Point* pts[2] = { 0 };
-        for (sk_Point* p = args.activeSketch->firstPoint; p; p = p->next) {
-            if (p->sel.selected) {
+        for (sk_Point* p = sk_sketchFirstPoint(args.activeSketch); p; p = sk_sketchNextPoint(args.activeSketch, p)) {
+            if (sk_pointUi(args.activeSketch, p)->sel.selected) {
                 ptCount++;
                 if (ptCount > 2) {
                     break;
@@ -228,20 +231,20 @@ bool scc_sketchLineMode(_sc_CommandFuncArgs args) {
 
 // FIXME: rename this and move it to sketches2.h
 bool _sc_anySelectedInSketch(sk_Sketch* sketch) {
-    for (sk_Point* p = sketch->firstPoint; p; p = p->next) {
-        if (p->sel.selected) {
+    for (sk_Point* p = sk_sketchFirstPoint(sketch); p; p = sk_sketchNextPoint(sketch, p)) {
+        if (sk_pointUi(sketch, p)->sel.selected) {
             return true;
         }
     }
 
-    for (sk_Line* l = sketch->firstLine; l; l = l->next) {
-        if (l->sel.selected) {
+    for (sk_Line* l = sk_sketchFirstLine(sketch); l; l = sk_sketchNextLine(sketch, l)) {
+        if (sk_lineUi(sketch, l)->sel.selected) {
             return true;
         }
     }
 
-    for (sk_Constraint* c = sketch->firstConstraint; c; c = c->nextAllocated) {
-        if (c->uiInfo.sel.selected) {
+    for (sk_Constraint* c = sk_sketchFirstConstraint(sketch); c; c = sk_sketchNextConstraint(sketch, c)) {
+        if (sk_constraintUi(sketch, c)->sel.selected) {
             return true;
         }
     }
@@ -323,6 +326,38 @@ bool scc_timelineAddExtrude(_sc_CommandFuncArgs args) {
     return true;
 }
 
+static bool _scc_timelineAddPattern(_sc_CommandFuncArgs args, tl_OpKind kind, float count, float step) {
+    tl_Op* op = tl_timelinePushPattern(args.timeline, HMM_V2(0, 0), kind); // FIXME: smart positioning
+    op->ui.sel.selected = true;
+    op->ui.sel.selectionAnim = 1;
+    *args.argBarFocusOverride = op;
+
+    op->args[1].kind = TL_OPAK_NUMBER;
+    op->args[1].number = count;
+    op->args[2].kind = TL_OPAK_NUMBER;
+    op->args[2].number = step;
+    return true;
+}
+
+bool scc_timelineAddLinearPattern(_sc_CommandFuncArgs args) {
+    return _scc_timelineAddPattern(args, TL_OPK_LINEAR_PATTERN, 2, 1);
+}
+
+bool scc_timelineAddCircularPattern(_sc_CommandFuncArgs args) {
+    return _scc_timelineAddPattern(args, TL_OPK_CIRCULAR_PATTERN, 4, 90);
+}
+
+// ops that go away get culled by main next frame
+bool scc_undo(_sc_CommandFuncArgs args) {
+    tlu_undo(args.undo, args.timeline, args.scratch);
+    return true;
+}
+
+bool scc_redo(_sc_CommandFuncArgs args) {
+    tlu_redo(args.undo, args.timeline, args.scratch);
+    return true;
+}
+
 bool scc_timelineMarkActive(_sc_CommandFuncArgs args) {
     tl_Op* selected = NULL;
     for (tl_Op* op = args.timeline->firstOp; op; op = op->next) {
@@ -342,7 +377,7 @@ bool scc_timelineMarkActive(_sc_CommandFuncArgs args) {
 
     args.timeline->activeOp = selected;
     *args.currentView = SC_VIEW_SCENE;
-    *args.scene = tl_solveForNode(args.timeline, args.timeline->activeOp, args.scratch);
+    tl_solveStart(args.timeline, args.timeline->activeOp);  // scene gets swapped in by tl_solvePoll once done
     return true;
 }
 
@@ -412,7 +447,7 @@ bool scc_sceneLookAt(_sc_CommandFuncArgs args) {
         args.scene->orbitOrigin.pt = selected->cornerPos;
     } else if (selected->id.geoKind == MESH_GK_EDGE) {
         // FIXME: what about curved edges??
-        SNZ_ASSERTF(selected->edgePoints.count >= 2, "edge with only %lld point(s)", selected->edgePoints.count);
+        SNZ_ASSERTF(selected->edgePoints.count >= 2, "edge with only %" PRId64 " point(s)", selected->edgePoints.count);
         HMM_Vec3 p1 = selected->edgePoints.elems[0];
         HMM_Vec3 p2 = selected->edgePoints.elems[1];
         HMM_Vec3 dir = HMM_Norm(HMM_Sub(p2, p1));
@@ -488,7 +523,8 @@ bool scc_sceneTake(_sc_CommandFuncArgs args) {
             } else {
                 SNZ_ASSERTF(false, "unreachable. kind: %d", geo->id.geoKind);
             }
-            outArg.geoId = geo->id;
+            // scenes get thrown out every solve, the op arg has to live as long as the op
+            outArg.geoId = *mesh_geoIdDuplicate(&geo->id, args.timeline->operationArena);
             foundCount++;
         }
     }
@@ -538,6 +574,10 @@ void sc_init(PoolAlloc* pool) {
     _sc_commandInit("new geomety", "I", SDLK_i, KMOD_NONE, tlSketchOrScene, scc_timelineAddGeometry);
     _sc_commandInit("new sketch", "S", SDLK_s, KMOD_NONE, tlSketchOrScene, scc_timelineAddSketch);
     _sc_commandInit("extrude", "E", SDLK_e, KMOD_NONE, tlSketchOrScene, scc_timelineAddExtrude);
+    _sc_commandInit("linear pattern", "P", SDLK_p, KMOD_NONE, tlSketchOrScene, scc_timelineAddLinearPattern);
+    _sc_commandInit("circular pattern", "C", SDLK_c, KMOD_NONE, tlSketchOrScene, scc_timelineAddCircularPattern);
+    _sc_commandInit("undo", "Ctrl Z", SDLK_z, KMOD_LCTRL, tlSketchOrScene, scc_undo);
+    _sc_commandInit("redo", "Ctrl Z", SDLK_z, (SDL_Keymod)(KMOD_LCTRL | KMOD_LSHIFT), tlSketchOrScene, scc_redo);
 
     // FIXME: these shouldn't be availible if geo filter is turned off
     // but they should give a warning/err msg to let the user know that the filter is disabled
@@ -621,6 +661,7 @@ void sc_updateAndBuildHintWindow(
     mesh_GeoKind* outGeoFilter,
     mesh_Scene* scene,
     tl_Op** argBarFocusOverride,
+    tlu_History* undo,
     snz_Arena* scratch,
     bool targetOpen) {
     snzu_boxNew("updatesParent");
@@ -634,6 +675,7 @@ void sc_updateAndBuildHintWindow(
         .outGeoFilter = outGeoFilter,
         .firstFrame = false,
         .argBarFocusOverride = argBarFocusOverride,
+        .undo = undo,
         .scene = scene,
     };
 
@@ -3,6 +3,7 @@
 #include "snooze.h"
 #include "sketches2.h"
 #include "mesh.h"
+#include "jobs.h"
 
 typedef struct _skt_Island _skt_Island;
 typedef struct _skt_Point _skt_Point;
@@ -109,7 +110,7 @@ bool _skt_vertLoopContainsPoint(_skt_VertLoop* l, HMM_Vec2 pt) {
 // checks only that B is inside of A
 // FIXME: tests
 bool _skt_vertLoopContainsVertLoop(_skt_VertLoop* a, _skt_VertLoop* b) {
-    SNZ_ASSERTF(b->pts.count > 0, "Vert loop with zero or less points. Had: %lld", b->pts.count);
+    SNZ_ASSERTF(b->pts.count > 0, "Vert loop with zero or less points. Had: %" PRId64, b->pts.count);
     bool ptInside = _skt_vertLoopContainsPoint(a, b->pts.elems[0]);
     if (!ptInside) {
         return false;
@@ -137,19 +138,19 @@ bool _skt_vertLoopContainsVertLoop(_skt_VertLoop* a, _skt_VertLoop* b) {
 //     }
 // }
 
-static mesh_Face _skt_vertLoopToMeshFace(int64_t opUniqueId, _skt_VertLoop* l, snz_Arena* scratch, snz_Arena* out) {
-    mesh_Face f = { 0 };
-    f.id = (mesh_GeoID){
-        .geoKind = MESH_GK_FACE,
-        .opUniqueId = opUniqueId,
-        .baseNodeId = l->sumOfLineUidHashes,
-    };
+// every tri culls one point, and it stops with two left, so a loop never makes more than this many
+static int64_t _skt_vertLoopMaxTris(const _skt_VertLoop* l) {
+    return SNZ_MAX(l->pts.count - 2, 0);
+}
 
+// ear clips l into outTris, which needs room for _skt_vertLoopMaxTris. Returns how many got written.
+// Only reads l, so different loops can go at the same time as long as they have different scratch.
+static int64_t _skt_vertLoopClip(const _skt_VertLoop* l, geo_Tri* outTris, snz_Arena* scratch) {
     // FIXME: move this data to be inline with the vert loop points ? // actually also profile if that is worth doing
     bool* culledFlags = SNZ_ARENA_PUSH_ARR(scratch, l->pts.count, bool);
     int culledCount = 0;
+    int64_t triCount = 0;
 
-    SNZ_ARENA_ARR_BEGIN(out, geo_Tri);
     int iterationsSinceTriWasAdded = 0;
     for (int startIdx = 0; true; (startIdx++, iterationsSinceTriWasAdded++)) {
         if (iterationsSinceTriWasAdded > l->pts.count) {
@@ -206,13 +207,22 @@ static mesh_Face _skt_vertLoopToMeshFace(int64_t opUniqueId, _skt_VertLoop* l, s
             continue;
         }
 
-        *SNZ_ARENA_PUSH(out, geo_Tri) = t;
+        outTris[triCount++] = t;
         culledFlags[ptIndexes[1]] = true;
         culledCount++;
         iterationsSinceTriWasAdded = 0;
     }
-    f.tris = SNZ_ARENA_ARR_END(out, geo_Tri);
-    return f;
+    return triCount;
+}
+
+typedef struct {
+    const _skt_VertLoop* loop;
+    mesh_Face* face; // tris has to be pushed already with room for _skt_vertLoopMaxTris, count gets set here
+} _skt_VertLoopClipJob;
+
+static void _skt_vertLoopClipJob(job_Worker* w, void* data) {
+    _skt_VertLoopClipJob* job = (_skt_VertLoopClipJob*)data;
+    job->face->tris.count = _skt_vertLoopClip(job->loop, job->face->tris.elems, &w->scratch);
 }
 
 typedef struct _skt_IntersectionEdge _skt_IntersectionEdge;
@@ -227,30 +237,21 @@ struct _skt_IntersectionEdge {
     bool culled;
 };
 
-// https://zimbry.blogspot.com/2011/09/better-bit-mixing-improving-on.html
-static int64_t _skt_hashUid(int64_t id) {
-    uint64_t out = id;
-    out ^= (out >> 33);
-    out *= 0xff51afd7ed558ccd;
-    out ^= (out >> 33);
-    out *= 0xc4ceb9fe1a85ec53;
-    out ^= (out >> 33);
-    return out;
-}
-
 // FIXME: does this function gauranteed crash on a malformed sketch??
 // FIXME: exhaustive checks to make sure that there aren't any colinear & fully overlapped edges in the sketch before starting this
 // FIXME: decide whether we are going to cope with T intersections here, and if not, add checks to make sure they don't exist on inputs
 // arena and scratch can be the same arena
 // uid used to correctly fill in geoIds for the results
-void skt_sketchTriangulate(const sk_Sketch* sketch, mesh_FaceSlice* outFaces, mesh_TempGeo* outTempGeo, int64_t opUid, snz_Arena* arena, snz_Arena* scratch) {
+// w is optional, with one each loop gets ear clipped as it's own job. Without it they all go one by one on this thread.
+void skt_sketchTriangulate(const sk_Sketch* sketch, mesh_FaceSlice* outFaces, mesh_TempGeo* outTempGeo, int64_t opUid, job_Worker* w, snz_Arena* arena, snz_Arena* scratch) {
+    prof_count(PROF_CK_SKETCH_TRIANGULATIONS, 1);
     _skt_Point* firstPoint = NULL;
     _skt_IntersectionEdge* firstIntersectionEdge = NULL;
     { // intersections
         // import pts
         SNZ_ARENA_ARR_BEGIN(scratch, _skt_Point);
         int i = 0;
-        for (sk_Point* p = sketch->firstPoint; p; p = p->next) {
+        for (sk_Point* p = sk_sketchFirstPoint(sketch); p; p = sk_sketchNextPoint(sketch, p)) {
             p->indexIntoSketch = i;
             _skt_Point* pt = SNZ_ARENA_PUSH(scratch, _skt_Point);
             *pt = (_skt_Point){
@@ -266,7 +267,7 @@ void skt_sketchTriangulate(const sk_Sketch* sketch, mesh_FaceSlice* outFaces, me
 
         // import lines
         int edgeCount = 0;
-        for (sk_Line* l = sketch->firstLine; l;l = l->next) {
+        for (sk_Line* l = sk_sketchFirstLine(sketch); l; l = sk_sketchNextLine(sketch, l)) {
             _skt_IntersectionEdge* e = SNZ_ARENA_PUSH(scratch, _skt_IntersectionEdge);
             *e = (_skt_IntersectionEdge){
                 .sourceUniqueId = l->uniqueId,
@@ -304,7 +305,7 @@ void skt_sketchTriangulate(const sk_Sketch* sketch, mesh_FaceSlice* outFaces, me
                     newPt->dbgIndex = (int)(uint64_t)newPt;
                     newPt->pos = HMM_Lerp(edge->p1->pos, t, edge->p2->pos);
                     newPt->next = firstPoint;
-                    newPt->sourceUniqueId = _skt_hashUid(edge->sourceUniqueId) + _skt_hashUid(edge->sourceUniqueId);
+                    newPt->sourceUniqueId = (int64_t)snz_hashMix64(edge->sourceUniqueId) + (int64_t)snz_hashMix64(edge->sourceUniqueId);
                     firstPoint = newPt;
 
                     // create new edges
@@ -404,7 +405,7 @@ void skt_sketchTriangulate(const sk_Sketch* sketch, mesh_FaceSlice* outFaces, me
             if (p->edges.count == 0) {
                 continue;
             }
-            SNZ_ASSERTF(p->edges.count >= 2, "Pt with only %lld adj.", p->edges.count);
+            SNZ_ASSERTF(p->edges.count >= 2, "Pt with only %" PRId64 " adj.", p->edges.count);
             p->next = newFirstPt;
             newFirstPt = p;
         }
@@ -442,7 +443,7 @@ void skt_sketchTriangulate(const sk_Sketch* sketch, mesh_FaceSlice* outFaces, me
                     edge->traversed = true;
                     prevPt = p;
                     currentPt = edge->other;
-                    lineIdHashSum += _skt_hashUid(edge->sourceUniqueId);
+                    lineIdHashSum += (int64_t)snz_hashMix64(edge->sourceUniqueId);
 
                     p = NULL; // break outer
                     break;
@@ -486,7 +487,7 @@ void skt_sketchTriangulate(const sk_Sketch* sketch, mesh_FaceSlice* outFaces, me
                     maxAngle = angle;
                 }
             }
-            lineIdHashSum += _skt_hashUid(selected->sourceUniqueId);
+            lineIdHashSum += (int64_t)snz_hashMix64(selected->sourceUniqueId);
 
             prevPt = currentPt;
             selected->traversed = true;
@@ -566,13 +567,32 @@ void skt_sketchTriangulate(const sk_Sketch* sketch, mesh_FaceSlice* outFaces, me
             .elems = SNZ_ARENA_PUSH_ARR(arena, faceCount, mesh_Face),
         };
 
+        // tris get pushed up front so jobs never touch arena, anything a loop doesn't use is just left empty at the end
+        _skt_VertLoopClipJob* jobs = SNZ_ARENA_PUSH_ARR(scratch, faceCount, _skt_VertLoopClipJob);
+        SDL_atomic_t pending = { 0 };
         int64_t i = 0;
         for (_skt_Island* island = firstIsland; island; island = island->next) {
             for (_skt_VertLoop* l = island->firstLoop; l; l = l->next) {
-                faces.elems[i] = _skt_vertLoopToMeshFace(opUid, l, scratch, arena);
+                faces.elems[i] = (mesh_Face){
+                    .id = (mesh_GeoID){
+                        .geoKind = MESH_GK_FACE,
+                        .opUniqueId = opUid,
+                        .baseNodeId = l->sumOfLineUidHashes,
+                    },
+                    .tris.elems = SNZ_ARENA_PUSH_ARR(arena, _skt_vertLoopMaxTris(l), geo_Tri),
+                };
+                jobs[i] = (_skt_VertLoopClipJob){ .loop = l, .face = &faces.elems[i] };
+                if (w && faceCount > 1) {
+                    job_push(w, _skt_vertLoopClipJob, &jobs[i], &pending);
+                } else {
+                    faces.elems[i].tris.count = _skt_vertLoopClip(l, faces.elems[i].tris.elems, scratch);
+                }
                 i++;
             }
         }
+        if (w) {
+            job_wait(w, &pending);
+        }
 
         *outFaces = faces;
     }
@@ -637,4 +657,48 @@ void skt_tests() {
     }
     // FIXME: more tests for triangulating a vertloop
     // FIXME: many more tests + maybe a fuzzer for skt_sketchTriangulate
+
+    {
+        snz_Arena arena = snz_arenaInitGrowable(1000000, "skt test arena");
+        snz_Arena scratch = snz_arenaInitGrowable(1000000, "skt test scratch");
+        sk_Sketch sketch = sk_sketchInit(&arena);
+        for (int i = 0; i < 12; i++) {  // separate polygons, so a loop each
+            HMM_Vec2 center = HMM_V2(10 + (i % 4) * 10, 10 + (i / 4) * 10);
+            int sides = 3 + i * 5;
+            sk_Point* first = NULL;
+            sk_Point* prev = NULL;
+            for (int j = 0; j < sides; j++) {
+                float angle = (float)j / sides * 2 * HMM_PI32;
+                sk_Point* p = sk_sketchAddPoint(&sketch, HMM_Add(center, HMM_V2(cosf(angle) * 3, sinf(angle) * 3)));
+                if (prev) {
+                    sk_sketchAddLine(&sketch, prev, p);
+                } else {
+                    first = p;
+                }
+                prev = p;
+            }
+            sk_sketchAddLine(&sketch, prev, first);
+        }
+
+        mesh_FaceSlice serialFaces = { 0 };
+        mesh_TempGeo serialGeo = { 0 };
+        skt_sketchTriangulate(&sketch, &serialFaces, &serialGeo, 1, NULL, &arena, &scratch);
+
+        job_System* jobs = job_systemInit(3, 1000000);
+        mesh_FaceSlice jobFaces = { 0 };
+        mesh_TempGeo jobGeo = { 0 };
+        skt_sketchTriangulate(&sketch, &jobFaces, &jobGeo, 1, job_systemCaller(jobs), &arena, &scratch);
+        job_systemDeinit(jobs);
+
+        bool correct = serialFaces.count == jobFaces.count && serialFaces.count >= 12;
+        for (int64_t i = 0; correct && i < serialFaces.count; i++) {
+            mesh_Face* a = &serialFaces.elems[i];
+            mesh_Face* b = &jobFaces.elems[i];
+            correct &= a->id.baseNodeId == b->id.baseNodeId && a->tris.count == b->tris.count && a->tris.count > 0;
+            correct &= memcmp(a->tris.elems, b->tris.elems, a->tris.count * sizeof(geo_Tri)) == 0;
+        }
+        snz_testPrint(correct, "loops triangulated as jobs match doing them one by one");
+        snz_arenaDeinit(&arena);
+        snz_arenaDeinit(&scratch);
+    }
 }
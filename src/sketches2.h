@@ -7,6 +7,7 @@
 #include "snooze.h"
 #include "ui.h"
 #include "mesh.h"
+#include "prof.h"
 
 typedef enum {
     SK_MK_ANY,
@@ -39,17 +40,32 @@ typedef struct {
 typedef struct sk_Point sk_Point;
 struct sk_Point {
     HMM_Vec2 pos;
-    sk_Point* next;
     sk_Manifold manifold;
-    int indexIntoSketch; // temp var for triangulation
+    int64_t slot;  // where this is in sketch->points, never changes while the pt is alive
+    int indexIntoSketch; // temp var for triangulation and solving
     int64_t uniqueId; // used for safer ops_GeoRefs
     bool solved;
     bool markedForDelete;
 
+    // rigid clusters, built by _sk_sketchBuildClusters and good until sketch->clusterHash doesn't match
+    struct {
+        sk_Point* root;  // NULL for pts the constructive pass placed, those are all one cluster fixed to the origin
+        sk_Point* next;  // thru every pt in the cluster, starting at root
+        struct sk_Constraint* firstConstraint;  // only on roots, everything touching a pt in the cluster
+        bool dirty;  // only on roots
+        double lambda;  // only on roots, damping the last solve converged with. zero to start over
+        uint64_t inputHash;  // only on roots, _sk_clusterInputHash as of the last solve
+        HMM_Vec2 solvedPos;  // where the last solve left this, anything else means it was dragged
+    } cluster;
+};
+
+// ui state lives in its own column of the pool, so the solver doesn't drag it thru the cache. see sk_pointUi
+typedef struct {
     bool inDragZone;
+    bool hovered;  // set by sketchui for the pts near the mouse, cleared once it's read
     float scaleFactor;
     ui_SelectionState sel;
-};
+} sk_PointUi;
 
 typedef struct sk_Line sk_Line;
 struct sk_Line {
@@ -60,15 +76,18 @@ struct sk_Line {
         };
         sk_Point* pts[2];
     };
-    sk_Line* next;
+    int64_t slot;  // see sk_Point.slot
     int64_t uniqueId; // used for safer ops_GeoRefs
     bool angleApplied;
     bool angleSolved;
     float expectedAngle;  // from p1 to p2, may not be normalized
     bool markedForDelete;
+};
 
+typedef struct {
+    bool hovered;  // see sk_PointUi.hovered
     ui_SelectionState sel;
-};
+} sk_LineUi;
 
 typedef enum {
     SK_CK_DISTANCE,
@@ -90,22 +109,24 @@ struct sk_Constraint {
 
     bool violated;
     bool markedForDelete;
+    bool applied;  // by the constructive pass, temp
 
-    sk_Constraint* nextAllocated;
-    sk_Constraint* nextUnapplied;
+    sk_Constraint* nextInCluster;
+    int64_t slot;  // see sk_Point.slot
     int64_t uniqueId; // used for safer ops_GeoRefs
-
-    // ui info things
-    struct {
-        ui_TextArea textArea;
-        ui_SelectionState sel;
-
-        HMM_Vec4 drawnColor;
-        HMM_Vec2 visualCenter;
-        float scaleFactor;
-        bool shouldStartFocus;  // used by the shortcut system to signal the constraints text box, FIXME: it's bad but works
-    } uiInfo;
 };
+
+// ui info things
+typedef struct {
+    ui_TextArea textArea;
+    ui_SelectionState sel;
+
+    HMM_Vec4 drawnColor;
+    HMM_Vec2 visualCenter;
+    float scaleFactor;
+    bool hovered;  // see sk_PointUi.hovered
+    bool shouldStartFocus;  // used by the shortcut system to signal the constraints text box, FIXME: it's bad but works
+} sk_ConstraintUi;
 // FIXME: opaque types for all of these
 
 // FIXME: this should not be here, but has to bc. import problems
@@ -116,43 +137,516 @@ const char* sk_constraintLabelStr(sk_Constraint* c, snz_Arena* scratch) {
     } else if (c->kind == SK_CK_DISTANCE) {
         return snz_arenaFormatStr(scratch, "%.2fm", c->value);
     } else {
-        SNZ_ASSERTF(false, "unreachable. kind: %d", c);
+        SNZ_ASSERTF(false, "unreachable. kind: %d", c->kind);
         return NULL;
     }
 }
 
 typedef struct {
-    sk_Point* firstPoint;
-    sk_Line* firstLine;
-    sk_Constraint* firstConstraint;
+    int64_t iterations;  // of the numeric solve, zero when the constructive pass placed everything
+    int64_t variableCount;  // x & y of every point the constructive pass couldn't place
+    int64_t equationCount;  // constraints touching any of those points
+    // variables - equations. FIXME: doesn't know about redundant constraints, so consistent but overconstrained sketches go negative
+    int64_t dof;
+    float maxResidual;  // worst constraint error after solving, meters or rads
+    int64_t violatedCount;
+    int64_t clusterCount;  // not counting the one the constructive pass placed
+    int64_t clustersSolved;  // less than clusterCount when only dragged ones needed it
+    bool coldStart;  // clusters were rebuilt, instead of picking up from the last solve
+} sk_SolveStats;
+
+typedef struct {
+    sk_Point* a;  // the lower address of the two, so either order finds it
+    sk_Point* b;
+    sk_Line* line;  // NULL for an empty slot
+} _sk_LineTableSlot;
+
+// open addressing w/ linear probing, unordered pt pair -> the line between them, for every line in the sketch.
+// slots are in the sketches arena. zeroed is fine, it gets built from the line list the first time it's needed.
+typedef struct {
+    _sk_LineTableSlot* slots;
+    int64_t capacity;  // always a power of two
+    int64_t count;
+    bool built;  // false when lines were changed w/o keeping this up to date, see _sk_lineTableBuild
+} _sk_LineTable;
+
+// pages double in size after the first two, so a pool is only ever a couple of them and a copy of a small sketch is small
+#define _SK_POOL_FIRST_PAGE_BITS 4
+#define _SK_POOL_MAX_PAGES 32
+
+typedef struct {
+    int64_t nextFree;  // slot + 1, zero at either end of the free list
+    int64_t prevFree;
+    uint32_t generation;  // bumped every time the slot gets freed, see sk_PointHandle. zero before its first use
+    bool live;
+} _sk_PoolSlot;
+
+// index addressed storage for one kind of sketch elt. each page holds a column per thing a slot has: the bookkeeping
+// above, then the elts, then their ui state. so a loop over elts is a walk down one array w/o touching the other two.
+// elts are all over the place by ptr (lines -> pts, clusters, sketchui), so pages never move once they're pushed,
+// growing adds a new one instead.
+// zeroed is an empty pool. pages are in the sketches arena, freed slots get reused before a new one is handed out.
+typedef struct {
+    char* pages[_SK_POOL_MAX_PAGES];
+    int64_t count;  // slots handed out so far, live or free. every slot below this is in a page
+    int64_t liveCount;
+    int64_t firstFree;  // slot + 1, zero when there aren't any
+} _sk_Pool;
+
+typedef struct {
+    // every elt in the sketch. loop over them w/ sk_sketchFirstPoint + sk_sketchNextPoint (and the same for lines and
+    // constraints), which goes in slot order.
+    _sk_Pool points;  // sk_Point + sk_PointUi
+    _sk_Pool lines;  // sk_Line + sk_LineUi
+    _sk_Pool constraints;  // sk_Constraint + sk_ConstraintUi
     // increments on add, gives a unique number (within one sketch) to each point, line, and constraint
     // used to correctly break ops_GeoRefs when an elt gets deleted and the memory pooled
     int64_t nextUniqueId;
 
-    sk_Constraint* firstUnappliedConstraint;
-
     sk_Point* originPt;
     sk_Line* originLine;
     float originAngle;
 
+    sk_SolveStats solveStats;  // from the last sk_sketchSolve
+    // bumped by everything in here that changes the sketch, and sk_sketchMarkChanged for edits made straight to elts.
+    // selection + other ui state doesn't count.
+    uint64_t version;
+    uint64_t solvedVersion;  // version as of the last sk_sketchSolve
+    uint64_t clusterHash;  // _sk_sketchStructureHash of the sketch when the clusters on its pts were built
+    uint64_t valueHash;  // _sk_sketchValueHash as of the last solve
+
+    _sk_LineTable lineTable;  // kept in sync by sk_sketchAddLine and sk_sketchFreeLine
+
     snz_Arena* arena;
 } sk_Sketch;
 
+// page 0 and 1 are 1 << _SK_POOL_FIRST_PAGE_BITS slots, every one after is twice the last
+static int64_t _sk_poolPageCapacity(int64_t page) {
+    return (int64_t)1 << (_SK_POOL_FIRST_PAGE_BITS + SNZ_MAX(page - 1, 0));
+}
+
+static int64_t _sk_poolPageOf(int64_t slot, int64_t* outOffset) {
+    if (slot < ((int64_t)1 << _SK_POOL_FIRST_PAGE_BITS)) {
+        *outOffset = slot;
+        return 0;
+    }
+    int64_t highBit = 0;
+    for (int64_t shift = 32; shift > 0; shift /= 2) {
+        if (((uint64_t)slot >> highBit) >> shift) {
+            highBit += shift;
+        }
+    }
+    *outOffset = slot - ((int64_t)1 << highBit);
+    return highBit - _SK_POOL_FIRST_PAGE_BITS + 1;
+}
+
+// columns start 16 aligned, the ui ones have HMM vecs in them
+static int64_t _sk_poolColumnBytes(int64_t capacity, int64_t size) {
+    return (capacity * size + 15) & ~(int64_t)15;
+}
+
+typedef struct {
+    _sk_PoolSlot* slot;
+    char* elt;
+    char* ui;
+} _sk_PoolEntry;
+
+static _sk_PoolEntry _sk_poolGet(const _sk_Pool* pool, int64_t slot, int64_t eltSize, int64_t uiSize) {
+    SNZ_ASSERTF(slot >= 0 && slot < pool->count, "sketch pool slot %" PRId64 " out of range.", slot);
+    int64_t offset = 0;
+    int64_t page = _sk_poolPageOf(slot, &offset);
+    int64_t capacity = _sk_poolPageCapacity(page);
+    char* slots = pool->pages[page];
+    char* elts = slots + _sk_poolColumnBytes(capacity, sizeof(_sk_PoolSlot));
+    char* uis = elts + _sk_poolColumnBytes(capacity, eltSize);
+    return (_sk_PoolEntry){
+        .slot = &((_sk_PoolSlot*)slots)[offset],
+        .elt = elts + offset * eltSize,
+        .ui = uis + offset * uiSize,
+    };
+}
+
+static void _sk_poolFreeListPush(_sk_Pool* pool, int64_t slot, int64_t eltSize, int64_t uiSize) {
+    _sk_PoolSlot* s = _sk_poolGet(pool, slot, eltSize, uiSize).slot;
+    s->prevFree = 0;
+    s->nextFree = pool->firstFree;
+    if (pool->firstFree) {
+        _sk_poolGet(pool, pool->firstFree - 1, eltSize, uiSize).slot->prevFree = slot + 1;
+    }
+    pool->firstFree = slot + 1;
+}
+
+static void _sk_poolFreeListRemove(_sk_Pool* pool, int64_t slot, int64_t eltSize, int64_t uiSize) {
+    _sk_PoolSlot* s = _sk_poolGet(pool, slot, eltSize, uiSize).slot;
+    if (s->prevFree) {
+        _sk_poolGet(pool, s->prevFree - 1, eltSize, uiSize).slot->nextFree = s->nextFree;
+    } else {
+        pool->firstFree = s->nextFree;
+    }
+    if (s->nextFree) {
+        _sk_poolGet(pool, s->nextFree - 1, eltSize, uiSize).slot->prevFree = s->prevFree;
+    }
+    s->nextFree = 0;
+    s->prevFree = 0;
+}
+
+// one more slot on the end, not live and not in the free list
+static int64_t _sk_poolGrow(_sk_Pool* pool, int64_t eltSize, int64_t uiSize, snz_Arena* arena) {
+    int64_t offset = 0;
+    int64_t page = _sk_poolPageOf(pool->count, &offset);
+    SNZ_ASSERTF(page < _SK_POOL_MAX_PAGES, "sketch pool out of pages at %" PRId64 " slots.", pool->count);
+    if (!pool->pages[page]) {
+        int64_t capacity = _sk_poolPageCapacity(page);
+        int64_t bytes = _sk_poolColumnBytes(capacity, sizeof(_sk_PoolSlot)) + _sk_poolColumnBytes(capacity, eltSize) +
+                        _sk_poolColumnBytes(capacity, uiSize);
+        pool->pages[page] = snz_arenaPushAligned(arena, 1, bytes, 16);
+    }
+    pool->count++;
+    return pool->count - 1;
+}
+
+// makes slot live, w/ its elt + ui zeroed. slot has to be free or past the end of the pool.
+static void _sk_poolClaim(_sk_Pool* pool, int64_t slot, int64_t eltSize, int64_t uiSize, snz_Arena* arena) {
+    while (pool->count <= slot) {
+        int64_t grown = _sk_poolGrow(pool, eltSize, uiSize, arena);
+        if (grown != slot) {
+            _sk_poolFreeListPush(pool, grown, eltSize, uiSize);
+        }
+    }
+    _sk_PoolEntry e = _sk_poolGet(pool, slot, eltSize, uiSize);
+    SNZ_ASSERTF(!e.slot->live, "claiming sketch pool slot %" PRId64 " that's already live.", slot);
+    if (e.slot->nextFree || e.slot->prevFree || pool->firstFree == slot + 1) {
+        _sk_poolFreeListRemove(pool, slot, eltSize, uiSize);
+    }
+    e.slot->live = true;
+    e.slot->generation += e.slot->generation == 0;
+    pool->liveCount++;
+}
+
+// the last slot freed, or a new one if there aren't any
+static int64_t _sk_poolAlloc(_sk_Pool* pool, int64_t eltSize, int64_t uiSize, snz_Arena* arena) {
+    int64_t slot = pool->firstFree ? pool->firstFree - 1 : pool->count;
+    _sk_poolClaim(pool, slot, eltSize, uiSize, arena);
+    return slot;
+}
+
+static void _sk_poolFree(_sk_Pool* pool, int64_t slot, int64_t eltSize, int64_t uiSize) {
+    _sk_PoolEntry e = _sk_poolGet(pool, slot, eltSize, uiSize);
+    SNZ_ASSERTF(e.slot->live, "freeing sketch pool slot %" PRId64 " that isn't live.", slot);
+    memset(e.elt, 0, eltSize);
+    memset(e.ui, 0, uiSize);
+    e.slot->live = false;
+    e.slot->generation++;
+    _sk_poolFreeListPush(pool, slot, eltSize, uiSize);
+    pool->liveCount--;
+}
+
+// the first live elt at or after slot, NULL if there aren't any
+static void* _sk_poolNext(const _sk_Pool* pool, int64_t slot, int64_t eltSize, int64_t uiSize) {
+    while (slot < pool->count) {
+        int64_t offset = 0;
+        int64_t page = _sk_poolPageOf(slot, &offset);
+        int64_t end = SNZ_MIN(_sk_poolPageCapacity(page), offset + pool->count - slot);
+        _sk_PoolEntry e = _sk_poolGet(pool, slot, eltSize, uiSize);
+        for (int64_t i = 0; i < end - offset; i++) {
+            if (e.slot[i].live) {
+                return e.elt + i * eltSize;
+            }
+        }
+        slot += end - offset;
+    }
+    return NULL;
+}
+
+// same slots, so elts in the copy are at the same index as in src. ptrs in the elts still go into src.
+static _sk_Pool _sk_poolDuplicate(const _sk_Pool* src, int64_t eltSize, int64_t uiSize, snz_Arena* arena) {
+    _sk_Pool out = *src;
+    for (int64_t page = 0; page < _SK_POOL_MAX_PAGES && src->pages[page]; page++) {
+        int64_t capacity = _sk_poolPageCapacity(page);
+        int64_t bytes = _sk_poolColumnBytes(capacity, sizeof(_sk_PoolSlot)) + _sk_poolColumnBytes(capacity, eltSize) +
+                        _sk_poolColumnBytes(capacity, uiSize);
+        out.pages[page] = snz_arenaPushAligned(arena, 1, bytes, 16);
+        memcpy(out.pages[page], src->pages[page], bytes);
+    }
+    return out;
+}
+
+// NULL when nothing is in the slot
+sk_Point* sk_sketchPointAt(const sk_Sketch* sketch, int64_t slot) {
+    if (slot < 0 || slot >= sketch->points.count) {
+        return NULL;
+    }
+    _sk_PoolEntry e = _sk_poolGet(&sketch->points, slot, sizeof(sk_Point), sizeof(sk_PointUi));
+    return e.slot->live ? (sk_Point*)e.elt : NULL;
+}
+
+sk_Line* sk_sketchLineAt(const sk_Sketch* sketch, int64_t slot) {
+    if (slot < 0 || slot >= sketch->lines.count) {
+        return NULL;
+    }
+    _sk_PoolEntry e = _sk_poolGet(&sketch->lines, slot, sizeof(sk_Line), sizeof(sk_LineUi));
+    return e.slot->live ? (sk_Line*)e.elt : NULL;
+}
+
+sk_Constraint* sk_sketchConstraintAt(const sk_Sketch* sketch, int64_t slot) {
+    if (slot < 0 || slot >= sketch->constraints.count) {
+        return NULL;
+    }
+    _sk_PoolEntry e = _sk_poolGet(&sketch->constraints, slot, sizeof(sk_Constraint), sizeof(sk_ConstraintUi));
+    return e.slot->live ? (sk_Constraint*)e.elt : NULL;
+}
+
+sk_Point* sk_sketchFirstPoint(const sk_Sketch* sketch) {
+    return _sk_poolNext(&sketch->points, 0, sizeof(sk_Point), sizeof(sk_PointUi));
+}
+
+// NULL after the last one. p can have been freed since the last call, its slot stays put
+sk_Point* sk_sketchNextPoint(const sk_Sketch* sketch, const sk_Point* p) {
+    return _sk_poolNext(&sketch->points, p->slot + 1, sizeof(sk_Point), sizeof(sk_PointUi));
+}
+
+sk_Line* sk_sketchFirstLine(const sk_Sketch* sketch) {
+    return _sk_poolNext(&sketch->lines, 0, sizeof(sk_Line), sizeof(sk_LineUi));
+}
+
+sk_Line* sk_sketchNextLine(const sk_Sketch* sketch, const sk_Line* l) {
+    return _sk_poolNext(&sketch->lines, l->slot + 1, sizeof(sk_Line), sizeof(sk_LineUi));
+}
+
+sk_Constraint* sk_sketchFirstConstraint(const sk_Sketch* sketch) {
+    return _sk_poolNext(&sketch->constraints, 0, sizeof(sk_Constraint), sizeof(sk_ConstraintUi));
+}
+
+sk_Constraint* sk_sketchNextConstraint(const sk_Sketch* sketch, const sk_Constraint* c) {
+    return _sk_poolNext(&sketch->constraints, c->slot + 1, sizeof(sk_Constraint), sizeof(sk_ConstraintUi));
+}
+
+sk_PointUi* sk_pointUi(const sk_Sketch* sketch, const sk_Point* p) {
+    return (sk_PointUi*)_sk_poolGet(&sketch->points, p->slot, sizeof(sk_Point), sizeof(sk_PointUi)).ui;
+}
+
+sk_LineUi* sk_lineUi(const sk_Sketch* sketch, const sk_Line* l) {
+    return (sk_LineUi*)_sk_poolGet(&sketch->lines, l->slot, sizeof(sk_Line), sizeof(sk_LineUi)).ui;
+}
+
+sk_ConstraintUi* sk_constraintUi(const sk_Sketch* sketch, const sk_Constraint* c) {
+    return (sk_ConstraintUi*)_sk_poolGet(&sketch->constraints, c->slot, sizeof(sk_Constraint), sizeof(sk_ConstraintUi)).ui;
+}
+
+// for holding onto a pt across frames, when it could get deleted and have its slot reused in between.
+// zeroed never resolves.
+typedef struct {
+    int64_t slot;
+    uint32_t generation;
+} sk_PointHandle;
+
+sk_PointHandle sk_pointHandle(const sk_Sketch* sketch, const sk_Point* p) {
+    if (!p) {
+        return (sk_PointHandle){ 0 };
+    }
+    _sk_PoolEntry e = _sk_poolGet(&sketch->points, p->slot, sizeof(sk_Point), sizeof(sk_PointUi));
+    return (sk_PointHandle){ .slot = p->slot, .generation = e.slot->generation };
+}
+
+// NULL if the pt has been deleted since the handle was made
+sk_Point* sk_pointHandleGet(const sk_Sketch* sketch, sk_PointHandle h) {
+    sk_Point* p = sk_sketchPointAt(sketch, h.slot);
+    if (p && _sk_poolGet(&sketch->points, h.slot, sizeof(sk_Point), sizeof(sk_PointUi)).slot->generation == h.generation) {
+        return p;
+    }
+    return NULL;
+}
+
+static int64_t _sk_lineTableFirstSlot(const _sk_LineTable* table, const sk_Point* a, const sk_Point* b) {
+    uint64_t hash = (uint64_t)(uintptr_t)a * 0x9e3779b97f4a7c15ULL;
+    hash ^= (uint64_t)(uintptr_t)b + (hash >> 29);
+    hash = snz_hashMix64(hash);
+    return (int64_t)(hash & (uint64_t)(table->capacity - 1));
+}
+
+// doesn't grow, see _sk_lineTableInsert
+static void _sk_lineTableInsertSlot(_sk_LineTable* table, sk_Line* line) {
+    sk_Point* a = line->p1 < line->p2 ? line->p1 : line->p2;
+    sk_Point* b = line->p1 < line->p2 ? line->p2 : line->p1;
+    int64_t i = _sk_lineTableFirstSlot(table, a, b);
+    while (table->slots[i].line) {
+        i = (i + 1) & (table->capacity - 1);
+    }
+    table->slots[i] = (_sk_LineTableSlot){ .a = a, .b = b, .line = line };
+    table->count++;
+}
+
+// everything in the line list goes back in, growing so there's room for at least extraCount more
+static void _sk_lineTableBuild(sk_Sketch* sketch, int64_t extraCount) {
+    _sk_LineTable* table = &sketch->lineTable;
+    int64_t lineCount = sketch->lines.liveCount;
+
+    // 70% max load. old slots stay in the arena when this grows, but they're at most as many as the new ones
+    int64_t capacity = SNZ_MAX(table->capacity, 64);
+    while ((lineCount + extraCount) * 10 > capacity * 7) {
+        capacity *= 2;
+    }
+    if (capacity != table->capacity || !table->slots) {
+        table->slots = SNZ_ARENA_PUSH_ARR(sketch->arena, capacity, _sk_LineTableSlot);
+        table->capacity = capacity;
+    } else {
+        memset(table->slots, 0, sizeof(*table->slots) * table->capacity);
+    }
+
+    table->count = 0;
+    for (sk_Line* l = sk_sketchFirstLine(sketch); l; l = sk_sketchNextLine(sketch, l)) {
+        _sk_lineTableInsertSlot(table, l);
+    }
+    table->built = true;
+}
+
+static void _sk_lineTableInsert(sk_Sketch* sketch, sk_Line* line) {
+    _sk_LineTable* table = &sketch->lineTable;
+    if (!table->built || (table->count + 1) * 10 > table->capacity * 7) {
+        _sk_lineTableBuild(sketch, 0);  // line is already live, so this puts it in
+        return;
+    }
+    _sk_lineTableInsertSlot(table, line);
+}
+
+static int64_t _sk_lineTableFind(const _sk_LineTable* table, const sk_Point* p1, const sk_Point* p2) {
+    if (table->count == 0) {
+        return -1;
+    }
+    const sk_Point* a = p1 < p2 ? p1 : p2;
+    const sk_Point* b = p1 < p2 ? p2 : p1;
+    for (int64_t i = _sk_lineTableFirstSlot(table, a, b); table->slots[i].line; i = (i + 1) & (table->capacity - 1)) {
+        if (table->slots[i].a == a && table->slots[i].b == b) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// backward shift delete, so no tombstones pile up
+static void _sk_lineTableRemove(_sk_LineTable* table, const sk_Line* line) {
+    int64_t mask = table->capacity - 1;
+    int64_t hole = -1;
+    if (table->count) {
+        const sk_Point* a = line->p1 < line->p2 ? line->p1 : line->p2;
+        const sk_Point* b = line->p1 < line->p2 ? line->p2 : line->p1;
+        for (int64_t i = _sk_lineTableFirstSlot(table, a, b); table->slots[i].line; i = (i + 1) & mask) {
+            if (table->slots[i].line == line) {
+                hole = i;
+                break;
+            }
+        }
+    }
+    SNZ_ASSERTF(hole >= 0, "removing line %" PRId64 " that isn't in the line table.", line->uniqueId);
+    for (int64_t i = (hole + 1) & mask; table->slots[i].line; i = (i + 1) & mask) {
+        int64_t home = _sk_lineTableFirstSlot(table, table->slots[i].a, table->slots[i].b);
+        // only move back when the hole is between where this wants to be and where it is (wrapping)
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            table->slots[hole] = table->slots[i];
+            hole = i;
+        }
+    }
+    table->slots[hole] = (_sk_LineTableSlot){ 0 };
+    table->count--;
+}
+
+// these return zeroed elts that are already live, in the first free slot
+sk_Point* sk_sketchAllocPoint(sk_Sketch* sketch) {
+    int64_t slot = _sk_poolAlloc(&sketch->points, sizeof(sk_Point), sizeof(sk_PointUi), sketch->arena);
+    sk_Point* p = sk_sketchPointAt(sketch, slot);
+    p->slot = slot;
+    return p;
+}
+
+sk_Line* sk_sketchAllocLine(sk_Sketch* sketch) {
+    int64_t slot = _sk_poolAlloc(&sketch->lines, sizeof(sk_Line), sizeof(sk_LineUi), sketch->arena);
+    sk_Line* l = sk_sketchLineAt(sketch, slot);
+    l->slot = slot;
+    return l;
+}
+
+sk_Constraint* sk_sketchAllocConstraint(sk_Sketch* sketch) {
+    int64_t slot = _sk_poolAlloc(&sketch->constraints, sizeof(sk_Constraint), sizeof(sk_ConstraintUi), sketch->arena);
+    sk_Constraint* c = sk_sketchConstraintAt(sketch, slot);
+    c->slot = slot;
+    return c;
+}
+
+// same as the ones above but in a specific slot, which has to be free. for putting elts back where they were
+sk_Point* sk_sketchAllocPointAt(sk_Sketch* sketch, int64_t slot) {
+    _sk_poolClaim(&sketch->points, slot, sizeof(sk_Point), sizeof(sk_PointUi), sketch->arena);
+    sk_Point* p = sk_sketchPointAt(sketch, slot);
+    p->slot = slot;
+    return p;
+}
+
+sk_Line* sk_sketchAllocLineAt(sk_Sketch* sketch, int64_t slot) {
+    _sk_poolClaim(&sketch->lines, slot, sizeof(sk_Line), sizeof(sk_LineUi), sketch->arena);
+    sk_Line* l = sk_sketchLineAt(sketch, slot);
+    l->slot = slot;
+    return l;
+}
+
+sk_Constraint* sk_sketchAllocConstraintAt(sk_Sketch* sketch, int64_t slot) {
+    _sk_poolClaim(&sketch->constraints, slot, sizeof(sk_Constraint), sizeof(sk_ConstraintUi), sketch->arena);
+    sk_Constraint* c = sk_sketchConstraintAt(sketch, slot);
+    c->slot = slot;
+    return c;
+}
+
+// these expect nothing left pointing at the elt. clusters could still be, so they always get rebuilt after.
+// the slot stays on the elt, so a loop can keep going from one that was just freed.
+void sk_sketchFreePoint(sk_Sketch* sketch, sk_Point* p) {
+    sketch->clusterHash = 0;
+    int64_t slot = p->slot;
+    _sk_poolFree(&sketch->points, slot, sizeof(sk_Point), sizeof(sk_PointUi));
+    p->slot = slot;
+}
+
+void sk_sketchFreeLine(sk_Sketch* sketch, sk_Line* l) {
+    sketch->clusterHash = 0;
+    if (sketch->lineTable.built) {
+        _sk_lineTableRemove(&sketch->lineTable, l);
+    }
+    int64_t slot = l->slot;
+    _sk_poolFree(&sketch->lines, slot, sizeof(sk_Line), sizeof(sk_LineUi));
+    l->slot = slot;
+}
+
+void sk_sketchFreeConstraint(sk_Sketch* sketch, sk_Constraint* c) {
+    sketch->clusterHash = 0;
+    int64_t slot = c->slot;
+    _sk_poolFree(&sketch->constraints, slot, sizeof(sk_Constraint), sizeof(sk_ConstraintUi));
+    c->slot = slot;
+}
+
+// versions come from one counter for every sketch, so a sketch ptr + version only ever means one state of one sketch.
+// sketchui keys its cache on that, and sketches get freed and their memory reused
+static uint64_t _sk_lastVersion;
+
+void sk_sketchMarkChanged(sk_Sketch* sketch) {
+    _sk_lastVersion++;
+    sketch->version = _sk_lastVersion;
+}
+
+// false when nothing that goes into solving changed since the last one, so it can be skipped
+bool sk_sketchChangedSinceSolve(const sk_Sketch* sketch) {
+    return sketch->version != sketch->solvedVersion;
+}
+
 void sk_sketchSetOrigin(sk_Sketch* sketch, sk_Line* line, bool originOnP1, float angle) {
+    sk_sketchMarkChanged(sketch);
     sketch->originLine = line;
     sketch->originPt = (originOnP1 ? line->p1 : line->p2);
     sketch->originAngle = angle;
 }
 
 sk_Point* sk_sketchAddPoint(sk_Sketch* sketch, HMM_Vec2 pos) {
-    sk_Point* p = SNZ_ARENA_PUSH(sketch->arena, sk_Point);
-    *p = (sk_Point){
-        .pos = pos,
-        .next = sketch->firstPoint,
-        .uniqueId = sketch->nextUniqueId,
-    };
-    sketch->firstPoint = p;
+    sk_Point* p = sk_sketchAllocPoint(sketch);
+    p->pos = pos;
+    p->uniqueId = sketch->nextUniqueId;
     sketch->nextUniqueId++;
+    sk_sketchMarkChanged(sketch);
     return p;
 }
 
@@ -161,30 +655,21 @@ sk_Line* sk_sketchAddLine(sk_Sketch* sketch, sk_Point* p1, sk_Point* p2) {
     SNZ_ASSERT(p1 != NULL, "attemped to create a line with a null pt");
     SNZ_ASSERT(p2 != NULL, "attemped to create a line with a null pt");
 
-    sk_Line* line = false;
-    for (sk_Line* l = sketch->firstLine; l; l = l->next) {
-        if (l->p1 == p1 && l->p2 == p2) {
-            line = l;
-            break;
-        } else if (l->p2 == p1 && l->p1 == p2) {
-            line = l;
-            break;
-        }
+    if (!sketch->lineTable.built) {
+        _sk_lineTableBuild(sketch, 1);
     }
-
-    if (line != NULL) {
-        return line;
+    int64_t slot = _sk_lineTableFind(&sketch->lineTable, p1, p2);
+    if (slot >= 0) {
+        return sketch->lineTable.slots[slot].line;
     }
 
-    line = SNZ_ARENA_PUSH(sketch->arena, sk_Line);
-    *line = (sk_Line){
-        .p1 = p1,
-        .p2 = p2,
-        .next = sketch->firstLine,
-        .uniqueId = sketch->nextUniqueId,
-    };
-    sketch->firstLine = line;
+    sk_Line* line = sk_sketchAllocLine(sketch);
+    line->p1 = p1;
+    line->p2 = p2;
+    line->uniqueId = sketch->nextUniqueId;
+    _sk_lineTableInsert(sketch, line);
     sketch->nextUniqueId++;
+    sk_sketchMarkChanged(sketch);
     return line;
 }
 
@@ -205,20 +690,43 @@ sk_Sketch sk_sketchInit(snz_Arena* arena) {
     return out;
 }
 
+// deep copy of everything in src, with the same uniqueIds and slots. arena is retained by the new sketch.
+sk_Sketch sk_sketchDuplicate(const sk_Sketch* src, snz_Arena* arena) {
+    sk_Sketch out = *src;
+    out.arena = arena;
+    out.clusterHash = 0;  // cluster ptrs are still into src
+    out.lineTable = (_sk_LineTable){ 0 };  // slots are in src's arena
+    out.points = _sk_poolDuplicate(&src->points, sizeof(sk_Point), sizeof(sk_PointUi), arena);
+    out.lines = _sk_poolDuplicate(&src->lines, sizeof(sk_Line), sizeof(sk_LineUi), arena);
+    out.constraints = _sk_poolDuplicate(&src->constraints, sizeof(sk_Constraint), sizeof(sk_ConstraintUi), arena);
+
+    // everything is in the same slot it was in src, so ptrs just get looked up again by it
+    for (sk_Line* l = sk_sketchFirstLine(&out); l; l = sk_sketchNextLine(&out, l)) {
+        l->p1 = sk_sketchPointAt(&out, l->p1->slot);
+        l->p2 = sk_sketchPointAt(&out, l->p2->slot);
+    }
+    for (sk_Constraint* c = sk_sketchFirstConstraint(&out); c; c = sk_sketchNextConstraint(&out, c)) {
+        c->line1 = c->line1 ? sk_sketchLineAt(&out, c->line1->slot) : NULL;
+        c->line2 = c->line2 ? sk_sketchLineAt(&out, c->line2->slot) : NULL;
+        c->nextInCluster = NULL;
+    }
+
+    out.originPt = src->originPt ? sk_sketchPointAt(&out, src->originPt->slot) : NULL;
+    out.originLine = src->originLine ? sk_sketchLineAt(&out, src->originLine->slot) : NULL;
+    return out;
+}
+
 // FIXME: deduplicate
 sk_Constraint* sk_sketchAddConstraintDistance(sk_Sketch* sketch, sk_Line* l, float length) {
     SNZ_ASSERT(l != NULL, "attemped to create a distance constraint with null line");
 
-    sk_Constraint* c = SNZ_ARENA_PUSH(sketch->arena, sk_Constraint);
-    *c = (sk_Constraint){
-        .kind = SK_CK_DISTANCE,
-        .line1 = l,
-        .value = length,
-        .nextAllocated = sketch->firstConstraint,
-        .uniqueId = sketch->nextUniqueId,
-    };
+    sk_Constraint* c = sk_sketchAllocConstraint(sketch);
+    c->kind = SK_CK_DISTANCE;
+    c->line1 = l;
+    c->value = length;
+    c->uniqueId = sketch->nextUniqueId;
     sketch->nextUniqueId++;
-    sketch->firstConstraint = c;
+    sk_sketchMarkChanged(sketch);
     return c;
 }
 
@@ -227,19 +735,16 @@ sk_Constraint* sk_sketchAddConstraintAngle(sk_Sketch* sketch, sk_Line* line1, bo
     SNZ_ASSERT(line1 != NULL, "attemped to create a angle constraint with null line");
     SNZ_ASSERT(line2 != NULL, "attemped to create a angle constraint with null line");
 
-    sk_Constraint* c = SNZ_ARENA_PUSH(sketch->arena, sk_Constraint);
-    *c = (sk_Constraint){
-        .kind = SK_CK_ANGLE,
-        .line1 = line1,
-        .line2 = line2,
-        .flipLine1 = flipLine1,
-        .flipLine2 = flipLine2,
-        .value = angle,
-        .nextAllocated = sketch->firstConstraint,
-        .uniqueId = sketch->nextUniqueId,
-    };
+    sk_Constraint* c = sk_sketchAllocConstraint(sketch);
+    c->kind = SK_CK_ANGLE;
+    c->line1 = line1;
+    c->line2 = line2;
+    c->flipLine1 = flipLine1;
+    c->flipLine2 = flipLine2;
+    c->value = angle;
+    c->uniqueId = sketch->nextUniqueId;
     sketch->nextUniqueId++;
-    sketch->firstConstraint = c;
+    sk_sketchMarkChanged(sketch);
     return c;
 }
 
@@ -446,28 +951,41 @@ static float _sk_angleNormalized(float a) {
     return a;
 }
 
-void sk_sketchSolve(sk_Sketch* sketch) {
+// error of one constraint at the current point positions, meters or rads
+static float _sk_constraintError(const sk_Constraint* c) {
+    if (c->kind == SK_CK_DISTANCE) {
+        return HMM_Len(HMM_Sub(c->line1->p2->pos, c->line1->p1->pos)) - c->value;
+    } else if (c->kind == SK_CK_ANGLE) {
+        float l1Angle = sk_angleOfLine(c->line1->p1->pos, c->line1->p2->pos, c->flipLine1);
+        float l2Angle = sk_angleOfLine(c->line2->p1->pos, c->line2->p2->pos, c->flipLine2);
+        return _sk_angleNormalized(_sk_angleNormalized(l2Angle - l1Angle) - c->value);
+    }
+    SNZ_ASSERTF(false, "unreachable. kind: %d", c->kind);
+    return 0;
+}
+
+// resets everything solve dependent, then places every point it can exactly by intersecting manifolds.
+// returns true if that got all of them.
+static bool _sk_sketchSolveConstructive(sk_Sketch* sketch) {
     int64_t sketchPointCount = 0;
     int64_t solvedPointCount = 1;
 
     {  // RESET SOLVE DEPENDENT VARIABLES IN THE SKETCH
-        for (sk_Point* point = sketch->firstPoint; point; point = point->next) {
+        for (sk_Point* point = sk_sketchFirstPoint(sketch); point; point = sk_sketchNextPoint(sketch, point)) {
             point->manifold = (sk_Manifold){ .kind = SK_MK_ANY };
             sketchPointCount++;
             point->solved = false;
         }
 
-        for (sk_Line* line = sketch->firstLine; line; line = line->next) {
+        for (sk_Line* line = sk_sketchFirstLine(sketch); line; line = sk_sketchNextLine(sketch, line)) {
             line->expectedAngle = 0;
             line->angleSolved = false;
             line->angleApplied = false;
         }
 
-        sketch->firstUnappliedConstraint = NULL;
-        for (sk_Constraint* c = sketch->firstConstraint; c; c = c->nextAllocated) {
+        for (sk_Constraint* c = sk_sketchFirstConstraint(sketch); c; c = sk_sketchNextConstraint(sketch, c)) {
             c->violated = false;
-            c->nextUnapplied = sketch->firstUnappliedConstraint;
-            sketch->firstUnappliedConstraint = c;
+            c->applied = false;
         }
 
         SNZ_ASSERT(sketch->originPt != NULL, "non-empty sketch w/ no origin pt.");
@@ -487,8 +1005,10 @@ void sk_sketchSolve(sk_Sketch* sketch) {
     while (true) {  // FIXME: cutoff
         bool anySolved = false;
 
-        sk_Constraint* prevConstraint = NULL;
-        for (sk_Constraint* c = sketch->firstUnappliedConstraint; c; c = c->nextUnapplied) {
+        for (sk_Constraint* c = sk_sketchFirstConstraint(sketch); c; c = sk_sketchNextConstraint(sketch, c)) {
+            if (c->applied) {
+                continue;
+            }
             bool applied = false;
             if (c->kind == SK_CK_DISTANCE) {
                 sk_Point* p1 = c->line1->p1;
@@ -541,17 +1061,11 @@ void sk_sketchSolve(sk_Sketch* sketch) {
 
             if (applied) {
                 anySolved = true;
-                if (!prevConstraint) {
-                    sketch->firstUnappliedConstraint = c->nextUnapplied;
-                } else {
-                    prevConstraint->nextUnapplied = c->nextUnapplied;
-                }
-            } else {
-                prevConstraint = c;
+                c->applied = true;
             }
         }  // end manifold join/angle propagation loop
 
-        for (sk_Line* line = sketch->firstLine; line; line = line->next) {
+        for (sk_Line* line = sk_sketchFirstLine(sketch); line; line = sk_sketchNextLine(sketch, line)) {
             int ptSolvedCount = line->p1->solved + line->p2->solved;
             if (!line->angleSolved && ptSolvedCount == 2) {
                 HMM_Vec2 diff = HMM_Sub(line->p2->pos, line->p1->pos);
@@ -581,7 +1095,7 @@ void sk_sketchSolve(sk_Sketch* sketch) {
             }
         }
 
-        for (sk_Point* p = sketch->firstPoint; p; p = p->next) {
+        for (sk_Point* p = sk_sketchFirstPoint(sketch); p; p = sk_sketchNextPoint(sketch, p)) {
             if (p->solved) {
                 continue;
             } else if (p->manifold.kind == SK_MK_POINT) {
@@ -602,15 +1116,21 @@ void sk_sketchSolve(sk_Sketch* sketch) {
         }
 
         if (solvedPointCount == sketchPointCount) {
-            return;  // skip implicit solving when everything is good
+            return true;  // skip implicit solving when everything is good
         } else if (!anySolved) {
             break;
         }
     }  // end solve loop
 
+    return false;
+}
+
+// the old fallback, nudges constraints one at a time. kept around for sk_bench to compare against.
+static void _sk_sketchSolveRelaxation(sk_Sketch* sketch) {
     for (int i = 0; i < 1000; i++) {
+        sketch->solveStats.iterations++;
         float maxError = 0;
-        for (sk_Constraint* c = sketch->firstConstraint; c; c = c->nextAllocated) {
+        for (sk_Constraint* c = sk_sketchFirstConstraint(sketch); c; c = sk_sketchNextConstraint(sketch, c)) {
             float error = 0;
             if (c->kind == SK_CK_ANGLE) {
                 // FIXME: Origin angle should be a constraint but it doesnt get applied here??
@@ -651,49 +1171,677 @@ void sk_sketchSolve(sk_Sketch* sketch) {
             return;
         }
     }  // end iteration loop
+}
+
+static void _sk_sketchMarkViolated(sk_Sketch* sketch) {
+    for (sk_Constraint* c = sk_sketchFirstConstraint(sketch); c; c = sk_sketchNextConstraint(sketch, c)) {
+        float error = fabsf(_sk_constraintError(c));
+        sketch->solveStats.maxResidual = SNZ_MAX(sketch->solveStats.maxResidual, error);
+        c->violated = !geo_floatZero(error);
+        sketch->solveStats.violatedCount += c->violated;
+    }
+}
+
+#define SK_SOLVE_MAX_ITERATIONS 100
+#define SK_SOLVE_TOLERANCE (geo_EPSILON * 0.001)
+
+// one row of the jacobian, angles touch at most 4 pts w/ 2 coords each
+typedef struct {
+    const sk_Constraint* c;  // NULL for the origin angle
+    int32_t cols[8];
+    double vals[8];
+    int64_t colCount;
+} _sk_SolveRow;
+
+typedef struct {
+    const sk_Sketch* sketch;
+    _sk_SolveRow* rows;
+    int64_t rowCount;
+    int64_t varCount;
+} _sk_SolveSystem;
+
+static double _sk_solveAngleWrap(double a) {
+    while (a > HMM_PI) {
+        a -= 2 * HMM_PI;
+    }
+    while (a < -HMM_PI) {
+        a += 2 * HMM_PI;
+    }
+    return a;
+}
+
+// points the constructive pass placed just read from their pos
+static void _sk_solvePos(const sk_Point* p, const double* x, double* outX, double* outY) {
+    if (!p->solved) {
+        *outX = x[p->indexIntoSketch * 2];
+        *outY = x[p->indexIntoSketch * 2 + 1];
+    } else {
+        *outX = p->pos.X;
+        *outY = p->pos.Y;
+    }
+}
+
+static void _sk_solveRowAdd(_sk_SolveRow* row, const sk_Point* p, double dx, double dy) {
+    if (p->solved) {
+        return;
+    }
+    for (int axis = 0; axis < 2; axis++) {
+        int32_t col = p->indexIntoSketch * 2 + axis;
+        // two lines in an angle constraint can share a pt, so cols get summed
+        int64_t i = 0;
+        for (; i < row->colCount; i++) {
+            if (row->cols[i] == col) {
+                break;
+            }
+        }
+        if (i == row->colCount) {
+            SNZ_ASSERT(row->colCount < 8, "solve row overflowed.");
+            row->cols[i] = col;
+            row->vals[i] = 0;
+            row->colCount++;
+        }
+        row->vals[i] += axis ? dy : dx;
+    }
+}
+
+// angle from p1 to p2, adds sign * its derivatives to row when row isn't NULL
+static double _sk_solveLineAngle(const sk_Line* l, bool flip, const double* x, _sk_SolveRow* row, double sign) {
+    double x1, y1, x2, y2;
+    _sk_solvePos(l->p1, x, &x1, &y1);
+    _sk_solvePos(l->p2, x, &x2, &y2);
+    double dx = x2 - x1;
+    double dy = y2 - y1;
+    double lenSq = dx * dx + dy * dy;
+    if (row && lenSq > 1e-12) {  // degenerate lines just don't pull on anything
+        _sk_solveRowAdd(row, l->p2, sign * -dy / lenSq, sign * dx / lenSq);
+        _sk_solveRowAdd(row, l->p1, sign * dy / lenSq, sign * -dx / lenSq);
+    }
+    return atan2(dy, dx) + (flip ? HMM_PI : 0);
+}
+
+// residual of the row at x, refills its jacobian entries when withJacobian is set
+static double _sk_solveRowEval(const _sk_SolveSystem* sys, _sk_SolveRow* row, const double* x, bool withJacobian) {
+    _sk_SolveRow* j = withJacobian ? row : NULL;
+    if (j) {
+        j->colCount = 0;
+    }
+
+    const sk_Constraint* c = row->c;
+    if (c == NULL) {
+        // the relaxation never applied this, leaving rotation about the origin free
+        double angle = _sk_solveLineAngle(sys->sketch->originLine, false, x, j, 1);
+        return _sk_solveAngleWrap(angle - sys->sketch->originAngle);
+    } else if (c->kind == SK_CK_DISTANCE) {
+        double x1, y1, x2, y2;
+        _sk_solvePos(c->line1->p1, x, &x1, &y1);
+        _sk_solvePos(c->line1->p2, x, &x2, &y2);
+        double dx = x2 - x1;
+        double dy = y2 - y1;
+        double len = sqrt(dx * dx + dy * dy);
+        if (j && len > 1e-9) {
+            _sk_solveRowAdd(j, c->line1->p2, dx / len, dy / len);
+            _sk_solveRowAdd(j, c->line1->p1, -dx / len, -dy / len);
+        }
+        return len - c->value;
+    } else if (c->kind == SK_CK_ANGLE) {
+        double l1Angle = _sk_solveLineAngle(c->line1, c->flipLine1, x, j, -1);
+        double l2Angle = _sk_solveLineAngle(c->line2, c->flipLine2, x, j, 1);
+        return _sk_solveAngleWrap(l2Angle - l1Angle - c->value);
+    }
+    SNZ_ASSERTF(false, "unreachable. kind: %d", c->kind);
+    return 0;
+}
+
+// fills r, returns half the squared norm of it
+static double _sk_solveEval(const _sk_SolveSystem* sys, const double* x, double* r, bool withJacobian) {
+    double cost = 0;
+    for (int64_t i = 0; i < sys->rowCount; i++) {
+        r[i] = _sk_solveRowEval(sys, &sys->rows[i], x, withJacobian);
+        cost += r[i] * r[i];
+    }
+    return cost / 2;
+}
+
+// free pts a constraint touches, at most 4. NULL is the origin line's angle.
+static int64_t _sk_constraintFreePoints(const sk_Sketch* sketch, const sk_Constraint* c, sk_Point** out) {
+    sk_Line* lines[2] = { sketch->originLine, NULL };
+    if (c) {
+        lines[0] = c->line1;
+        lines[1] = c->kind == SK_CK_ANGLE ? c->line2 : NULL;
+    }
+
+    int64_t count = 0;
+    for (int64_t i = 0; i < 2; i++) {
+        for (int64_t j = 0; lines[i] && j < 2; j++) {
+            sk_Point* p = lines[i]->pts[j];
+            bool dupe = false;
+            for (int64_t k = 0; k < count; k++) {
+                dupe |= out[k] == p;
+            }
+            if (!p->solved && !dupe) {
+                out[count++] = p;
+            }
+        }
+    }
+    return count;
+}
+
+static int64_t _sk_solveRowPoints(const _sk_SolveSystem* sys, const _sk_SolveRow* row, sk_Point** out) {
+    return _sk_constraintFreePoints(sys->sketch, row->c, out);
+}
+
+// reverse cuthill-mckee over free pts, so pts that share constraints get indices near each other and the
+// envelope of JtJ stays thin. expects indexIntoSketch to be the pts position in freePts, and rewrites both.
+static void _sk_solveOrder(const _sk_SolveSystem* sys, sk_Point** freePts, int64_t freeCount, snz_Arena* scratch) {
+    int64_t* degrees = SNZ_ARENA_PUSH_ARR(scratch, freeCount + 1, int64_t);
+    sk_Point* rowPts[4] = { 0 };
+    for (int64_t i = 0; i < sys->rowCount; i++) {
+        int64_t count = _sk_solveRowPoints(sys, &sys->rows[i], rowPts);
+        for (int64_t j = 0; j < count; j++) {
+            degrees[rowPts[j]->indexIntoSketch] += count - 1;
+        }
+    }
+
+    // csr adjacency, may have repeats, the bfs doesn't care
+    int64_t* adjStarts = SNZ_ARENA_PUSH_ARR(scratch, freeCount + 1, int64_t);
+    for (int64_t i = 0; i < freeCount; i++) {
+        adjStarts[i + 1] = adjStarts[i] + degrees[i];
+    }
+    int64_t* adj = SNZ_ARENA_PUSH_ARR(scratch, adjStarts[freeCount], int64_t);
+    int64_t* fill = SNZ_ARENA_PUSH_ARR(scratch, freeCount, int64_t);
+    for (int64_t i = 0; i < sys->rowCount; i++) {
+        int64_t count = _sk_solveRowPoints(sys, &sys->rows[i], rowPts);
+        for (int64_t j = 0; j < count; j++) {
+            for (int64_t k = 0; k < count; k++) {
+                int64_t a = rowPts[j]->indexIntoSketch;
+                if (j != k) {
+                    adj[adjStarts[a] + fill[a]++] = rowPts[k]->indexIntoSketch;
+                }
+            }
+        }
+    }
+
+    // components start from their lowest degree pt, found by walking every pt lowest degree first
+    int64_t* starts = SNZ_ARENA_PUSH_ARR(scratch, freeCount, int64_t);
+    for (int64_t i = 0; i < freeCount; i++) {
+        int64_t j = i;
+        for (; j > 0 && degrees[starts[j - 1]] > degrees[i]; j--) {
+            starts[j] = starts[j - 1];
+        }
+        starts[j] = i;
+    }
+
+    int64_t* order = SNZ_ARENA_PUSH_ARR(scratch, freeCount, int64_t);
+    bool* visited = SNZ_ARENA_PUSH_ARR(scratch, freeCount, bool);
+    int64_t orderCount = 0;
+    for (int64_t s = 0; s < freeCount; s++) {
+        if (visited[starts[s]]) {
+            continue;
+        }
+        visited[starts[s]] = true;
+        order[orderCount++] = starts[s];
+        for (int64_t head = orderCount - 1; head < orderCount; head++) {
+            int64_t node = order[head];
+            int64_t firstNew = orderCount;
+            for (int64_t i = adjStarts[node]; i < adjStarts[node + 1]; i++) {
+                int64_t n = adj[i];
+                if (visited[n]) {
+                    continue;
+                }
+                visited[n] = true;
+                // neighbors go in lowest degree first
+                int64_t j = orderCount++;
+                for (; j > firstNew && degrees[order[j - 1]] > degrees[n]; j--) {
+                    order[j] = order[j - 1];
+                }
+                order[j] = n;
+            }
+        }
+    }
+
+    sk_Point** ordered = SNZ_ARENA_PUSH_ARR(scratch, freeCount, sk_Point*);
+    for (int64_t i = 0; i < freeCount; i++) {
+        ordered[freeCount - 1 - i] = freePts[order[i]];
+    }
+    for (int64_t i = 0; i < freeCount; i++) {
+        freePts[i] = ordered[i];
+        freePts[i]->indexIntoSketch = i;
+    }
+}
+
+// lower triangle of JtJ, row i holding cols first[i] through i, starting at vals[offsets[i]]
+typedef struct {
+    int64_t* first;
+    int64_t* offsets;
+    double* vals;
+    int64_t n;
+} _sk_SolveEnvelope;
+
+static _sk_SolveEnvelope _sk_solveEnvelopeInit(const _sk_SolveSystem* sys, snz_Arena* scratch) {
+    _sk_SolveEnvelope e = { .n = sys->varCount };
+    e.first = SNZ_ARENA_PUSH_ARR(scratch, e.n, int64_t);
+    e.offsets = SNZ_ARENA_PUSH_ARR(scratch, e.n + 1, int64_t);
+    for (int64_t i = 0; i < e.n; i++) {
+        e.first[i] = i;
+    }
+
+    sk_Point* rowPts[4] = { 0 };
+    for (int64_t i = 0; i < sys->rowCount; i++) {
+        int64_t count = _sk_solveRowPoints(sys, &sys->rows[i], rowPts);
+        int64_t minCol = e.n;
+        for (int64_t j = 0; j < count; j++) {
+            minCol = SNZ_MIN(minCol, rowPts[j]->indexIntoSketch * 2);
+        }
+        for (int64_t j = 0; j < count; j++) {
+            for (int64_t axis = 0; axis < 2; axis++) {
+                int64_t col = rowPts[j]->indexIntoSketch * 2 + axis;
+                e.first[col] = SNZ_MIN(e.first[col], minCol);
+            }
+        }
+    }
+
+    for (int64_t i = 0; i < e.n; i++) {
+        e.offsets[i + 1] = e.offsets[i] + (i - e.first[i] + 1);
+    }
+    e.vals = SNZ_ARENA_PUSH_ARR(scratch, e.offsets[e.n], double);
+    return e;
+}
+
+// fills the envelope w/ JtJ + lambda * I, then cholesky factors it in place.
+// false if it wasn't positive definite, which damping harder fixes.
+static bool _sk_solveEnvelopeFactor(const _sk_SolveSystem* sys, _sk_SolveEnvelope* e, double lambda) {
+    memset(e->vals, 0, sizeof(*e->vals) * e->offsets[e->n]);
+    for (int64_t i = 0; i < sys->rowCount; i++) {
+        const _sk_SolveRow* row = &sys->rows[i];
+        for (int64_t a = 0; a < row->colCount; a++) {
+            for (int64_t b = 0; b < row->colCount; b++) {
+                int64_t r = row->cols[a];
+                int64_t c = row->cols[b];
+                if (c <= r) {
+                    e->vals[e->offsets[r] + c - e->first[r]] += row->vals[a] * row->vals[b];
+                }
+            }
+        }
+    }
 
-    // mark constraints as violated
-    for (sk_Constraint* c = sketch->firstConstraint; c; c = c->nextAllocated) {
-        if (c->kind == SK_CK_DISTANCE) {
-            float error = HMM_Len(HMM_Sub(c->line1->p2->pos, c->line1->p1->pos)) - c->value;
-            if (!geo_floatZero(error)) {
-                c->violated = true;
+    for (int64_t i = 0; i < e->n; i++) {
+        double* li = &e->vals[e->offsets[i] - e->first[i]];
+        li[i] += lambda;
+        for (int64_t j = e->first[i]; j <= i; j++) {
+            double* lj = &e->vals[e->offsets[j] - e->first[j]];
+            double sum = li[j];
+            for (int64_t k = SNZ_MAX(e->first[i], e->first[j]); k < j; k++) {
+                sum -= li[k] * lj[k];
+            }
+            if (j < i) {
+                li[j] = sum / lj[j];
+            } else if (sum <= 0) {
+                return false;
+            } else {
+                li[i] = sqrt(sum);
             }
-        } else if (c->kind == SK_CK_ANGLE) {
-            float l1Angle = sk_angleOfLine(c->line1->p2->pos, c->line1->p2->pos, c->flipLine1);
-            float l2Angle = sk_angleOfLine(c->line2->p2->pos, c->line2->p2->pos, c->flipLine2);
+        }
+    }
+    return true;
+}
+
+// solves L Lt out = b, b & out can be the same
+static void _sk_solveEnvelopeSolve(const _sk_SolveEnvelope* e, const double* b, double* out) {
+    for (int64_t i = 0; i < e->n; i++) {
+        const double* li = &e->vals[e->offsets[i] - e->first[i]];
+        double sum = b[i];
+        for (int64_t k = e->first[i]; k < i; k++) {
+            sum -= li[k] * out[k];
+        }
+        out[i] = sum / li[i];
+    }
+    for (int64_t i = e->n - 1; i >= 0; i--) {
+        const double* li = &e->vals[e->offsets[i] - e->first[i]];
+        out[i] /= li[i];
+        for (int64_t k = e->first[i]; k < i; k++) {
+            out[k] -= li[k] * out[i];
+        }
+    }
+}
 
-            float error = c->value - (l2Angle - l1Angle);
-            if (!geo_floatZero(error)) {
-                c->violated = true;
+static uint64_t _sk_hashBytes(uint64_t hash, const void* data, int64_t size) {
+    const uint8_t* bytes = data;
+    for (int64_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+#define _SK_HASH_VAL(hash, lvalue) _sk_hashBytes((hash), &(lvalue), sizeof(lvalue))
+
+// which elts there are and how they connect, so everything but pt positions and constraint values.
+// elt ptrs are in there because the clusters point at them, so a copy or restore never matches.
+// freeing an elt zeroes clusterHash, bc. its memory can come back as a new elt at the same address.
+static uint64_t _sk_sketchStructureHash(const sk_Sketch* sketch) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (sk_Point* p = sk_sketchFirstPoint(sketch); p; p = sk_sketchNextPoint(sketch, p)) {
+        hash = _SK_HASH_VAL(hash, p);
+    }
+    for (sk_Line* l = sk_sketchFirstLine(sketch); l; l = sk_sketchNextLine(sketch, l)) {
+        hash = _SK_HASH_VAL(hash, l);
+        hash = _SK_HASH_VAL(hash, l->pts);
+    }
+    for (sk_Constraint* c = sk_sketchFirstConstraint(sketch); c; c = sk_sketchNextConstraint(sketch, c)) {
+        hash = _SK_HASH_VAL(hash, c);
+        hash = _SK_HASH_VAL(hash, c->kind);
+        hash = _SK_HASH_VAL(hash, c->line1);
+        hash = _SK_HASH_VAL(hash, c->line2);
+        hash = _SK_HASH_VAL(hash, c->flipLine1);
+        hash = _SK_HASH_VAL(hash, c->flipLine2);
+    }
+    hash = _SK_HASH_VAL(hash, sketch->originPt);
+    hash = _SK_HASH_VAL(hash, sketch->originLine);
+    return hash | 1;  // so zero is never a match
+}
+
+static uint64_t _sk_sketchValueHash(const sk_Sketch* sketch) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (sk_Constraint* c = sk_sketchFirstConstraint(sketch); c; c = sk_sketchNextConstraint(sketch, c)) {
+        hash = _SK_HASH_VAL(hash, c->value);
+    }
+    hash = _SK_HASH_VAL(hash, sketch->originAngle);
+    return hash;
+}
+
+// everything a cluster's solve depends on that isn't in the cluster: its constraints values and the pts the
+// constructive pass placed that those touch.
+static uint64_t _sk_clusterInputHash(const sk_Sketch* sketch, const sk_Point* root) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (sk_Constraint* c = root->cluster.firstConstraint; c; c = c->nextInCluster) {
+        hash = _SK_HASH_VAL(hash, c->value);
+        for (int64_t i = 0; i < 2; i++) {
+            sk_Line* l = i == 0 ? c->line1 : c->line2;
+            for (int64_t j = 0; l && j < 2; j++) {
+                if (l->pts[j]->solved) {
+                    hash = _SK_HASH_VAL(hash, l->pts[j]->pos);
+                }
             }
         }
     }
+    // the origin row, which may or may not be in here
+    hash = _SK_HASH_VAL(hash, sketch->originAngle);
+    for (int64_t j = 0; j < 2; j++) {
+        if (sketch->originLine->pts[j]->solved) {
+            hash = _SK_HASH_VAL(hash, sketch->originLine->pts[j]->pos);
+        }
+    }
+    return hash;
+}
+
+// levenberg-marquardt over the x & y of every pt in one cluster.
+// the jacobian is sparse, each row only has the coords of the pts in one constraint, and pts get reordered
+// so that the normal equations factor w/ a banded cholesky instead of a dense one.
+static void _sk_clusterSolveNumeric(sk_Sketch* sketch, sk_Point* root, snz_Arena* scratch) {
+    int64_t scratchStart = snz_arenaUsedBytes(scratch);
+    _sk_SolveSystem sys = { .sketch = sketch };
+
+    int64_t freeCount = 0;
+    for (sk_Point* p = root; p; p = p->cluster.next) {
+        p->indexIntoSketch = freeCount++;
+    }
+    sys.varCount = freeCount * 2;
+    sk_Point** freePts = SNZ_ARENA_PUSH_ARR(scratch, freeCount, sk_Point*);
+    for (sk_Point* p = root; p; p = p->cluster.next) {
+        freePts[p->indexIntoSketch] = p;
+    }
+
+    for (sk_Constraint* c = root->cluster.firstConstraint; c; c = c->nextInCluster) {
+        sys.rowCount++;
+    }
+    sk_Line* originLine = sketch->originLine;
+    bool originRow = (!originLine->p1->solved && originLine->p1->cluster.root == root) ||
+                     (!originLine->p2->solved && originLine->p2->cluster.root == root);
+    sys.rowCount += originRow;
+
+    sys.rows = SNZ_ARENA_PUSH_ARR(scratch, sys.rowCount, _sk_SolveRow);
+    int64_t rowIdx = 0;
+    for (sk_Constraint* c = root->cluster.firstConstraint; c; c = c->nextInCluster) {
+        sys.rows[rowIdx++].c = c;
+    }
+    // the last is left zeroed, which is the origin row
+
+    _sk_solveOrder(&sys, freePts, freeCount, scratch);
+    _sk_SolveEnvelope envelope = _sk_solveEnvelopeInit(&sys, scratch);
+
+    int64_t iterations = 0;
+    double* x = SNZ_ARENA_PUSH_ARR(scratch, sys.varCount, double);
+    double* xNew = SNZ_ARENA_PUSH_ARR(scratch, sys.varCount, double);
+    double* r = SNZ_ARENA_PUSH_ARR(scratch, sys.rowCount, double);
+    double* rNew = SNZ_ARENA_PUSH_ARR(scratch, sys.rowCount, double);
+    double* g = SNZ_ARENA_PUSH_ARR(scratch, sys.varCount, double);
+    double* step = SNZ_ARENA_PUSH_ARR(scratch, sys.varCount, double);
+    for (int64_t i = 0; i < freeCount; i++) {
+        x[i * 2] = freePts[i]->pos.X;
+        x[i * 2 + 1] = freePts[i]->pos.Y;
+    }
+
+    double cost = _sk_solveEval(&sys, x, r, true);
+    // picking up where the last solve on this cluster left off. a drag is small next to whatever it took to converge
+    // the first time, so starting at a big damping again would only cost iterations walking it back down.
+    double lambda = root->cluster.lambda ? root->cluster.lambda : 1e-3;
+    bool jacobianChanged = true;
+    bool converged = false;
+    while (iterations < SK_SOLVE_MAX_ITERATIONS) {
+        double maxResidual = 0;
+        for (int64_t i = 0; i < sys.rowCount; i++) {
+            maxResidual = SNZ_MAX(maxResidual, fabs(r[i]));
+        }
+        if (maxResidual < SK_SOLVE_TOLERANCE) {
+            converged = true;
+            break;
+        }
+        iterations++;
+
+        // -Jt r, the downhill direction
+        if (jacobianChanged) {
+            memset(g, 0, sizeof(*g) * sys.varCount);
+            for (int64_t i = 0; i < sys.rowCount; i++) {
+                const _sk_SolveRow* row = &sys.rows[i];
+                for (int64_t k = 0; k < row->colCount; k++) {
+                    g[row->cols[k]] -= row->vals[k] * r[i];
+                }
+            }
+        }
+
+        // damping w/ the identity, instead of marquardt's diagonal, keeps steps the shortest ones that do the job.
+        // underconstrained pts then move as little as they can, which is what you want when dragging.
+        bool accepted = false;
+        if (_sk_solveEnvelopeFactor(&sys, &envelope, lambda)) {
+            _sk_solveEnvelopeSolve(&envelope, g, step);
+            for (int64_t i = 0; i < sys.varCount; i++) {
+                xNew[i] = x[i] + step[i];
+            }
+            accepted = _sk_solveEval(&sys, xNew, rNew, false) < cost;
+        }
+
+        jacobianChanged = accepted;
+        if (accepted) {
+            double* tmp = x;
+            x = xNew;
+            xNew = tmp;
+            cost = _sk_solveEval(&sys, x, r, true);
+            lambda = SNZ_MAX(lambda * 0.1, 1e-9);  // any lower and roundoff starts pushing free pts around
+        } else if (lambda > 1e12) {
+            break;  // overconstrained or in a local min, nothing else to do
+        } else {
+            lambda *= 10;
+        }
+    }
+
+    for (int64_t i = 0; i < freeCount; i++) {
+        freePts[i]->pos = HMM_V2(x[i * 2], x[i * 2 + 1]);
+    }
+    root->cluster.lambda = converged ? lambda : 0;  // not worth keeping when it gave up
+    root->cluster.inputHash = _sk_clusterInputHash(sketch, root);
+    sketch->solveStats.iterations += iterations;
+    sketch->solveStats.clustersSolved++;
+    snz_arenaPop(scratch, snz_arenaUsedBytes(scratch) - scratchStart);
+}
+
+static sk_Point* _sk_clusterFind(sk_Point* p) {
+    sk_Point* root = p;
+    while (root->cluster.root != root) {
+        root = root->cluster.root;
+    }
+    while (p->cluster.root != root) {
+        sk_Point* next = p->cluster.root;
+        p->cluster.root = root;
+        p = next;
+    }
+    return root;
+}
+
+// right after the constructive pass, everything it placed is rigid and fixed to the origin. what's left gets
+// split up by which pts share constraints, and each of those only depends on itself and the fixed pts.
+// so moving a free pt only needs its own cluster re-solved, and the fixed ones never depend on free ones.
+static void _sk_sketchBuildClusters(sk_Sketch* sketch, uint64_t hash) {
+    for (sk_Point* p = sk_sketchFirstPoint(sketch); p; p = sk_sketchNextPoint(sketch, p)) {
+        p->cluster.root = p->solved ? NULL : p;
+        p->cluster.next = NULL;
+        p->cluster.firstConstraint = NULL;
+        p->cluster.dirty = false;
+        p->cluster.lambda = 0;
+    }
+
+    sk_Point* pts[4] = { 0 };
+    for (sk_Constraint* c = sk_sketchFirstConstraint(sketch); c; c = sk_sketchNextConstraint(sketch, c)) {
+        int64_t count = _sk_constraintFreePoints(sketch, c, pts);
+        for (int64_t i = 1; i < count; i++) {
+            sk_Point* a = _sk_clusterFind(pts[0]);
+            sk_Point* b = _sk_clusterFind(pts[i]);
+            if (a != b) {
+                b->cluster.root = a;
+            }
+        }
+    }
+
+    sketch->solveStats.clusterCount = 0;
+    sketch->solveStats.variableCount = 0;
+    for (sk_Point* p = sk_sketchFirstPoint(sketch); p; p = sk_sketchNextPoint(sketch, p)) {
+        if (p->solved) {
+            continue;
+        }
+        sk_Point* root = _sk_clusterFind(p);
+        if (root != p) {
+            p->cluster.next = root->cluster.next;
+            root->cluster.next = p;
+        } else {
+            root->cluster.dirty = true;
+            sketch->solveStats.clusterCount++;
+        }
+        sketch->solveStats.variableCount += 2;
+    }
+
+    sketch->solveStats.equationCount = 0;
+    for (sk_Constraint* c = sk_sketchFirstConstraint(sketch); c; c = sk_sketchNextConstraint(sketch, c)) {
+        c->nextInCluster = NULL;
+        if (_sk_constraintFreePoints(sketch, c, pts)) {
+            sk_Point* root = pts[0]->cluster.root;
+            c->nextInCluster = root->cluster.firstConstraint;
+            root->cluster.firstConstraint = c;
+            sketch->solveStats.equationCount++;
+        }
+    }
+    sketch->solveStats.equationCount += _sk_constraintFreePoints(sketch, NULL, pts) > 0;
+    sketch->solveStats.dof = sketch->solveStats.variableCount - sketch->solveStats.equationCount;
+    sketch->clusterHash = hash;
+}
+
+// scratch is used for the numeric solve, and is back where it started once this returns.
+// results are in sketch->solveStats.
+//
+// the rigid cluster breakdown sticks around on the sketch until its structure changes. until then, each solve
+// starts from the last one: the constructive pass is skipped and only clusters w/ a pt that was moved since the last
+// solve get solved again, from where they were and w/ the damping they converged with.
+// new values or moving a pt the constructive pass placed means redoing that pass, but if it places the same pts as
+// before the clusters are still good, and only the ones that see different fixed pts or values need solving.
+// anything else starts over cold, see sketch->solveStats.coldStart.
+void sk_sketchSolve(sk_Sketch* sketch, snz_Arena* scratch) {
+    sk_SolveStats* stats = &sketch->solveStats;
+    stats->iterations = 0;
+    stats->clustersSolved = 0;
+    stats->maxResidual = 0;
+    stats->violatedCount = 0;
+    stats->coldStart = false;
+
+    uint64_t hash = _sk_sketchStructureHash(sketch);
+    uint64_t valueHash = _sk_sketchValueHash(sketch);
+    bool cold = hash != sketch->clusterHash;
+    bool replace = valueHash != sketch->valueHash;
+    for (sk_Point* p = sk_sketchFirstPoint(sketch); p && !cold; p = sk_sketchNextPoint(sketch, p)) {
+        if (memcmp(&p->pos, &p->cluster.solvedPos, sizeof(p->pos)) == 0) {
+            continue;
+        } else if (p->solved) {
+            replace = true;
+        } else {
+            p->cluster.root->cluster.dirty = true;
+        }
+    }
+
+    if (cold || replace) {
+        _sk_sketchSolveConstructive(sketch);
+    }
+    if (!cold && replace) {
+        // solved pts are the ones w/o a cluster, see _sk_sketchBuildClusters
+        for (sk_Point* p = sk_sketchFirstPoint(sketch); p && !cold; p = sk_sketchNextPoint(sketch, p)) {
+            cold = p->solved != (p->cluster.root == NULL);
+        }
+        for (sk_Point* p = sk_sketchFirstPoint(sketch); p && !cold; p = sk_sketchNextPoint(sketch, p)) {
+            if (p->cluster.root == p && p->cluster.inputHash != _sk_clusterInputHash(sketch, p)) {
+                p->cluster.dirty = true;
+            }
+        }
+    }
+    if (cold) {
+        _sk_sketchBuildClusters(sketch, hash);
+        stats->coldStart = true;
+    }
+    sketch->valueHash = valueHash;
+
+    for (sk_Point* p = sk_sketchFirstPoint(sketch); p; p = sk_sketchNextPoint(sketch, p)) {
+        if (p->cluster.root == p && p->cluster.dirty) {
+            _sk_clusterSolveNumeric(sketch, p, scratch);
+            p->cluster.dirty = false;
+        }
+    }
+
+    for (sk_Point* p = sk_sketchFirstPoint(sketch); p; p = sk_sketchNextPoint(sketch, p)) {
+        p->cluster.solvedPos = p->pos;
+    }
+    _sk_sketchMarkViolated(sketch);
+
+    sketch->solvedVersion = sketch->version;
+    prof_count(PROF_CK_SKETCH_SOLVES, 1);
+    prof_count(PROF_CK_SKETCH_SOLVE_ITERATIONS, stats->iterations);
 }
 
 // picks a new origin if necessary
 void sk_sketchClearElementsMarkedForDelete(sk_Sketch* sketch) {
     // propagate marking for deletion to anything dependent
     {
-        for (sk_Line* l = sketch->firstLine; l; l = l->next) {
+        for (sk_Line* l = sk_sketchFirstLine(sketch); l; l = sk_sketchNextLine(sketch, l)) {
             if (l->p1->markedForDelete || l->p2->markedForDelete) {
                 l->markedForDelete = true;
             }
         }
 
-        for (sk_Point* p = sketch->firstPoint; p; p = p->next) {
+        for (sk_Point* p = sk_sketchFirstPoint(sketch); p; p = sk_sketchNextPoint(sketch, p)) {
             p->markedForDelete = true;
         }
 
         // keep any points connected to any lines that still exist
-        for (sk_Line* l = sketch->firstLine; l; l = l->next) {
+        for (sk_Line* l = sk_sketchFirstLine(sketch); l; l = sk_sketchNextLine(sketch, l)) {
             if (!l->markedForDelete) {
                 l->p1->markedForDelete = false;
                 l->p2->markedForDelete = false;
             }
         }
 
-        for (sk_Constraint* c = sketch->firstConstraint; c; c = c->nextAllocated) {
+        for (sk_Constraint* c = sk_sketchFirstConstraint(sketch); c; c = sk_sketchNextConstraint(sketch, c)) {
             if (c->kind == SK_CK_ANGLE) {
                 if (c->line1->markedForDelete || c->line2->markedForDelete) {
                     c->markedForDelete = true;
@@ -708,69 +1856,115 @@ void sk_sketchClearElementsMarkedForDelete(sk_Sketch* sketch) {
         }
     }
 
-    // FIXME: pool deleted elts so they can be reused
+    bool anyDeleted = false;
 
-    {  // remake point list
-        sk_Point* newList = NULL;
-        sk_Point* next = NULL;
-        for (sk_Point* p = sketch->firstPoint; p; p = next) {
-            next = p->next;
+    {  // free everything that's still marked
+        for (sk_Point* p = sk_sketchFirstPoint(sketch); p; p = sk_sketchNextPoint(sketch, p)) {
             bool isOrigin = p == sketch->originLine->p1 || p == sketch->originLine->p2;
             if (!p->markedForDelete || isOrigin) {
                 p->markedForDelete = false;
-                p->next = newList;
-                newList = p;
             } else {
-                memset(p, 0, sizeof(*p));
+                sk_sketchFreePoint(sketch, p);
+                anyDeleted = true;
             }
         }
-        sketch->firstPoint = newList;
-    }
 
-    {  // remake line list
-        sk_Line* newList = NULL;
-        sk_Line* next = NULL;
-        for (sk_Line* l = sketch->firstLine; l; l = next) {
-            next = l->next;
+        for (sk_Line* l = sk_sketchFirstLine(sketch); l; l = sk_sketchNextLine(sketch, l)) {
             if (!l->markedForDelete || l == sketch->originLine) {
                 l->markedForDelete = false;
-                l->next = newList;
-                newList = l;
             } else {
-                memset(l, 0, sizeof(*l));
+                sk_sketchFreeLine(sketch, l);
+                anyDeleted = true;
             }
         }
-        sketch->firstLine = newList;
-    }
 
-    {  // remake constraint list
-        sk_Constraint* newList = NULL;
-        sk_Constraint* next = NULL;
-        for (sk_Constraint* c = sketch->firstConstraint; c; c = next) {
-            next = c->nextAllocated;
-            if (!c->markedForDelete) {
-                c->nextAllocated = newList;
-                newList = c;
-            } else {
-                memset(c, 0, sizeof(*c));
+        for (sk_Constraint* c = sk_sketchFirstConstraint(sketch); c; c = sk_sketchNextConstraint(sketch, c)) {
+            if (c->markedForDelete) {
+                sk_sketchFreeConstraint(sketch, c);
+                anyDeleted = true;
             }
         }
-        sketch->firstConstraint = newList;
+    }
+
+    if (anyDeleted) {
+        sk_sketchMarkChanged(sketch);
     }
 }
 
 void sk_sketchDeselectAll(sk_Sketch* sketch) {
-    for (sk_Point* p = sketch->firstPoint; p; p = p->next) {
-        p->sel.selected = false;
+    for (sk_Point* p = sk_sketchFirstPoint(sketch); p; p = sk_sketchNextPoint(sketch, p)) {
+        sk_pointUi(sketch, p)->sel.selected = false;
+    }
+
+    for (sk_Line* l = sk_sketchFirstLine(sketch); l; l = sk_sketchNextLine(sketch, l)) {
+        sk_lineUi(sketch, l)->sel.selected = false;
+    }
+
+    for (sk_Constraint* c = sk_sketchFirstConstraint(sketch); c; c = sk_sketchNextConstraint(sketch, c)) {
+        sk_constraintUi(sketch, c)->sel.selected = false;
+    }
+}
+
+// size x size grid of unit squares, from the origin line out, w/ every edge distance constrained and pts jittered off
+// of where they should end up. square corners go in along the top row and right column, which is the least it takes
+// for the grid to be rigid, and doesn't touch the origin so the constructive pass gets stuck right away.
+// leaving out the last brace leaves one dof. returns pts in row order.
+static sk_Point** _sk_testPushGrid(sk_Sketch* s, int64_t size, float jitter, bool allBraces, snz_Arena* arena) {
+    sk_Point** pts = SNZ_ARENA_PUSH_ARR(arena, size * size, sk_Point*);
+    for (int64_t y = 0; y < size; y++) {
+        for (int64_t x = 0; x < size; x++) {
+            int64_t i = y * size + x;
+            HMM_Vec2 offset = HMM_V2((float)((i * 7919) % 1000) / 1000 - 0.5, (float)((i * 6271) % 1000) / 1000 - 0.5);
+            HMM_Vec2 pos = HMM_Add(HMM_V2(x, y), HMM_Mul(offset, jitter * 2));
+            if (i == 0) {
+                pts[i] = s->originLine->p1;
+            } else if (i == 1) {
+                pts[i] = s->originLine->p2;
+            } else {
+                pts[i] = sk_sketchAddPoint(s, pos);
+            }
+        }
     }
 
-    for (sk_Line* l = sketch->firstLine; l; l = l->next) {
-        l->sel.selected = false;
+    for (int64_t y = 0; y < size; y++) {
+        for (int64_t x = 0; x < size; x++) {
+            sk_Point* p = pts[y * size + x];
+            if (x + 1 < size) {
+                sk_sketchAddConstraintDistance(s, sk_sketchAddLine(s, p, pts[y * size + x + 1]), 1);
+            }
+            if (y + 1 < size) {
+                sk_sketchAddConstraintDistance(s, sk_sketchAddLine(s, p, pts[(y + 1) * size + x]), 1);
+            }
+        }
     }
 
-    for (sk_Constraint* c = sketch->firstConstraint; c; c = c->nextAllocated) {
-        c->uiInfo.sel.selected = false;
+    int64_t last = size - 2;
+    for (int64_t cell = 0; cell < (size - 1) * 2 - 1; cell++) {
+        if (!allBraces && cell == (size - 1) * 2 - 2) {
+            break;
+        }
+        int64_t x = cell < size - 1 ? cell : last;
+        int64_t y = cell < size - 1 ? last : cell - (size - 1);
+        sk_Point* corner = pts[y * size + x];
+        sk_Line* horizontal = sk_sketchAddLine(s, corner, pts[y * size + x + 1]);
+        sk_Line* vertical = sk_sketchAddLine(s, corner, pts[(y + 1) * size + x]);
+        sk_sketchAddConstraintAngle(s, horizontal, false, vertical, false, HMM_AngleDeg(90));
     }
+    return pts;
+}
+
+// unit square w/ its sides and one corner constrained, knocked a bit out of shape. free to move as a whole.
+static void _sk_testPushSquare(sk_Sketch* s, HMM_Vec2 corner, sk_Point** outPts) {
+    HMM_Vec2 offsets[4] = { HMM_V2(0, 0), HMM_V2(1.1, 0.1), HMM_V2(1, 0.9), HMM_V2(-0.1, 1.1) };
+    sk_Line* lines[4] = { 0 };
+    for (int64_t i = 0; i < 4; i++) {
+        outPts[i] = sk_sketchAddPoint(s, HMM_Add(corner, offsets[i]));
+    }
+    for (int64_t i = 0; i < 4; i++) {
+        lines[i] = sk_sketchAddLine(s, outPts[i], outPts[(i + 1) % 4]);
+        sk_sketchAddConstraintDistance(s, lines[i], 1);
+    }
+    sk_sketchAddConstraintAngle(s, lines[0], false, lines[3], true, HMM_AngleDeg(90));
 }
 
 void sk_tests() {
@@ -883,7 +2077,8 @@ void sk_tests() {
         snz_testPrint(_sk_manifoldEq(out, comp), "circle/tangent line manifold join");
     }  // END MANIFOLD JOIN CASES
 
-    snz_Arena a = snz_arenaInit(1000000, "sk testing arena");
+    snz_Arena a = snz_arenaInit(10000000, "sk testing arena");
+    snz_Arena scratch = snz_arenaInit(10000000, "sk testing scratch");
 
     {
         sk_Sketch s = sk_sketchInit(&a);
@@ -901,7 +2096,7 @@ void sk_tests() {
         sk_sketchAddConstraintDistance(&s, l3, 1);
 
         sk_sketchSetOrigin(&s, l1, true, 0);
-        sk_sketchSolve(&s);  // FIXME: message?
+        sk_sketchSolve(&s, &scratch);  // FIXME: message?
     }
 
     {
@@ -920,8 +2115,434 @@ void sk_tests() {
         sk_sketchAddConstraintAngle(&s, l1, false, l3, true, HMM_AngleDeg(-30));
 
         sk_sketchSetOrigin(&s, l1, true, 0);
-        sk_sketchSolve(&s);  // FIXME: message?
+        sk_sketchSolve(&s, &scratch);  // FIXME: message?
+
+        // copy has to solve to the same place without touching the original
+        p2->pos = HMM_V2(5, 5);
+        sk_Sketch copy = sk_sketchDuplicate(&s, &a);
+        sk_sketchSolve(&copy, &scratch);
+        bool correct = HMM_EqV2(p2->pos, HMM_V2(5, 5));
+        sk_sketchSolve(&s, &scratch);
+        sk_Point* copyPt = sk_sketchFirstPoint(&copy);
+        for (sk_Point* p = sk_sketchFirstPoint(&s); p; p = sk_sketchNextPoint(&s, p)) {
+            correct &= copyPt != p && copyPt->uniqueId == p->uniqueId && copyPt->slot == p->slot;
+            correct &= geo_v2Equal(copyPt->pos, p->pos);
+            copyPt = sk_sketchNextPoint(&copy, copyPt);
+        }
+        correct &= copyPt == NULL;
+        correct &= copy.originLine != l1 && copy.originLine->uniqueId == l1->uniqueId;
+        snz_testPrint(correct, "sketch duplicate");
+    }
+
+    {
+        sk_Sketch s = sk_sketchInit(&a);
+        sk_Point* p1 = s.originLine->p1;
+        sk_Point* p2 = s.originLine->p2;
+        sk_Point* p3 = sk_sketchAddPoint(&s, HMM_V2(0, 2));
+        sk_Line* l2 = sk_sketchAddLine(&s, p2, p3);
+        sk_Line* l3 = sk_sketchAddLine(&s, p3, p1);
+        sk_sketchAddConstraintDistance(&s, s.originLine, 1);
+        sk_sketchAddConstraintDistance(&s, l2, 1);
+        sk_sketchAddConstraintDistance(&s, l3, 1);
+        sk_sketchAddConstraintDistance(&s, s.originLine, 1.5);
+        sk_sketchSolve(&s, &scratch);
+        snz_testPrint(s.solveStats.violatedCount == 1 && s.solveStats.iterations == 0, "conflicting constraints get marked violated");
+    }
+
+    {
+        sk_Sketch s = sk_sketchInit(&a);
+        sk_Point* p3 = sk_sketchAddPoint(&s, HMM_V2(3, 4));
+        sk_Point* stray = sk_sketchAddPoint(&s, HMM_V2(5, 5));
+        sk_Line* l = sk_sketchAddLine(&s, s.originPt, p3);
+        sk_sketchAddLine(&s, stray, p3);
+        sk_sketchAddConstraintDistance(&s, l, 10);
+        sk_sketchSolve(&s, &scratch);
+        bool correct = s.solveStats.dof == 4 && s.solveStats.violatedCount == 0;
+        correct &= HMM_Len(HMM_Sub(p3->pos, HMM_V2(6, 8))) < 0.001;
+        correct &= HMM_EqV2(stray->pos, HMM_V2(5, 5));
+        snz_testPrint(correct, "underconstrained pts only move as far as they have to");
+    }
+
+    {
+        const int64_t size = 8;
+        sk_Sketch s = sk_sketchInit(&a);
+        sk_Point** pts = _sk_testPushGrid(&s, size, 0.3, true, &a);
+        int64_t scratchStart = snz_arenaUsedBytes(&scratch);
+        sk_sketchSolve(&s, &scratch);
+
+        bool correct = s.solveStats.iterations > 0;
+        correct &= s.solveStats.violatedCount == 0;
+        correct &= s.solveStats.dof == 0;
+        correct &= s.solveStats.variableCount == (size * size - 2) * 2;
+        correct &= snz_arenaUsedBytes(&scratch) == scratchStart;
+        for (int64_t y = 0; y < size; y++) {
+            for (int64_t x = 0; x < size; x++) {
+                correct &= HMM_Len(HMM_Sub(pts[y * size + x]->pos, HMM_V2(x, y))) < 0.001;
+            }
+        }
+        snz_testPrint(correct, "numeric solve finishes a grid the constructive pass can't");
+
+        s = sk_sketchInit(&a);
+        _sk_testPushGrid(&s, size, 0.3, false, &a);
+        sk_sketchSolve(&s, &scratch);
+        snz_testPrint(s.solveStats.dof == 1 && s.solveStats.violatedCount == 0, "grid missing a brace has a dof left");
     }
 
+    {
+        sk_Sketch s = sk_sketchInit(&a);
+        sk_sketchAddConstraintDistance(&s, s.originLine, 1);
+        sk_Point* pts[16] = { 0 };
+        for (int64_t i = 0; i < 4; i++) {
+            _sk_testPushSquare(&s, HMM_V2(i * 3, 5), &pts[i * 4]);
+        }
+        sk_sketchSolve(&s, &scratch);
+        bool correct = s.solveStats.clusterCount == 4 && s.solveStats.clustersSolved == 4;
+        correct &= s.solveStats.dof == 12 && s.solveStats.violatedCount == 0;
+
+        pts[5]->pos = HMM_Add(pts[5]->pos, HMM_V2(0.3, 0.1));
+        HMM_Vec2 before[16] = { 0 };
+        for (int64_t i = 0; i < 16; i++) {
+            before[i] = pts[i]->pos;
+        }
+        sk_Sketch copy = sk_sketchDuplicate(&s, &a);
+        sk_sketchSolve(&s, &scratch);
+        correct &= s.solveStats.clustersSolved == 1 && s.solveStats.violatedCount == 0;
+        for (int64_t i = 0; i < 16; i++) {
+            if (i / 4 != 1) {
+                correct &= memcmp(&before[i], &pts[i]->pos, sizeof(before[i])) == 0;
+            }
+        }
+
+        // has to land in the same place as solving everything would
+        sk_sketchSolve(&copy, &scratch);
+        correct &= copy.solveStats.clustersSolved == 4;
+        for (sk_Point* p = sk_sketchFirstPoint(&s); p; p = sk_sketchNextPoint(&s, p)) {
+            correct &= geo_v2Equal(p->pos, sk_sketchPointAt(&copy, p->slot)->pos);
+        }
+
+        sk_sketchSolve(&s, &scratch);
+        correct &= s.solveStats.clustersSolved == 0;
+        snz_testPrint(correct, "dragging a pt only re-solves its own cluster");
+
+        // last constraint is the last squares angle
+        sk_sketchConstraintAt(&s, s.constraints.count - 1)->value = HMM_AngleDeg(80);
+        sk_sketchSolve(&s, &scratch);
+        correct = s.solveStats.clustersSolved == 1 && !s.solveStats.coldStart;
+        s.originLine->p2->pos = HMM_V2(0.5, 0.5);
+        sk_sketchSolve(&s, &scratch);
+        correct &= s.solveStats.clustersSolved == 0 && !s.solveStats.coldStart;
+        correct &= geo_v2Equal(s.originLine->p2->pos, HMM_V2(1, 0));
+        snz_testPrint(correct, "value edits and moved fixed pts only re-solve clusters that see them");
+
+        sk_sketchAddPoint(&s, HMM_V2(-3, -3));
+        sk_sketchSolve(&s, &scratch);
+        correct = s.solveStats.coldStart && s.solveStats.clusterCount == 5 && s.solveStats.clustersSolved == 5;
+        snz_testPrint(correct, "structure changes re-solve everything");
+    }
+
+    {
+        const int64_t size = 8;
+        sk_Sketch s = sk_sketchInit(&a);
+        sk_Point** pts = _sk_testPushGrid(&s, size, 0.2, true, &a);
+        sk_sketchSolve(&s, &scratch);
+        bool correct = s.solveStats.coldStart && s.solveStats.violatedCount == 0;
+
+        // the grid hangs off of the origin line, so moving its far end is the same as dragging the whole thing
+        sk_sketchConstraintAt(&s, s.constraints.count - 1)->value = HMM_AngleDeg(91);
+        sk_Constraint* originDistance = NULL;
+        for (sk_Constraint* c = sk_sketchFirstConstraint(&s); c; c = sk_sketchNextConstraint(&s, c)) {
+            if (c->kind == SK_CK_DISTANCE && c->line1 == s.originLine) {
+                originDistance = c;
+            }
+        }
+        originDistance->value = 1.2;
+        sk_sketchSolve(&s, &scratch);
+        correct &= !s.solveStats.coldStart && s.solveStats.clustersSolved == 1;
+
+        // a copy has no clusters, so it has to start over
+        pts[size * size - 1]->pos = HMM_Add(pts[size * size - 1]->pos, HMM_V2(0.05, -0.05));
+        sk_Sketch copy = sk_sketchDuplicate(&s, &a);
+        sk_sketchSolve(&s, &scratch);
+        int64_t warmIterations = s.solveStats.iterations;
+        correct &= !s.solveStats.coldStart && s.solveStats.violatedCount == 0;
+        sk_sketchSolve(&copy, &scratch);
+        correct &= copy.solveStats.coldStart && copy.solveStats.violatedCount == 0;
+        correct &= warmIterations <= copy.solveStats.iterations;
+        for (sk_Point* p = sk_sketchFirstPoint(&s); p; p = sk_sketchNextPoint(&s, p)) {
+            correct &= HMM_Len(HMM_Sub(p->pos, sk_sketchPointAt(&copy, p->slot)->pos)) < 0.001;
+        }
+        snz_testPrint(correct, "warm solves land where cold ones do, in no more iterations");
+    }
+
+    {
+        sk_Sketch s = sk_sketchInit(&a);
+        bool correct = sk_sketchChangedSinceSolve(&s);
+        sk_Point* p = sk_sketchAddPoint(&s, HMM_V2(2, 3));
+        sk_Line* l = sk_sketchAddLine(&s, s.originLine->p2, p);
+        prof_countersFrameEnd();
+        sk_sketchSolve(&s, &scratch);
+        correct &= !sk_sketchChangedSinceSolve(&s);
+
+        // none of these do anything
+        sk_sketchClearElementsMarkedForDelete(&s);
+        correct &= sk_sketchAddLine(&s, p, s.originLine->p2) == l;
+        sk_sketchDeselectAll(&s);
+        correct &= !sk_sketchChangedSinceSolve(&s);
+
+        sk_sketchAddConstraintDistance(&s, l, 2);
+        correct &= sk_sketchChangedSinceSolve(&s);
+        sk_sketchSolve(&s, &scratch);
+
+        l->markedForDelete = true;
+        sk_sketchClearElementsMarkedForDelete(&s);
+        correct &= sk_sketchChangedSinceSolve(&s);
+        sk_sketchSolve(&s, &scratch);
+
+        p->pos = HMM_V2(4, 4);
+        sk_sketchMarkChanged(&s);
+        correct &= sk_sketchChangedSinceSolve(&s);
+        sk_sketchSolve(&s, &scratch);
+        prof_countersFrameEnd();
+        correct &= prof_lastFrameCounts[PROF_CK_SKETCH_SOLVES] == 4;
+        snz_testPrint(correct, "edits mark the sketch as needing a solve, nothing else does");
+    }
+
+    {
+        sk_Sketch s = sk_sketchInit(&a);
+        sk_Point* p = sk_sketchAddPoint(&s, HMM_V2(2, 3));
+        sk_PointHandle h = sk_pointHandle(&s, p);
+        bool correct = sk_pointHandleGet(&s, h) == p;
+        p->markedForDelete = true;
+        sk_sketchClearElementsMarkedForDelete(&s);
+        correct &= sk_pointHandleGet(&s, h) == NULL;
+        sk_Point* reused = sk_sketchAddPoint(&s, HMM_V2(4, 5));
+        correct &= reused == p && sk_pointHandleGet(&s, h) == NULL;
+        correct &= sk_pointHandleGet(&s, sk_pointHandle(&s, reused)) == reused;
+        correct &= sk_pointHandleGet(&s, (sk_PointHandle){ 0 }) == NULL;
+        snz_testPrint(correct, "deleted elts get reused, handles to them stop resolving");
+
+        // pages get added as the pools grow, nothing already in one moves
+        snz_Arena poolArena = snz_arenaInit(10000000, "sk pool test arena");
+        sk_Sketch big = sk_sketchInit(&poolArena);
+        sk_Point* pts[1000] = { 0 };
+        for (int64_t i = 0; i < 1000; i++) {
+            pts[i] = sk_sketchAddPoint(&big, HMM_V2(i, 0));
+        }
+        int64_t count = 0;
+        for (sk_Point* p = sk_sketchFirstPoint(&big); p; p = sk_sketchNextPoint(&big, p)) {
+            count++;
+        }
+        correct = count == 1002 && big.points.liveCount == 1002;
+        for (int64_t i = 0; i < 1000; i++) {
+            correct &= sk_sketchPointAt(&big, pts[i]->slot) == pts[i] && pts[i]->pos.X == i;
+        }
+
+        // and putting them back in the same slot, like undo does
+        int64_t slot = pts[500]->slot;
+        sk_sketchFreePoint(&big, pts[500]);
+        sk_sketchFreePoint(&big, pts[10]);
+        correct &= sk_sketchPointAt(&big, slot) == NULL;
+        correct &= sk_sketchAllocPointAt(&big, slot) == pts[500];
+        correct &= sk_sketchAllocPoint(&big) == pts[10];
+        correct &= sk_sketchAllocPointAt(&big, big.points.count + 3)->slot == big.points.count - 1;
+        correct &= sk_sketchAllocPoint(&big)->slot == big.points.count - 2;  // the ones skipped over are free
+        snz_arenaDeinit(&poolArena);
+        snz_testPrint(correct, "pools grow w/o moving elts, and can fill specific slots");
+
+        int64_t usedBytes = 0;
+        for (int64_t i = 0; i < 100; i++) {
+            sk_Point* p1 = sk_sketchAddPoint(&s, HMM_V2(i, 0));
+            sk_Point* p2 = sk_sketchAddPoint(&s, HMM_V2(i, 1));
+            sk_sketchAddConstraintDistance(&s, sk_sketchAddLine(&s, p1, p2), 1);
+            sk_sketchSolve(&s, &scratch);
+            p1->markedForDelete = true;
+            p2->markedForDelete = true;
+            sk_sketchClearElementsMarkedForDelete(&s);
+            if (i == 0) {
+                usedBytes = snz_arenaUsedBytes(&a);
+            }
+        }
+        correct = usedBytes == snz_arenaUsedBytes(&a);
+        sk_sketchSolve(&s, &scratch);
+        correct &= sk_sketchFirstConstraint(&s) == NULL && s.solveStats.violatedCount == 0;
+        snz_testPrint(correct, "adding and deleting over and over doesn't grow the arena");
+    }
+
+    {
+        sk_Sketch s = sk_sketchInit(&a);
+        sk_Point* pts[50] = { 0 };
+        for (int64_t i = 0; i < 50; i++) {
+            pts[i] = sk_sketchAddPoint(&s, HMM_V2(i, i % 7));
+        }
+        bool correct = true;
+        srand(12);
+        for (int64_t i = 0; i < 2000; i++) {
+            sk_Point* p1 = pts[rand() % 50];
+            sk_Point* p2 = pts[rand() % 50];
+            if (p1 == p2) {
+                continue;
+            }
+            sk_Line* expected = NULL;
+            for (sk_Line* l = sk_sketchFirstLine(&s); l; l = sk_sketchNextLine(&s, l)) {
+                if ((l->p1 == p1 && l->p2 == p2) || (l->p1 == p2 && l->p2 == p1)) {
+                    expected = l;
+                }
+            }
+            int64_t lineCount = s.lines.liveCount;
+            sk_Line* l = sk_sketchAddLine(&s, p1, p2);
+            correct &= expected ? l == expected : s.lines.liveCount == lineCount + 1;
+        }
+        int64_t lineCount = 0;
+        for (sk_Line* l = sk_sketchFirstLine(&s); l; l = sk_sketchNextLine(&s, l)) {
+            lineCount++;
+        }
+        correct &= s.lineTable.count == lineCount;
+        snz_testPrint(correct, "add line finds existing lines in either order");
+
+        sk_Line* deleted = sk_sketchAddLine(&s, pts[3], pts[4]);
+        int64_t deletedUid = deleted->uniqueId;
+        deleted->markedForDelete = true;
+        sk_sketchClearElementsMarkedForDelete(&s);
+        sk_Line* readded = sk_sketchAddLine(&s, pts[4], pts[3]);
+        lineCount = 0;
+        for (sk_Line* l = sk_sketchFirstLine(&s); l; l = sk_sketchNextLine(&s, l)) {
+            lineCount++;
+        }
+        correct = readded->uniqueId != deletedUid && s.lineTable.count == lineCount;
+
+        // a copy gets its own, instead of finding lines in the original
+        sk_Sketch copy = sk_sketchDuplicate(&s, &a);
+        sk_Line* copyLine = sk_sketchAddLine(&copy, sk_sketchPointAt(&copy, pts[3]->slot), sk_sketchPointAt(&copy, pts[4]->slot));
+        correct &= copyLine != readded && copyLine->uniqueId == readded->uniqueId;
+        snz_testPrint(correct, "line table stays in sync thru deletes and copies");
+    }
+
+    snz_arenaDeinit(&scratch);
     snz_arenaDeinit(&a);
 }
+
+// 1k to 7k constraints of braced grid, solved w/ the old relaxation then the numeric solver,
+// then dragging around in a sketch of lots of separate shapes. Not run at startup.
+void sk_bench() {
+    snz_Arena arena = snz_arenaInit(100000000, "sk bench arena");
+    snz_Arena scratch = snz_arenaInit(100000000, "sk bench scratch");
+
+    for (int64_t size = 16; size <= 64; size *= 2) {
+        sk_Sketch s = sk_sketchInit(&arena);
+        _sk_testPushGrid(&s, size, 0.2, true, &arena);
+        uint64_t start = SDL_GetPerformanceCounter();
+        s.solveStats = (sk_SolveStats){ 0 };
+        if (!_sk_sketchSolveConstructive(&s)) {
+            _sk_sketchSolveRelaxation(&s);
+        }
+        _sk_sketchMarkViolated(&s);
+        double relaxTime = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+        sk_SolveStats relax = s.solveStats;
+        snz_arenaClear(&arena);
+
+        s = sk_sketchInit(&arena);
+        _sk_testPushGrid(&s, size, 0.2, true, &arena);
+        start = SDL_GetPerformanceCounter();
+        sk_sketchSolve(&s, &scratch);
+        double numericTime = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+        sk_SolveStats numeric = s.solveStats;
+        snz_arenaClear(&arena);
+
+        SNZ_LOGF("%" PRId64 "x%" PRId64 " grid, %" PRId64 " constraints: relaxation %.4fs, %" PRId64 " iters, max residual %f, %" PRId64 " violated. "
+                 "numeric %.4fs, %" PRId64 " iters, max residual %f, %" PRId64 " violated, %" PRId64 " dof",
+                 size, size, numeric.equationCount, relaxTime, relax.iterations, relax.maxResidual, relax.violatedCount,
+                 numericTime, numeric.iterations, numeric.maxResidual, numeric.violatedCount, numeric.dof);
+    }
+
+    {
+        // lots of separate shapes, like after an import. dragging one shouldn't cost anything like solving all of them
+        const int64_t squareCount = 2000;
+        sk_Sketch s = sk_sketchInit(&arena);
+        sk_sketchAddConstraintDistance(&s, s.originLine, 1);
+        sk_Point* pts[4] = { 0 };
+        for (int64_t i = 0; i < squareCount; i++) {
+            _sk_testPushSquare(&s, HMM_V2((i % 50) * 3, (i / 50) * 3 + 5), pts);
+        }
+
+        uint64_t start = SDL_GetPerformanceCounter();
+        sk_sketchSolve(&s, &scratch);
+        double fullTime = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+        int64_t fullIterations = s.solveStats.iterations;
+
+        pts[0]->pos = HMM_Add(pts[0]->pos, HMM_V2(0.3, 0.1));
+        start = SDL_GetPerformanceCounter();
+        sk_sketchSolve(&s, &scratch);
+        double dragTime = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+        SNZ_ASSERT(s.solveStats.clustersSolved == 1, "bench drag solved more than the dragged cluster.");
+
+        start = SDL_GetPerformanceCounter();
+        sk_sketchSolve(&s, &scratch);
+        double idleTime = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+        snz_arenaClear(&arena);
+
+        SNZ_LOGF("%" PRId64 " squares, %" PRId64 " clusters: full solve %.4fs, %" PRId64 " iters. dragging one %.5fs, nothing moved %.5fs",
+                 squareCount, s.solveStats.clusterCount, fullTime, fullIterations, dragTime, idleTime);
+    }
+
+    {
+        // adding lines in bulk, like an import or a pattern would, both new and ones that are already there.
+        // time per line should stay flat as the count goes up. each count gets its own arena, the pools + line table
+        // for 100k lines are about 50MB and that would only get bigger if anything got added to points or lines.
+        for (int64_t count = 25000; count <= 100000; count *= 2) {
+            snz_Arena linesArena = snz_arenaInitGrowable(10000000, "sk bench lines arena");
+            sk_Sketch s = sk_sketchInit(&linesArena);
+            sk_Point** pts = SNZ_ARENA_PUSH_ARR(&linesArena, count + 1, sk_Point*);
+            for (int64_t i = 0; i <= count; i++) {
+                pts[i] = sk_sketchAddPoint(&s, HMM_V2(i % 300, i / 300));
+            }
+
+            uint64_t start = SDL_GetPerformanceCounter();
+            for (int64_t i = 0; i < count; i++) {
+                sk_sketchAddLine(&s, pts[i], pts[i + 1]);
+            }
+            double addTime = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+            start = SDL_GetPerformanceCounter();
+            for (int64_t i = 0; i < count; i++) {
+                sk_sketchAddLine(&s, pts[i + 1], pts[i]);
+            }
+            double dupeTime = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+            snz_arenaDeinit(&linesArena);
+
+            SNZ_LOGF("%" PRId64 " lines: adding %.4fs (%.1fns each), re-adding %.4fs (%.1fns each)",
+                     count, addTime, addTime / count * 1e9, dupeTime, dupeTime / count * 1e9);
+        }
+    }
+
+    {
+        // dragging a corner of a grid around for a while, picking up from the last solve each frame vs. starting over
+        const int64_t size = 32;
+        const int64_t frameCount = 30;
+        for (int64_t warm = 0; warm < 2; warm++) {
+            sk_Sketch s = sk_sketchInit(&arena);
+            sk_Point** pts = _sk_testPushGrid(&s, size, 0.2, false, &arena);
+            sk_sketchSolve(&s, &scratch);
+
+            int64_t iterations = 0;
+            int64_t violated = 0;
+            uint64_t start = SDL_GetPerformanceCounter();
+            for (int64_t i = 0; i < frameCount; i++) {
+                sk_Point* dragged = pts[size * size - 1];
+                dragged->pos = HMM_Add(dragged->pos, HMM_V2(0.02, -0.03));
+                if (!warm) {
+                    s.clusterHash = 0;
+                }
+                sk_sketchSolve(&s, &scratch);
+                iterations += s.solveStats.iterations;
+                violated += s.solveStats.violatedCount;
+            }
+            double time = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+            snz_arenaClear(&arena);
+
+            SNZ_LOGF("%" PRId64 "x%" PRId64 " grid, dragged for %" PRId64 " frames, %s: %.4fs, %" PRId64 " iters, %" PRId64 " violated",
+                     size, size, frameCount, warm ? "warm" : "cold", time, iterations, violated);
+        }
+    }
+
+    snz_arenaDeinit(&scratch);
+    snz_arenaDeinit(&arena);
+}
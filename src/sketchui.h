@@ -119,7 +119,7 @@ static void _sku_constraintScaleFactorAndCenter(sk_Constraint* c, HMM_Mat4 model
     *outScaleFactor = scaleFactor;
 }
 
-static bool _sku_constraintHovered(sk_Constraint* c, float scaleFactor, HMM_Vec2 visualCenter, HMM_Vec2 mousePos) {
+static bool _sku_constraintHovered(const sk_Sketch* sketch, sk_Constraint* c, float scaleFactor, HMM_Vec2 visualCenter, HMM_Vec2 mousePos) {
     bool out = true;
     if (c->kind == SK_CK_DISTANCE) {
         HMM_Vec2 p1 = c->line1->p1->pos;
@@ -143,30 +143,31 @@ static bool _sku_constraintHovered(sk_Constraint* c, float scaleFactor, HMM_Vec2
             out = false;
         }
     } else {
-        SNZ_ASSERTF(false, "unreachable. kind: %d", c);
+        SNZ_ASSERTF(false, "unreachable. kind: %d", c->kind);
     }
 
-    if (c->uiInfo.textArea.inter.hovered) {
+    if (sk_constraintUi(sketch, c)->textArea.inter.hovered) {
         out = true;
     }
     return out;
 }
 
 // see _sku_buildConstraint, which this is dependent on for state
-static void _sku_drawConstraint(sk_Constraint* c, snz_Arena* scratch, HMM_Mat4 sketchMVP, float soundPct) {
-    float drawnThickness = HMM_Lerp(SKU_CONSTRAINT_THICKNESS, c->uiInfo.sel.hoverAnim, SKU_CONSTRAINT_HOVERED_THICKNESS);
+static void _sku_drawConstraint(const sk_Sketch* sketch, sk_Constraint* c, snz_Arena* scratch, HMM_Mat4 sketchMVP, float soundPct) {
+    const sk_ConstraintUi* ui = sk_constraintUi(sketch, c);
+    float drawnThickness = HMM_Lerp(SKU_CONSTRAINT_THICKNESS, ui->sel.hoverAnim, SKU_CONSTRAINT_HOVERED_THICKNESS);
 
     if (c->kind == SK_CK_DISTANCE) {
         HMM_Vec2 p1 = c->line1->p1->pos;
         HMM_Vec2 p2 = c->line1->p2->pos;
         HMM_Vec2 diff = HMM_NormV2(HMM_SubV2(p2, p1));
-        HMM_Vec2 offset = HMM_Mul(HMM_V2(diff.Y, -diff.X), SKU_DISTANCE_CONSTRAINT_OFFSET * (1 + soundPct) * c->uiInfo.scaleFactor);
+        HMM_Vec2 offset = HMM_Mul(HMM_V2(diff.Y, -diff.X), SKU_DISTANCE_CONSTRAINT_OFFSET * (1 + soundPct) * ui->scaleFactor);
         p1 = HMM_Add(p1, offset);
         p2 = HMM_Add(p2, offset);
         HMM_Vec4 points[2] = { 0 };
         points[0].XY = p1;
         points[1].XY = p2;
-        snzr_drawLine(points, 2, c->uiInfo.drawnColor, drawnThickness, sketchMVP);
+        snzr_drawLine(points, 2, ui->drawnColor, drawnThickness, sketchMVP);
     } else if (c->kind == SK_CK_ANGLE) {
         sk_Point* joint = NULL;
         // FIXME: this can be incorrect based on flippings, fix to always be accurate
@@ -178,7 +179,7 @@ static void _sku_drawConstraint(sk_Constraint* c, snz_Arena* scratch, HMM_Mat4 s
             return;
         }
 
-        float offset = SKU_ANGLE_CONSTRAINT_OFFSET * (1 + soundPct) * c->uiInfo.scaleFactor;
+        float offset = SKU_ANGLE_CONSTRAINT_OFFSET * (1 + soundPct) * ui->scaleFactor;
         if (geo_floatEqual(fabsf(c->value), HMM_AngleDeg(90))) {
             sk_Point* otherOnLine1 = (c->line1->p1 == joint) ? c->line1->p2 : c->line1->p1;
             sk_Point* otherOnLine2 = (c->line2->p1 == joint) ? c->line2->p2 : c->line2->p1;
@@ -188,7 +189,7 @@ static void _sku_drawConstraint(sk_Constraint* c, snz_Arena* scratch, HMM_Mat4 s
             pts[0].XY = HMM_Add(joint->pos, offset1);
             pts[1].XY = HMM_Add(joint->pos, HMM_Add(offset1, offset2));
             pts[2].XY = HMM_Add(joint->pos, offset2);
-            snzr_drawLine(pts, 3, c->uiInfo.drawnColor, drawnThickness, sketchMVP);
+            snzr_drawLine(pts, 3, ui->drawnColor, drawnThickness, sketchMVP);
         } else {
             HMM_Vec2 angles = _sku_angleOfLinesInAngleConstraint(c);
             float startAngle = angles.X;
@@ -200,7 +201,7 @@ static void _sku_drawConstraint(sk_Constraint* c, snz_Arena* scratch, HMM_Mat4 s
                 HMM_Vec2 o = HMM_RotateV2(HMM_V2(offset, 0), startAngle + (i * c->value / (ptCount - 1)));
                 linePts[i].XY = HMM_Add(joint->pos, o);
             }
-            snzr_drawLine(linePts, ptCount, c->uiInfo.drawnColor, drawnThickness, sketchMVP);
+            snzr_drawLine(linePts, ptCount, ui->drawnColor, drawnThickness, sketchMVP);
         }
     } else {
         SNZ_ASSERTF(false, "unreachable. kind: %d", c->kind);
@@ -209,45 +210,47 @@ static void _sku_drawConstraint(sk_Constraint* c, snz_Arena* scratch, HMM_Mat4 s
 
 // does UI state processing, calculates scaleFactor, center, color also, & should be called before drawConstraint
 // updates the constraints value (which will be unsolved unless equal to the previous frames value)
-static void _sku_buildConstraint(sk_Constraint* c, float sound, HMM_Mat4 model, HMM_Vec3 cameraPos, snz_Arena* scratch) {
-    c->uiInfo.drawnColor = ui_colorText;
+static void _sku_buildConstraint(sk_Sketch* sketch, sk_Constraint* c, float sound, HMM_Mat4 model, HMM_Vec3 cameraPos, snz_Arena* scratch) {
+    sk_ConstraintUi* ui = sk_constraintUi(sketch, c);
+    ui->drawnColor = ui_colorText;
     if (c->violated) {
-        c->uiInfo.drawnColor = ui_colorErr;
+        ui->drawnColor = ui_colorErr;
     }
-    c->uiInfo.drawnColor = HMM_LerpV4(c->uiInfo.drawnColor, c->uiInfo.sel.selectionAnim, ui_colorAccent);
+    ui->drawnColor = HMM_LerpV4(ui->drawnColor, ui->sel.selectionAnim, ui_colorAccent);
 
-    _sku_constraintScaleFactorAndCenter(c, model, cameraPos, &c->uiInfo.visualCenter, &c->uiInfo.scaleFactor);
+    _sku_constraintScaleFactorAndCenter(c, model, cameraPos, &ui->visualCenter, &ui->scaleFactor);
 
-    float drawnHeight = SKU_LABEL_SIZE * c->uiInfo.scaleFactor;
+    float drawnHeight = SKU_LABEL_SIZE * ui->scaleFactor;
 
     HMM_Vec2 textTopLeft = HMM_V2(0, 0);  // TL of the label in sketch space
     if (c->kind == SK_CK_DISTANCE) {
         HMM_Vec2 p1 = c->line1->p1->pos;
         HMM_Vec2 p2 = c->line1->p2->pos;
         HMM_Vec2 diff = HMM_NormV2(HMM_SubV2(p2, p1));
-        HMM_Vec2 offset = HMM_Mul(HMM_V2(diff.Y, -diff.X), SKU_DISTANCE_CONSTRAINT_OFFSET * (1 + sound) * c->uiInfo.scaleFactor);
-        textTopLeft = HMM_Add(c->uiInfo.visualCenter, HMM_Mul(offset, 2.0f));
+        HMM_Vec2 offset = HMM_Mul(HMM_V2(diff.Y, -diff.X), SKU_DISTANCE_CONSTRAINT_OFFSET * (1 + sound) * ui->scaleFactor);
+        textTopLeft = HMM_Add(ui->visualCenter, HMM_Mul(offset, 2.0f));
     } else if (c->kind == SK_CK_ANGLE) {
         HMM_Vec2 angles = _sku_angleOfLinesInAngleConstraint(c);
         float startAngle = angles.X;
         float angleRange = _sku_angleDifferenceForConstraint(c, angles.Left, angles.Right);
-        float offset = SKU_ANGLE_CONSTRAINT_OFFSET * (1 + sound) * c->uiInfo.scaleFactor;
+        float offset = SKU_ANGLE_CONSTRAINT_OFFSET * (1 + sound) * ui->scaleFactor;
         textTopLeft = HMM_RotateV2(HMM_V2(offset * 1.5, 0), startAngle + angleRange / 2);
-        textTopLeft = HMM_Add(textTopLeft, c->uiInfo.visualCenter);
+        textTopLeft = HMM_Add(textTopLeft, ui->visualCenter);
     } else {
         SNZ_ASSERTF(false, "unreachable. kind: %d", c->kind);
     }
 
-    char* boxName = snz_arenaFormatStr(scratch, "%p", c);
+    // uid too, the memory of a deleted constraint gets reused and shouldn't pick up its text box
+    char* boxName = snz_arenaFormatStr(scratch, "%p %" PRId64, (void*)c, c->uniqueId);
     snzu_boxNew(boxName);
     textTopLeft.Y *= -1;  // flip to UI space before drawing
     snzu_boxSetStart(textTopLeft);
 
     // FIXME: this can be clicked while in line mode and it is not correct
-    ui_textArea(&c->uiInfo.textArea, &ui_titleFont, drawnHeight, c->uiInfo.drawnColor, c->uiInfo.shouldStartFocus);
-    c->uiInfo.shouldStartFocus = false;
+    ui_textArea(&ui->textArea, &ui_titleFont, drawnHeight, ui->drawnColor, ui->shouldStartFocus);
+    ui->shouldStartFocus = false;
 
-    float val = atof(c->uiInfo.textArea.chars);
+    float val = atof(ui->textArea.chars);
 
     // FIXME: unit spec parsing
     if (c->kind == SK_CK_ANGLE) {
@@ -267,14 +270,15 @@ static void _sku_buildConstraint(sk_Constraint* c, float sound, HMM_Mat4 model,
         }
     }
 
-    if (!geo_floatZero(val)) {
+    if (!geo_floatZero(val) && val != c->value) {  // this runs every frame, only changes should cause a re-solve
         c->value = val;  // FIXME: when this turns into a 90deg angle, the text box immediately disappears
+        sk_sketchMarkChanged(sketch);
     }
 
-    if (!c->uiInfo.textArea.wasFocused) {  // FIXME: kinda wasteful to have this running constantly
+    if (!ui->textArea.wasFocused) {  // FIXME: kinda wasteful to have this running constantly
         // FIXME: this has a one frame delay on scene open before things have text. ig its fine but not ideal.
         const char* str = sk_constraintLabelStr(c, scratch);
-        ui_textAreaSetStr(&c->uiInfo.textArea, str, strlen(str));
+        ui_textAreaSetStr(&ui->textArea, str, strlen(str));
     }
 
     // FIXME: flip labels if camera is on the other side
@@ -352,6 +356,642 @@ static bool _sku_AABBContainsPt(HMM_Vec2 boxStart, HMM_Vec2 boxEnd, HMM_Vec2 pt)
     return false;
 }
 
+typedef enum {
+    SKU_GEK_POINT,
+    SKU_GEK_LINE,
+    SKU_GEK_CONSTRAINT,
+    SKU_GEK_COUNT,
+} _sku_GridEntryKind;
+
+typedef struct {
+    int64_t x;
+    int64_t y;
+    _sku_GridEntryKind kind;
+    union {
+        sk_Point* point;
+        sk_Line* line;
+        sk_Constraint* constraint;
+        void* elt;
+    };
+    // all of these are entry idx + 1, zero at the end
+    int64_t nextInCell;
+    int64_t prevInCell;
+    int64_t nextOfElt;  // thru everything filed for the same elt, also the free list
+} _sku_GridEntry;
+
+SNZ_SLICE(_sku_GridEntry);
+
+typedef struct {
+    bool occupied;
+    int64_t x;
+    int64_t y;
+    int64_t firstEntry;  // idx + 1, zero when empty. empty cells stay occupied until the next rehash
+} _sku_GridCell;
+
+// what the grid knows about one slot of a sketch pool, see _sku_Grid.filed
+typedef struct {
+    void* elt;  // whatever was in the slot as of the last update, NULL for nothing
+    HMM_Vec2 a;  // where elt was filed from, see _sku_gridEltPositions
+    HMM_Vec2 b;
+    int64_t firstEntry;  // idx + 1, zero if nothing got filed (off at inf)
+    bool active;  // in the grids active list for this kind
+} _sku_GridFiled;
+
+// FIXME: lines longer than this only get filed along the first part of them, shouldn't happen w/ how cells get sized
+#define SKU_GRID_MAX_LINE_STEPS 100000
+
+// uniform grid over where the pts, lines, and constraint handles of a sketch are, so hover + box select only have to
+// look at what's filed near the mouse. Same idea as tl_NodeGrid, but updated in place: each pool slot remembers where
+// it got filed from, and only elts that moved (or got swapped out) are taken out + put back. See _sku_gridUpdate.
+//
+// Also keeps the active list, every elt w/ any selection/hover/drag state that isn't at rest. Everything else would
+// come out of a selection update the same as it went in, so the per frame status + animation work only looks at these.
+typedef struct {
+    _sku_GridEntry* entries;
+    int64_t entryCount;  // live ones, not counting the free list
+    int64_t entryCapacity;
+    int64_t entryEnd;  // entries past this have never been used
+    int64_t firstFreeEntry;  // idx + 1
+    _sku_GridCell* cells;  // open addressing w/ linear probing, cell -> its list of entries
+    int64_t cellCapacity;  // always a power of two
+    int64_t cellCount;
+    float cellSize;  // sketch units, picked on rebuild to fit about one pt per cell
+    float longestLine;  // see _sku_hoverQueryRadius
+
+    _sku_GridFiled* filed[SKU_GEK_COUNT];  // by kind, then by slot
+    int64_t filedCapacity[SKU_GEK_COUNT];
+    int64_t* active[SKU_GEK_COUNT];  // slots, by kind. see _sku_gridActivate
+    int64_t activeCount[SKU_GEK_COUNT];
+    int64_t activeCapacity[SKU_GEK_COUNT];
+
+    const sk_Sketch* sketch;  // and its versions as of the last update
+    const char* firstPages[SKU_GEK_COUNT];  // of each of its pools, a sketch loaded over the old one gets new ones
+    uint64_t version;
+    uint64_t solvedVersion;
+} _sku_Grid;
+
+// there's only ever one sketch up in the ui at a time
+static _sku_Grid _sku_grid;
+
+static int64_t _sku_gridCoord(const _sku_Grid* g, float v) {
+    return (int64_t)floorf(v / g->cellSize);
+}
+
+static int64_t _sku_gridFirstSlot(const _sku_Grid* g, int64_t x, int64_t y) {
+    uint64_t hash = 14695981039346656037ULL;
+    hash = _SK_HASH_VAL(hash, x);
+    hash = _SK_HASH_VAL(hash, y);
+    return (int64_t)(hash & (uint64_t)(g->cellCapacity - 1));
+}
+
+static _sku_GridCell* _sku_gridFindCell(const _sku_Grid* g, int64_t x, int64_t y) {
+    if (g->cellCount == 0) {
+        return NULL;
+    }
+    for (int64_t i = _sku_gridFirstSlot(g, x, y); g->cells[i].occupied; i = (i + 1) & (g->cellCapacity - 1)) {
+        if (g->cells[i].x == x && g->cells[i].y == y) {
+            return &g->cells[i];
+        }
+    }
+    return NULL;
+}
+
+// cells that emptied out get dropped here, it's the only time they can be w/o breaking probe chains
+static void _sku_gridRehash(_sku_Grid* g, int64_t capacity) {
+    _sku_GridCell* old = g->cells;
+    int64_t oldCapacity = g->cellCapacity;
+    g->cells = calloc(capacity, sizeof(*g->cells));
+    SNZ_ASSERTF(g->cells != NULL, "sketch grid alloc failed, capacity: %" PRId64, capacity);
+    g->cellCapacity = capacity;
+    g->cellCount = 0;
+    for (int64_t i = 0; i < oldCapacity; i++) {
+        if (!old[i].occupied || !old[i].firstEntry) {
+            continue;
+        }
+        int64_t j = _sku_gridFirstSlot(g, old[i].x, old[i].y);
+        while (g->cells[j].occupied) {
+            j = (j + 1) & (g->cellCapacity - 1);
+        }
+        g->cells[j] = old[i];
+        g->cellCount++;
+    }
+    free(old);
+}
+
+// finds or makes the cell at x, y
+static _sku_GridCell* _sku_gridCellAt(_sku_Grid* g, int64_t x, int64_t y) {
+    _sku_GridCell* cell = _sku_gridFindCell(g, x, y);
+    if (cell) {
+        return cell;
+    }
+    // half full at most
+    if ((g->cellCount + 1) * 2 > g->cellCapacity) {
+        int64_t capacity = SNZ_MAX(g->cellCapacity, 64);
+        while (capacity < (g->cellCount + 1) * 4) {
+            capacity *= 2;
+        }
+        _sku_gridRehash(g, capacity);
+    }
+    int64_t i = _sku_gridFirstSlot(g, x, y);
+    while (g->cells[i].occupied) {
+        i = (i + 1) & (g->cellCapacity - 1);
+    }
+    g->cells[i] = (_sku_GridCell){ .occupied = true, .x = x, .y = y };
+    g->cellCount++;
+    return &g->cells[i];
+}
+
+// links entry into its cell and onto the front of the elts list, returns the new head of that list
+static int64_t _sku_gridPushEntry(_sku_Grid* g, _sku_GridEntry entry, int64_t firstOfElt) {
+    int64_t idx = 0;
+    if (g->firstFreeEntry) {
+        idx = g->firstFreeEntry - 1;
+        g->firstFreeEntry = g->entries[idx].nextOfElt;
+    } else {
+        if (g->entryEnd >= g->entryCapacity) {
+            g->entryCapacity = g->entryCapacity ? g->entryCapacity * 2 : 256;
+            g->entries = realloc(g->entries, sizeof(*g->entries) * g->entryCapacity);
+            SNZ_ASSERTF(g->entries != NULL, "sketch grid alloc failed, capacity: %" PRId64, g->entryCapacity);
+        }
+        idx = g->entryEnd;
+        g->entryEnd++;
+    }
+
+    _sku_GridCell* cell = _sku_gridCellAt(g, entry.x, entry.y);
+    entry.prevInCell = 0;
+    entry.nextInCell = cell->firstEntry;
+    entry.nextOfElt = firstOfElt;
+    if (cell->firstEntry) {
+        g->entries[cell->firstEntry - 1].prevInCell = idx + 1;
+    }
+    cell->firstEntry = idx + 1;
+    g->entries[idx] = entry;
+    g->entryCount++;
+    return idx + 1;
+}
+
+// solves that blow up can leave pts at inf/nan, those don't get filed (and can't be hovered anyways)
+static bool _sku_gridPtFileable(HMM_Vec2 pt) {
+    return isfinite(pt.X) && isfinite(pt.Y);
+}
+
+static int64_t _sku_gridFilePt(_sku_Grid* g, _sku_GridEntry entry, HMM_Vec2 pt) {
+    if (!_sku_gridPtFileable(pt)) {
+        return 0;
+    }
+    entry.x = _sku_gridCoord(g, pt.X);
+    entry.y = _sku_gridCoord(g, pt.Y);
+    return _sku_gridPushEntry(g, entry, 0);
+}
+
+// files entry in every cell the line from a to b crosses, see _tl_nodeGridFileLine. Returns the first of them.
+static int64_t _sku_gridFileLine(_sku_Grid* g, _sku_GridEntry entry, HMM_Vec2 a, HMM_Vec2 b) {
+    if (!_sku_gridPtFileable(a) || !_sku_gridPtFileable(b)) {
+        return 0;
+    }
+    int64_t steps = (int64_t)ceilf(HMM_Len(HMM_Sub(b, a)) / (g->cellSize / 2));
+    steps = SNZ_MIN(steps, SKU_GRID_MAX_LINE_STEPS);
+    int64_t prevX = _sku_gridCoord(g, a.X);
+    int64_t prevY = _sku_gridCoord(g, a.Y);
+    entry.x = prevX;
+    entry.y = prevY;
+    int64_t first = _sku_gridPushEntry(g, entry, 0);
+    for (int64_t i = 1; i <= steps; i++) {
+        HMM_Vec2 pt = HMM_Lerp(a, (float)i / steps, b);
+        int64_t x = _sku_gridCoord(g, pt.X);
+        int64_t y = _sku_gridCoord(g, pt.Y);
+        if (x == prevX && y == prevY) {
+            continue;
+        } else if (x != prevX && y != prevY) {
+            entry.x = prevX;
+            entry.y = y;
+            first = _sku_gridPushEntry(g, entry, first);
+            entry.x = x;
+            entry.y = prevY;
+            first = _sku_gridPushEntry(g, entry, first);
+        }
+        entry.x = x;
+        entry.y = y;
+        first = _sku_gridPushEntry(g, entry, first);
+        prevX = x;
+        prevY = y;
+    }
+    return first;
+}
+
+// the elt in slot of the pool for kind, NULL if it's free
+static void* _sku_gridEltAt(const sk_Sketch* sketch, _sku_GridEntryKind kind, int64_t slot) {
+    if (kind == SKU_GEK_POINT) {
+        return sk_sketchPointAt(sketch, slot);
+    } else if (kind == SKU_GEK_LINE) {
+        return sk_sketchLineAt(sketch, slot);
+    } else if (kind == SKU_GEK_CONSTRAINT) {
+        return sk_sketchConstraintAt(sketch, slot);
+    }
+    SNZ_ASSERTF(false, "unreachable case. kind: %d", kind);
+    return NULL;
+}
+
+static const _sk_Pool* _sku_gridPool(const sk_Sketch* sketch, _sku_GridEntryKind kind) {
+    if (kind == SKU_GEK_POINT) {
+        return &sketch->points;
+    } else if (kind == SKU_GEK_LINE) {
+        return &sketch->lines;
+    }
+    return &sketch->constraints;
+}
+
+// everything about elt that decides which cells it goes in. Constraints are filed by what their hover area is built
+// around, see _sku_constraintHovered
+static void _sku_gridEltPositions(_sku_GridEntryKind kind, void* elt, HMM_Vec2* outA, HMM_Vec2* outB) {
+    if (kind == SKU_GEK_POINT) {
+        *outA = ((sk_Point*)elt)->pos;
+        *outB = *outA;
+    } else if (kind == SKU_GEK_LINE) {
+        *outA = ((sk_Line*)elt)->p1->pos;
+        *outB = ((sk_Line*)elt)->p2->pos;
+    } else {
+        sk_Constraint* c = elt;
+        if (c->kind == SK_CK_ANGLE) {
+            *outA = c->flipLine1 ? c->line1->p2->pos : c->line1->p1->pos;
+            *outB = *outA;
+        } else if (c->kind == SK_CK_DISTANCE) {
+            *outA = c->line1->p1->pos;
+            *outB = c->line1->p2->pos;
+        } else {
+            SNZ_ASSERTF(false, "unreachable case. kind: %d", c->kind);
+        }
+    }
+}
+
+// zeroed out past whatever was there, so new slots start w/ nothing filed
+static _sku_GridFiled* _sku_gridFiledAt(_sku_Grid* g, _sku_GridEntryKind kind, int64_t slot) {
+    if (slot >= g->filedCapacity[kind]) {
+        int64_t capacity = SNZ_MAX(g->filedCapacity[kind], 64);
+        while (capacity <= slot) {
+            capacity *= 2;
+        }
+        g->filed[kind] = realloc(g->filed[kind], sizeof(*g->filed[kind]) * capacity);
+        SNZ_ASSERTF(g->filed[kind] != NULL, "sketch grid alloc failed, capacity: %" PRId64, capacity);
+        memset(&g->filed[kind][g->filedCapacity[kind]], 0, sizeof(*g->filed[kind]) * (capacity - g->filedCapacity[kind]));
+        g->filedCapacity[kind] = capacity;
+    }
+    return &g->filed[kind][slot];
+}
+
+static void _sku_gridUnfile(_sku_Grid* g, _sku_GridFiled* f) {
+    int64_t next = 0;
+    for (int64_t i = f->firstEntry; i; i = next) {
+        _sku_GridEntry* e = &g->entries[i - 1];
+        next = e->nextOfElt;
+        if (e->prevInCell) {
+            g->entries[e->prevInCell - 1].nextInCell = e->nextInCell;
+        } else {
+            _sku_gridFindCell(g, e->x, e->y)->firstEntry = e->nextInCell;
+        }
+        if (e->nextInCell) {
+            g->entries[e->nextInCell - 1].prevInCell = e->prevInCell;
+        }
+        e->nextOfElt = g->firstFreeEntry;
+        g->firstFreeEntry = i;
+        g->entryCount--;
+    }
+    f->elt = NULL;
+    f->firstEntry = 0;
+}
+
+static void _sku_gridFile(_sku_Grid* g, _sku_GridFiled* f, _sku_GridEntryKind kind, void* elt, HMM_Vec2 a, HMM_Vec2 b) {
+    _sku_GridEntry entry = (_sku_GridEntry){ .kind = kind, .elt = elt };
+    if (kind == SKU_GEK_POINT || (kind == SKU_GEK_CONSTRAINT && ((sk_Constraint*)elt)->kind == SK_CK_ANGLE)) {
+        f->firstEntry = _sku_gridFilePt(g, entry, a);
+    } else {
+        f->firstEntry = _sku_gridFileLine(g, entry, a, b);
+    }
+    f->elt = elt;
+    f->a = a;
+    f->b = b;
+}
+
+// puts slot in the active list if it isn't already, anything that gives an elt selection/hover state has to call this
+static void _sku_gridActivate(_sku_Grid* g, _sku_GridEntryKind kind, int64_t slot) {
+    _sku_GridFiled* f = _sku_gridFiledAt(g, kind, slot);
+    if (f->active) {
+        return;
+    }
+    f->active = true;
+    if (g->activeCount[kind] >= g->activeCapacity[kind]) {
+        g->activeCapacity[kind] = g->activeCapacity[kind] ? g->activeCapacity[kind] * 2 : 64;
+        g->active[kind] = realloc(g->active[kind], sizeof(*g->active[kind]) * g->activeCapacity[kind]);
+        SNZ_ASSERTF(g->active[kind] != NULL, "sketch grid alloc failed, capacity: %" PRId64, g->activeCapacity[kind]);
+    }
+    g->active[kind][g->activeCount[kind]] = slot;
+    g->activeCount[kind]++;
+}
+
+// anims that get this close to zero are snapped there, they'd never get there on their own
+#define SKU_ANIM_REST 0.001f
+
+// true if an elt w/ this state would come out of selection updates w/ it unchanged, see _sku_Grid.active
+static bool _sku_selectionAtRest(ui_SelectionState* sel) {
+    return !sel->selected && !sel->tempSelected && sel->hoverAnim < SKU_ANIM_REST && sel->selectionAnim < SKU_ANIM_REST;
+}
+
+static ui_SelectionState* _sku_gridEltSelection(const sk_Sketch* sketch, _sku_GridEntryKind kind, void* elt) {
+    if (kind == SKU_GEK_POINT) {
+        return &sk_pointUi(sketch, elt)->sel;
+    } else if (kind == SKU_GEK_LINE) {
+        return &sk_lineUi(sketch, elt)->sel;
+    }
+    return &sk_constraintUi(sketch, elt)->sel;
+}
+
+static bool _sku_gridEltAtRest(const sk_Sketch* sketch, _sku_GridEntryKind kind, void* elt) {
+    if (kind == SKU_GEK_POINT) {
+        sk_PointUi* ui = sk_pointUi(sketch, elt);
+        return _sku_selectionAtRest(&ui->sel) && !ui->hovered && !ui->inDragZone;
+    } else if (kind == SKU_GEK_LINE) {
+        sk_LineUi* ui = sk_lineUi(sketch, elt);
+        return _sku_selectionAtRest(&ui->sel) && !ui->hovered;
+    }
+    sk_ConstraintUi* ui = sk_constraintUi(sketch, elt);
+    return _sku_selectionAtRest(&ui->sel) && !ui->hovered && !ui->textArea.inter.hovered;
+}
+
+// drops everything from the active list that's at rest or gone
+static void _sku_gridPruneActive(_sku_Grid* g, const sk_Sketch* sketch) {
+    for (_sku_GridEntryKind kind = 0; kind < SKU_GEK_COUNT; kind++) {
+        for (int64_t i = 0; i < g->activeCount[kind];) {
+            int64_t slot = g->active[kind][i];
+            void* elt = _sku_gridEltAt(sketch, kind, slot);
+            if (elt && !_sku_gridEltAtRest(sketch, kind, elt)) {
+                i++;
+                continue;
+            }
+            if (elt) {
+                ui_SelectionState* sel = _sku_gridEltSelection(sketch, kind, elt);
+                sel->hoverAnim = 0;
+                sel->selectionAnim = 0;
+            }
+            g->filed[kind][slot].active = false;
+            g->activeCount[kind]--;
+            g->active[kind][i] = g->active[kind][g->activeCount[kind]];
+        }
+    }
+}
+
+static int64_t _sku_gridEntrySlot(const _sku_GridEntry* e) {
+    if (e->kind == SKU_GEK_POINT) {
+        return e->point->slot;
+    } else if (e->kind == SKU_GEK_LINE) {
+        return e->line->slot;
+    }
+    return e->constraint->slot;
+}
+
+// only what's active can be selected, so this is the same as sk_sketchDeselectAll w/o going thru everything
+static void _sku_gridDeselectAll(_sku_Grid* g, const sk_Sketch* sketch) {
+    for (_sku_GridEntryKind kind = 0; kind < SKU_GEK_COUNT; kind++) {
+        for (int64_t i = 0; i < g->activeCount[kind]; i++) {
+            void* elt = _sku_gridEltAt(sketch, kind, g->active[kind][i]);
+            if (elt) {
+                _sku_gridEltSelection(sketch, kind, elt)->selected = false;
+            }
+        }
+    }
+}
+
+// cells sized so that pts spread evenly over the sketch would be about one per cell
+static float _sku_gridIdealCellSize(HMM_Vec2 min, HMM_Vec2 max, int64_t ptCount) {
+    if (ptCount > 1) {
+        float extent = SNZ_MAX(max.X - min.X, max.Y - min.Y);
+        float size = extent / sqrtf((float)ptCount);
+        if (isfinite(size) && size > 0.0001f) {
+            return size;
+        }
+    }
+    return 1;
+}
+
+// throws out everything and files the whole sketch again w/ cells cellSize big. The active list is refilled from
+// scratch too, a sketch the grid hasn't seen could have state from the last time it was up.
+static void _sku_gridRebuild(_sku_Grid* g, const sk_Sketch* sketch, float cellSize) {
+    g->entryCount = 0;
+    g->entryEnd = 0;
+    g->firstFreeEntry = 0;
+    g->cellCount = 0;
+    if (g->cells) {
+        memset(g->cells, 0, sizeof(*g->cells) * g->cellCapacity);
+    }
+    g->cellSize = cellSize;
+    g->longestLine = 0;
+
+    for (_sku_GridEntryKind kind = 0; kind < SKU_GEK_COUNT; kind++) {
+        if (g->filed[kind]) {
+            memset(g->filed[kind], 0, sizeof(*g->filed[kind]) * g->filedCapacity[kind]);
+        }
+        g->activeCount[kind] = 0;
+        int64_t count = _sku_gridPool(sketch, kind)->count;
+        for (int64_t slot = 0; slot < count; slot++) {
+            void* elt = _sku_gridEltAt(sketch, kind, slot);
+            if (!elt) {
+                continue;
+            }
+            HMM_Vec2 a, b;
+            _sku_gridEltPositions(kind, elt, &a, &b);
+            _sku_gridFile(g, _sku_gridFiledAt(g, kind, slot), kind, elt, a, b);
+            if (!_sku_gridEltAtRest(sketch, kind, elt)) {
+                _sku_gridActivate(g, kind, slot);
+            }
+            float length = HMM_Len(HMM_Sub(b, a));
+            if (kind == SKU_GEK_LINE && isfinite(length)) {
+                g->longestLine = SNZ_MAX(g->longestLine, length);
+            }
+        }
+    }
+}
+
+static void _sku_gridDeinit(_sku_Grid* g) {
+    free(g->entries);
+    free(g->cells);
+    for (_sku_GridEntryKind kind = 0; kind < SKU_GEK_COUNT; kind++) {
+        free(g->filed[kind]);
+        free(g->active[kind]);
+    }
+    *g = (_sku_Grid){ 0 };
+}
+
+// brings the grid up to date if sketch isn't the one it was built for, or has been edited or solved since.
+// Versions are unique across sketches, so this is just a couple compares when nothing happened. Otherwise every slot
+// gets its filed positions compared, and only elts that moved are refiled. A drag only moves the clusters it touches
+// (see sk_sketchSolve), so that's the dragged pts + whatever's attached, not the whole sketch. Only rebuilds for a
+// different sketch, or once the cells are far off from what would fit.
+static void _sku_gridUpdate(_sku_Grid* g, const sk_Sketch* sketch) {
+    if (g->sketch == sketch && g->version == sketch->version && g->solvedVersion == sketch->solvedVersion) {
+        return;
+    }
+    bool sameSketch = g->sketch == sketch && g->cellSize > 0;
+    for (_sku_GridEntryKind kind = 0; kind < SKU_GEK_COUNT; kind++) {
+        sameSketch &= g->firstPages[kind] == _sku_gridPool(sketch, kind)->pages[0];
+        g->firstPages[kind] = _sku_gridPool(sketch, kind)->pages[0];
+    }
+    g->sketch = sketch;
+    g->version = sketch->version;
+    g->solvedVersion = sketch->solvedVersion;
+
+    HMM_Vec2 min = HMM_V2(INFINITY, INFINITY);
+    HMM_Vec2 max = HMM_V2(-INFINITY, -INFINITY);
+    int64_t ptCount = 0;
+    for (sk_Point* p = sk_sketchFirstPoint(sketch); p; p = sk_sketchNextPoint(sketch, p)) {
+        if (_sku_gridPtFileable(p->pos)) {
+            min = HMM_V2(SNZ_MIN(min.X, p->pos.X), SNZ_MIN(min.Y, p->pos.Y));
+            max = HMM_V2(SNZ_MAX(max.X, p->pos.X), SNZ_MAX(max.Y, p->pos.Y));
+            ptCount++;
+        }
+    }
+    float idealCellSize = _sku_gridIdealCellSize(min, max, ptCount);
+    // anywhere in here the cells still hold a handful of things each, past it they're worth resizing
+    if (!sameSketch || idealCellSize > g->cellSize * 4 || idealCellSize * 4 < g->cellSize) {
+        _sku_gridRebuild(g, sketch, idealCellSize);
+        return;
+    }
+
+    g->longestLine = 0;
+    for (_sku_GridEntryKind kind = 0; kind < SKU_GEK_COUNT; kind++) {
+        int64_t count = SNZ_MAX(_sku_gridPool(sketch, kind)->count, g->filedCapacity[kind]);
+        for (int64_t slot = 0; slot < count; slot++) {
+            void* elt = _sku_gridEltAt(sketch, kind, slot);
+            _sku_GridFiled* f = slot < g->filedCapacity[kind] ? &g->filed[kind][slot] : NULL;
+            if (!elt) {
+                if (f && f->elt) {
+                    _sku_gridUnfile(g, f);
+                }
+                continue;
+            }
+
+            HMM_Vec2 a, b;
+            _sku_gridEltPositions(kind, elt, &a, &b);
+            float length = HMM_Len(HMM_Sub(b, a));
+            if (kind == SKU_GEK_LINE && isfinite(length)) {
+                g->longestLine = SNZ_MAX(g->longestLine, length);
+            }
+            // as bytes, so nans don't count as moving every time
+            if (f && f->elt == elt && memcmp(&f->a, &a, sizeof(a)) == 0 && memcmp(&f->b, &b, sizeof(b)) == 0) {
+                continue;
+            }
+            f = _sku_gridFiledAt(g, kind, slot);
+            if (f->elt) {
+                _sku_gridUnfile(g, f);
+            }
+            _sku_gridFile(g, f, kind, elt, a, b);
+        }
+    }
+}
+
+// every entry filed in a cell touching the sketch space rect. Anything with a pt or part of a line in the rect comes
+// out, and probably some that don't, so check. Lines + distance constraints come out once per cell they're in.
+// As of the last _sku_gridUpdate.
+static _sku_GridEntrySlice _sku_gridQuery(const _sku_Grid* g, HMM_Vec2 min, HMM_Vec2 max, snz_Arena* arena) {
+    SNZ_ARENA_ARR_BEGIN(arena, _sku_GridEntry);
+    if (g->cellCount == 0 || !_sku_gridPtFileable(min) || !_sku_gridPtFileable(max)) {
+        return SNZ_ARENA_ARR_END(arena, _sku_GridEntry);
+    }
+    // doubles so a huge rect (mouse off at the horizon) doesn't overflow the cell coords
+    double minX = floor(min.X / g->cellSize);
+    double minY = floor(min.Y / g->cellSize);
+    double maxX = floor(max.X / g->cellSize);
+    double maxY = floor(max.Y / g->cellSize);
+    bool coordsFit = SNZ_MAX(fabs(minX), fabs(maxX)) < 1e15 && SNZ_MAX(fabs(minY), fabs(maxY)) < 1e15;
+
+    double rangeCellCount = (maxX - minX + 1) * (maxY - minY + 1);
+    if (!coordsFit || rangeCellCount > g->cellCount) {
+        // zoomed way out, going thru the cells that have anything in them is less
+        for (int64_t i = 0; i < g->cellCapacity; i++) {
+            const _sku_GridCell* cell = &g->cells[i];
+            if (cell->occupied && cell->x >= minX && cell->x <= maxX && cell->y >= minY && cell->y <= maxY) {
+                for (int64_t j = cell->firstEntry; j; j = g->entries[j - 1].nextInCell) {
+                    *SNZ_ARENA_PUSH(arena, _sku_GridEntry) = g->entries[j - 1];
+                }
+            }
+        }
+    } else {
+        for (int64_t x = (int64_t)minX; x <= (int64_t)maxX; x++) {
+            for (int64_t y = (int64_t)minY; y <= (int64_t)maxY; y++) {
+                const _sku_GridCell* cell = _sku_gridFindCell(g, x, y);
+                if (!cell) {
+                    continue;
+                }
+                for (int64_t j = cell->firstEntry; j; j = g->entries[j - 1].nextInCell) {
+                    *SNZ_ARENA_PUSH(arena, _sku_GridEntry) = g->entries[j - 1];
+                }
+            }
+        }
+    }
+    return SNZ_ARENA_ARR_END(arena, _sku_GridEntry);
+}
+
+// biggest fraction of its distance to the camera that anything is hoverable from, see the hover checks below.
+// angle constraints are the widest, at SKU_ANGLE_CONSTRAINT_OFFSET * 1.4
+#define SKU_HOVER_MAX_SCALE 0.08f
+
+// how far from the mouse something can be and still be hovered. Hover distances scale with how far the elt is from
+// the camera, which is at most the mouses distance + how far the mouse is from it (the sketch is rigidly placed), and
+// for lines it's measured from their midpoint, up to half the longest line away from where the mouse is nearest.
+static float _sku_hoverQueryRadius(const _sku_Grid* g, float mouseDistToCamera) {
+    return SKU_HOVER_MAX_SCALE * (mouseDistToCamera + g->longestLine / 2) / (1 - SKU_HOVER_MAX_SCALE);
+}
+
+// sets hovered on every pt, line, and constraint in the grid that the mouse (in sketch space) is over, and puts them
+// in the active list. Anything not filed near the mouse is left alone, it couldn't be hovered and the flags are
+// expected to already be false. Constraint labels can be hovered from anywhere, so those get checked by the caller.
+static void _sku_markHovered(_sku_Grid* g, HMM_Vec2 mouse, HMM_Mat4 model, HMM_Vec3 cameraPos, snz_Arena* scratch) {
+    HMM_Vec3 mouseTransformed = _sku_mulM4V3(model, HMM_V3(mouse.X, mouse.Y, 0));
+    float radius = _sku_hoverQueryRadius(g, HMM_Len(HMM_Sub(cameraPos, mouseTransformed)));
+    HMM_Vec2 offset = HMM_V2(radius, radius);
+    _sku_GridEntrySlice nearMouse = _sku_gridQuery(g, HMM_Sub(mouse, offset), HMM_Add(mouse, offset), scratch);
+
+    for (int64_t i = 0; i < nearMouse.count; i++) {
+        _sku_GridEntry* e = &nearMouse.elems[i];
+        if (e->kind == SKU_GEK_POINT) {
+            sk_Point* p = e->point;
+            HMM_Vec3 transformed = HMM_MulM4V4(model, HMM_V4(p->pos.X, p->pos.Y, 0, 1)).XYZ;
+            float scaleFactor = HMM_Len(HMM_Sub(cameraPos, transformed));
+            sk_PointUi* ui = sk_pointUi(g->sketch, p);
+            ui->scaleFactor = scaleFactor;
+            ui->hovered = HMM_Len(HMM_Sub(mouse, p->pos)) < (0.02 * scaleFactor);
+            if (ui->hovered) {
+                _sku_gridActivate(g, SKU_GEK_POINT, p->slot);
+            }
+        } else if (e->kind == SKU_GEK_LINE) {
+            sk_Line* l = e->line;
+            HMM_Vec2 midpt = HMM_DivV2F(HMM_Add(l->p1->pos, l->p2->pos), 2.0f);
+            HMM_Vec3 transformedCenter = HMM_MulM4V4(model, HMM_V4(midpt.X, midpt.Y, 0, 1)).XYZ;
+            float distToCamera = HMM_Len(HMM_Sub(transformedCenter, cameraPos));
+            sk_LineUi* ui = sk_lineUi(g->sketch, l);
+            ui->hovered = _sku_lineContainsPt(l->p1->pos, l->p2->pos, 0.01 * distToCamera, mouse);
+            if (ui->hovered) {
+                _sku_gridActivate(g, SKU_GEK_LINE, l->slot);
+            }
+        } else if (e->kind == SKU_GEK_CONSTRAINT) {
+            sk_Constraint* c = e->constraint;
+            HMM_Vec2 visualCenter;
+            float scaleFactor;
+            _sku_constraintScaleFactorAndCenter(c, model, cameraPos, &visualCenter, &scaleFactor);
+            sk_ConstraintUi* ui = sk_constraintUi(g->sketch, c);
+            ui->hovered = _sku_constraintHovered(g->sketch, c, scaleFactor, visualCenter, mouse);
+            if (ui->hovered) {
+                _sku_gridActivate(g, SKU_GEK_CONSTRAINT, c->slot);
+            }
+        } else {
+            SNZ_ASSERTF(false, "unreachable case. kind: %d", e->kind);
+        }
+    }
+
+    // the only pt that uses scaleFactor outside of hovering, see _sku_draw
+    sk_Point* origin = g->sketch->originPt;
+    HMM_Vec3 transformed = HMM_MulM4V4(model, HMM_V4(origin->pos.X, origin->pos.Y, 0, 1)).XYZ;
+    sk_pointUi(g->sketch, origin)->scaleFactor = HMM_Len(HMM_Sub(cameraPos, transformed));
+}
+
 // FIXME: factor out inter, only pass mouse pos
 static void _sku_draw(sk_Sketch* sketch, snzu_Interaction* inter, HMM_Mat4 model, HMM_Mat4 sketchMVP, HMM_Mat4 uiMVP, HMM_Vec3 cameraPos, snz_Arena* scratch, float sound, HMM_Vec2 resolution) {
     {  // grid around the cursor
@@ -389,26 +1029,28 @@ static void _sku_draw(sk_Sketch* sketch, snzu_Interaction* inter, HMM_Mat4 model
         }
     }  // end grid
 
-    for (sk_Point* p = sketch->firstPoint; p; p = p->next) {
+    for (sk_Point* p = sk_sketchFirstPoint(sketch); p; p = sk_sketchNextPoint(sketch, p)) {
         _sku_drawManifold(p, cameraPos, model, sketchMVP, sound, scratch);
     }
 
-    for (sk_Constraint* c = sketch->firstConstraint; c; c = c->nextAllocated) {
-        _sku_drawConstraint(c, scratch, sketchMVP, sound);
+    for (sk_Constraint* c = sk_sketchFirstConstraint(sketch); c; c = sk_sketchNextConstraint(sketch, c)) {
+        _sku_drawConstraint(sketch, c, scratch, sketchMVP, sound);
     }
 
-    for (sk_Line* l = sketch->firstLine; l; l = l->next) {
+    for (sk_Line* l = sk_sketchFirstLine(sketch); l; l = sk_sketchNextLine(sketch, l)) {
         HMM_Vec4 points[2] = { 0 };
         points[0].XY = l->p1->pos;
         points[1].XY = l->p2->pos;
-        float thickness = HMM_Lerp(ui_lineThickness, l->sel.hoverAnim, ui_lineHoveredThickness);
-        HMM_Vec4 color = HMM_LerpV4(ui_colorText, l->sel.selectionAnim, ui_colorAccent);
+        const sk_LineUi* ui = sk_lineUi(sketch, l);
+        float thickness = HMM_Lerp(ui_lineThickness, ui->sel.hoverAnim, ui_lineHoveredThickness);
+        HMM_Vec4 color = HMM_LerpV4(ui_colorText, ui->sel.selectionAnim, ui_colorAccent);
         snzr_drawLine(points, 2, color, thickness, sketchMVP);
     }
 
-    for (sk_Point* p = sketch->firstPoint; p; p = p->next) {
-        HMM_Vec4 color = HMM_LerpV4(ui_colorText, p->sel.selectionAnim, ui_colorAccent);
-        float sizeAnim = p->sel.hoverAnim + p->sel.selectionAnim;
+    for (sk_Point* p = sk_sketchFirstPoint(sketch); p; p = sk_sketchNextPoint(sketch, p)) {
+        const sk_PointUi* ui = sk_pointUi(sketch, p);
+        HMM_Vec4 color = HMM_LerpV4(ui_colorText, ui->sel.selectionAnim, ui_colorAccent);
+        float sizeAnim = ui->sel.hoverAnim + ui->sel.selectionAnim;
         float size = HMM_Lerp(ui_cornerHalfSize, sizeAnim, ui_cornerHoveredHalfSize);
         ren3d_drawBillboard(
             sketchMVP,
@@ -426,7 +1068,7 @@ static void _sku_draw(sk_Sketch* sketch, snzu_Interaction* inter, HMM_Mat4 model
             vp = HMM_Mul(HMM_Translate(HMM_V3(p->pos.X, p->pos.Y, 0)), vp);
             vp = HMM_Mul(sketchMVP, vp);
 
-            float rad = 0.04 * p->scaleFactor * (1 + (sizeAnim * 0.25));
+            float rad = 0.04 * ui->scaleFactor * (1 + (sizeAnim * 0.25));
             HMM_Vec4 pts[3] = { 0 };
             pts[0].XY = HMM_RotateV2(HMM_V2(rad, 0), HMM_AngleDeg(60));
             pts[1].XY = HMM_RotateV2(HMM_V2(rad, 0), HMM_AngleDeg(180));
@@ -502,27 +1144,49 @@ void sku_drawAndBuildSketch(
         ui_SelectionRegion* const region = SNZU_USE_MEM(ui_SelectionRegion, "region");
         snzu_Action regionAct = inter->mouseActions[SNZU_MB_LEFT];
 
+        _sku_gridUpdate(&_sku_grid, sketch);
+        _sku_markHovered(&_sku_grid, mouse, model, cameraPos, scratch);
+
+        _sku_Grid* const g = &_sku_grid;
+        {  // drag zone, only matters while dragging or on the frame one starts, see ui_selectionRegionUpdate
+            // pts that were in it last frame are all active
+            for (int64_t i = 0; i < g->activeCount[SKU_GEK_POINT]; i++) {
+                sk_Point* p = sk_sketchPointAt(sketch, g->active[SKU_GEK_POINT][i]);
+                if (p) {
+                    sk_pointUi(sketch, p)->inDragZone = false;
+                }
+            }
+
+            if (region->dragging || regionAct == SNZU_ACT_DOWN) {
+                // FIXME: make contains check precise, not per vert
+                HMM_Vec2 start = HMM_V2(0, 0);
+                HMM_Vec2 end = HMM_V2(0, 0);
+                start.X = SNZ_MIN(mouse.X, region->dragOrigin.X);
+                start.Y = SNZ_MIN(mouse.Y, region->dragOrigin.Y);
+                end.X = SNZ_MAX(mouse.X, region->dragOrigin.X);
+                end.Y = SNZ_MAX(mouse.Y, region->dragOrigin.Y);
+                _sku_GridEntrySlice inRect = _sku_gridQuery(g, start, end, scratch);
+                for (int64_t i = 0; i < inRect.count; i++) {
+                    // lines + constraints are only in the zone when their pts are, which are filed in cells they're in
+                    _sku_GridEntry* e = &inRect.elems[i];
+                    _sku_gridActivate(g, e->kind, _sku_gridEntrySlot(e));
+                    if (e->kind == SKU_GEK_POINT && _sku_AABBContainsPt(start, end, e->point->pos)) {
+                        sk_pointUi(sketch, e->point)->inDragZone = true;
+                    }
+                }
+            }
+        }
+        _sku_gridPruneActive(g, sketch);
+
         ui_SelectionStatus* firstStatus = NULL;
-        {  // loop over all elems and make the list of selection statuses
+        {  // make the list of selection statuses, anything not active would come out of the update the same
             bool anyPointHovered = false;
 
-            // FIXME: make contains check precise, not per vert
-            HMM_Vec2 start = HMM_V2(0, 0);
-            HMM_Vec2 end = HMM_V2(0, 0);
-            start.X = SNZ_MIN(mouse.X, region->dragOrigin.X);
-            start.Y = SNZ_MIN(mouse.Y, region->dragOrigin.Y);
-            end.X = SNZ_MAX(mouse.X, region->dragOrigin.X);
-            end.Y = SNZ_MAX(mouse.Y, region->dragOrigin.Y);
-            for (sk_Point* p = sketch->firstPoint; p; p = p->next) {
-                p->inDragZone = false;
-                if (_sku_AABBContainsPt(start, end, p->pos)) {
-                    p->inDragZone = true;
-                }
-
-                HMM_Vec3 transformed = HMM_MulM4V4(model, HMM_V4(p->pos.X, p->pos.Y, 0, 1)).XYZ;
-                float scaleFactor = HMM_Len(HMM_Sub(cameraPos, transformed));
-                p->scaleFactor = scaleFactor;
-                bool hovered = HMM_Len(HMM_Sub(mouse, p->pos)) < (0.02 * scaleFactor);
+            for (int64_t i = 0; i < g->activeCount[SKU_GEK_POINT]; i++) {
+                sk_Point* p = sk_sketchPointAt(sketch, g->active[SKU_GEK_POINT][i]);
+                sk_PointUi* ui = sk_pointUi(sketch, p);
+                bool hovered = ui->hovered;
+                ui->hovered = false;
                 anyPointHovered |= hovered;
                 if (inNonLineTool) {
                     hovered = false;
@@ -530,28 +1194,28 @@ void sku_drawAndBuildSketch(
 
                 ui_SelectionStatus* status = SNZ_ARENA_PUSH(scratch, ui_SelectionStatus);
                 *status = (ui_SelectionStatus){
-                    .state = &p->sel,
+                    .state = &ui->sel,
                     .hovered = hovered,
-                    .withinDragZone = p->inDragZone,
+                    .withinDragZone = ui->inDragZone,
                     .next = firstStatus,
                 };
                 firstStatus = status;
             }  // end point loop
 
-            for (sk_Line* l = sketch->firstLine; l; l = l->next) {
-                bool withinDragZone = l->p1->inDragZone && l->p2->inDragZone;
+            for (int64_t i = 0; i < g->activeCount[SKU_GEK_LINE]; i++) {
+                sk_Line* l = sk_sketchLineAt(sketch, g->active[SKU_GEK_LINE][i]);
+                sk_LineUi* ui = sk_lineUi(sketch, l);
+                bool withinDragZone = sk_pointUi(sketch, l->p1)->inDragZone && sk_pointUi(sketch, l->p2)->inDragZone;
 
-                HMM_Vec2 midpt = HMM_DivV2F(HMM_Add(l->p1->pos, l->p2->pos), 2.0f);
-                HMM_Vec3 transformedCenter = HMM_MulM4V4(model, HMM_V4(midpt.X, midpt.Y, 0, 1)).XYZ;
-                float distToCamera = HMM_Len(HMM_Sub(transformedCenter, cameraPos));
-                bool hovered = _sku_lineContainsPt(l->p1->pos, l->p2->pos, 0.01 * distToCamera, mouse);
+                bool hovered = ui->hovered;
+                ui->hovered = false;
                 if (anyPointHovered || inLineMode || inNonLineTool) {
                     hovered = false;
                 }
 
                 ui_SelectionStatus* status = SNZ_ARENA_PUSH(scratch, ui_SelectionStatus);
                 *status = (ui_SelectionStatus){
-                    .state = &l->sel,
+                    .state = &ui->sel,
                     .hovered = hovered,
                     .withinDragZone = withinDragZone,
                     .next = firstStatus,
@@ -559,13 +1223,14 @@ void sku_drawAndBuildSketch(
                 firstStatus = status;
             }
 
-            for (sk_Constraint* c = sketch->firstConstraint; c; c = c->nextAllocated) {
-                HMM_Vec2 visualCenter;
-                float scaleFactor;
-                _sku_constraintScaleFactorAndCenter(c, model, cameraPos, &visualCenter, &scaleFactor);
-
+            for (int64_t i = 0; i < g->activeCount[SKU_GEK_CONSTRAINT]; i++) {
+                sk_Constraint* c = sk_sketchConstraintAt(sketch, g->active[SKU_GEK_CONSTRAINT][i]);
                 // FIXME: multiple elems are animated as if clickable when only one is, pick a side please
-                bool hovered = _sku_constraintHovered(c, scaleFactor, visualCenter, mouse);
+                // labels can be far from where the constraint is filed in the grid, so they get checked here
+                // (and activated in the build loop, see below)
+                sk_ConstraintUi* ui = sk_constraintUi(sketch, c);
+                bool hovered = ui->hovered || ui->textArea.inter.hovered;
+                ui->hovered = false;
                 // NOTE: cancelling hover here means that even though these statuses are in the set to update
                 // when in line mode, they will never be able to capture the mouse or be selected.
                 if (anyPointHovered || inLineMode || inNonLineTool) {
@@ -574,7 +1239,7 @@ void sku_drawAndBuildSketch(
 
                 if (hovered) {
                     if (inter->doubleClicked) {
-                        c->uiInfo.shouldStartFocus = true;  // this is reset in build, so that signals from shortcuts make it
+                        ui->shouldStartFocus = true;  // this is reset in build, so that signals from shortcuts make it
                     }
                 }
 
@@ -582,14 +1247,14 @@ void sku_drawAndBuildSketch(
                 if (c->kind == SK_CK_ANGLE) {
                     sk_Point* base1 = c->flipLine1 ? c->line1->p2 : c->line1->p1;
                     sk_Point* base2 = c->flipLine2 ? c->line2->p2 : c->line2->p1;
-                    withinDragZone = base1 == base2 && base1->inDragZone;
+                    withinDragZone = base1 == base2 && sk_pointUi(sketch, base1)->inDragZone;
                 } else if (c->kind == SK_CK_DISTANCE) {
-                    withinDragZone = c->line1->p1->inDragZone && c->line1->p2->inDragZone;
+                    withinDragZone = sk_pointUi(sketch, c->line1->p1)->inDragZone && sk_pointUi(sketch, c->line1->p2)->inDragZone;
                 }
 
                 ui_SelectionStatus* status = SNZ_ARENA_PUSH(scratch, ui_SelectionStatus);
                 *status = (ui_SelectionStatus){
-                    .state = &c->uiInfo.sel,
+                    .state = &ui->sel,
                     .hovered = hovered,
                     .withinDragZone = withinDragZone,
                     .next = firstStatus,
@@ -610,29 +1275,31 @@ void sku_drawAndBuildSketch(
         { // handle logic for each tool mode
             if (inLineMode) {
                 { // make sure no invalid selections can linger into line mode
-                    // FIXME: this number of loops happening ev frame gonna be a perf issue?
-                    for (sk_Line* l = sketch->firstLine; l; l = l->next) {
-                        l->sel.selected = false;
+                    for (int64_t i = 0; i < g->activeCount[SKU_GEK_LINE]; i++) {
+                        sk_lineUi(sketch, sk_sketchLineAt(sketch, g->active[SKU_GEK_LINE][i]))->sel.selected = false;
                     }
-
-                    for (sk_Constraint* c = sketch->firstConstraint; c; c = c->nextAllocated) {
-                        c->uiInfo.sel.selected = false;
+                    for (int64_t i = 0; i < g->activeCount[SKU_GEK_CONSTRAINT]; i++) {
+                        sk_constraintUi(sketch, sk_sketchConstraintAt(sketch, g->active[SKU_GEK_CONSTRAINT][i]))->sel.selected = false;
                     }
                 }
 
-                sk_Point** const lastPt = SNZU_USE_MEM(sk_Point*, "lastPt");
+                // handle bc. the pt could be deleted (or undone) and its memory reused while this is held
+                sk_PointHandle* const lastPtHandle = SNZU_USE_MEM(sk_PointHandle, "lastPt");
+                sk_Point* lastPtVal = sk_pointHandleGet(sketch, *lastPtHandle);
+                sk_Point** const lastPt = &lastPtVal;
 
                 int selectedCount = 0;
                 sk_Point* newSel = NULL;
-                for (sk_Point* p = sketch->firstPoint; p; p = p->next) {
-                    if (p->sel.selected) {
+                for (int64_t i = 0; i < g->activeCount[SKU_GEK_POINT]; i++) {
+                    sk_Point* p = sk_sketchPointAt(sketch, g->active[SKU_GEK_POINT][i]);
+                    if (sk_pointUi(sketch, p)->sel.selected) {
                         selectedCount++;
                         if (p != *lastPt) {
                             newSel = p;
                         }
                     }
                 }
-                sk_sketchDeselectAll(sketch);
+                _sku_gridDeselectAll(g, sketch);
 
                 if (inter->mouseActions[SNZU_MB_LEFT] == SNZU_ACT_DOWN) {
                     if (!*lastPt && !newSel) {
@@ -655,9 +1322,11 @@ void sku_drawAndBuildSketch(
                 }
 
                 if (*lastPt) {
-                    (*lastPt)->sel.selected = true;
+                    sk_pointUi(sketch, *lastPt)->sel.selected = true;
+                    _sku_gridActivate(g, SKU_GEK_POINT, (*lastPt)->slot);
                 }
 
+                *lastPtHandle = sk_pointHandle(sketch, *lastPt);
                 lineSrcPoint = *lastPt;
             }  // end line mode logic
             else if (inMoveMode) {
@@ -669,14 +1338,18 @@ void sku_drawAndBuildSketch(
                 *prevMouse = mouse;
 
                 // FIXME: selecting a line should select the base pts also?? but then deletion is weird???
-                for (sk_Point* p = sketch->firstPoint; p; p = p->next) {
-                    if (p->sel.selected) {
+                for (int64_t i = 0; i < g->activeCount[SKU_GEK_POINT]; i++) {
+                    sk_Point* p = sk_sketchPointAt(sketch, g->active[SKU_GEK_POINT][i]);
+                    if (sk_pointUi(sketch, p)->sel.selected) {
                         p->pos = HMM_Add(p->pos, diff);
                     }
                 }
+                if (diff.X != 0 || diff.Y != 0) {
+                    sk_sketchMarkChanged(sketch);
+                }
                 if (regionAct == SNZU_ACT_DOWN) {
                     sc_cancelActiveCommand();
-                    sk_sketchDeselectAll(sketch);
+                    _sku_gridDeselectAll(g, sketch);
                 }
                 // FIXME: doing this by diff instead of abs feels sluggish
             } else if (inRotateMode) {
@@ -696,28 +1369,33 @@ void sku_drawAndBuildSketch(
 
                 HMM_Vec2 center = HMM_V2(0, 0);
                 int count = 0;
-                for (sk_Point* p = sketch->firstPoint; p; p = p->next) {
-                    if (p->sel.selected) {
+                for (int64_t i = 0; i < g->activeCount[SKU_GEK_POINT]; i++) {
+                    sk_Point* p = sk_sketchPointAt(sketch, g->active[SKU_GEK_POINT][i]);
+                    if (sk_pointUi(sketch, p)->sel.selected) {
                         center = HMM_Add(center, p->pos);
                         count++;
                     }
                 }
                 center = HMM_DivV2F(center, (float)count);
 
-                for (sk_Point* p = sketch->firstPoint; p; p = p->next) {
-                    if (p->sel.selected) {
+                for (int64_t i = 0; i < g->activeCount[SKU_GEK_POINT]; i++) {
+                    sk_Point* p = sk_sketchPointAt(sketch, g->active[SKU_GEK_POINT][i]);
+                    if (sk_pointUi(sketch, p)->sel.selected) {
                         HMM_Vec2 nPos = HMM_RotateV2(HMM_Sub(p->pos, center), angleDiff);
                         p->pos = HMM_Add(nPos, center);
                     }
                 }
 
-                if (sketch->originLine->p1->sel.selected && sketch->originLine->p2->sel.selected) {
+                if (sk_pointUi(sketch, sketch->originLine->p1)->sel.selected && sk_pointUi(sketch, sketch->originLine->p2)->sel.selected) {
                     sketch->originAngle += angleDiff;
                 }
+                if (angleDiff != 0 && count > 0) {
+                    sk_sketchMarkChanged(sketch);
+                }
 
                 if (regionAct == SNZU_ACT_DOWN) {
                     sc_cancelActiveCommand();
-                    sk_sketchDeselectAll(sketch);
+                    _sku_gridDeselectAll(g, sketch);
                 }
             }  // end rotate mode logic
         }
@@ -731,8 +1409,12 @@ void sku_drawAndBuildSketch(
         }
     }  // end selection management scope
 
-    for (sk_Constraint* c = sketch->firstConstraint; c; c = c->nextAllocated) {
-        _sku_buildConstraint(c, sound, model, cameraPos, scratch);
+    for (sk_Constraint* c = sk_sketchFirstConstraint(sketch); c; c = sk_sketchNextConstraint(sketch, c)) {
+        _sku_buildConstraint(sketch, c, sound, model, cameraPos, scratch);
+        // labels get hovered by the ui lib, not the grid. A frame late, but this is the only loop that sees them all
+        if (sk_constraintUi(sketch, c)->textArea.inter.hovered) {
+            _sku_gridActivate(&_sku_grid, SKU_GEK_CONSTRAINT, c->slot);
+        }
     }
 
     if (inLineMode && lineSrcPoint) {
@@ -756,4 +1438,208 @@ void sku_drawAndBuildSketch(
     snzu_boxExit();  // exit main parent
 
     glEnable(GL_DEPTH_TEST);
+}
+
+// hovered flags from _sku_markHovered vs. the same checks run on every elt
+static bool _sku_testHoverMatchesBruteForce(sk_Sketch* sketch, HMM_Vec2 mouse, HMM_Mat4 model, HMM_Vec3 cameraPos, snz_Arena* scratch) {
+    _sku_gridUpdate(&_sku_grid, sketch);
+    _sku_markHovered(&_sku_grid, mouse, model, cameraPos, scratch);
+
+    bool correct = true;
+    for (sk_Point* p = sk_sketchFirstPoint(sketch); p; p = sk_sketchNextPoint(sketch, p)) {
+        float scaleFactor = HMM_Len(HMM_Sub(cameraPos, _sku_mulM4V3(model, HMM_V3(p->pos.X, p->pos.Y, 0))));
+        sk_PointUi* ui = sk_pointUi(sketch, p);
+        correct &= ui->hovered == (HMM_Len(HMM_Sub(mouse, p->pos)) < (0.02 * scaleFactor));
+        ui->hovered = false;
+    }
+    for (sk_Line* l = sk_sketchFirstLine(sketch); l; l = sk_sketchNextLine(sketch, l)) {
+        HMM_Vec2 midpt = HMM_DivV2F(HMM_Add(l->p1->pos, l->p2->pos), 2.0f);
+        float distToCamera = HMM_Len(HMM_Sub(_sku_mulM4V3(model, HMM_V3(midpt.X, midpt.Y, 0)), cameraPos));
+        sk_LineUi* ui = sk_lineUi(sketch, l);
+        correct &= ui->hovered == _sku_lineContainsPt(l->p1->pos, l->p2->pos, 0.01 * distToCamera, mouse);
+        ui->hovered = false;
+    }
+    for (sk_Constraint* c = sk_sketchFirstConstraint(sketch); c; c = sk_sketchNextConstraint(sketch, c)) {
+        HMM_Vec2 visualCenter;
+        float scaleFactor;
+        _sku_constraintScaleFactorAndCenter(c, model, cameraPos, &visualCenter, &scaleFactor);
+        sk_ConstraintUi* ui = sk_constraintUi(sketch, c);
+        correct &= ui->hovered == _sku_constraintHovered(sketch, c, scaleFactor, visualCenter, mouse);
+        ui->hovered = false;
+    }
+    return correct;
+}
+
+void sku_tests() {
+    snz_testPrintSection("sketch ui");
+
+    snz_Arena arena = snz_arenaInit(100000000, "sku test arena");
+    snz_Arena scratch = snz_arenaInit(100000000, "sku test scratch arena");
+
+    {
+        srand(5);
+        sk_Sketch sketch = sk_sketchInit(&arena);
+        for (int i = 0; i < 500; i++) {
+            sk_sketchAddPoint(&sketch, HMM_V2((float)(rand() % 2000 - 1000) / 100, (float)(rand() % 2000 - 1000) / 100));
+        }
+        sk_Point* pts[500] = { 0 };
+        int ptCount = 0;
+        for (sk_Point* p = sk_sketchFirstPoint(&sketch); p && ptCount < 500; p = sk_sketchNextPoint(&sketch, p)) {
+            pts[ptCount++] = p;
+        }
+        for (int i = 0; i < 300; i++) {
+            sk_Point* a = pts[rand() % ptCount];
+            sk_Point* b = pts[rand() % ptCount];
+            if (a == b) {
+                continue;
+            }
+            sk_Line* l = sk_sketchAddLine(&sketch, a, b);
+            if (rand() % 3 == 0) {
+                sk_sketchAddConstraintDistance(&sketch, l, 1);
+            } else if (rand() % 3 == 0 && l->slot > 1) {
+                sk_Line* other = sk_sketchLineAt(&sketch, rand() % l->slot);
+                if (other) {
+                    sk_sketchAddConstraintAngle(&sketch, l, false, other, false, HMM_AngleDeg(45));
+                }
+            }
+        }
+
+        geo_Align align = (geo_Align){
+            .pt = HMM_V3(3, -2, 1),
+            .normal = HMM_V3(0, 0, 1),
+            .vertical = HMM_V3(0, 1, 0),
+        };
+        HMM_Mat4 model = geo_alignToM4(geo_alignZero(), align);
+
+        bool correct = true;
+        for (int round = 0; round < 3; round++) {
+            for (int i = 0; i < 500; i++) {
+                // close in enough that things are getting hovered, and mice right on top of pts
+                HMM_Vec3 cameraPos = HMM_V3((float)(rand() % 20 - 10), (float)(rand() % 20 - 10), (float)(rand() % 40 + 1));
+                HMM_Vec2 mouse = HMM_V2((float)(rand() % 2000 - 1000) / 100, (float)(rand() % 2000 - 1000) / 100);
+                if (i % 2) {
+                    mouse = HMM_Add(pts[rand() % ptCount]->pos, HMM_V2(0.01f, -0.01f));
+                }
+                correct &= _sku_testHoverMatchesBruteForce(&sketch, mouse, model, cameraPos, &scratch);
+                snz_arenaClear(&scratch);
+            }
+
+            // moving pts w/o marking the change would leave the grid stale, everything that moves them marks it
+            for (int i = 0; i < ptCount; i++) {
+                if (rand() % 10 == 0) {
+                    pts[i]->pos = HMM_Add(pts[i]->pos, HMM_V2((float)(rand() % 200 - 100) / 100, (float)(rand() % 200 - 100) / 100));
+                }
+            }
+            sk_sketchMarkChanged(&sketch);
+        }
+        snz_testPrint(correct, "grid hover checks match checking everything");
+        snz_arenaClear(&arena);
+    }
+
+    {
+        srand(6);
+        sk_Sketch sketch = sk_sketchInit(&arena);
+        for (int i = 0; i < 1000; i++) {
+            sk_sketchAddPoint(&sketch, HMM_V2((float)(rand() % 100000 - 50000), (float)(rand() % 100000 - 50000)));
+        }
+        _sku_gridUpdate(&_sku_grid, &sketch);
+
+        bool correct = true;
+        for (int i = 0; i < 200; i++) {
+            HMM_Vec2 min = HMM_V2((float)(rand() % 100000 - 50000), (float)(rand() % 100000 - 50000));
+            HMM_Vec2 max = HMM_Add(min, HMM_V2((float)(rand() % 20000), (float)(rand() % 20000)));
+            if (i == 0) {  // big enough to go thru the occupied cells instead
+                min = HMM_V2(-1e7, -1e7);
+                max = HMM_V2(1e7, 1e7);
+            }
+            _sku_GridEntrySlice found = _sku_gridQuery(&_sku_grid, min, max, &scratch);
+            for (sk_Point* p = sk_sketchFirstPoint(&sketch); p; p = sk_sketchNextPoint(&sketch, p)) {
+                if (!_sku_AABBContainsPt(min, max, p->pos)) {
+                    continue;
+                }
+                bool wasFound = false;
+                for (int64_t j = 0; j < found.count; j++) {
+                    wasFound |= found.elems[j].kind == SKU_GEK_POINT && found.elems[j].point == p;
+                }
+                correct &= wasFound;
+            }
+            snz_arenaClear(&scratch);
+        }
+
+        // a different sketch in the same memory, w/ nothing marked since, still has to get picked up
+        sk_sketchMarkChanged(&sketch);
+        uint64_t version = sketch.version;
+        snz_arenaClear(&arena);
+        sketch = sk_sketchInit(&arena);
+        correct &= sketch.version != version;
+        _sku_gridUpdate(&_sku_grid, &sketch);
+        int64_t ptCount = 0;
+        for (sk_Point* p = sk_sketchFirstPoint(&sketch); p; p = sk_sketchNextPoint(&sketch, p)) {
+            ptCount++;
+        }
+        correct &= _sku_gridQuery(&_sku_grid, HMM_V2(-1e7, -1e7), HMM_V2(1e7, 1e7), &scratch).count >= ptCount;
+        correct &= _sku_grid.entryCount < 1000;
+        snz_testPrint(correct, "grid box queries find every pt in the box");
+        snz_arenaClear(&scratch);
+        snz_arenaClear(&arena);
+    }
+
+    {
+        srand(7);
+        sk_Sketch sketch = sk_sketchInit(&arena);
+        for (int i = 0; i < 300; i++) {
+            sk_Point* p = sk_sketchAddPoint(&sketch, HMM_V2((float)(rand() % 2000 - 1000) / 100, (float)(rand() % 2000 - 1000) / 100));
+            sk_Line* l = sk_sketchAddLine(&sketch, p, sk_sketchPointAt(&sketch, rand() % p->slot));
+            if (rand() % 3 == 0) {
+                sk_sketchAddConstraintDistance(&sketch, l, 1);
+            }
+        }
+        _sku_gridUpdate(&_sku_grid, &sketch);
+
+        bool correct = true;
+        for (int round = 0; round < 30; round++) {
+            // a drag, a delete, and an add, but nothing that should resize the cells
+            for (sk_Point* p = sk_sketchFirstPoint(&sketch); p; p = sk_sketchNextPoint(&sketch, p)) {
+                if (rand() % 20 == 0) {
+                    p->pos = HMM_Add(p->pos, HMM_V2((float)(rand() % 200 - 100) / 100, (float)(rand() % 200 - 100) / 100));
+                }
+            }
+            sk_Line* deleted = sk_sketchLineAt(&sketch, rand() % sketch.lines.count);
+            if (deleted && deleted != sketch.originLine) {
+                deleted->markedForDelete = true;
+                sk_sketchClearElementsMarkedForDelete(&sketch);
+            }
+            sk_Point* added = sk_sketchAddPoint(&sketch, HMM_V2((float)(rand() % 2000 - 1000) / 100, 0));
+            sk_sketchAddConstraintDistance(&sketch, sk_sketchAddLine(&sketch, added, sketch.originPt), 1);
+            sk_sketchMarkChanged(&sketch);
+
+            float cellSize = _sku_grid.cellSize;
+            _sku_gridUpdate(&_sku_grid, &sketch);
+            correct &= _sku_grid.cellSize == cellSize;
+
+            _sku_Grid fresh = { 0 };
+            _sku_gridRebuild(&fresh, &sketch, cellSize);
+            correct &= fresh.entryCount == _sku_grid.entryCount;
+            _sku_gridDeinit(&fresh);
+
+            // nothing left behind by what moved or got deleted
+            _sku_GridEntrySlice all = _sku_gridQuery(&_sku_grid, HMM_V2(-1e7, -1e7), HMM_V2(1e7, 1e7), &scratch);
+            correct &= all.count == _sku_grid.entryCount;
+            for (int64_t i = 0; i < all.count; i++) {
+                _sku_GridEntry* e = &all.elems[i];
+                correct &= _sku_gridEltAt(&sketch, e->kind, _sku_gridEntrySlot(e)) == e->elt;
+                if (e->kind == SKU_GEK_POINT) {
+                    correct &= e->x == _sku_gridCoord(&_sku_grid, e->point->pos.X) && e->y == _sku_gridCoord(&_sku_grid, e->point->pos.Y);
+                }
+            }
+            snz_arenaClear(&scratch);
+        }
+        snz_testPrint(correct, "incremental grid updates match a rebuild");
+        snz_arenaClear(&arena);
+    }
+
+    // so the ui doesn't think the test sketch is still around, its memory is going away
+    _sku_grid.sketch = NULL;
+    snz_arenaDeinit(&arena);
+    snz_arenaDeinit(&scratch);
 }
\ No newline at end of file
@@ -27,18 +27,30 @@
 
 FILE* _snz_logFile;
 
+// so gcc checks args against the format like it would for printf. int64_t is a long on linux and
+// a long long on windows, so use PRId64 for those and not %lld
+#ifdef __GNUC__
+#define _SNZ_PRINTF_CHECK(fmtIdx, argsIdx) __attribute__((format(printf, fmtIdx, argsIdx)))
+#else
+#define _SNZ_PRINTF_CHECK(fmtIdx, argsIdx)
+#endif
+
+void _snz_logF(const char* file, int64_t line, const char* fmt, ...) _SNZ_PRINTF_CHECK(3, 4);
 void _snz_logF(const char* file, int64_t line, const char* fmt, ...) {
     va_list args;
     va_start(args, fmt);
+    va_list argsCopy;  // a va_list can only be walked once outside of msvc
+    va_copy(argsCopy, args);
 
-    fprintf(_snz_logFile, "[%s:%lld]: ", file, line);
+    fprintf(_snz_logFile, "[%s:%" PRId64 "]: ", file, line);
     vfprintf(_snz_logFile, fmt, args);
     fputc('\n', _snz_logFile);
 
-    printf("[%s:%lld]: ", file, line);
-    vprintf(fmt, args);
+    printf("[%s:%" PRId64 "]: ", file, line);
+    vprintf(fmt, argsCopy);
     printf("\n");
 
+    va_end(argsCopy);
     va_end(args);
 }
 
@@ -53,17 +65,21 @@ void _snz_logF(const char* file, int64_t line, const char* fmt, ...) {
 #define SNZ_ASSERT(cond, msg) _snz_assertf(cond, "%s", __FILE__, __LINE__, msg)
 #define SNZ_ASSERTF(cond, fmt, ...) _snz_assertf(cond, fmt, __FILE__, __LINE__, __VA_ARGS__)
 
+void _snz_assertf(bool cond, const char* fmt, const char* file, int64_t line, ...) _SNZ_PRINTF_CHECK(2, 5);
 void _snz_assertf(bool cond, const char* fmt, const char* file, int64_t line, ...) {
     if (!cond) {
         va_list args;
         va_start(args, line);
-        printf("[%s:%lld]: [ASSERTION FAILED]: ", file, line);
+        va_list argsCopy;
+        va_copy(argsCopy, args);
+        printf("[%s:%" PRId64 "]: [ASSERTION FAILED]: ", file, line);
         vprintf(fmt, args);
         printf("\n");
 
-        fprintf(_snz_logFile, "[%s:%lld]: [ASSERTION FAILED]: ", file, line);
-        vfprintf(_snz_logFile, fmt, args);
+        fprintf(_snz_logFile, "[%s:%" PRId64 "]: [ASSERTION FAILED]: ", file, line);
+        vfprintf(_snz_logFile, fmt, argsCopy);
         fprintf(_snz_logFile, "\n");
+        va_end(argsCopy);
         va_end(args);
 
         fclose(_snz_logFile);
@@ -100,9 +116,22 @@ void snz_testPrintSection(const char* name) {
 SNZ_SLICE(HMM_Vec2);
 SNZ_SLICE(HMM_Vec3);
 SNZ_SLICE(HMM_Vec3Slice);
+SNZ_SLICE(HMM_Mat4);
 SNZ_SLICE(bool);
 SNZ_SLICE(int64_t);
 
+// murmur3's fmix64. Anything hashing into a power of two table should go thru this last, fnv and sequential ids
+// leave the low bits too close together on their own
+// https://zimbry.blogspot.com/2011/09/better-bit-mixing-improving-on.html
+uint64_t snz_hashMix64(uint64_t h) {
+    h ^= (h >> 33);
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= (h >> 33);
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= (h >> 33);
+    return h;
+}
+
 // FIXME: multiple def guards
 
 // UTILITIES ==================================================================
@@ -113,9 +142,8 @@ SNZ_SLICE(int64_t);
 // ARENAS ======================================================================
 // ARENAS ======================================================================
 
-// fixed size, ungrowable
+// fixed size unless made w/ snz_arenaInitGrowable
 // zeroes memory on free and init
-// FIXME: make growable
 // FIXME: testing
 typedef struct {
     void* start;
@@ -123,6 +151,10 @@ typedef struct {
     int64_t reserved;
     const char* name;  // used for debug messages only
 
+    // growable arenas only. Filling a block moves to a new one that's at least twice as big, full ones get kept
+    // around (so pointers into them stay good) until the next clear. Every block starts w/ a _snz_ArenaBlockHeader.
+    int64_t growBlockSize;
+
     int64_t arrModeElemSize;
     int64_t arrModeElemCount;
     const char* arrModeTypeName;  // used for debug only
@@ -134,6 +166,9 @@ typedef struct {
 // returns a pointer to memory that is zeroed
 #define SNZ_ARENA_PUSH_ARR(bump, count, T) (T*)(snz_arenaPush((bump), sizeof(T), count))
 
+// same as SNZ_ARENA_PUSH_ARR, lined up to _Alignof(T) instead of 8
+#define SNZ_ARENA_PUSH_ARR_ALIGNED(bump, count, T) (T*)(snz_arenaPushAligned((bump), sizeof(T), count, _Alignof(T)))
+
 snz_Arena snz_arenaInit(int64_t size, const char* name) {
     snz_Arena a = { 0 };
     a.name = name;
@@ -144,15 +179,99 @@ snz_Arena snz_arenaInit(int64_t size, const char* name) {
     return a;
 }
 
+typedef struct {
+    void* prevBlock;  // header of the block filled before this one, null on the first one
+    int64_t reserved;
+} _snz_ArenaBlockHeader;
+
+// block size is just what the first block gets, see growBlockSize
+snz_Arena snz_arenaInitGrowable(int64_t blockSize, const char* name) {
+    snz_Arena a = { 0 };
+    a.name = name;
+    a.reserved = blockSize;
+    a.growBlockSize = blockSize;
+    _snz_ArenaBlockHeader* header = calloc(1, sizeof(_snz_ArenaBlockHeader) + blockSize);
+    SNZ_ASSERTF(header != NULL, "arena alloc for '%s' failed.", a.name);
+    header->reserved = blockSize;
+    a.start = header + 1;
+    a.end = a.start;
+    return a;
+}
+
+static _snz_ArenaBlockHeader* _snz_arenaBlockHeader(void* blockStart) {
+    return (_snz_ArenaBlockHeader*)blockStart - 1;
+}
+
+// in debug builds, memory a growable arena gives back gets stomped first so anything still pointing into it
+// reads obvious garbage (& the heap's own free checks can catch it after)
+static void _snz_arenaBlockFree(_snz_ArenaBlockHeader* header) {
+#ifndef NDEBUG
+    memset(header + 1, 0xDD, header->reserved);
+#endif
+    free(header);
+}
+
+// frees every block except the current one
+static void _snz_arenaFreePrevBlocks(snz_Arena* a) {
+    _snz_ArenaBlockHeader* header = _snz_arenaBlockHeader(a->start)->prevBlock;
+    while (header) {
+        _snz_ArenaBlockHeader* prev = header->prevBlock;
+        _snz_arenaBlockFree(header);
+        header = prev;
+    }
+    _snz_arenaBlockHeader(a->start)->prevBlock = NULL;
+}
+
 void snz_arenaDeinit(snz_Arena* a) {
-    free(a->start);
+    if (a->growBlockSize) {
+        _snz_arenaFreePrevBlocks(a);
+        _snz_arenaBlockFree(_snz_arenaBlockHeader(a->start));
+    } else {
+        free(a->start);
+    }
     memset(a, 0, sizeof(*a));
 }
 
+// bytes pushed so far, for growable arenas full blocks count all of their space
+int64_t snz_arenaUsedBytes(const snz_Arena* a) {
+    int64_t used = (char*)(a->end) - (char*)(a->start);
+    if (a->growBlockSize) {
+        for (_snz_ArenaBlockHeader* h = _snz_arenaBlockHeader(a->start)->prevBlock; h; h = h->prevBlock) {
+            used += h->reserved;
+        }
+    }
+    return used;
+}
+
+// moves a growable arena onto a new block with room for at least size more bytes.
+// If an array is being built it gets moved over too, so it stays contiguous, but
+// pointers to elts of it from before this push are left pointing at the old block.
+static void _snz_arenaGrow(snz_Arena* a, int64_t size, int64_t count) {
+    int64_t arrBytes = a->arrModeElemSize ? (a->arrModeElemCount - count) * a->arrModeElemSize : 0;
+    int64_t newReserved = SNZ_MAX(a->reserved * 2, a->growBlockSize);
+    while (newReserved <= arrBytes + size * count) {
+        newReserved *= 2;
+    }
+
+    _snz_ArenaBlockHeader* header = calloc(1, sizeof(_snz_ArenaBlockHeader) + newReserved);
+    SNZ_ASSERTF(header != NULL, "arena grow for '%s' failed. Requested block: %" PRId64, a->name, newReserved);
+    header->prevBlock = _snz_arenaBlockHeader(a->start);
+    header->reserved = newReserved;
+
+    char* oldArr = (char*)(a->end) - arrBytes;
+    memcpy(header + 1, oldArr, arrBytes);
+#ifndef NDEBUG
+    memset(oldArr, 0xDD, arrBytes);
+#endif
+    a->start = header + 1;
+    a->end = (char*)(a->start) + arrBytes;
+    a->reserved = newReserved;
+}
+
 // FIXME: file and line of req.
 void* snz_arenaPush(snz_Arena* a, int64_t size, int64_t count) {
     SNZ_ASSERTF(a->arrModeElemSize == 0 || size == a->arrModeElemSize,
-                "arena push failed for '%s'. Active array elem: '%s' (size %lld), requested: %lld",
+                "arena push failed for '%s'. Active array elem: '%s' (size %" PRId64 "), requested: %" PRId64,
                 a->name, a->arrModeTypeName, a->arrModeElemSize, size);
     a->arrModeElemCount += count;  // this will always be correct when inside arr mode, and it will just get reset on enter, so we don't need to branch here.
 
@@ -160,22 +279,49 @@ void* snz_arenaPush(snz_Arena* a, int64_t size, int64_t count) {
         size += sizeof(uint64_t) - (size % sizeof(uint64_t));
     }
     char* o = (char*)(a->end);
+    if (!(o + (size * count) < (char*)(a->start) + a->reserved) && a->growBlockSize) {
+        _snz_arenaGrow(a, size, count);
+        o = (char*)(a->end);
+    }
     if (!(o + (size * count) < (char*)(a->start) + a->reserved)) {
         SNZ_ASSERTF(false,
-                    "arena push failed for '%s'. Cap: %lld, Used: %llu, Requested: %llu",
+                    "arena push failed for '%s'. Cap: %" PRId64 ", Used: %" PRIu64 ", Requested: %" PRId64,
                     a->name, a->reserved, (uint64_t)a->end - (uint64_t)a->start, count * size);
     }
     a->end = o + (size * count);
     return o;
 }
 
+// for types that need more than the 8 byte alignment regular pushes get, like the SSE ones in HMM. align has to be a power of 2
+void* snz_arenaPushAligned(snz_Arena* a, int64_t size, int64_t count, int64_t align) {
+    SNZ_ASSERT(a->arrModeElemSize == 0, "aligned pushes can't happen in array mode");
+    SNZ_ASSERTF(align > 0 && (align & (align - 1)) == 0, "alignment of %" PRId64 " isn't a power of 2", align);
+    char* o = (char*)snz_arenaPush(a, size * count + align - 1, 1);  // one elt, pushes pad every elt out to 8
+    return o + ((align - ((uintptr_t)o & (align - 1))) & (align - 1));
+}
+
+// sizes are in the same terms as snz_arenaUsedBytes, so popping back to a count from there is always right.
+// On growable arenas, popping past the start of the current block frees it and goes back to the one before.
 void snz_arenaPop(snz_Arena* a, int64_t size) {
     SNZ_ASSERTF(a->arrModeElemSize == 0,
                 "arena pop failed for '%s'. Active array elem: '%s'",
                 a->name, a->arrModeTypeName);
+    while (a->growBlockSize && size > (char*)(a->end) - (char*)(a->start)) {
+        _snz_ArenaBlockHeader* header = _snz_arenaBlockHeader(a->start);
+        if (!header->prevBlock) {
+            break;  // asserts below
+        }
+        size -= (char*)(a->end) - (char*)(a->start);
+        _snz_ArenaBlockHeader* prev = header->prevBlock;
+        _snz_arenaBlockFree(header);
+        // full blocks count as all used, see snz_arenaUsedBytes
+        a->start = prev + 1;
+        a->reserved = prev->reserved;
+        a->end = (char*)(a->start) + a->reserved;
+    }
     char* c = (char*)(a->end);
     SNZ_ASSERTF(size <= (c - (char*)(a->start)),
-                "arena pop failed for '%s', tried to pop %lld bytes, only %lld remaining",
+                "arena pop failed for '%s', tried to pop %" PRId64 " bytes, only %" PRIu64 " remaining",
                 a->name, size, (uint64_t)a->end - (uint64_t)a->start);
     a->end = c - size;
     memset(a->end, 0, size);
@@ -188,6 +334,20 @@ void snz_arenaClear(snz_Arena* a) {
     SNZ_ASSERTF(a->arrModeElemSize == 0,
                 "arena clear failed for '%s'. Active array elem: '%s'",
                 a->name, a->arrModeTypeName);
+    if (a->growBlockSize) {
+        _snz_arenaFreePrevBlocks(a);
+#ifndef NDEBUG
+        // a new block every time in debug, so stale pointers from before the clear end up in freed + stomped memory
+        _snz_ArenaBlockHeader* old = _snz_arenaBlockHeader(a->start);
+        _snz_ArenaBlockHeader* header = calloc(1, sizeof(_snz_ArenaBlockHeader) + old->reserved);
+        SNZ_ASSERTF(header != NULL, "arena clear for '%s' failed to get a new block.", a->name);
+        header->reserved = old->reserved;
+        _snz_arenaBlockFree(old);
+        a->start = header + 1;
+        a->end = a->start;
+        return;
+#endif
+    }
     memset(a->start, 0, (int64_t)(a->end) - (int64_t)(a->start));
     a->end = a->start;
 }
@@ -199,12 +359,16 @@ char* snz_arenaCopyStr(snz_Arena* arena, const char* str) {
 }
 
 char* snz_arenaFormatStrV(snz_Arena* arena, const char* fmt, va_list args) {
-    uint64_t len = vsnprintf(NULL, 0, fmt, args);
+    va_list argsCopy;
+    va_copy(argsCopy, args);
+    uint64_t len = vsnprintf(NULL, 0, fmt, argsCopy);
+    va_end(argsCopy);
     char* out = SNZ_ARENA_PUSH_ARR(arena, len + 1, char);
     vsprintf_s(out, len + 1, fmt, args);
     return out;
 }
 
+char* snz_arenaFormatStr(snz_Arena* arena, const char* fmt, ...) _SNZ_PRINTF_CHECK(2, 3);
 char* snz_arenaFormatStr(snz_Arena* arena, const char* fmt, ...) {
     va_list args;
     va_start(args, fmt);
@@ -218,7 +382,7 @@ char* snz_arenaFormatStr(snz_Arena* arena, const char* fmt, ...) {
 void _snz_arenaArrBegin(snz_Arena* a, int64_t elemSize, const char* elemName) {
     SNZ_ASSERTF(a->arrModeElemSize == 0,
                 "arena arr begin failed for '%s'. Previous array elem: '%s', attempted to begin with '%s'",
-                a->name, a->arrModeTypeName, elemName);
+                a->name, a->arrModeTypeName ? a->arrModeTypeName : "", elemName);
     a->arrModeElemSize = elemSize;
     a->arrModeElemCount = 0;
     a->arrModeTypeName = elemName;
@@ -231,12 +395,90 @@ void _snz_arenaArrBegin(snz_Arena* a, int64_t elemSize, const char* elemName) {
 #define SNZ_ARENA_ARR_END(arena, T) SNZ_ARENA_ARR_END_NAMED(arena, T, T##Slice)
 void _snz_arenaArrEnd(snz_Arena* a, int64_t elemSize) {
     SNZ_ASSERTF(a->arrModeElemSize == elemSize,
-                "arena arr end failed for '%s', Current elem: '%s' (size %lld), end elt size was: %lld",
+                "arena arr end failed for '%s', Current elem: '%s' (size %" PRId64 "), end elt size was: %" PRId64,
                 a->name, a->arrModeTypeName, a->arrModeElemSize, elemSize);
     a->arrModeElemSize = 0;
     a->arrModeTypeName = NULL;
 }
 
+void snz_arenaTests() {
+    snz_testPrintSection("arenas");
+
+    snz_Arena a = snz_arenaInitGrowable(64, "arena test growable");
+    {
+        int64_t* singles[100] = { 0 };
+        for (int64_t i = 0; i < 100; i++) {
+            singles[i] = SNZ_ARENA_PUSH(&a, int64_t);
+            *singles[i] = i;
+        }
+        bool correct = a.reserved > 64;
+        for (int64_t i = 0; i < 100; i++) {
+            correct &= *singles[i] == i;
+        }
+        snz_testPrint(correct, "growable arena keeps old blocks alive");
+    }
+
+    {
+        SNZ_ARENA_ARR_BEGIN(&a, int64_t);
+        for (int64_t i = 0; i < 1000; i++) {
+            *SNZ_ARENA_PUSH(&a, int64_t) = i;
+        }
+        int64_tSlice arr = SNZ_ARENA_ARR_END(&a, int64_t);
+        bool correct = arr.count == 1000;
+        for (int64_t i = 0; i < arr.count; i++) {
+            correct &= arr.elems[i] == i;
+        }
+        snz_testPrint(correct, "growable arena keeps arrays contiguous across blocks");
+    }
+
+    {
+        int64_t grownSize = a.reserved;
+        snz_arenaClear(&a);
+        int64_t* zeroed = SNZ_ARENA_PUSH_ARR(&a, 100, int64_t);
+        bool correct = a.reserved == grownSize && _snz_arenaBlockHeader(a.start)->prevBlock == NULL;
+        for (int64_t i = 0; i < 100; i++) {
+            correct &= zeroed[i] == 0;
+        }
+        snz_testPrint(correct, "growable arena clear keeps only the biggest block");
+    }
+
+    {
+        bool correct = true;
+        for (int i = 0; i < 8; i++) {
+            SNZ_ARENA_PUSH_ARR(&a, i + 1, char);  // knocks the end off of 16 most of the time
+            HMM_Mat4* mats = SNZ_ARENA_PUSH_ARR_ALIGNED(&a, 3, HMM_Mat4);
+            correct &= ((uintptr_t)mats % _Alignof(HMM_Mat4)) == 0;
+            mats[2] = HMM_M4D(1.0f);
+        }
+        snz_testPrint(correct, "aligned arena pushes line up");
+    }
+
+    {
+        snz_Arena b = snz_arenaInit(100000, "arena test aligned size");
+        snz_arenaPushAligned(&b, 1, 10000, 16);
+        snz_testPrint(snz_arenaUsedBytes(&b) < 10000 + 32, "aligned arena pushes only take what they asked for");
+        snz_arenaDeinit(&b);
+    }
+
+    {
+        snz_Arena b = snz_arenaInitGrowable(64, "arena test pops");
+        int64_t* first = SNZ_ARENA_PUSH(&b, int64_t);
+        *first = 5;
+        void* firstBlock = b.start;
+        int64_t mark = snz_arenaUsedBytes(&b);
+        for (int i = 0; i < 6; i++) {
+            SNZ_ARENA_PUSH_ARR(&b, b.reserved, char);  // a new block every time
+        }
+        snz_arenaPop(&b, snz_arenaUsedBytes(&b) - mark);
+        bool correct = b.start == firstBlock && snz_arenaUsedBytes(&b) == mark && *first == 5;
+        correct &= _snz_arenaBlockHeader(b.start)->prevBlock == NULL;
+        correct &= *SNZ_ARENA_PUSH(&b, int64_t) == 0;
+        snz_arenaDeinit(&b);
+        snz_testPrint(correct, "growable arena pops back across blocks");
+    }
+    snz_arenaDeinit(&a);
+}
+
 // ARENAS ======================================================================
 // ARENAS ======================================================================
 // ARENAS ======================================================================
@@ -288,7 +530,7 @@ static void _snzr_glDebugCallback(GLenum source, GLenum type, GLuint id, GLenum
         lineOfCode;                                                                         \
         int64_t err = glGetError();                                                         \
         if (err != GL_NO_ERROR) {                                                           \
-            SNZ_ASSERTF(false, "open gl function %s failed. code: %lld", #lineOfCode, err); \
+            SNZ_ASSERTF(false, "open gl function %s failed. code: %" PRId64, #lineOfCode, err); \
         }                                                                                   \
     } while (0)
 
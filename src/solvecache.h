@@ -0,0 +1,928 @@
+#pragma once
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <direct.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "mesh.h"
+#include "snooze.h"
+
+/*
+SOLVE CACHE:
+op results kept on disk between runs, so reopening a timeline doesn't mean redoing every csg op in it. Each result is
+one file in a directory, named by a key that's a hash of everything that went into solving it (the timeline makes
+these, see _tl_opCacheKey). Files are a header + a compact dump of the faces, their geo ids, and pattern instances.
+Loading maps the file and points the faces tris straight into the mapping, so a hit is mostly just I/O. The mapping
+has to be kept around for as long as the faces are, see scache_mappingRelease.
+
+Every file gets checked (magic, version, key, size, a hash of all of it, and that every index in it is in bounds)
+before anything in it gets used. Any file that fails gets deleted and counts as a miss.
+
+An index file in the same directory has the size + when each entry was last used, everything over maxBytes gets
+thrown out oldest use first. The index is only written every SCACHE_INDEX_WRITE_EVERY stores and on deinit, from a
+copy taken under the lock so loads + stores on other threads never wait on it. A crash loses whatever happened since
+the last write, which only messes with the LRU order (or leaves files on disk, see the FIXME on _scache_indexRead).
+
+Windows won't delete a file while anything has it mapped, so evicted files that couldn't be deleted are kept on a
+pending list and retried on every store. Whatever is still stuck at deinit goes back in the index as least
+recently used, so the next run either gets a hit out of it or evicts it first.
+
+Safe to load/store from a bunch of threads at once, as long as they don't store the same key at the same time.
+FIXME: not safe to share one directory between two processes
+
+fns:
+scache_init() - makes the directory if it needs to and reads the index
+scache_deinit() - writes the index, frees everything. Mappings handed out stay good.
+scache_load() - false on a miss or a bad file
+scache_store() - writes faces + instances under key, evicting whatever's needed to fit
+scache_mappingRelease() - unmaps what scache_load gave
+*/
+
+#define SCACHE_MAGIC 0x43534441  // "ADSC"
+#define SCACHE_INDEX_MAGIC 0x49534441  // "ADSI"
+#define SCACHE_VERSION 1
+#define SCACHE_PATH_MAX 512
+#define SCACHE_DIR_MAX (SCACHE_PATH_MAX - 32)  // leaves room for a file name + .tmp on the end of any path made from it
+#define SCACHE_TEMP_PATH_MAX (SCACHE_PATH_MAX + 8)  // for paths with .tmp (or anything that short) on the end of a full path
+#define SCACHE_INDEX_NAME "index.adsi"
+#define SCACHE_INDEX_WRITE_EVERY 32  // stores
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint64_t payloadBytes;
+    uint64_t payloadHash;
+} _scache_FileHeader;
+
+// first thing in the payload. After it go instances, faces, ids, then tris at the first 16 aligned offset
+typedef struct {
+    int64_t instanceCount;
+    int64_t faceCount;
+    int64_t idCount;
+    int64_t triCount;
+} _scache_PayloadHeader;
+
+typedef struct {
+    int64_t idIdx;
+    int64_t triStart;
+    int64_t triCount;
+} _scache_FileFace;
+
+typedef struct {
+    int64_t geoKind;
+    int64_t opUniqueId;
+    int64_t baseNodeId;
+    int64_t diffIdxs[2]; // -1 for none, otherwise always after this one, so there can't be any loops
+} _scache_FileGeoId;
+
+SNZ_SLICE(_scache_FileGeoId);
+
+typedef struct {
+    uint64_t key;
+    int64_t bytes;
+    int64_t lastUse;
+} _scache_Entry;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    int64_t entryCount;
+    int64_t useClock;
+    uint64_t entriesHash;
+} _scache_IndexHeader;
+
+typedef struct {
+    void* data; // null when nothing's mapped
+    int64_t size;
+} scache_Mapping;
+
+typedef struct {
+    scache_Mapping mapping; // faces tris point into this
+    mesh_FaceSlice* faces;
+    HMM_Mat4Slice* instances; // null when there weren't any stored
+} scache_Result;
+
+typedef struct {
+    char dirPath[SCACHE_DIR_MAX];
+    int64_t maxBytes;
+    SDL_atomic_t indexWriting; // 1 while some thread has the index file open, only one writes at a time
+
+    SDL_SpinLock lock; // for everything below
+    _scache_Entry* entries; // FIXME: linear lookups, fine for the few thousand entries a cache would have
+    int64_t entryCount;
+    int64_t entryCapacity;
+    int64_t totalBytes;
+    int64_t useClock; // goes up once per load/store, entries with the lowest lastUse go first
+    _scache_Entry* pendingDeletes; // evicted, but the file couldn't be deleted yet
+    int64_t pendingDeleteCount;
+    int64_t pendingDeleteCapacity;
+    int64_t storesSinceIndexWrite;
+
+    struct {
+        int64_t hits;
+        int64_t misses;
+        int64_t stores;
+        int64_t evictions;
+        int64_t rejected; // files that failed a check on load
+    } stats;
+} scache_Cache;
+
+// word at a time, this runs over every byte of every hit
+static uint64_t _scache_hashBytes(uint64_t hash, const void* data, int64_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    int64_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word = 0;
+        memcpy(&word, bytes + i, 8);
+        hash = (hash ^ word) * 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 32;
+    }
+    for (; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+static void _scache_filePath(const scache_Cache* c, uint64_t key, char* out) {
+    snprintf(out, SCACHE_PATH_MAX, "%s/%016llx.adsc", c->dirPath, (unsigned long long)key);
+}
+
+static _scache_Entry* _scache_entryFind(scache_Cache* c, uint64_t key) {
+    for (int64_t i = 0; i < c->entryCount; i++) {
+        if (c->entries[i].key == key) {
+            return &c->entries[i];
+        }
+    }
+    return NULL;
+}
+
+// swaps in the last one, order doesn't matter
+static void _scache_entryRemove(scache_Cache* c, _scache_Entry* entry) {
+    c->totalBytes -= entry->bytes;
+    *entry = c->entries[c->entryCount - 1];
+    c->entryCount--;
+}
+
+static _scache_Entry* _scache_entryPush(scache_Cache* c, uint64_t key) {
+    if (c->entryCount >= c->entryCapacity) {
+        c->entryCapacity = c->entryCapacity ? c->entryCapacity * 2 : 64;
+        c->entries = realloc(c->entries, sizeof(*c->entries) * c->entryCapacity);
+        SNZ_ASSERTF(c->entries != NULL, "solve cache index alloc failed, capacity: %" PRId64, c->entryCapacity);
+    }
+    _scache_Entry* out = &c->entries[c->entryCount];
+    c->entryCount++;
+    *out = (_scache_Entry){ .key = key };
+    return out;
+}
+
+typedef struct {
+    _scache_Entry* entries; // malloced
+    int64_t entryCount;
+    int64_t useClock;
+} _scache_IndexSnapshot;
+
+// copy of what goes in the index, so the file can be written after letting go of the lock
+static _scache_IndexSnapshot _scache_indexSnapshotLocked(const scache_Cache* c) {
+    _scache_IndexSnapshot snap = {
+        .entries = malloc(sizeof(*c->entries) * SNZ_MAX(c->entryCount, 1)),
+        .entryCount = c->entryCount,
+        .useClock = c->useClock,
+    };
+    SNZ_ASSERTF(snap.entries != NULL, "solve cache index snapshot alloc failed, count: %" PRId64, c->entryCount);
+    memcpy(snap.entries, c->entries, sizeof(*c->entries) * c->entryCount);
+    return snap;
+}
+
+// written to a temp file first, so a crash partway leaves the old one. Frees the snapshot.
+// Has to be called with indexWriting set, two threads writing the temp file at once would mangle it
+static void _scache_indexWrite(const scache_Cache* c, _scache_IndexSnapshot* snap) {
+    char path[SCACHE_PATH_MAX] = { 0 };
+    char tempPath[SCACHE_PATH_MAX] = { 0 };
+    snprintf(path, SCACHE_PATH_MAX, "%s/" SCACHE_INDEX_NAME, c->dirPath);
+    snprintf(tempPath, SCACHE_PATH_MAX, "%s/" SCACHE_INDEX_NAME ".tmp", c->dirPath);
+
+    _scache_IndexHeader header = {
+        .magic = SCACHE_INDEX_MAGIC,
+        .version = SCACHE_VERSION,
+        .entryCount = snap->entryCount,
+        .useClock = snap->useClock,
+        .entriesHash = _scache_hashBytes(14695981039346656037ULL, snap->entries, sizeof(*snap->entries) * snap->entryCount),
+    };
+    FILE* f = fopen(tempPath, "wb");
+    bool ok = f != NULL;
+    if (ok) {
+        ok &= fwrite(&header, sizeof(header), 1, f) == 1;
+        ok &= (int64_t)fwrite(snap->entries, sizeof(*snap->entries), snap->entryCount, f) == snap->entryCount;
+        ok &= fclose(f) == 0;
+    }
+    free(snap->entries);
+    *snap = (_scache_IndexSnapshot){ 0 };
+
+    if (!ok) {
+        SNZ_LOGF("Writing solve cache index '%s' failed.", tempPath);
+        remove(tempPath);
+        return;
+    }
+    remove(path);
+    if (rename(tempPath, path) != 0) {
+        SNZ_LOGF("Moving solve cache index to '%s' failed.", path);
+    }
+}
+
+// skipped if another thread is already writing, storesSinceIndexWrite stays up so the next store tries again
+static void _scache_indexWriteIfFree(scache_Cache* c) {
+    if (SDL_AtomicSet(&c->indexWriting, 1)) {
+        return;
+    }
+    SDL_AtomicLock(&c->lock);
+    _scache_IndexSnapshot snap = _scache_indexSnapshotLocked(c);
+    c->storesSinceIndexWrite = 0;
+    SDL_AtomicUnlock(&c->lock);
+
+    _scache_indexWrite(c, &snap);
+    SDL_AtomicSet(&c->indexWriting, 0);
+}
+
+// a missing or broken index just starts the cache empty. FIXME: any files it had are left on disk forever
+static void _scache_indexRead(scache_Cache* c) {
+    char path[SCACHE_PATH_MAX] = { 0 };
+    snprintf(path, SCACHE_PATH_MAX, "%s/" SCACHE_INDEX_NAME, c->dirPath);
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        return;
+    }
+
+    _scache_IndexHeader header = { 0 };
+    bool ok = fread(&header, sizeof(header), 1, f) == 1;
+    ok = ok && header.magic == SCACHE_INDEX_MAGIC && header.version == SCACHE_VERSION;
+    ok = ok && header.entryCount >= 0 && header.entryCount < INT32_MAX && header.useClock >= 0;
+    if (ok) {
+        c->entryCapacity = SNZ_MAX(header.entryCount, 64);
+        c->entries = realloc(c->entries, sizeof(*c->entries) * c->entryCapacity);
+        SNZ_ASSERTF(c->entries != NULL, "solve cache index alloc failed, capacity: %" PRId64, c->entryCapacity);
+        ok = (int64_t)fread(c->entries, sizeof(*c->entries), header.entryCount, f) == header.entryCount;
+    }
+    ok = ok && header.entriesHash == _scache_hashBytes(14695981039346656037ULL, c->entries, sizeof(*c->entries) * header.entryCount);
+    fclose(f);
+    if (!ok) {
+        SNZ_LOGF("Solve cache index '%s' was broken, starting over.", path);
+        return;
+    }
+
+    c->entryCount = header.entryCount;
+    c->useClock = header.useClock;
+    for (int64_t i = 0; i < c->entryCount; i++) {
+        c->totalBytes += c->entries[i].bytes;
+    }
+}
+
+// false when the file is still there, missing counts as deleted
+static bool _scache_fileDelete(const char* path) {
+    return remove(path) == 0 || errno == ENOENT;
+}
+
+// lock has to be held
+static void _scache_pendingDeletePush(scache_Cache* c, _scache_Entry entry) {
+    if (c->pendingDeleteCount >= c->pendingDeleteCapacity) {
+        c->pendingDeleteCapacity = c->pendingDeleteCapacity ? c->pendingDeleteCapacity * 2 : 16;
+        c->pendingDeletes = realloc(c->pendingDeletes, sizeof(*c->pendingDeletes) * c->pendingDeleteCapacity);
+        SNZ_ASSERTF(c->pendingDeletes != NULL, "solve cache pending delete alloc failed, capacity: %" PRId64, c->pendingDeleteCapacity);
+    }
+    c->pendingDeletes[c->pendingDeleteCount] = entry;
+    c->pendingDeleteCount++;
+}
+
+// lock has to be held. When key is given it's dropped without deleting it's file, because that's just been rewritten
+static void _scache_pendingDeletesRetryLocked(scache_Cache* c, uint64_t rewrittenKey) {
+    for (int64_t i = c->pendingDeleteCount - 1; i >= 0; i--) {
+        char path[SCACHE_PATH_MAX] = { 0 };
+        _scache_filePath(c, c->pendingDeletes[i].key, path);
+        if (c->pendingDeletes[i].key == rewrittenKey || _scache_fileDelete(path)) {
+            c->pendingDeletes[i] = c->pendingDeletes[c->pendingDeleteCount - 1];
+            c->pendingDeleteCount--;
+        }
+    }
+}
+
+// oldest use first until everything fits, lock has to be held. Files that are mapped by someone stay good on posix,
+// windows won't delete those so they go on the pending list.
+static void _scache_evictLocked(scache_Cache* c) {
+    while (c->totalBytes > c->maxBytes && c->entryCount > 0) {
+        _scache_Entry* oldest = &c->entries[0];
+        for (int64_t i = 1; i < c->entryCount; i++) {
+            if (c->entries[i].lastUse < oldest->lastUse) {
+                oldest = &c->entries[i];
+            }
+        }
+        char path[SCACHE_PATH_MAX] = { 0 };
+        _scache_filePath(c, oldest->key, path);
+        if (!_scache_fileDelete(path)) {
+            _scache_pendingDeletePush(c, *oldest);
+        }
+        _scache_entryRemove(c, oldest);
+        c->stats.evictions++;
+    }
+}
+
+void scache_init(scache_Cache* c, const char* dirPath, int64_t maxBytes) {
+    *c = (scache_Cache){ .maxBytes = maxBytes };
+    SNZ_ASSERTF(strlen(dirPath) < SCACHE_DIR_MAX, "solve cache path too long: %s", dirPath);
+    strcpy(c->dirPath, dirPath);
+#ifdef _WIN32
+    _mkdir(dirPath);
+#else
+    mkdir(dirPath, 0755);
+#endif
+    _scache_indexRead(c);
+    _scache_evictLocked(c);  // cap could've gone down since last time
+}
+
+void scache_deinit(scache_Cache* c) {
+    SDL_AtomicLock(&c->lock);
+    _scache_pendingDeletesRetryLocked(c, 0);
+    for (int64_t i = 0; i < c->pendingDeleteCount; i++) {
+        _scache_Entry* entry = _scache_entryFind(c, c->pendingDeletes[i].key);
+        if (!entry) {
+            entry = _scache_entryPush(c, c->pendingDeletes[i].key);
+            entry->bytes = c->pendingDeletes[i].bytes;
+            c->totalBytes += entry->bytes;
+        }
+        entry->lastUse = 0;
+    }
+    _scache_IndexSnapshot snap = _scache_indexSnapshotLocked(c);
+    SDL_AtomicUnlock(&c->lock);
+
+    while (SDL_AtomicSet(&c->indexWriting, 1)) {
+        SDL_Delay(0);  // a store on another thread is still finishing its write
+    }
+    _scache_indexWrite(c, &snap);
+    free(c->entries);
+    free(c->pendingDeletes);
+    *c = (scache_Cache){ 0 };
+}
+
+// copy on write, so whoever gets the faces can still write to them without touching the file
+static bool _scache_map(const char* path, scache_Mapping* out) {
+    *out = (scache_Mapping){ 0 };
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size = { 0 };
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    CloseHandle(file);  // the mapping keeps the file open
+    if (!mapping) {
+        return false;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping);  // and the view keeps the mapping
+    if (!data) {
+        return false;
+    }
+    *out = (scache_Mapping){ .data = data, .size = size.QuadPart };
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st = { 0 };
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* data = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);  // the mapping keeps the file
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    *out = (scache_Mapping){ .data = data, .size = st.st_size };
+#endif
+    return true;
+}
+
+void scache_mappingRelease(scache_Mapping* m) {
+    if (!m->data) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(m->data);
+#else
+    munmap(m->data, m->size);
+#endif
+    *m = (scache_Mapping){ 0 };
+}
+
+static int64_t _scache_align16(int64_t offset) {
+    return (offset + 15) & ~(int64_t)15;
+}
+
+// offset of the tris from the start of the payload, given what's in its header
+static int64_t _scache_trisOffset(const _scache_PayloadHeader* p) {
+    int64_t offset = sizeof(_scache_PayloadHeader);
+    offset += p->instanceCount * sizeof(HMM_Mat4);
+    offset += p->faceCount * sizeof(_scache_FileFace);
+    offset += p->idCount * sizeof(_scache_FileGeoId);
+    return _scache_align16(offset);
+}
+
+// false if anything in the file is off. Everything after this can index into it without checking
+static bool _scache_fileValid(const scache_Mapping* m, uint64_t key) {
+    if (m->size < (int64_t)(sizeof(_scache_FileHeader) + sizeof(_scache_PayloadHeader))) {
+        return false;
+    }
+    const _scache_FileHeader* header = (const _scache_FileHeader*)m->data;
+    if (header->magic != SCACHE_MAGIC || header->version != SCACHE_VERSION || header->key != key) {
+        return false;
+    } else if (header->payloadBytes != (uint64_t)(m->size - sizeof(*header))) {
+        return false;
+    }
+    const uint8_t* payload = (const uint8_t*)m->data + sizeof(*header);
+    if (_scache_hashBytes(14695981039346656037ULL, payload, header->payloadBytes) != header->payloadHash) {
+        return false;
+    }
+
+    const _scache_PayloadHeader* p = (const _scache_PayloadHeader*)payload;
+    int64_t maxCount = (int64_t)header->payloadBytes;  // nothing takes less than a byte, so this keeps the sums below from overflowing
+    if (p->instanceCount < 0 || p->faceCount < 0 || p->idCount < p->faceCount || p->triCount < 0) {
+        return false;
+    } else if (p->instanceCount > maxCount || p->idCount > maxCount || p->triCount > maxCount) {
+        return false;
+    } else if (_scache_trisOffset(p) + p->triCount * (int64_t)sizeof(geo_Tri) != (int64_t)header->payloadBytes) {
+        return false;
+    }
+
+    const _scache_FileFace* faces = (const _scache_FileFace*)(payload + sizeof(*p) + p->instanceCount * sizeof(HMM_Mat4));
+    for (int64_t i = 0; i < p->faceCount; i++) {
+        const _scache_FileFace* f = &faces[i];
+        if (f->idIdx < 0 || f->idIdx >= p->idCount || f->triStart < 0 || f->triCount < 0) {
+            return false;
+        } else if (f->triCount > p->triCount - f->triStart) {
+            return false;
+        }
+    }
+    const _scache_FileGeoId* ids = (const _scache_FileGeoId*)(faces + p->faceCount);
+    for (int64_t i = 0; i < p->idCount; i++) {
+        for (int j = 0; j < 2; j++) {
+            int64_t diffIdx = ids[i].diffIdxs[j];
+            if (diffIdx != -1 && (diffIdx <= i || diffIdx >= p->idCount)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// faces/ids/instances go in arena, tris stay in the mapping that's in out
+bool scache_load(scache_Cache* c, uint64_t key, scache_Result* out, snz_Arena* arena) {
+    *out = (scache_Result){ 0 };
+    SDL_AtomicLock(&c->lock);
+    _scache_Entry* entry = _scache_entryFind(c, key);
+    if (!entry) {
+        c->stats.misses++;
+        SDL_AtomicUnlock(&c->lock);
+        return false;
+    }
+    c->useClock++;
+    entry->lastUse = c->useClock;
+    SDL_AtomicUnlock(&c->lock);
+
+    char path[SCACHE_PATH_MAX] = { 0 };
+    _scache_filePath(c, key, path);
+    scache_Mapping mapping = { 0 };
+    bool mapped = _scache_map(path, &mapping);
+    if (!mapped || !_scache_fileValid(&mapping, key)) {
+        scache_mappingRelease(&mapping);
+        SNZ_LOGF("Solve cache file '%s' was missing or broken, dropping it.", path);
+        remove(path);
+        SDL_AtomicLock(&c->lock);
+        entry = _scache_entryFind(c, key);  // could've moved while unlocked
+        if (entry) {
+            _scache_entryRemove(c, entry);
+        }
+        c->stats.rejected++;
+        c->stats.misses++;
+        SDL_AtomicUnlock(&c->lock);
+        return false;
+    }
+
+    const uint8_t* payload = (const uint8_t*)mapping.data + sizeof(_scache_FileHeader);
+    const _scache_PayloadHeader* p = (const _scache_PayloadHeader*)payload;
+    const HMM_Mat4* instances = (const HMM_Mat4*)(payload + sizeof(*p));
+    const _scache_FileFace* fileFaces = (const _scache_FileFace*)(instances + p->instanceCount);
+    const _scache_FileGeoId* fileIds = (const _scache_FileGeoId*)(fileFaces + p->faceCount);
+    geo_Tri* tris = (geo_Tri*)(payload + _scache_trisOffset(p));
+
+    // backwards so that diffs are always made before the ones pointing at them
+    mesh_GeoID* ids = SNZ_ARENA_PUSH_ARR(arena, p->idCount, mesh_GeoID);
+    for (int64_t i = p->idCount - 1; i >= 0; i--) {
+        const _scache_FileGeoId* fileId = &fileIds[i];
+        ids[i] = (mesh_GeoID){
+            .geoKind = (mesh_GeoKind)fileId->geoKind,
+            .opUniqueId = fileId->opUniqueId,
+            .baseNodeId = fileId->baseNodeId,
+            .diffGeo1 = fileId->diffIdxs[0] >= 0 ? &ids[fileId->diffIdxs[0]] : NULL,
+            .diffGeo2 = fileId->diffIdxs[1] >= 0 ? &ids[fileId->diffIdxs[1]] : NULL,
+        };
+    }
+
+    out->faces = SNZ_ARENA_PUSH(arena, mesh_FaceSlice);
+    *out->faces = (mesh_FaceSlice){
+        .count = p->faceCount,
+        .elems = SNZ_ARENA_PUSH_ARR(arena, p->faceCount, mesh_Face),
+    };
+    for (int64_t i = 0; i < p->faceCount; i++) {
+        const _scache_FileFace* f = &fileFaces[i];
+        out->faces->elems[i] = (mesh_Face){
+            .id = ids[f->idIdx],
+            .tris = (geo_TriSlice){ .elems = &tris[f->triStart], .count = f->triCount },
+        };
+    }
+
+    if (p->instanceCount > 0) {
+        // copied out cause these need more alignment than the file gives them
+        out->instances = SNZ_ARENA_PUSH(arena, HMM_Mat4Slice);
+        *out->instances = (HMM_Mat4Slice){
+            .count = p->instanceCount,
+            .elems = SNZ_ARENA_PUSH_ARR_ALIGNED(arena, p->instanceCount, HMM_Mat4),
+        };
+        memcpy(out->instances->elems, instances, sizeof(HMM_Mat4) * p->instanceCount);
+    }
+    out->mapping = mapping;
+
+    SDL_AtomicLock(&c->lock);
+    c->stats.hits++;
+    SDL_AtomicUnlock(&c->lock);
+    return true;
+}
+
+// pushes id + every diff under it, returns the index it went to. Only ever pushed after the one pointing at it
+static int64_t _scache_idPush(const mesh_GeoID* id, snz_Arena* scratch, int64_t* idCount) {
+    int64_t idx = *idCount;
+    (*idCount)++;
+    _scache_FileGeoId* out = SNZ_ARENA_PUSH(scratch, _scache_FileGeoId);
+    *out = (_scache_FileGeoId){
+        .geoKind = id->geoKind,
+        .opUniqueId = id->opUniqueId,
+        .baseNodeId = id->baseNodeId,
+        .diffIdxs = { -1, -1 },
+    };
+    const mesh_GeoID* diffs[2] = { id->diffGeo1, id->diffGeo2 };
+    for (int i = 0; i < 2; i++) {
+        if (diffs[i]) {
+            out->diffIdxs[i] = _scache_idPush(diffs[i], scratch, idCount);
+        }
+    }
+    return idx;
+}
+
+// instances can be null. Nothing happens but a log if the file can't be written
+void scache_store(scache_Cache* c, uint64_t key, const mesh_FaceSlice* faces, const HMM_Mat4Slice* instances, snz_Arena* scratch) {
+    uint64_t scratchStart = snz_arenaUsedBytes(scratch);
+    int64_t instanceCount = instances ? instances->count : 0;
+
+    // ids go into their own run in scratch while faces get counted, then everything's written out in order
+    _scache_FileFace* fileFaces = SNZ_ARENA_PUSH_ARR(scratch, faces->count, _scache_FileFace);
+    int64_t idCount = 0;
+    int64_t triCount = 0;
+    SNZ_ARENA_ARR_BEGIN(scratch, _scache_FileGeoId);
+    for (int64_t i = 0; i < faces->count; i++) {
+        const mesh_Face* f = &faces->elems[i];
+        fileFaces[i] = (_scache_FileFace){
+            .idIdx = _scache_idPush(&f->id, scratch, &idCount),
+            .triStart = triCount,
+            .triCount = f->tris.count,
+        };
+        triCount += f->tris.count;
+    }
+    _scache_FileGeoIdSlice fileIds = SNZ_ARENA_ARR_END(scratch, _scache_FileGeoId);
+    SNZ_ASSERT(fileIds.count == idCount, "solve cache id count mismatch.");
+
+    _scache_PayloadHeader payloadHeader = {
+        .instanceCount = instanceCount,
+        .faceCount = faces->count,
+        .idCount = idCount,
+        .triCount = triCount,
+    };
+    int64_t trisOffset = _scache_trisOffset(&payloadHeader);
+    int64_t payloadBytes = trisOffset + triCount * sizeof(geo_Tri);
+    uint8_t* payload = SNZ_ARENA_PUSH_ARR(scratch, payloadBytes, uint8_t);
+    {
+        uint8_t* at = payload;
+        memcpy(at, &payloadHeader, sizeof(payloadHeader));
+        at += sizeof(payloadHeader);
+        if (instanceCount) {
+            memcpy(at, instances->elems, sizeof(HMM_Mat4) * instanceCount);
+            at += sizeof(HMM_Mat4) * instanceCount;
+        }
+        memcpy(at, fileFaces, sizeof(*fileFaces) * faces->count);
+        at += sizeof(*fileFaces) * faces->count;
+        memcpy(at, fileIds.elems, sizeof(*fileIds.elems) * idCount);
+
+        geo_Tri* tris = (geo_Tri*)(payload + trisOffset);
+        for (int64_t i = 0; i < faces->count; i++) {
+            const geo_TriSlice* faceTris = &faces->elems[i].tris;
+            memcpy(&tris[fileFaces[i].triStart], faceTris->elems, sizeof(geo_Tri) * faceTris->count);
+        }
+    }
+
+    _scache_FileHeader header = {
+        .magic = SCACHE_MAGIC,
+        .version = SCACHE_VERSION,
+        .key = key,
+        .payloadBytes = payloadBytes,
+        .payloadHash = _scache_hashBytes(14695981039346656037ULL, payload, payloadBytes),
+    };
+
+    // under a temp name first so a load never sees half a file
+    char path[SCACHE_PATH_MAX] = { 0 };
+    char tempPath[SCACHE_TEMP_PATH_MAX] = { 0 };
+    _scache_filePath(c, key, path);
+    int tempPathLen = snprintf(tempPath, SCACHE_TEMP_PATH_MAX, "%s.tmp", path);
+    if (tempPathLen < 0 || tempPathLen >= SCACHE_TEMP_PATH_MAX) {
+        snz_arenaPop(scratch, snz_arenaUsedBytes(scratch) - scratchStart);
+        SNZ_LOGF("Solve cache temp path for '%s' didn't fit.", path);
+        return;
+    }
+    FILE* f = fopen(tempPath, "wb");
+    bool ok = f != NULL;
+    if (ok) {
+        ok &= fwrite(&header, sizeof(header), 1, f) == 1;
+        ok &= (int64_t)fwrite(payload, 1, payloadBytes, f) == payloadBytes;
+        ok &= fclose(f) == 0;
+    }
+    if (ok) {
+        remove(path);
+        ok = rename(tempPath, path) == 0;
+    }
+    snz_arenaPop(scratch, snz_arenaUsedBytes(scratch) - scratchStart);
+    if (!ok) {
+        SNZ_LOGF("Writing solve cache file '%s' failed.", path);
+        remove(tempPath);
+        return;
+    }
+
+    SDL_AtomicLock(&c->lock);
+    _scache_Entry* entry = _scache_entryFind(c, key);
+    if (entry) {
+        c->totalBytes -= entry->bytes;
+    } else {
+        entry = _scache_entryPush(c, key);
+    }
+    c->useClock++;
+    entry->bytes = sizeof(header) + payloadBytes;
+    entry->lastUse = c->useClock;
+    c->totalBytes += entry->bytes;
+    c->stats.stores++;
+    _scache_pendingDeletesRetryLocked(c, key);
+    _scache_evictLocked(c);
+    c->storesSinceIndexWrite++;
+    bool indexDue = c->storesSinceIndexWrite >= SCACHE_INDEX_WRITE_EVERY;
+    SDL_AtomicUnlock(&c->lock);
+
+    if (indexDue) {
+        _scache_indexWriteIfFree(c);
+    }
+}
+
+static mesh_FaceSlice _scache_testRandomFaces(snz_Arena* arena) {
+    mesh_FaceSlice out = {
+        .count = 1 + rand() % 20,
+    };
+    out.elems = SNZ_ARENA_PUSH_ARR(arena, out.count, mesh_Face);
+    for (int64_t i = 0; i < out.count; i++) {
+        mesh_Face* f = &out.elems[i];
+        f->id = (mesh_GeoID){ .geoKind = MESH_GK_FACE, .opUniqueId = rand() % 10, .baseNodeId = i };
+        mesh_GeoID* parent = &f->id;
+        for (int depth = rand() % 4; depth > 0; depth--) {
+            mesh_GeoID* diff = SNZ_ARENA_PUSH(arena, mesh_GeoID);
+            *diff = (mesh_GeoID){ .geoKind = MESH_GK_EDGE, .opUniqueId = rand(), .baseNodeId = rand() };
+            if (rand() % 2) {
+                parent->diffGeo1 = diff;
+            } else {
+                parent->diffGeo2 = diff;
+            }
+            parent = diff;
+        }
+
+        f->tris = (geo_TriSlice){ .count = rand() % 50 };
+        f->tris.elems = SNZ_ARENA_PUSH_ARR(arena, f->tris.count, geo_Tri);
+        for (int64_t triIdx = 0; triIdx < f->tris.count; triIdx++) {
+            for (int ptIdx = 0; ptIdx < 3; ptIdx++) {
+                f->tris.elems[triIdx].elems[ptIdx] = HMM_V3((float)rand(), (float)rand(), (float)rand());
+            }
+        }
+    }
+    return out;
+}
+
+static bool _scache_testGeoIdsEqual(const mesh_GeoID* a, const mesh_GeoID* b) {
+    if (!a || !b) {
+        return a == b;
+    }
+    bool out = a->geoKind == b->geoKind && a->opUniqueId == b->opUniqueId && a->baseNodeId == b->baseNodeId;
+    return out && _scache_testGeoIdsEqual(a->diffGeo1, b->diffGeo1) && _scache_testGeoIdsEqual(a->diffGeo2, b->diffGeo2);
+}
+
+static bool _scache_testFacesEqual(const mesh_FaceSlice* a, const mesh_FaceSlice* b) {
+    if (a->count != b->count) {
+        return false;
+    }
+    for (int64_t i = 0; i < a->count; i++) {
+        const mesh_Face* faceA = &a->elems[i];
+        const mesh_Face* faceB = &b->elems[i];
+        if (!_scache_testGeoIdsEqual(&faceA->id, &faceB->id) || faceA->tris.count != faceB->tris.count) {
+            return false;
+        } else if (memcmp(faceA->tris.elems, faceB->tris.elems, sizeof(geo_Tri) * faceA->tris.count) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void scache_tests() {
+    snz_testPrintSection("solve cache");
+    srand(4);
+    snz_Arena arena = snz_arenaInit(10000000, "solve cache test arena");
+    snz_Arena scratch = snz_arenaInit(10000000, "solve cache test scratch");
+    const char* dir = "testing/solvecache";
+
+    {  // fresh every time
+        scache_Cache c = { 0 };
+        scache_init(&c, dir, INT64_MAX);
+        while (c.entryCount) {
+            char path[SCACHE_PATH_MAX] = { 0 };
+            _scache_filePath(&c, c.entries[0].key, path);
+            remove(path);
+            _scache_entryRemove(&c, &c.entries[0]);
+        }
+        scache_deinit(&c);
+    }
+
+    {
+        scache_Cache c = { 0 };
+        scache_init(&c, dir, INT64_MAX);
+        mesh_FaceSlice stored[20] = { 0 };
+        HMM_Mat4Slice instances = { .count = 3, .elems = SNZ_ARENA_PUSH_ARR_ALIGNED(&arena, 3, HMM_Mat4) };
+        for (int i = 0; i < 3; i++) {
+            instances.elems[i] = HMM_Translate(HMM_V3((float)i, 2, 3));
+        }
+        for (int i = 0; i < 20; i++) {
+            stored[i] = _scache_testRandomFaces(&arena);
+            scache_store(&c, i + 1, &stored[i], i == 7 ? &instances : NULL, &scratch);
+        }
+        scache_deinit(&c);
+
+        // from a new cache to make sure it's the index + files doing it
+        scache_init(&c, dir, INT64_MAX);
+        bool correct = c.entryCount == 20;
+        for (int i = 0; i < 20; i++) {
+            scache_Result result = { 0 };
+            correct &= scache_load(&c, i + 1, &result, &arena);
+            correct &= result.faces && _scache_testFacesEqual(result.faces, &stored[i]);
+            if (i == 7) {
+                correct &= result.instances && result.instances->count == 3;
+                correct &= result.instances && memcmp(result.instances->elems, instances.elems, sizeof(HMM_Mat4) * 3) == 0;
+            } else {
+                correct &= result.instances == NULL;
+            }
+            scache_mappingRelease(&result.mapping);
+        }
+        scache_Result missed = { 0 };
+        correct &= !scache_load(&c, 1000, &missed, &arena) && c.stats.hits == 20 && c.stats.misses == 1;
+        snz_testPrint(correct, "solve cache results come back the same after reopening");
+
+        // flip one byte in the middle of a file
+        char path[SCACHE_PATH_MAX] = { 0 };
+        _scache_filePath(&c, 3, path);
+        FILE* f = fopen(path, "r+b");
+        fseek(f, 0, SEEK_END);
+        long size = ftell(f);
+        fseek(f, size / 2, SEEK_SET);
+        uint8_t byte = 0;
+        fread(&byte, 1, 1, f);
+        byte ^= 0x10;
+        fseek(f, size / 2, SEEK_SET);
+        fwrite(&byte, 1, 1, f);
+        fclose(f);
+
+        // and cut the end off of another
+        _scache_filePath(&c, 4, path);
+        f = fopen(path, "rb");
+        uint8_t* bytes = SNZ_ARENA_PUSH_ARR(&scratch, 100000, uint8_t);
+        size_t readSize = fread(bytes, 1, 100000, f);
+        fclose(f);
+        f = fopen(path, "wb");
+        fwrite(bytes, 1, readSize - 10, f);
+        fclose(f);
+        snz_arenaClear(&scratch);
+
+        scache_Result result = { 0 };
+        correct = !scache_load(&c, 3, &result, &arena) && !scache_load(&c, 4, &result, &arena);
+        correct &= c.stats.rejected == 2 && c.entryCount == 18;
+        correct &= scache_load(&c, 5, &result, &arena);
+        scache_mappingRelease(&result.mapping);
+        snz_testPrint(correct, "solve cache drops files that were messed with");
+
+        // used order is now 2, 5, 6 ... 20, 1 (3 + 4 are gone). A cap that only fits 20, 1, and a new one has to drop the other 16
+        for (int i = 6; i <= 20; i++) {
+            correct &= scache_load(&c, i, &result, &arena);
+            scache_mappingRelease(&result.mapping);
+        }
+        correct &= scache_load(&c, 1, &result, &arena);
+        scache_mappingRelease(&result.mapping);
+        int64_t emptyBytes = sizeof(_scache_FileHeader) + _scache_trisOffset(&(_scache_PayloadHeader){ 0 });
+        c.maxBytes = _scache_entryFind(&c, 1)->bytes + _scache_entryFind(&c, 20)->bytes + emptyBytes;
+        mesh_FaceSlice empty = { .count = 0 };
+        scache_store(&c, 50, &empty, NULL, &scratch);
+        correct &= c.entryCount == 3 && c.totalBytes == c.maxBytes && c.stats.evictions == 16;
+        correct &= _scache_entryFind(&c, 1) && _scache_entryFind(&c, 20) && _scache_entryFind(&c, 50);
+        scache_deinit(&c);
+
+        scache_init(&c, dir, INT64_MAX);
+        correct &= c.entryCount == 3 && scache_load(&c, 50, &result, &arena) && result.faces->count == 0;
+        scache_mappingRelease(&result.mapping);
+        scache_deinit(&c);
+        snz_testPrint(correct, "solve cache evicts least recently used over the cap");
+    }
+
+#ifndef _WIN32
+    {
+        // a directory with something in it can't be removed either, so it stands in for a file that windows has mapped
+        scache_Cache c = { 0 };
+        scache_init(&c, dir, INT64_MAX);
+        mesh_FaceSlice empty = { .count = 0 };
+        scache_store(&c, 60, &empty, NULL, &scratch);
+        char path[SCACHE_PATH_MAX] = { 0 };
+        char innerPath[SCACHE_TEMP_PATH_MAX] = { 0 };
+        _scache_filePath(&c, 60, path);
+        int innerPathLen = snprintf(innerPath, SCACHE_TEMP_PATH_MAX, "%s/stuck", path);
+        SNZ_ASSERTF(innerPathLen > 0 && innerPathLen < SCACHE_TEMP_PATH_MAX, "solve cache test path didn't fit: %s", path);
+        remove(path);
+        mkdir(path, 0755);
+        fclose(fopen(innerPath, "wb"));
+
+        c.maxBytes = 0;
+        scache_store(&c, 61, &empty, NULL, &scratch);  // evicts everything, itself included
+        bool correct = c.entryCount == 0 && c.pendingDeleteCount == 1 && c.pendingDeletes[0].key == 60;
+        scache_deinit(&c);
+        scache_init(&c, dir, INT64_MAX);
+        _scache_Entry* stuck = _scache_entryFind(&c, 60);
+        correct &= stuck && stuck->lastUse == 0;
+
+        remove(innerPath);
+        c.maxBytes = 0;
+        scache_store(&c, 62, &empty, NULL, &scratch);
+        struct stat st = { 0 };
+        correct &= c.entryCount == 0 && c.pendingDeleteCount == 0 && stat(path, &st) != 0;
+        scache_deinit(&c);
+        snz_testPrint(correct, "solve cache retries deletes that failed");
+    }
+#endif
+
+    {
+        scache_Cache c = { 0 };
+        scache_init(&c, dir, INT64_MAX);
+        char indexPath[SCACHE_PATH_MAX] = { 0 };
+        snprintf(indexPath, SCACHE_PATH_MAX, "%s/" SCACHE_INDEX_NAME, dir);
+        remove(indexPath);
+
+        mesh_FaceSlice empty = { .count = 0 };
+        for (int64_t i = 0; i < SCACHE_INDEX_WRITE_EVERY - 1; i++) {
+            scache_store(&c, 70 + i, &empty, NULL, &scratch);
+        }
+        FILE* before = fopen(indexPath, "rb");
+        bool correct = before == NULL;
+        scache_store(&c, 70 + SCACHE_INDEX_WRITE_EVERY, &empty, NULL, &scratch);
+        FILE* after = fopen(indexPath, "rb");
+        correct &= after != NULL && c.storesSinceIndexWrite == 0;
+        if (before) {
+            fclose(before);
+        }
+        if (after) {
+            fclose(after);
+        }
+        scache_deinit(&c);
+        snz_testPrint(correct, "solve cache only writes the index every so many stores");
+    }
+
+    snz_arenaDeinit(&arena);
+    snz_arenaDeinit(&scratch);
+}
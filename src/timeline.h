@@ -1,5 +1,10 @@
 #pragma once
 
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
 #include "geometry.h"
 #include "sketches2.h"
 #include "sketchTriangulation.h"
@@ -7,12 +12,17 @@
 #include "ui.h"
 #include "mesh.h"
 #include "csg2.h"
+#include "jobs.h"
+#include "ser.h"
+#include "solvecache.h"
 
 typedef enum {
     TL_OPK_NONE,
     TL_OPK_SKETCH,
     TL_OPK_BASE_GEOMETRY,
     TL_OPK_EXTRUDE,
+    TL_OPK_LINEAR_PATTERN,
+    TL_OPK_CIRCULAR_PATTERN,
 
     TL_OPK_COUNT,
 } tl_OpKind;
@@ -21,6 +31,8 @@ const char* tl_opKindNames[] = {
     [TL_OPK_SKETCH] = "sketch",
     [TL_OPK_BASE_GEOMETRY] = "geometry",
     [TL_OPK_EXTRUDE] = "extrude",
+    [TL_OPK_LINEAR_PATTERN] = "linear pattern",
+    [TL_OPK_CIRCULAR_PATTERN] = "circular pattern",
 };
 
 typedef enum {
@@ -47,6 +59,25 @@ bool tl_opArgKindExpectsDependency(tl_OpArgKind argKind) {
     return false;
 }
 
+typedef enum {
+    TL_OPEK_NONE,
+    TL_OPEK_MISSING_DEP, // an arg that should point at another op doesn't
+    TL_OPEK_CYCLE, // op is on a loop of dependencies
+    TL_OPEK_DEP_HAS_ERROR, // something this depends on has one of the above
+} tl_OpErrorKind;
+
+const char* tl_opErrorKindNames[] = {
+    [TL_OPEK_NONE] = "none",
+    [TL_OPEK_MISSING_DEP] = "missing dependency",
+    [TL_OPEK_CYCLE] = "circular dependency",
+    [TL_OPEK_DEP_HAS_ERROR] = "dependency has an error",
+};
+
+typedef struct {
+    tl_OpErrorKind kind;
+    int argIdx; // which arg the error came in thru
+} tl_OpError;
+
 typedef struct tl_Op tl_Op;
 typedef struct {
     tl_OpArgKind kind;
@@ -60,6 +91,8 @@ int tl_opArgKindsExpected[][TL_OP_ARG_MAX_COUNT] = {
     [TL_OPK_SKETCH] = { 0 },
     [TL_OPK_BASE_GEOMETRY] = { 0 },
     [TL_OPK_EXTRUDE] = {TL_OPAK_GEOID_FACE, TL_OPAK_NUMBER},
+    [TL_OPK_LINEAR_PATTERN] = {TL_OPAK_GEOID_FACE, TL_OPAK_NUMBER, TL_OPAK_NUMBER},
+    [TL_OPK_CIRCULAR_PATTERN] = {TL_OPAK_GEOID_EDGE, TL_OPAK_NUMBER, TL_OPAK_NUMBER},
 };
 
 // lookup from opKind -> arg names
@@ -67,17 +100,30 @@ const char* tl_opArgNames[][TL_OP_ARG_MAX_COUNT] = {
     [TL_OPK_SKETCH] = { 0 },
     [TL_OPK_BASE_GEOMETRY] = { 0 },
     [TL_OPK_EXTRUDE] = { "face", "distance" },
+    [TL_OPK_LINEAR_PATTERN] = { "direction", "count", "spacing" },
+    [TL_OPK_CIRCULAR_PATTERN] = { "axis", "count", "angle" },
 };
 
+// patterns repeat the whole result of whatever op their first arg points into. Linear ones step along the normal
+// of the face picked, circular ones turn around the line from the first to last point of the edge picked.
+// spacing is the distance between copies, angle is degrees between copies, count includes the original
+#define TL_PATTERN_MAX_COUNT 1000
+
 struct tl_Op {
     tl_Op* next;
     int64_t uniqueId; // incrementing number to safely identify tl nodes in geo refs (and break them when tl_ops are deleted)
     bool markedForDeletion;
+    uint64_t savedHash; // _tl_opSaveHash as of the last time a tl_Journal wrote this op out, zero if it never has
 
     struct {
         HMM_Vec2 pos;
         ui_SelectionState sel;
         snzu_Interaction inter;
+        bool built; // tl_build made a box for this last frame, inter is stale otherwise
+        int64_t gridQueryId; // see tl_NodeGrid
+        int64_t gridFirstEntry; // idx + 1 of the first of the entries filed for this + its dependency lines
+        int64_t gridFirstDependent; // idx + 1, see tl_NodeGrid.dependents
+        bool gridMoved; // in tl_NodeGrid.moved already
     } ui;
 
     tl_OpKind kind;
@@ -86,41 +132,268 @@ struct tl_Op {
         mesh_FaceSlice baseGeometry;
     } val;
     tl_OpArg args[TL_OP_ARG_MAX_COUNT];
+    tl_OpError error; // set by the scheduling pass, see _tl_opsSchedule
+
+    struct {
+        int64_t passId; // matches tl->nextSchedulePassId - 1 when the op is in the current pass
+        int64_t idx; // into the passes op list, then into the ordered list it returns once it's done
+        int64_t depIdxs[TL_OP_ARG_MAX_COUNT]; // into the ordered list, -1 for args without a dependency
+    } schedule; // temp vars for _tl_opsSchedule, the ordered list + these get copied as a set when solving async
 
     struct {
         const mesh_TempGeo* tempGeo;
         const mesh_FaceSlice* faces;
+        // pattern ops only, null otherwise. Where each copy of the source (first dep) went, faces is all of them merged.
+        // the scene draws the source once per transform instead of the merged faces, see _tl_solveThread
+        const HMM_Mat4Slice* instances;
+
+        // hash of this ops params + the hashes of everything it depends on, as of the last time it was solved
+        // zero if it never has been. Solving skips any op where this still matches.
+        uint64_t hash;
+        uint64_t cacheKey; // same idea as hash but the same across runs, see _tl_opCacheKey. Set with hash
+        // faces tris point into this when they came out of the disk cache, released along with arena
+        scache_Mapping cacheMapping;
+        int64_t timesSolved; // only counts actual recomputes, not skips
+        // owns faces + tempGeo, allocated on first solve and freed when the op gets culled. Growable, and only cleared
+        // when this op gets re-solved, so nothing else's results go with it. Nothing outside the timeline should
+        // keep pointers into it (duplicate geo ids out instead), in debug builds clearing stomps the old memory.
+        snz_Arena arena;
+
+        // from the last time this was actually recomputed, only filled in when the solve was asked to record them
+        struct {
+            bool valid;
+            double seconds;
+            int64_t faceCount;
+            int64_t triCount;
+            int64_t bytes; // of arena
+            bool fromCache; // only the load + temp geo are in seconds then
+        } stats;
     } solve;
 };
 
+// first block of each op solve arena, they grow from here
+#define TL_OP_SOLVE_ARENA_BLOCK_SIZE 1000000
+
 SNZ_SLICE_NAMED(tl_Op*, tl_OpPtrSlice);
 
+#define TL_SOLVE_INPUT_ARENA_SIZE 10000000
+#define TL_SOLVE_SCRATCH_SIZE 1000000000
+#define TL_SOLVE_SCENE_ARENA_SIZE 500000000
+#define TL_SPECULATE_DWELL_SECONDS 0.25f
+// goes into every disk cache key. Bump it when anything changes what an op solves to (csg, triangulation, extrudes,
+// patterns...) so results cached by older builds stop matching instead of getting loaded
+#define TL_SOLVE_VERSION 1
+
+// one background solve at a time, see tl_solveStart
+// liveOps are only touched by the main thread, the solve thread only ever sees the copies in jobOps,
+// which get written back to the live ones once the thread has been waited on
+typedef struct {
+    SDL_Thread* thread; // null when nothing is running
+    SDL_atomic_t cancel;
+    SDL_atomic_t done;
+
+    tl_OpPtrSlice liveOps; // deps first, target last
+    tl_OpPtrSlice jobOps; // parallel to liveOps
+    job_System* jobs; // copied from the timeline on start, null to solve everything on the solve thread itself
+    bool recordStats; // also copied from the timeline
+    scache_Cache* cache; // same
+    mesh_Scene scene; // only valid after done is set, and when not canceled
+
+    snz_Arena inputArena; // for job ops and copies of their inputs
+    snz_Arena scratch;
+    // double buffered, the front one is whatever the ui is currently drawing
+    snz_Arena sceneArenas[2];
+    int frontSceneIdx;
+
+    int64_t targetUid; // zero when solving everything
+    bool speculative; // started by tl_solveSpeculate, and no tl_solveStart has asked for it yet. Main thread only
+    bool lowPriority; // for the thread, set on start. The thread unsets it when it picks up a promotion
+    SDL_atomic_t promoted; // set by tl_solveStart on a running speculative solve, seen by the thread between ops
+    job_System* promotedJobs; // what jobs turns into once promoted, the timelines jobs even when pre-solves don't use them
+    bool sceneHeld; // a speculative solve finished, scene is built in the back arena and waiting on a tl_solveStart
+    bool sceneAdopted; // tl_solveStart took the held scene, the next poll swaps it in
+} tl_SolveJob;
+
+typedef struct {
+    int64_t uid; // zero for an empty slot, uids never are
+    tl_Op* op;
+} _tl_OpTableSlot;
+
+// open addressing w/ linear probing, uid -> op for every op in the timeline
+typedef struct {
+    _tl_OpTableSlot* slots;
+    int64_t capacity; // always a power of two
+    int64_t count;
+} _tl_OpTable;
+
+typedef struct {
+    int64_t x;
+    int64_t y;
+    tl_Op* op;
+    bool line; // filed for one of ops dependency lines passing thru, not for the node itself
+    int64_t prevInCell; // idx + 1, all of these
+    int64_t nextInCell;
+    int64_t nextOfOp; // rest of what's filed for op, or the next free entry
+} _tl_NodeGridEntry;
+
+typedef struct {
+    bool occupied;
+    int64_t x;
+    int64_t y;
+    int64_t firstEntry; // idx + 1, zero once everything in it has been taken out
+} _tl_NodeGridCell;
+
+typedef struct {
+    tl_Op* op; // has a dependency line ending at the op this is listed on
+    int64_t next; // idx + 1
+} _tl_NodeGridDependent;
+
+// world space, nodes are ~150 across so a cell fits a few
+#define TL_NODE_GRID_CELL_SIZE 512.0f
+// nodes are filed by just their center, so anything looking for nodes touching a rect grows it by this first.
+// has to be at least the biggest a node radius gets, see _tl_radiusOfNode
+#define TL_NODE_GRID_MARGIN 100.0f
+// FIXME: lines longer than this only get filed along the first part of them
+#define TL_NODE_GRID_MAX_LINE_STEPS 100000
+
+// uniform grid over where op nodes + their dependency lines are, so the ui only has to build what's on screen.
+// Updated in place, same as the sketch grid (see _sku_Grid): each op keeps the list of entries filed for it, and ops
+// passed to tl_nodeGridOpMoved get taken out + put back on the next update, along with the lines of ops that depend
+// on them. Ops coming, going, or changing deps rebuild it whole, see tl_nodeGridMarkStale.
+typedef struct {
+    _tl_NodeGridEntry* entries;
+    int64_t entryCount; // live ones, not counting the free list
+    int64_t entryCapacity;
+    int64_t entryEnd; // entries past this have never been used
+    int64_t firstFreeEntry; // idx + 1
+    _tl_NodeGridCell* cells; // open addressing w/ linear probing, cell -> its list of entries
+    int64_t cellCapacity; // always a power of two
+    int64_t cellCount;
+    _tl_NodeGridDependent* dependents; // lists of these start at op->ui.gridFirstDependent, as of the last rebuild
+    int64_t dependentCount;
+    int64_t dependentCapacity;
+    tl_Op** moved; // since the last update
+    int64_t movedCount;
+    int64_t movedCapacity;
+    bool stale; // rebuilt whole on the next update
+    int64_t queryId; // stamped onto ops found by a query, so ones filed in a bunch of cells come out once
+    HMM_Vec2 mousePos; // world space, as of the last tl_build. For tl_timelineHoveredOp
+} tl_NodeGrid;
+
 typedef struct {
     tl_Op* firstOp;
+    _tl_OpTable opTable; // kept in sync with the op list, see _tl_timelinePushOp and tl_timelineCullOpsMarkedForDelete
     tl_Op* activeOp;
     int64_t nextUniqueId; // used to safely id nodes even if the address is reused
+    int64_t nextSchedulePassId;
     HMM_Vec2 camPos;
     float camHeight;
     snz_Arena* operationArena;
+    tl_NodeGrid nodeGrid;
 
-    snz_Arena* generatedArena;
-    PoolAlloc* generatedPool;
+    tl_SolveJob solveJob;
+    job_System* jobs; // optional, independent ops get solved at the same time on this when set. Not owned.
+    scache_Cache* solveCache; // optional, csg op results get kept here between runs. Not owned.
+    bool recordSolveStats; // see op->solve.stats, off means no timing/counting at all
+
+    // pre-solving whatever's hovered, see tl_solveSpeculate
+    struct {
+        bool enabled;
+        bool useJobs; // off keeps pre-solves to their one low priority thread and leaves t->jobs alone
+        float dwellSeconds; // how long an op has to be hovered before it gets pre-solved
+        int64_t hoveredUid;
+        float hoveredTime;
+        bool started; // only one pre-solve per hover
+    } speculate;
 
     tl_OpArg takenArgSignal; // set by scs to take geo, unset by handling code in argbar
 } tl_Timeline;
 
-tl_Timeline tl_timelineInit(snz_Arena* opArena, snz_Arena* generatedArena, PoolAlloc* generatedPool) {
+tl_Timeline tl_timelineInit(snz_Arena* opArena) {
     tl_Timeline out = {
         .operationArena = opArena,
-        .generatedArena = generatedArena,
-        .generatedPool = generatedPool,
         .camHeight = 1000,
         .camPos = HMM_V2(0, 0),
         .nextUniqueId = 1,
+        .nextSchedulePassId = 1,
+        .speculate.dwellSeconds = TL_SPECULATE_DWELL_SECONDS,
     };
     return out;
 }
 
+static int64_t _tl_opTableFirstSlot(const _tl_OpTable* table, int64_t uid) {
+    uint64_t hash = snz_hashMix64((uint64_t)uid);
+    return (int64_t)(hash & (uint64_t)(table->capacity - 1));
+}
+
+static void _tl_opTableInsertSlot(_tl_OpTable* table, _tl_OpTableSlot slot);
+
+// 70% max load
+static void _tl_opTableGrowIfNeeded(_tl_OpTable* table) {
+    if ((table->count + 1) * 10 <= table->capacity * 7) {
+        return;
+    }
+
+    _tl_OpTable old = *table;
+    table->capacity = old.capacity ? old.capacity * 2 : 64;
+    table->count = 0;
+    table->slots = calloc(table->capacity, sizeof(*table->slots));
+    SNZ_ASSERTF(table->slots != NULL, "op table alloc failed, capacity: %" PRId64, table->capacity);
+    for (int64_t i = 0; i < old.capacity; i++) {
+        if (old.slots[i].uid) {
+            _tl_opTableInsertSlot(table, old.slots[i]);
+        }
+    }
+    free(old.slots);
+}
+
+// growing goes by the uids in slots, never thru the ops, so tables that only care about uids can leave op null
+static void _tl_opTableInsertSlot(_tl_OpTable* table, _tl_OpTableSlot slot) {
+    SNZ_ASSERT(slot.uid != 0, "op table insert with a zero uid.");
+    _tl_opTableGrowIfNeeded(table);
+
+    int64_t i = _tl_opTableFirstSlot(table, slot.uid);
+    while (table->slots[i].uid) {
+        SNZ_ASSERTF(table->slots[i].uid != slot.uid, "duplicate uid in op table: %" PRId64, slot.uid);
+        i = (i + 1) & (table->capacity - 1);
+    }
+    table->slots[i] = slot;
+    table->count++;
+}
+
+static void _tl_opTableInsert(_tl_OpTable* table, tl_Op* op) {
+    _tl_opTableInsertSlot(table, (_tl_OpTableSlot){ .uid = op->uniqueId, .op = op });
+}
+
+static int64_t _tl_opTableFind(const _tl_OpTable* table, int64_t uid) {
+    if (uid == 0 || table->count == 0) {
+        return -1;
+    }
+    for (int64_t i = _tl_opTableFirstSlot(table, uid); table->slots[i].uid; i = (i + 1) & (table->capacity - 1)) {
+        if (table->slots[i].uid == uid) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// backward shift delete, so no tombstones pile up
+static void _tl_opTableRemove(_tl_OpTable* table, int64_t uid) {
+    int64_t hole = _tl_opTableFind(table, uid);
+    SNZ_ASSERTF(hole >= 0, "removing uid %" PRId64 " that isn't in the op table.", uid);
+    int64_t mask = table->capacity - 1;
+    for (int64_t i = (hole + 1) & mask; table->slots[i].uid; i = (i + 1) & mask) {
+        int64_t home = _tl_opTableFirstSlot(table, table->slots[i].uid);
+        // only move back when the hole is between where this wants to be and where it is (wrapping)
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            table->slots[hole] = table->slots[i];
+            hole = i;
+        }
+    }
+    table->slots[hole] = (_tl_OpTableSlot){ 0 };
+    table->count--;
+}
+
 // pushes to list for the TL, sets a good uniqueID, and inits scene to a default
 static tl_Op* _tl_timelinePushOp(tl_Timeline* tl) {
     tl_Op* out = SNZ_ARENA_PUSH(tl->operationArena, tl_Op);
@@ -130,21 +403,37 @@ static tl_Op* _tl_timelinePushOp(tl_Timeline* tl) {
     };
     tl->firstOp = out;
     tl->nextUniqueId++;
+    _tl_opTableInsert(&tl->opTable, out);
+    tl->nodeGrid.stale = true;
     return out;
 }
 
-// FIXME: make it a hash lookup
-tl_Op* tl_timelineGetOpByUID(tl_Timeline* tl, int64_t uid) {
-    if (uid == 0) { // temporary, for perf
-        return NULL;
+// puts op in the list where its uid goes, for ops that come back with a uid they already had (loading, undo).
+// doesn't touch the uid table
+static void _tl_timelineLinkOp(tl_Timeline* tl, tl_Op* op) {
+    tl_Op** nextPtr = &tl->firstOp;
+    while (*nextPtr && (*nextPtr)->uniqueId > op->uniqueId) {
+        nextPtr = &(*nextPtr)->next;
     }
+    op->next = *nextPtr;
+    *nextPtr = op;
+    tl->nodeGrid.stale = true;
+}
+
+tl_Op* tl_timelineGetOpByUID(tl_Timeline* tl, int64_t uid) {
+    int64_t slot = _tl_opTableFind(&tl->opTable, uid);
+    return slot >= 0 ? tl->opTable.slots[slot].op : NULL;
+}
 
+// throws out the uid table and rebuilds it from the op list,
+// for anything that replaces/loads ops without going thru _tl_timelinePushOp
+void tl_timelineRebuildOpTable(tl_Timeline* tl) {
+    free(tl->opTable.slots);
+    tl->opTable = (_tl_OpTable){ 0 };
     for (tl_Op* op = tl->firstOp; op; op = op->next) {
-        if (op->uniqueId == uid) {
-            return op;
-        }
+        _tl_opTableInsert(&tl->opTable, op);
     }
-    return NULL;
+    tl->nodeGrid.stale = true;
 }
 
 tl_Op* tl_timelinePushSketch(tl_Timeline* tl, HMM_Vec2 pos, sk_Sketch sketch) {
@@ -182,13 +471,22 @@ tl_Op* tl_timelinePushExtrude(tl_Timeline* tl, HMM_Vec2 pos) {
     return out;
 }
 
+// kind should be TL_OPK_LINEAR_PATTERN or TL_OPK_CIRCULAR_PATTERN, args are left for the caller
+tl_Op* tl_timelinePushPattern(tl_Timeline* tl, HMM_Vec2 pos, tl_OpKind kind) {
+    SNZ_ASSERTF(kind == TL_OPK_LINEAR_PATTERN || kind == TL_OPK_CIRCULAR_PATTERN, "not a pattern kind: %d", kind);
+    tl_Op* out = _tl_timelinePushOp(tl);
+    out->ui.pos = pos;
+    out->kind = kind;
+    return out;
+}
+
 void tl_timelineDeselectAll(tl_Timeline* tl) {
     for (tl_Op* op = tl->firstOp; op; op = op->next) {
         op->ui.sel.selected = false;
     }
 }
 
-static bool tl_timelineAnySelected(tl_Timeline* tl) {
+bool tl_timelineAnySelected(tl_Timeline* tl) {
     for (tl_Op* o = tl->firstOp; o; o = o->next) {
         if (o->ui.sel.selected) {
             return true;
@@ -197,7 +495,20 @@ static bool tl_timelineAnySelected(tl_Timeline* tl) {
     return false;
 }
 
+void tl_solveCancel(tl_Timeline* t);
+static void _tl_nodeGridClear(tl_NodeGrid* g);
+
 void tl_timelineCullOpsMarkedForDelete(tl_Timeline* t) {
+    bool anyMarked = false;
+    for (tl_Op* op = t->firstOp; op; op = op->next) {
+        anyMarked |= op->markedForDeletion;
+    }
+    if (!anyMarked) {
+        return;
+    }
+    // the solve thread could be holding any of these, has to stop before they get freed
+    tl_solveCancel(t);
+
     // cull dependencies to deleted ops
     for (tl_Op* op = t->firstOp; op; op = op->next) {
         if (t->activeOp == op && op->markedForDeletion) {
@@ -216,6 +527,9 @@ void tl_timelineCullOpsMarkedForDelete(tl_Timeline* t) {
         }
     }
 
+    // entries point at ops that are about to get zeroed, empty until tl_build rebuilds it
+    _tl_nodeGridClear(&t->nodeGrid);
+
     // cull elts marked for delete
     tl_Op* next = NULL;
     tl_Op** lastNextPtr = &t->firstOp;
@@ -223,6 +537,11 @@ void tl_timelineCullOpsMarkedForDelete(tl_Timeline* t) {
         next = op->next;
         if (op->markedForDeletion) {
             *lastNextPtr = op->next;
+            _tl_opTableRemove(&t->opTable, op->uniqueId);
+            if (op->solve.arena.start) {
+                snz_arenaDeinit(&op->solve.arena);
+            }
+            scache_mappingRelease(&op->solve.cacheMapping);
             memset(op, 0, sizeof(*op));
             continue;
         }
@@ -231,163 +550,3134 @@ void tl_timelineCullOpsMarkedForDelete(tl_Timeline* t) {
     // FIXME: free list
 }
 
-// FIXME: bubbles & remove target op plz
-mesh_Scene tl_solveForNode(tl_Timeline* t, tl_Op* targetOp, snz_Arena* scratch) {
-    SNZ_ASSERT(targetOp, "Solve for node requires a node.");
+static uint64_t _tl_hashBytes(uint64_t hash, const void* data, int64_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (int64_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
 
-    SNZ_ARENA_ARR_BEGIN(scratch, tl_Op*);
-    *SNZ_ARENA_PUSH(scratch, tl_Op*) = targetOp;
-    while (true) { // FIXME: cutoff
-        bool anyAdded = false;
-        tl_OpPtrSlice added = (tl_OpPtrSlice){
-            .count = scratch->arrModeElemCount,
-            .elems = (tl_Op**)(scratch->end) - scratch->arrModeElemCount,
-        };
+// val has to be an lvalue, and hashing whole structs will pick up padding, so do it field by field
+#define _TL_HASH_VAL(hash, val) _tl_hashBytes((hash), &(val), sizeof(val))
 
-        for (int opIdx = 0; opIdx < added.count; opIdx++) {
-            tl_Op* op = added.elems[opIdx];
-            for (int argIdx = 0; argIdx < TL_OP_ARG_MAX_COUNT; argIdx++) {
-                tl_Op* new = tl_timelineGetOpByUID(t, op->args[argIdx].geoId.opUniqueId);
-                if (!new) {
-                    tl_OpArgKind kind = tl_opArgKindsExpected[op->kind][argIdx];
-                    if (tl_opArgKindExpectsDependency(kind)) {
-                        SNZ_ASSERT(false, "tried to solve with a missing dep.");
-                    }
-                    continue;
-                }
-                bool inAdded = false;
-                for (int k = 0; k < added.count; k++) {
-                    if (added.elems[k] == new) {
-                        inAdded = true;
-                    }
+static int64_t _tl_nodeGridCoord(float v) {
+    return (int64_t)floorf(v / TL_NODE_GRID_CELL_SIZE);
+}
+
+static int64_t _tl_nodeGridFirstSlot(const tl_NodeGrid* g, int64_t x, int64_t y) {
+    uint64_t hash = 14695981039346656037ULL;
+    hash = _TL_HASH_VAL(hash, x);
+    hash = _TL_HASH_VAL(hash, y);
+    hash = snz_hashMix64(hash);
+    return (int64_t)(hash & (uint64_t)(g->cellCapacity - 1));
+}
+
+static _tl_NodeGridCell* _tl_nodeGridFindCell(const tl_NodeGrid* g, int64_t x, int64_t y) {
+    if (g->cellCount == 0) {
+        return NULL;
+    }
+    for (int64_t i = _tl_nodeGridFirstSlot(g, x, y); g->cells[i].occupied; i = (i + 1) & (g->cellCapacity - 1)) {
+        if (g->cells[i].x == x && g->cells[i].y == y) {
+            return &g->cells[i];
+        }
+    }
+    return NULL;
+}
+
+// refiles every cell with anything left in it into a table of capacity, dropping the ones that emptied out
+static void _tl_nodeGridRehash(tl_NodeGrid* g, int64_t capacity) {
+    _tl_NodeGridCell* old = g->cells;
+    int64_t oldCapacity = g->cellCapacity;
+    g->cells = calloc(capacity, sizeof(*g->cells));
+    SNZ_ASSERTF(g->cells != NULL, "node grid alloc failed, capacity: %" PRId64, capacity);
+    g->cellCapacity = capacity;
+    g->cellCount = 0;
+    for (int64_t i = 0; i < oldCapacity; i++) {
+        if (!old[i].occupied || !old[i].firstEntry) {
+            continue;
+        }
+        int64_t slot = _tl_nodeGridFirstSlot(g, old[i].x, old[i].y);
+        while (g->cells[slot].occupied) {
+            slot = (slot + 1) & (g->cellCapacity - 1);
+        }
+        g->cells[slot] = old[i];
+        g->cellCount++;
+    }
+    free(old);
+}
+
+// finds or makes the cell, keeping the table half full at most
+static _tl_NodeGridCell* _tl_nodeGridCellAt(tl_NodeGrid* g, int64_t x, int64_t y) {
+    _tl_NodeGridCell* cell = _tl_nodeGridFindCell(g, x, y);
+    if (cell) {
+        return cell;
+    }
+    if ((g->cellCount + 1) * 2 > g->cellCapacity) {
+        int64_t capacity = g->cellCapacity ? g->cellCapacity : 64;
+        while ((g->cellCount + 1) * 2 > capacity) {
+            capacity *= 2;
+        }
+        _tl_nodeGridRehash(g, capacity);
+    }
+    int64_t i = _tl_nodeGridFirstSlot(g, x, y);
+    while (g->cells[i].occupied) {
+        i = (i + 1) & (g->cellCapacity - 1);
+    }
+    g->cells[i] = (_tl_NodeGridCell){ .occupied = true, .x = x, .y = y };
+    g->cellCount++;
+    return &g->cells[i];
+}
+
+static void _tl_nodeGridClear(tl_NodeGrid* g) {
+    g->entryCount = 0;
+    g->entryEnd = 0;
+    g->firstFreeEntry = 0;
+    g->cellCount = 0;
+    g->dependentCount = 0;
+    g->movedCount = 0;
+    g->stale = true;
+    if (g->cells) {
+        memset(g->cells, 0, sizeof(*g->cells) * g->cellCapacity);
+    }
+}
+
+// anything that adds/removes ops or changes their deps calls this, the next update files everything over again
+void tl_nodeGridMarkStale(tl_Timeline* t) {
+    t->nodeGrid.stale = true;
+}
+
+static void _tl_nodeGridPushMoved(tl_NodeGrid* g, tl_Op* op) {
+    if (g->movedCount >= g->movedCapacity) {
+        g->movedCapacity = g->movedCapacity ? g->movedCapacity * 2 : 64;
+        g->moved = realloc(g->moved, sizeof(*g->moved) * g->movedCapacity);
+        SNZ_ASSERTF(g->moved != NULL, "node grid alloc failed, capacity: %" PRId64, g->movedCapacity);
+    }
+    g->moved[g->movedCount] = op;
+    g->movedCount++;
+}
+
+// for anything that changes op->ui.pos after the op has been filed. The next update takes out + puts back just the
+// ops passed here and the lines coming into them, instead of the whole grid
+void tl_nodeGridOpMoved(tl_Timeline* t, tl_Op* op) {
+    tl_NodeGrid* g = &t->nodeGrid;
+    if (g->stale || op->ui.gridMoved) {
+        return;
+    }
+    op->ui.gridMoved = true;
+    _tl_nodeGridPushMoved(g, op);
+}
+
+// returns idx + 1 of the new entry, which goes on the front of the list starting at firstOfOp
+static int64_t _tl_nodeGridPushEntry(tl_NodeGrid* g, tl_Op* op, int64_t x, int64_t y, bool line, int64_t firstOfOp) {
+    int64_t idx = 0;
+    if (g->firstFreeEntry) {
+        idx = g->firstFreeEntry - 1;
+        g->firstFreeEntry = g->entries[idx].nextOfOp;
+    } else {
+        if (g->entryEnd >= g->entryCapacity) {
+            g->entryCapacity = g->entryCapacity ? g->entryCapacity * 2 : 256;
+            g->entries = realloc(g->entries, sizeof(*g->entries) * g->entryCapacity);
+            SNZ_ASSERTF(g->entries != NULL, "node grid alloc failed, capacity: %" PRId64, g->entryCapacity);
+        }
+        idx = g->entryEnd;
+        g->entryEnd++;
+    }
+    g->entryCount++;
+
+    _tl_NodeGridCell* cell = _tl_nodeGridCellAt(g, x, y);
+    g->entries[idx] = (_tl_NodeGridEntry){
+        .x = x,
+        .y = y,
+        .op = op,
+        .line = line,
+        .nextInCell = cell->firstEntry,
+        .nextOfOp = firstOfOp,
+    };
+    if (cell->firstEntry) {
+        g->entries[cell->firstEntry - 1].prevInCell = idx + 1;
+    }
+    cell->firstEntry = idx + 1;
+    return idx + 1;
+}
+
+// files op in every cell the line from a to b crosses. Steps are half a cell so each one moves at most one cell
+// over on each axis, and diagonal moves file both cells around the corner cause the line could've cut thru either.
+// Returns the new start of ops entry list
+static int64_t _tl_nodeGridFileLine(tl_NodeGrid* g, tl_Op* op, HMM_Vec2 a, HMM_Vec2 b, int64_t firstOfOp) {
+    int64_t steps = (int64_t)ceilf(HMM_Len(HMM_Sub(b, a)) / (TL_NODE_GRID_CELL_SIZE / 2));
+    steps = SNZ_MIN(steps, TL_NODE_GRID_MAX_LINE_STEPS);
+    int64_t prevX = _tl_nodeGridCoord(a.X);
+    int64_t prevY = _tl_nodeGridCoord(a.Y);
+    firstOfOp = _tl_nodeGridPushEntry(g, op, prevX, prevY, true, firstOfOp);
+    for (int64_t i = 1; i <= steps; i++) {
+        HMM_Vec2 pt = HMM_Lerp(a, (float)i / steps, b);
+        int64_t x = _tl_nodeGridCoord(pt.X);
+        int64_t y = _tl_nodeGridCoord(pt.Y);
+        if (x == prevX && y == prevY) {
+            continue;
+        } else if (x != prevX && y != prevY) {
+            firstOfOp = _tl_nodeGridPushEntry(g, op, prevX, y, true, firstOfOp);
+            firstOfOp = _tl_nodeGridPushEntry(g, op, x, prevY, true, firstOfOp);
+        }
+        firstOfOp = _tl_nodeGridPushEntry(g, op, x, y, true, firstOfOp);
+        prevX = x;
+        prevY = y;
+    }
+    return firstOfOp;
+}
+
+// op has to have nothing filed for it already
+static void _tl_nodeGridFileOp(tl_Timeline* t, tl_Op* op) {
+    tl_NodeGrid* g = &t->nodeGrid;
+    int64_t first = _tl_nodeGridPushEntry(g, op, _tl_nodeGridCoord(op->ui.pos.X), _tl_nodeGridCoord(op->ui.pos.Y), false, 0);
+    for (int i = 0; i < TL_OP_ARG_MAX_COUNT; i++) {
+        if (!tl_opArgKindExpectsDependency(op->args[i].kind)) {
+            continue;
+        }
+        tl_Op* dependency = tl_timelineGetOpByUID(t, op->args[i].geoId.opUniqueId);
+        if (dependency) {
+            first = _tl_nodeGridFileLine(g, op, op->ui.pos, dependency->ui.pos, first);
+        }
+    }
+    op->ui.gridFirstEntry = first;
+}
+
+// takes out the node + lines filed for op and puts their entries on the free list. Nothing happens if there aren't any
+static void _tl_nodeGridUnfileOp(tl_NodeGrid* g, tl_Op* op) {
+    int64_t next = 0;
+    for (int64_t idx = op->ui.gridFirstEntry; idx; idx = next) {
+        _tl_NodeGridEntry* entry = &g->entries[idx - 1];
+        next = entry->nextOfOp;
+        if (entry->prevInCell) {
+            g->entries[entry->prevInCell - 1].nextInCell = entry->nextInCell;
+        } else {
+            _tl_NodeGridCell* cell = _tl_nodeGridFindCell(g, entry->x, entry->y);
+            SNZ_ASSERT(cell && cell->firstEntry == idx, "node grid entry wasn't in its cell");
+            cell->firstEntry = entry->nextInCell;
+        }
+        if (entry->nextInCell) {
+            g->entries[entry->nextInCell - 1].prevInCell = entry->prevInCell;
+        }
+        *entry = (_tl_NodeGridEntry){ .nextOfOp = g->firstFreeEntry };
+        g->firstFreeEntry = idx;
+        g->entryCount--;
+    }
+    op->ui.gridFirstEntry = 0;
+}
+
+static void _tl_nodeGridRebuild(tl_Timeline* t) {
+    tl_NodeGrid* g = &t->nodeGrid;
+    _tl_nodeGridClear(g);
+    g->stale = false;
+    for (tl_Op* op = t->firstOp; op; op = op->next) {
+        op->ui.gridFirstEntry = 0;
+        op->ui.gridFirstDependent = 0;
+        op->ui.gridMoved = false;
+    }
+
+    for (tl_Op* op = t->firstOp; op; op = op->next) {
+        _tl_nodeGridFileOp(t, op);
+        for (int i = 0; i < TL_OP_ARG_MAX_COUNT; i++) {
+            if (!tl_opArgKindExpectsDependency(op->args[i].kind)) {
+                continue;
+            }
+            tl_Op* dependency = tl_timelineGetOpByUID(t, op->args[i].geoId.opUniqueId);
+            if (!dependency) {
+                continue;
+            }
+            if (g->dependentCount >= g->dependentCapacity) {
+                g->dependentCapacity = g->dependentCapacity ? g->dependentCapacity * 2 : 256;
+                g->dependents = realloc(g->dependents, sizeof(*g->dependents) * g->dependentCapacity);
+                SNZ_ASSERTF(g->dependents != NULL, "node grid alloc failed, capacity: %" PRId64, g->dependentCapacity);
+            }
+            g->dependents[g->dependentCount] = (_tl_NodeGridDependent){
+                .op = op,
+                .next = dependency->ui.gridFirstDependent,
+            };
+            g->dependentCount++;
+            dependency->ui.gridFirstDependent = g->dependentCount;
+        }
+    }
+}
+
+// files everything over again if the grid was marked stale, otherwise refiles just the ops that moved since the last
+// update + the ops w/ lines going into them. Nothing moved costs nothing.
+void tl_nodeGridUpdate(tl_Timeline* t) {
+    tl_NodeGrid* g = &t->nodeGrid;
+    if (g->stale) {
+        _tl_nodeGridRebuild(t);
+        return;
+    }
+
+    // lines from dependents end at the moved op, so they have to go too. Gets pushed onto the end of the same list,
+    // dependents that are already on it come out twice but have nothing filed the second time
+    int64_t movedCount = g->movedCount;
+    for (int64_t i = 0; i < movedCount; i++) {
+        for (int64_t d = g->moved[i]->ui.gridFirstDependent; d; d = g->dependents[d - 1].next) {
+            _tl_nodeGridPushMoved(g, g->dependents[d - 1].op);
+        }
+    }
+    for (int64_t i = 0; i < g->movedCount; i++) {
+        _tl_nodeGridUnfileOp(g, g->moved[i]);
+    }
+    for (int64_t i = 0; i < g->movedCount; i++) {
+        tl_Op* op = g->moved[i];
+        op->ui.gridMoved = false;
+        if (!op->ui.gridFirstEntry) {
+            _tl_nodeGridFileOp(t, op);
+        }
+    }
+    g->movedCount = 0;
+}
+
+static void _tl_nodeGridQueryCell(tl_NodeGrid* g, const _tl_NodeGridCell* cell, snz_Arena* arena) {
+    for (int64_t i = cell->firstEntry; i; i = g->entries[i - 1].nextInCell) {
+        tl_Op* op = g->entries[i - 1].op;
+        if (op->ui.gridQueryId != g->queryId) {
+            op->ui.gridQueryId = g->queryId;
+            *SNZ_ARENA_PUSH(arena, tl_Op*) = op;
+        }
+    }
+}
+
+static int _tl_opNewestFirstCompare(const void* a, const void* b) {
+    int64_t uidA = (*(tl_Op* const*)a)->uniqueId;
+    int64_t uidB = (*(tl_Op* const*)b)->uniqueId;
+    return uidA > uidB ? -1 : (uidA < uidB ? 1 : 0);
+}
+
+// every op with its node or one of its dependency lines in the world space rect, once each and in the same order as
+// the op list. Ops that only have a line in it come out too, so check. As of the last tl_nodeGridUpdate.
+tl_OpPtrSlice tl_nodeGridQuery(tl_Timeline* t, HMM_Vec2 min, HMM_Vec2 max, snz_Arena* arena) {
+    tl_NodeGrid* g = &t->nodeGrid;
+    g->queryId++;
+    int64_t minX = _tl_nodeGridCoord(min.X - TL_NODE_GRID_MARGIN);
+    int64_t minY = _tl_nodeGridCoord(min.Y - TL_NODE_GRID_MARGIN);
+    int64_t maxX = _tl_nodeGridCoord(max.X + TL_NODE_GRID_MARGIN);
+    int64_t maxY = _tl_nodeGridCoord(max.Y + TL_NODE_GRID_MARGIN);
+
+    SNZ_ARENA_ARR_BEGIN(arena, tl_Op*);
+    double rangeCellCount = (double)(maxX - minX + 1) * (double)(maxY - minY + 1);
+    if (rangeCellCount > g->cellCount) {
+        // zoomed way out, going thru the cells that have anything in them is less
+        for (int64_t i = 0; i < g->cellCapacity; i++) {
+            const _tl_NodeGridCell* cell = &g->cells[i];
+            if (cell->occupied && cell->x >= minX && cell->x <= maxX && cell->y >= minY && cell->y <= maxY) {
+                _tl_nodeGridQueryCell(g, cell, arena);
+            }
+        }
+    } else {
+        for (int64_t x = minX; x <= maxX; x++) {
+            for (int64_t y = minY; y <= maxY; y++) {
+                const _tl_NodeGridCell* cell = _tl_nodeGridFindCell(g, x, y);
+                if (cell) {
+                    _tl_nodeGridQueryCell(g, cell, arena);
                 }
-                if (inAdded) {
-                    continue;
+            }
+        }
+    }
+    tl_OpPtrSlice out = SNZ_ARENA_ARR_END_NAMED(arena, tl_Op*, tl_OpPtrSlice);
+    qsort(out.elems, out.count, sizeof(*out.elems), _tl_opNewestFirstCompare);
+    return out;
+}
+
+// null if the mouse isn't over any, as of the last ui frame. Only looks thru the nodes filed near the mouse
+tl_Op* tl_timelineHoveredOp(tl_Timeline* tl) {
+    const tl_NodeGrid* g = &tl->nodeGrid;
+    HMM_Vec2 pos = g->mousePos;
+    for (int64_t x = _tl_nodeGridCoord(pos.X - TL_NODE_GRID_MARGIN); x <= _tl_nodeGridCoord(pos.X + TL_NODE_GRID_MARGIN); x++) {
+        for (int64_t y = _tl_nodeGridCoord(pos.Y - TL_NODE_GRID_MARGIN); y <= _tl_nodeGridCoord(pos.Y + TL_NODE_GRID_MARGIN); y++) {
+            const _tl_NodeGridCell* cell = _tl_nodeGridFindCell(g, x, y);
+            for (int64_t i = cell ? cell->firstEntry : 0; i; i = g->entries[i - 1].nextInCell) {
+                const _tl_NodeGridEntry* entry = &g->entries[i - 1];
+                if (!entry->line && entry->op->ui.inter.hovered) {
+                    return entry->op;
                 }
-                *SNZ_ARENA_PUSH(scratch, tl_Op*) = new;
-                anyAdded = true;
             }
         }
+    }
+    return NULL;
+}
 
-        if (!anyAdded) {
-            break;
+static uint64_t _tl_hashGeoId(uint64_t hash, const mesh_GeoID* id) {
+    hash = _TL_HASH_VAL(hash, id->geoKind);
+    hash = _TL_HASH_VAL(hash, id->opUniqueId);
+    hash = _TL_HASH_VAL(hash, id->baseNodeId);
+    const mesh_GeoID* diffs[2] = { id->diffGeo1, id->diffGeo2 };
+    for (int i = 0; i < 2; i++) {
+        bool present = diffs[i] != NULL;
+        hash = _TL_HASH_VAL(hash, present);
+        if (present) {
+            hash = _tl_hashGeoId(hash, diffs[i]);
+        }
+    }
+    return hash;
+}
+
+static uint64_t _tl_hashSketch(uint64_t hash, const sk_Sketch* sketch) {
+    for (sk_Point* p = sk_sketchFirstPoint(sketch); p; p = sk_sketchNextPoint(sketch, p)) {
+        hash = _TL_HASH_VAL(hash, p->uniqueId);
+        hash = _TL_HASH_VAL(hash, p->pos.X);
+        hash = _TL_HASH_VAL(hash, p->pos.Y);
+    }
+    for (sk_Line* l = sk_sketchFirstLine(sketch); l; l = sk_sketchNextLine(sketch, l)) {
+        hash = _TL_HASH_VAL(hash, l->uniqueId);
+        hash = _TL_HASH_VAL(hash, l->p1->uniqueId);
+        hash = _TL_HASH_VAL(hash, l->p2->uniqueId);
+    }
+    for (sk_Constraint* c = sk_sketchFirstConstraint(sketch); c; c = sk_sketchNextConstraint(sketch, c)) {
+        int64_t lineIds[2] = { c->line1 ? c->line1->uniqueId : 0, c->line2 ? c->line2->uniqueId : 0 };
+        hash = _TL_HASH_VAL(hash, c->uniqueId);
+        hash = _TL_HASH_VAL(hash, c->kind);
+        hash = _TL_HASH_VAL(hash, c->value);
+        hash = _TL_HASH_VAL(hash, lineIds);
+        hash = _TL_HASH_VAL(hash, c->flipLine1);
+        hash = _TL_HASH_VAL(hash, c->flipLine2);
+    }
+    hash = _TL_HASH_VAL(hash, sketch->originAngle);
+    return hash;
+}
+
+// dependency of op thru arg argIdx, ops has to be the ordered list from the _tl_opsSchedule call that op was in
+static tl_Op* _tl_opsDep(tl_OpPtrSlice ops, const tl_Op* op, int argIdx) {
+    int64_t idx = op->schedule.depIdxs[argIdx];
+    if (idx < 0) {
+        return NULL;
+    }
+    SNZ_ASSERTF(idx < ops.count, "op dep idx out of bounds: %" PRId64, idx);
+    return ops.elems[idx];
+}
+
+// everything about op itself that goes into solving it, not including anything from deps
+static uint64_t _tl_hashOpInputs(uint64_t hash, const tl_Op* op) {
+    hash = _TL_HASH_VAL(hash, op->kind);
+    for (int i = 0; i < TL_OP_ARG_MAX_COUNT; i++) {
+        const tl_OpArg* arg = &op->args[i];
+        hash = _TL_HASH_VAL(hash, arg->kind);
+        hash = _TL_HASH_VAL(hash, arg->number);
+        hash = _tl_hashGeoId(hash, &arg->geoId);
+    }
+
+    if (op->kind == TL_OPK_SKETCH) {
+        hash = _tl_hashSketch(hash, &op->val.sketch);
+    } else if (op->kind == TL_OPK_BASE_GEOMETRY) {
+        // base geo never gets edited after being pushed, so identity is enough
+        hash = _TL_HASH_VAL(hash, op->val.baseGeometry.elems);
+        hash = _TL_HASH_VAL(hash, op->val.baseGeometry.count);
+    }
+    return hash;
+}
+
+// zero is reserved for never solved/saved, so it never comes out of here
+static uint64_t _tl_hashFinish(uint64_t hash) {
+    hash = snz_hashMix64(hash);
+    if (hash == 0) {
+        hash = 1;
+    }
+    return hash;
+}
+
+// everything that goes into solving op, including the solve hashes of its deps, so those need to be up to date first
+// ops has to contain all of ops dependencies
+static uint64_t _tl_opHash(tl_OpPtrSlice ops, const tl_Op* op) {
+    uint64_t hash = _tl_hashOpInputs(14695981039346656037ULL, op);
+    for (int i = 0; i < TL_OP_ARG_MAX_COUNT; i++) {
+        tl_Op* dep = _tl_opsDep(ops, op, i);
+        if (dep) {
+            hash = _TL_HASH_VAL(hash, dep->solve.hash);
         }
     }
-    tl_OpPtrSlice dependencies = SNZ_ARENA_ARR_END_NAMED(scratch, tl_Op*, tl_OpPtrSlice);
+    return _tl_hashFinish(hash);
+}
 
-    { // reset per solve state
-        snz_arenaClear(t->generatedArena);
-        poolAllocClear(t->generatedPool);
+// like _tl_opHash, but only from things that don't change between runs (no pointers), so it can key the disk cache.
+// Base geometry gets hashed tri by tri, so this is only worth doing when op is actually getting solved.
+// face ids have the op uid in them, so that goes in too
+static uint64_t _tl_opCacheKey(tl_OpPtrSlice ops, const tl_Op* op) {
+    uint64_t hash = 14695981039346656037ULL;
+    uint64_t version = TL_SOLVE_VERSION;
+    hash = _TL_HASH_VAL(hash, version);
+    hash = _TL_HASH_VAL(hash, op->uniqueId);
+    hash = _TL_HASH_VAL(hash, op->kind);
+    for (int i = 0; i < TL_OP_ARG_MAX_COUNT; i++) {
+        const tl_OpArg* arg = &op->args[i];
+        hash = _TL_HASH_VAL(hash, arg->kind);
+        hash = _TL_HASH_VAL(hash, arg->number);
+        hash = _tl_hashGeoId(hash, &arg->geoId);
+        tl_Op* dep = _tl_opsDep(ops, op, i);
+        if (dep) {
+            hash = _TL_HASH_VAL(hash, dep->solve.cacheKey);
+        }
+    }
 
-        for (int64_t i = 0; i < dependencies.count; i++) {
-            tl_Op* op = dependencies.elems[i];
-            memset(&op->solve, 0, sizeof(op->solve));
+    if (op->kind == TL_OPK_SKETCH) {
+        hash = _tl_hashSketch(hash, &op->val.sketch);
+    } else if (op->kind == TL_OPK_BASE_GEOMETRY) {
+        for (int64_t i = 0; i < op->val.baseGeometry.count; i++) {
+            const mesh_Face* f = &op->val.baseGeometry.elems[i];
+            hash = _tl_hashGeoId(hash, &f->id);
+            hash = _TL_HASH_VAL(hash, f->tris.count);
+            hash = _tl_hashBytes(hash, f->tris.elems, sizeof(geo_Tri) * f->tris.count);
         }
     }
+    return _tl_hashFinish(hash);
+}
 
-    for (int64_t i = dependencies.count - 1; i >= 0; i--) {
-        tl_Op* op = dependencies.elems[i];
-        SNZ_ASSERT(!op->markedForDeletion, "tl op marked for delete made it to the solving stage");
+// op that arg argIdx of op depends on, only if it was pulled into the current scheduling pass
+static tl_Op* _tl_opScheduledDep(tl_Timeline* t, tl_Op* op, int argIdx) {
+    if (!tl_opArgKindExpectsDependency(op->args[argIdx].kind)) {
+        return NULL;
+    }
+    tl_Op* dep = tl_timelineGetOpByUID(t, op->args[argIdx].geoId.opUniqueId);
+    if (dep && dep->schedule.passId == t->nextSchedulePassId - 1) {
+        return dep;
+    }
+    return NULL;
+}
 
-        if (op->kind == TL_OPK_SKETCH) {
-            sk_Sketch* sketch = &op->val.sketch;
-            sk_sketchSolve(sketch);
-            mesh_FaceSlice* faces = SNZ_ARENA_PUSH(t->generatedArena, mesh_FaceSlice);
-            mesh_TempGeo* tempGeo = SNZ_ARENA_PUSH(t->generatedArena, mesh_TempGeo);
-            skt_sketchTriangulate(sketch, faces, tempGeo, op->uniqueId, t->generatedArena, scratch);
-            op->solve.faces = faces;
-            op->solve.tempGeo = tempGeo;
-        } else if (op->kind == TL_OPK_BASE_GEOMETRY) {
-            op->solve.faces = &op->val.baseGeometry;
-            op->solve.tempGeo = mesh_facesToTempGeo(op->solve.faces, op->uniqueId, t->generatedArena, scratch);
-        } else if (op->kind == TL_OPK_EXTRUDE) {
-            tl_Op* targetDep = NULL;
-            const mesh_Face* ogFace = NULL;
-            float targetSize = 0;
-            { // unpack and validate args/dependent geo/etc.
-                SNZ_ASSERTF(op->args[0].kind == TL_OPAK_GEOID_FACE, "Extrude requires first arg to be a face. Actual kind: %d", op->args[0].kind);
-                mesh_GeoID targetFaceId = op->args[0].geoId;
-                targetDep = tl_timelineGetOpByUID(t, op->args[0].geoId.opUniqueId);
+// Pulls in targetOp (or every op when it's NULL) + everything they depend on, then does Kahn's over that to give a
+// list ordered so that every op comes after it's deps. Linear in ops + args.
+// Every op pulled in gets it's error reset, then set when it refers to an op that doesn't exist, is on a cycle, or
+// depends on something with an error. outOk is false when any op has one, the returned list leaves out cycles and
+// anything after them.
+// FIXME: bubbles & remove target op plz
+static tl_OpPtrSlice _tl_opsSchedule(tl_Timeline* t, tl_Op* targetOp, snz_Arena* arena, bool* outOk) {
+    int64_t passId = t->nextSchedulePassId;
+    t->nextSchedulePassId++;
 
-                SNZ_ASSERTF(op->args[1].kind == TL_OPAK_NUMBER, "Extrude requires second arg to be a number. Actual kind: %d", op->args[1].kind);
-                targetSize = op->args[1].number;
+    // BFS to collect everything, arr is being read while it's pushed to
+    SNZ_ARENA_ARR_BEGIN(arena, tl_Op*);
+    if (targetOp) {
+        *SNZ_ARENA_PUSH(arena, tl_Op*) = targetOp;
+        targetOp->schedule.passId = passId;
+    } else {
+        for (tl_Op* op = t->firstOp; op; op = op->next) {
+            *SNZ_ARENA_PUSH(arena, tl_Op*) = op;
+            op->schedule.passId = passId;
+        }
+    }
+    for (int64_t i = 0; i < arena->arrModeElemCount; i++) {
+        tl_Op* op = ((tl_Op**)(arena->end) - arena->arrModeElemCount)[i];
+        op->schedule.idx = i;
+        op->error = (tl_OpError){ 0 };
 
-                mesh_GeoIDResult geo = mesh_geoIdFind(targetDep->solve.faces, targetDep->solve.tempGeo, targetFaceId);
-                SNZ_ASSERT(geo.kind == MESH_GK_FACE, "Extrude geoid find failed.");
-                SNZ_ASSERT(mesh_faceFlat(geo.face), "Face to extrude wasn't flat.");
-                ogFace = geo.face;
+        for (int argIdx = 0; argIdx < TL_OP_ARG_MAX_COUNT; argIdx++) {
+            if (!tl_opArgKindExpectsDependency(op->args[argIdx].kind)) {
+                continue;
             }
+            tl_Op* dep = tl_timelineGetOpByUID(t, op->args[argIdx].geoId.opUniqueId);
+            if (!dep) {
+                if (!op->error.kind) {
+                    op->error = (tl_OpError){ .kind = TL_OPEK_MISSING_DEP, .argIdx = argIdx };
+                }
+                continue;
+            } else if (dep->schedule.passId == passId) {
+                continue;
+            }
+            dep->schedule.passId = passId;
+            *SNZ_ARENA_PUSH(arena, tl_Op*) = dep;
+        }
+    }
+    tl_OpPtrSlice ops = SNZ_ARENA_ARR_END_NAMED(arena, tl_Op*, tl_OpPtrSlice);
 
-            mesh_EdgeSlice edges = mesh_tempGeoFindAllAdjacentEdges(targetDep->solve.tempGeo, ogFace, scratch);
-            SNZ_ASSERT(edges.count, "No edges on face.");
+    // edges go dep -> op, CSR style list of dependents for each op
+    int64_t* depCounts = SNZ_ARENA_PUSH_ARR(arena, ops.count, int64_t);  // becomes in degree for kahns
+    int64_t* dependentStarts = SNZ_ARENA_PUSH_ARR(arena, ops.count + 1, int64_t);
+    for (int64_t i = 0; i < ops.count; i++) {
+        for (int argIdx = 0; argIdx < TL_OP_ARG_MAX_COUNT; argIdx++) {
+            tl_Op* dep = _tl_opScheduledDep(t, ops.elems[i], argIdx);
+            if (dep) {
+                depCounts[i]++;
+                dependentStarts[dep->schedule.idx + 1]++;
+            }
+        }
+    }
+    for (int64_t i = 0; i < ops.count; i++) {
+        dependentStarts[i + 1] += dependentStarts[i];
+    }
+    int64_t* dependents = SNZ_ARENA_PUSH_ARR(arena, dependentStarts[ops.count], int64_t);
+    int64_t* fillCounts = SNZ_ARENA_PUSH_ARR(arena, ops.count, int64_t);
+    for (int64_t i = 0; i < ops.count; i++) {
+        for (int argIdx = 0; argIdx < TL_OP_ARG_MAX_COUNT; argIdx++) {
+            tl_Op* dep = _tl_opScheduledDep(t, ops.elems[i], argIdx);
+            if (dep) {
+                int64_t depIdx = dep->schedule.idx;
+                dependents[dependentStarts[depIdx] + fillCounts[depIdx]] = i;
+                fillCounts[depIdx]++;
+            }
+        }
+    }
 
-            int64_t newFaceCount = 2 + edges.count;
-            mesh_FaceSlice newFaces = (mesh_FaceSlice){
-                .count = newFaceCount,
-                .elems = SNZ_ARENA_PUSH_ARR(t->generatedArena, newFaceCount, mesh_Face),
-            };
+    // kahns, order doubles as the queue
+    tl_Op** order = SNZ_ARENA_PUSH_ARR(arena, ops.count, tl_Op*);
+    int64_t orderCount = 0;
+    for (int64_t i = 0; i < ops.count; i++) {
+        if (depCounts[i] == 0) {
+            order[orderCount++] = ops.elems[i];
+        }
+    }
+    for (int64_t i = 0; i < orderCount; i++) {
+        int64_t idx = order[i]->schedule.idx;
+        for (int64_t j = dependentStarts[idx]; j < dependentStarts[idx + 1]; j++) {
+            int64_t dependentIdx = dependents[j];
+            depCounts[dependentIdx]--;
+            if (depCounts[dependentIdx] == 0) {
+                order[orderCount++] = ops.elems[dependentIdx];
+            }
+        }
+    }
 
-            HMM_Vec3 translation = HMM_Mul(geo_triNormal(ogFace->tris.elems[0]), targetSize);
-            { // new face, outward
-                mesh_Face f = (mesh_Face){
-                    .id = (mesh_GeoID) {
-                        .geoKind = MESH_GK_FACE,
-                        .opUniqueId = op->uniqueId,
-                        .diffGeo1 = mesh_geoIdDuplicate(&ogFace->id, t->generatedArena),
-                    },
-                };
-                f.tris = geo_triSliceDuplicate(&ogFace->tris, t->generatedArena);
-                mesh_faceTranslate(&f, translation);
-                newFaces.elems[0] = f;
-            }
-
-            { // flipped face on top of the original
-                mesh_Face f = (mesh_Face){
-                    .id = (mesh_GeoID) {
-                        .geoKind = MESH_GK_FACE,
-                        .opUniqueId = op->uniqueId,
-                        .diffGeo1 = mesh_geoIdDuplicate(&ogFace->id, t->generatedArena),
-                    },
-                };
-                f.tris = geo_triSliceDuplicate(&ogFace->tris, t->generatedArena);
-                geo_triSliceInvert(&f.tris);
-                newFaces.elems[1] = f;
-            }
-
-            boolSlice edgeFlips = mesh_edgesGetFlipsToMatchFace(ogFace, edges, scratch, scratch);
-            for (int64_t edgeIdx = 0; edgeIdx < edges.count; edgeIdx++) {
-                mesh_Edge* e = &edges.elems[edgeIdx];
-                mesh_Face* f = &newFaces.elems[2 + edgeIdx];
-                f->id = (mesh_GeoID){
-                    .geoKind = MESH_GK_FACE,
-                    .opUniqueId = op->uniqueId,
-                    .diffGeo1 = mesh_geoIdDuplicate(&e->id, t->generatedArena),
-                };
-                int64_t triCount = (e->points.count - 1) * 2;
-                f->tris = (geo_TriSlice){
-                    .count = triCount,
-                    .elems = SNZ_ARENA_PUSH_ARR(t->generatedArena, triCount, geo_Tri),
-                };
-                for (int64_t ptIdx = 0; ptIdx < e->points.count - 1; ptIdx++) {
-                    bool flip = edgeFlips.elems[edgeIdx];
-                    HMM_Vec3 pt1 = e->points.elems[ptIdx + !flip];
-                    HMM_Vec3 pt2 = e->points.elems[ptIdx + flip];
-                    HMM_Vec3 upperPt1 = HMM_Add(pt1, translation);
-                    HMM_Vec3 upperPt2 = HMM_Add(pt2, translation);
-                    f->tris.elems[ptIdx * 2 + 0] = geo_triInit(pt1, upperPt2, pt2);
-                    f->tris.elems[ptIdx * 2 + 1] = geo_triInit(pt1, upperPt1, upperPt2);
+    if (orderCount < ops.count) {
+        // leftovers are on a cycle or downstream of one. Peel off the downstream ones from the bottom up
+        // (leftovers that no other leftover depends on), whatever's still around after is on a cycle.
+        int64_t* leftoverDependentCounts = fillCounts;  // reused, they're done
+        memset(leftoverDependentCounts, 0, sizeof(*leftoverDependentCounts) * ops.count);
+        for (int64_t i = 0; i < ops.count; i++) {
+            if (depCounts[i] == 0) {
+                continue;
+            }
+            for (int argIdx = 0; argIdx < TL_OP_ARG_MAX_COUNT; argIdx++) {
+                tl_Op* dep = _tl_opScheduledDep(t, ops.elems[i], argIdx);
+                if (dep && depCounts[dep->schedule.idx] != 0) {
+                    leftoverDependentCounts[dep->schedule.idx]++;
                 }
             }
-
-            mesh_FaceSlice* faces = SNZ_ARENA_PUSH(t->generatedArena, mesh_FaceSlice);
-            *faces = csg_facesUnion(targetDep->solve.faces, &newFaces, t->generatedArena, scratch);
-            op->solve.faces = faces;
-            op->solve.tempGeo = mesh_facesToTempGeo(faces, op->uniqueId, t->generatedArena, scratch);
-        } else {
-            SNZ_ASSERTF(false, "unreachable. kind: %lld", op->kind);
         }
-    } // end loop solving
 
-    mesh_Scene out = mesh_sceneInit(targetOp->solve.faces, targetOp->solve.tempGeo, t->generatedArena, scratch);
-    return out;
+        int64_t* peelQueue = SNZ_ARENA_PUSH_ARR(arena, ops.count, int64_t);
+        int64_t peelCount = 0;
+        for (int64_t i = 0; i < ops.count; i++) {
+            if (depCounts[i] != 0 && leftoverDependentCounts[i] == 0) {
+                peelQueue[peelCount++] = i;
+            }
+        }
+        for (int64_t i = 0; i < peelCount; i++) {
+            tl_Op* op = ops.elems[peelQueue[i]];
+            for (int argIdx = 0; argIdx < TL_OP_ARG_MAX_COUNT; argIdx++) {
+                tl_Op* dep = _tl_opScheduledDep(t, op, argIdx);
+                if (!dep || depCounts[dep->schedule.idx] == 0) {
+                    continue;
+                }
+                if (!op->error.kind) {
+                    op->error = (tl_OpError){ .kind = TL_OPEK_DEP_HAS_ERROR, .argIdx = argIdx };
+                }
+                leftoverDependentCounts[dep->schedule.idx]--;
+                if (leftoverDependentCounts[dep->schedule.idx] == 0) {
+                    peelQueue[peelCount++] = dep->schedule.idx;
+                }
+            }
+            depCounts[peelQueue[i]] = -1;  // out of the leftovers, but not zero so it doesn't look solvable
+        }
+
+        for (int64_t i = 0; i < ops.count; i++) {
+            if (depCounts[i] <= 0) {
+                continue;
+            }
+            tl_Op* op = ops.elems[i];
+            for (int argIdx = 0; argIdx < TL_OP_ARG_MAX_COUNT; argIdx++) {
+                tl_Op* dep = _tl_opScheduledDep(t, op, argIdx);
+                if (dep && depCounts[dep->schedule.idx] > 0) {
+                    op->error = (tl_OpError){ .kind = TL_OPEK_CYCLE, .argIdx = argIdx };
+                    break;
+                }
+            }
+        }
+    }
+
+    // errors flow down to everything after them, order is already deps first so one pass does it
+    bool ok = orderCount == ops.count;
+    for (int64_t i = 0; i < orderCount; i++) {
+        tl_Op* op = order[i];
+        for (int argIdx = 0; argIdx < TL_OP_ARG_MAX_COUNT && !op->error.kind; argIdx++) {
+            tl_Op* dep = _tl_opScheduledDep(t, op, argIdx);
+            if (dep && dep->error.kind) {
+                op->error = (tl_OpError){ .kind = TL_OPEK_DEP_HAS_ERROR, .argIdx = argIdx };
+            }
+        }
+        ok &= !op->error.kind;
+    }
+
+    // positions are only known now, dep lookups when solving go thru these instead of uids
+    for (int64_t i = 0; i < orderCount; i++) {
+        order[i]->schedule.idx = i;
+    }
+    for (int64_t i = 0; i < orderCount; i++) {
+        tl_Op* op = order[i];
+        for (int argIdx = 0; argIdx < TL_OP_ARG_MAX_COUNT; argIdx++) {
+            tl_Op* dep = _tl_opScheduledDep(t, op, argIdx);
+            op->schedule.depIdxs[argIdx] = dep ? dep->schedule.idx : -1;
+        }
+    }
+
+    *outOk = ok;
+    return (tl_OpPtrSlice){ .elems = order, .count = orderCount };
+}
+
+// refreshes op->error for every op in the timeline
+void tl_timelineCheckDependencies(tl_Timeline* t, snz_Arena* scratch) {
+    bool ok = false;
+    _tl_opsSchedule(t, NULL, scratch, &ok);
+}
+
+// where each copy of a pattern op goes, the first one is always the source as is
+static HMM_Mat4Slice _tl_patternInstances(const tl_Op* op, const tl_Op* sourceDep, snz_Arena* arena) {
+    SNZ_ASSERTF(op->args[1].kind == TL_OPAK_NUMBER, "Pattern requires second arg to be a number. Actual kind: %d", op->args[1].kind);
+    SNZ_ASSERTF(op->args[2].kind == TL_OPAK_NUMBER, "Pattern requires third arg to be a number. Actual kind: %d", op->args[2].kind);
+    float countArg = roundf(op->args[1].number);
+    int64_t count = (countArg >= 1) ? (int64_t)SNZ_MIN(countArg, TL_PATTERN_MAX_COUNT) : 1;  // nan ends up 1 too
+    float step = op->args[2].number;
+
+    HMM_Mat4Slice out = {
+        .count = count,
+        .elems = SNZ_ARENA_PUSH_ARR_ALIGNED(arena, count, HMM_Mat4),
+    };
+    mesh_GeoIDResult geo = mesh_geoIdFind(sourceDep->solve.faces, sourceDep->solve.tempGeo, op->args[0].geoId);
+    if (op->kind == TL_OPK_LINEAR_PATTERN) {
+        SNZ_ASSERT(geo.kind == MESH_GK_FACE, "Linear pattern geoid find failed.");
+        SNZ_ASSERT(mesh_faceFlat(geo.face), "Face to pattern along wasn't flat.");
+        HMM_Vec3 offset = HMM_Mul(geo_triNormal(geo.face->tris.elems[0]), step);
+        for (int64_t i = 0; i < count; i++) {
+            out.elems[i] = HMM_Translate(HMM_Mul(offset, (float)i));
+        }
+    } else {
+        SNZ_ASSERT(geo.kind == MESH_GK_EDGE, "Circular pattern geoid find failed.");
+        HMM_Vec3Slice pts = geo.edge->points;
+        HMM_Vec3 pivot = pts.elems[0];
+        SNZ_ASSERT(!geo_v3Equal(pivot, pts.elems[pts.count - 1]), "Edge to pattern around is a loop.");
+        HMM_Vec3 axis = HMM_Norm(HMM_Sub(pts.elems[pts.count - 1], pivot));
+        for (int64_t i = 0; i < count; i++) {
+            HMM_Mat4 rotation = HMM_Rotate_RH(HMM_AngleDeg(step * i), axis);
+            out.elems[i] = HMM_MulM4(HMM_Translate(pivot), HMM_MulM4(rotation, HMM_Translate(HMM_MulV3F(pivot, -1.0f))));
+        }
+    }
+    return out;
+}
+
+// one copy of source per instance, all unioned in one go. Faces are id'd as this op + which copy + the face they
+// came from. Copies go to arena and not scratch because any that don't touch another get kept as is by the union.
+static mesh_FaceSlice _tl_patternMerge(const tl_Op* op, const mesh_FaceSlice* source, HMM_Mat4Slice instances, snz_Arena* arena, snz_Arena* scratch) {
+    mesh_FaceSlice* copies = SNZ_ARENA_PUSH_ARR(scratch, instances.count, mesh_FaceSlice);
+    for (int64_t i = 0; i < instances.count; i++) {
+        copies[i] = mesh_facesDuplicate(*source, arena);
+        mesh_facesTransform(copies[i], instances.elems[i]);
+        for (int64_t faceIdx = 0; faceIdx < copies[i].count; faceIdx++) {
+            copies[i].elems[faceIdx].id = (mesh_GeoID){
+                .geoKind = MESH_GK_FACE,
+                .opUniqueId = op->uniqueId,
+                .baseNodeId = i + 1,
+                .diffGeo1 = mesh_geoIdDuplicate(&source->elems[faceIdx].id, arena),
+            };
+        }
+    }
+    return csg_facesUnionMany(copies, instances.count, arena, scratch);
+}
+
+// brings op up to date, recomputing only if it's hash has changed since it was last solved. Results end up in op->solve.
+// ops has to be the ordered list from _tl_opsSchedule, and everything op depends on has to be solved already.
+// Only reads op inputs, never writes them, and only op->solve gets written. Safe to run on different ops at once.
+// Anything left half done by a cancel has it's hash zeroed so it gets redone next time.
+// With a cache, extrudes + patterns get looked up there before being done for real, and stored after.
+// w is the worker this is running on, if any, so parts of the op can be split into more jobs. Scratch is it's scratch.
+static void _tl_solveOneOp(tl_OpPtrSlice ops, tl_Op* op, scache_Cache* cache, bool recordStats, job_Worker* w, snz_Arena* scratch) {
+    SNZ_ASSERT(!op->markedForDeletion, "tl op marked for delete made it to the solving stage");
+
+    uint64_t hash = _tl_opHash(ops, op);
+    if (op->solve.hash == hash) {
+        return;  // nothing that feeds this changed since it was last solved, results are still good
+    }
+
+    if (!op->solve.arena.start) {
+        op->solve.arena = snz_arenaInitGrowable(TL_OP_SOLVE_ARENA_BLOCK_SIZE, "tl op solve arena");
+    } else {
+        snz_arenaClear(&op->solve.arena);
+    }
+    scache_mappingRelease(&op->solve.cacheMapping);
+    op->solve.faces = NULL;
+    op->solve.tempGeo = NULL;
+    op->solve.instances = NULL;
+    op->solve.hash = 0;
+    memset(&op->solve.stats, 0, sizeof(op->solve.stats));
+    snz_Arena* arena = &op->solve.arena;
+    uint64_t startTick = recordStats ? SDL_GetPerformanceCounter() : 0;
+
+    // sketches + base geo aren't worth it, they're quick and their temp geo doesn't come from just their faces
+    op->solve.cacheKey = _tl_opCacheKey(ops, op);
+    bool cacheable = cache && (op->kind == TL_OPK_EXTRUDE || op->kind == TL_OPK_LINEAR_PATTERN || op->kind == TL_OPK_CIRCULAR_PATTERN);
+    scache_Result cached = { 0 };
+    bool cacheHit = cacheable && scache_load(cache, op->solve.cacheKey, &cached, arena);
+    if (!cacheHit) {
+        op->solve.timesSolved++;
+    }
+
+    if (cacheHit) {
+        op->solve.faces = cached.faces;
+        op->solve.instances = cached.instances;
+        op->solve.cacheMapping = cached.mapping;
+        op->solve.tempGeo = mesh_facesToTempGeo(cached.faces, op->uniqueId, arena, scratch);
+    } else if (op->kind == TL_OPK_SKETCH) {
+        // solving moves points around, so it happens on a copy to keep the op as is
+        sk_Sketch sketch = sk_sketchDuplicate(&op->val.sketch, scratch);
+        sk_sketchSolve(&sketch, scratch);
+        mesh_FaceSlice* faces = SNZ_ARENA_PUSH(arena, mesh_FaceSlice);
+        mesh_TempGeo* tempGeo = SNZ_ARENA_PUSH(arena, mesh_TempGeo);
+        skt_sketchTriangulate(&sketch, faces, tempGeo, op->uniqueId, w, arena, scratch);
+        op->solve.faces = faces;
+        op->solve.tempGeo = tempGeo;
+    } else if (op->kind == TL_OPK_BASE_GEOMETRY) {
+        op->solve.faces = &op->val.baseGeometry;
+        op->solve.tempGeo = mesh_facesToTempGeo(op->solve.faces, op->uniqueId, arena, scratch);
+    } else if (op->kind == TL_OPK_EXTRUDE) {
+        tl_Op* targetDep = NULL;
+        const mesh_Face* ogFace = NULL;
+        float targetSize = 0;
+        { // unpack and validate args/dependent geo/etc.
+            SNZ_ASSERTF(op->args[0].kind == TL_OPAK_GEOID_FACE, "Extrude requires first arg to be a face. Actual kind: %d", op->args[0].kind);
+            mesh_GeoID targetFaceId = op->args[0].geoId;
+            targetDep = _tl_opsDep(ops, op, 0);
+
+            SNZ_ASSERTF(op->args[1].kind == TL_OPAK_NUMBER, "Extrude requires second arg to be a number. Actual kind: %d", op->args[1].kind);
+            targetSize = op->args[1].number;
+
+            mesh_GeoIDResult geo = mesh_geoIdFind(targetDep->solve.faces, targetDep->solve.tempGeo, targetFaceId);
+            SNZ_ASSERT(geo.kind == MESH_GK_FACE, "Extrude geoid find failed.");
+            SNZ_ASSERT(mesh_faceFlat(geo.face), "Face to extrude wasn't flat.");
+            ogFace = geo.face;
+        }
+
+        mesh_EdgeSlice edges = mesh_tempGeoFindAllAdjacentEdges(targetDep->solve.tempGeo, ogFace, scratch);
+        SNZ_ASSERT(edges.count, "No edges on face.");
+
+        int64_t newFaceCount = 2 + edges.count;
+        mesh_FaceSlice newFaces = (mesh_FaceSlice){
+            .count = newFaceCount,
+            .elems = SNZ_ARENA_PUSH_ARR(arena, newFaceCount, mesh_Face),
+        };
+
+        HMM_Vec3 translation = HMM_Mul(geo_triNormal(ogFace->tris.elems[0]), targetSize);
+        { // new face, outward
+            mesh_Face f = (mesh_Face){
+                .id = (mesh_GeoID) {
+                    .geoKind = MESH_GK_FACE,
+                    .opUniqueId = op->uniqueId,
+                    .diffGeo1 = mesh_geoIdDuplicate(&ogFace->id, arena),
+                },
+            };
+            f.tris = geo_triSliceDuplicate(&ogFace->tris, arena);
+            mesh_faceTranslate(&f, translation);
+            newFaces.elems[0] = f;
+        }
+
+        { // flipped face on top of the original
+            mesh_Face f = (mesh_Face){
+                .id = (mesh_GeoID) {
+                    .geoKind = MESH_GK_FACE,
+                    .opUniqueId = op->uniqueId,
+                    .diffGeo1 = mesh_geoIdDuplicate(&ogFace->id, arena),
+                },
+            };
+            f.tris = geo_triSliceDuplicate(&ogFace->tris, arena);
+            geo_triSliceInvert(&f.tris);
+            newFaces.elems[1] = f;
+        }
+
+        boolSlice edgeFlips = mesh_edgesGetFlipsToMatchFace(ogFace, edges, scratch, scratch);
+        for (int64_t edgeIdx = 0; edgeIdx < edges.count; edgeIdx++) {
+            mesh_Edge* e = &edges.elems[edgeIdx];
+            mesh_Face* f = &newFaces.elems[2 + edgeIdx];
+            f->id = (mesh_GeoID){
+                .geoKind = MESH_GK_FACE,
+                .opUniqueId = op->uniqueId,
+                .diffGeo1 = mesh_geoIdDuplicate(&e->id, arena),
+            };
+            int64_t triCount = (e->points.count - 1) * 2;
+            f->tris = (geo_TriSlice){
+                .count = triCount,
+                .elems = SNZ_ARENA_PUSH_ARR(arena, triCount, geo_Tri),
+            };
+            for (int64_t ptIdx = 0; ptIdx < e->points.count - 1; ptIdx++) {
+                bool flip = edgeFlips.elems[edgeIdx];
+                HMM_Vec3 pt1 = e->points.elems[ptIdx + !flip];
+                HMM_Vec3 pt2 = e->points.elems[ptIdx + flip];
+                HMM_Vec3 upperPt1 = HMM_Add(pt1, translation);
+                HMM_Vec3 upperPt2 = HMM_Add(pt2, translation);
+                f->tris.elems[ptIdx * 2 + 0] = geo_triInit(pt1, upperPt2, pt2);
+                f->tris.elems[ptIdx * 2 + 1] = geo_triInit(pt1, upperPt1, upperPt2);
+            }
+        }
+
+        mesh_FaceSlice* faces = SNZ_ARENA_PUSH(arena, mesh_FaceSlice);
+        *faces = csg_facesUnion(targetDep->solve.faces, &newFaces, arena, scratch);
+        op->solve.faces = faces;
+        op->solve.tempGeo = mesh_facesToTempGeo(faces, op->uniqueId, arena, scratch);
+    } else if (op->kind == TL_OPK_LINEAR_PATTERN || op->kind == TL_OPK_CIRCULAR_PATTERN) {
+        tl_Op* sourceDep = _tl_opsDep(ops, op, 0);
+        HMM_Mat4Slice* instances = SNZ_ARENA_PUSH(arena, HMM_Mat4Slice);
+        *instances = _tl_patternInstances(op, sourceDep, arena);
+
+        mesh_FaceSlice* faces = SNZ_ARENA_PUSH(arena, mesh_FaceSlice);
+        *faces = _tl_patternMerge(op, sourceDep->solve.faces, *instances, arena, scratch);
+        op->solve.faces = faces;
+        op->solve.instances = instances;
+        op->solve.tempGeo = mesh_facesToTempGeo(faces, op->uniqueId, arena, scratch);
+    } else {
+        SNZ_ASSERTF(false, "unreachable. kind: %d", op->kind);
+    }
+
+    if (mesh_cancelRequested()) {
+        return;  // results are junk, hash stays zeroed
+    }
+    op->solve.hash = hash;
+    if (cacheable && !cacheHit) {
+        scache_store(cache, op->solve.cacheKey, op->solve.faces, op->solve.instances, scratch);
+    }
+
+    if (recordStats) {
+        op->solve.stats.seconds = (double)(SDL_GetPerformanceCounter() - startTick) / SDL_GetPerformanceFrequency();
+        op->solve.stats.faceCount = op->solve.faces->count;
+        for (int64_t i = 0; i < op->solve.faces->count; i++) {
+            op->solve.stats.triCount += op->solve.faces->elems[i].tris.count;
+        }
+        op->solve.stats.bytes = snz_arenaUsedBytes(arena);
+        op->solve.stats.fromCache = cacheHit;
+        op->solve.stats.valid = true;
+    }
+}
+
+// brings every op in ops up to date, one at a time, in order. ops has to be ordered deps first, like _tl_opsSchedule gives.
+// Stops early when mesh_cancelRequested.
+static void _tl_solveOps(tl_OpPtrSlice ops, scache_Cache* cache, bool recordStats, snz_Arena* scratch) {
+    for (int64_t i = 0; i < ops.count; i++) {
+        if (mesh_cancelRequested()) {
+            return;
+        }
+        _tl_solveOneOp(ops, ops.elems[i], cache, recordStats, NULL, scratch);
+    }
+}
+
+typedef struct _tl_WideSolve _tl_WideSolve;
+
+typedef struct {
+    _tl_WideSolve* solve;
+    int64_t idx; // into ops
+} _tl_WideSolveOp;
+
+// shared between every job of one _tl_solveOpsWide
+struct _tl_WideSolve {
+    tl_OpPtrSlice ops;
+    scache_Cache* cache;
+    bool recordStats;
+    SDL_atomic_t* promoted; // optional, see tl_SolveJob. Once it's set the driving thread goes back to normal priority
+    job_Worker* caller; // the driving thread's worker
+    bool callerRaised; // only touched by the driving thread
+    _tl_WideSolveOp* jobDatas; // parallel to ops
+    SDL_atomic_t* depsLeft; // parallel to ops, op gets pushed as a job when this hits zero
+    int64_t* dependentStarts; // CSR, dependents of op i are dependents[dependentStarts[i]..dependentStarts[i + 1]]
+    int64_t* dependents;
+    SDL_atomic_t pending; // jobs pushed but not finished
+};
+
+static void _tl_wideSolveOpJob(job_Worker* w, void* data) {
+    _tl_WideSolveOp* solveOp = (_tl_WideSolveOp*)data;
+    _tl_WideSolve* solve = solveOp->solve;
+    if (mesh_cancelRequested()) {
+        return;  // nothing after this gets pushed, so everything winds down
+    }
+    if (w == solve->caller && solve->promoted && !solve->callerRaised && SDL_AtomicGet(solve->promoted)) {
+        SDL_SetThreadPriority(SDL_THREAD_PRIORITY_NORMAL);  // priority is per thread, so only it can do this
+        solve->callerRaised = true;
+    }
+    _tl_solveOneOp(solve->ops, solve->ops.elems[solveOp->idx], solve->cache, solve->recordStats, w, &w->scratch);
+    if (mesh_cancelRequested()) {
+        return;
+    }
+
+    for (int64_t i = solve->dependentStarts[solveOp->idx]; i < solve->dependentStarts[solveOp->idx + 1]; i++) {
+        int64_t dependentIdx = solve->dependents[i];
+        if (SDL_AtomicAdd(&solve->depsLeft[dependentIdx], -1) == 1) {  // returns the old val, so this was the last dep
+            job_push(w, _tl_wideSolveOpJob, &solve->jobDatas[dependentIdx], &solve->pending);
+        }
+    }
+}
+
+// same as _tl_solveOps, but every op whose deps are done gets solved at the same time as any others, across jobs.
+// arena is for the bookkeeping, each op gets the scratch of whatever worker picks it up.
+// Caller has to be the thread driving jobs. promoted is optional, see _tl_WideSolve.
+static void _tl_solveOpsWide(tl_OpPtrSlice ops, job_System* jobs, scache_Cache* cache, bool recordStats, SDL_atomic_t* promoted, snz_Arena* arena) {
+    _tl_WideSolve* solve = SNZ_ARENA_PUSH(arena, _tl_WideSolve);
+    solve->ops = ops;
+    solve->cache = cache;
+    solve->recordStats = recordStats;
+    solve->promoted = promoted;
+    solve->caller = job_systemCaller(jobs);
+    solve->jobDatas = SNZ_ARENA_PUSH_ARR(arena, ops.count, _tl_WideSolveOp);
+    solve->depsLeft = SNZ_ARENA_PUSH_ARR(arena, ops.count, SDL_atomic_t);
+    solve->dependentStarts = SNZ_ARENA_PUSH_ARR(arena, ops.count + 1, int64_t);
+
+    for (int64_t i = 0; i < ops.count; i++) {
+        solve->jobDatas[i] = (_tl_WideSolveOp){ .solve = solve, .idx = i };
+        for (int argIdx = 0; argIdx < TL_OP_ARG_MAX_COUNT; argIdx++) {
+            int64_t depIdx = ops.elems[i]->schedule.depIdxs[argIdx];
+            if (depIdx >= 0) {
+                solve->depsLeft[i].value++;
+                solve->dependentStarts[depIdx + 1]++;
+            }
+        }
+    }
+    for (int64_t i = 0; i < ops.count; i++) {
+        solve->dependentStarts[i + 1] += solve->dependentStarts[i];
+    }
+    solve->dependents = SNZ_ARENA_PUSH_ARR(arena, solve->dependentStarts[ops.count], int64_t);
+    int64_t* fillCounts = SNZ_ARENA_PUSH_ARR(arena, ops.count, int64_t);
+    for (int64_t i = 0; i < ops.count; i++) {
+        for (int argIdx = 0; argIdx < TL_OP_ARG_MAX_COUNT; argIdx++) {
+            int64_t depIdx = ops.elems[i]->schedule.depIdxs[argIdx];
+            if (depIdx >= 0) {
+                solve->dependents[solve->dependentStarts[depIdx] + fillCounts[depIdx]] = i;
+                fillCounts[depIdx]++;
+            }
+        }
+    }
+
+    // roots get found before any are pushed, once jobs start depsLeft of everything else starts moving
+    int64_t* roots = SNZ_ARENA_PUSH_ARR(arena, ops.count, int64_t);
+    int64_t rootCount = 0;
+    for (int64_t i = 0; i < ops.count; i++) {
+        if (solve->depsLeft[i].value == 0) {
+            roots[rootCount++] = i;
+        }
+    }
+    job_Worker* caller = solve->caller;
+    for (int64_t i = 0; i < rootCount; i++) {
+        job_push(caller, _tl_wideSolveOpJob, &solve->jobDatas[roots[i]], &solve->pending);
+    }
+    job_wait(caller, &solve->pending);
+}
+
+// solves targetOp and it's deps right here, on this thread (+ t->jobs when set). Not safe while a background solve is running.
+// targetOp can be null to solve every op in the timeline.
+// false if nothing was solved because of an error in targetOp or it's deps, see op->error
+bool tl_solveOp(tl_Timeline* t, tl_Op* targetOp, snz_Arena* scratch) {
+    SNZ_ASSERT(t->solveJob.thread == NULL, "sync solve while a background solve was running.");
+    bool ok = false;
+    tl_OpPtrSlice ops = _tl_opsSchedule(t, targetOp, scratch, &ok);
+    if (!ok) {
+        return false;
+    }
+    if (t->jobs) {
+        _tl_solveOpsWide(ops, t->jobs, t->solveCache, t->recordSolveStats, NULL, scratch);
+    } else {
+        _tl_solveOps(ops, t->solveCache, t->recordSolveStats, scratch);
+    }
+    return true;
+}
+
+// true when every op targetOp needs is solved with what it has now, so solving it again wouldn't do anything
+static bool _tl_opsUpToDate(tl_Timeline* t, tl_Op* targetOp, snz_Arena* scratch) {
+    bool ok = false;
+    tl_OpPtrSlice ops = _tl_opsSchedule(t, targetOp, scratch, &ok);
+    for (int64_t i = 0; i < ops.count && ok; i++) {
+        ok &= ops.elems[i]->solve.hash == _tl_opHash(ops, ops.elems[i]);
+    }
+    return ok;
+}
+
+static int _tl_solveThread(void* data) {
+    tl_SolveJob* job = (tl_SolveJob*)data;
+    if (job->lowPriority) {
+        SDL_SetThreadPriority(SDL_THREAD_PRIORITY_LOW);
+    }
+    if (job->jobs) {
+        _tl_solveOpsWide(job->jobOps, job->jobs, job->cache, job->recordStats, &job->promoted, &job->scratch);
+    } else {
+        // one at a time so a promotion gets picked up between ops, see tl_solveStart
+        for (int64_t i = 0; i < job->jobOps.count && !mesh_cancelRequested(); i++) {
+            if (SDL_AtomicGet(&job->promoted) && job->lowPriority) {
+                SDL_SetThreadPriority(SDL_THREAD_PRIORITY_NORMAL);
+                job->lowPriority = false;
+                if (job->promotedJobs) {
+                    // whatever got done already is skipped by it's hash
+                    _tl_solveOpsWide(job->jobOps, job->promotedJobs, job->cache, job->recordStats, NULL, &job->scratch);
+                    break;
+                }
+            }
+            _tl_solveOneOp(job->jobOps, job->jobOps.elems[i], job->cache, job->recordStats, NULL, &job->scratch);
+        }
+    }
+    if (SDL_AtomicGet(&job->promoted) && job->lowPriority) {
+        SDL_SetThreadPriority(SDL_THREAD_PRIORITY_NORMAL);  // for the scene, when it came in late or jobs were on
+        job->lowPriority = false;
+    }
+
+    if (!mesh_cancelRequested()) {
+        tl_Op* target = job->jobOps.elems[job->jobOps.count - 1];
+        snz_Arena* sceneArena = &job->sceneArenas[!job->frontSceneIdx];
+        snz_arenaClear(sceneArena);
+        if (target->solve.instances) {
+            // source is always in the job ops, deps of the target are even when they didn't need solving
+            tl_Op* source = _tl_opsDep(job->jobOps, target, 0);
+            job->scene = mesh_sceneInitInstanced(target->solve.faces, target->solve.tempGeo,
+                                                 source->solve.faces, *target->solve.instances, sceneArena, &job->scratch);
+        } else {
+            job->scene = mesh_sceneInit(target->solve.faces, target->solve.tempGeo, sceneArena, &job->scratch);
+        }
+    }
+    SDL_AtomicSet(&job->done, 1);
+    return 0;
+}
+
+// waits for the thread and hands solve results (even partial ones) back to the live ops
+static void _tl_solveJobJoin(tl_SolveJob* job) {
+    SDL_WaitThread(job->thread, NULL);
+    job->thread = NULL;
+    SDL_AtomicSet(&job->cancel, 0);  // token stays set between jobs, this would stop any other mesh fns dead otherwise
+    for (int64_t i = 0; i < job->liveOps.count; i++) {
+        job->liveOps.elems[i]->solve = job->jobOps.elems[i]->solve;
+    }
+}
+
+// blocks until any running solve stops, the scene being drawn is unaffected
+void tl_solveCancel(tl_Timeline* t) {
+    tl_SolveJob* job = &t->solveJob;
+    if (!job->thread) {
+        return;
+    }
+    SDL_AtomicSet(&job->cancel, 1);
+    _tl_solveJobJoin(job);
+}
+
+// speculative solves hold onto their scene when they finish instead of having it swapped in, see tl_solveSpeculate
+static bool _tl_solveJobStart(tl_Timeline* t, tl_Op* targetOp, bool speculative) {
+    tl_SolveJob* job = &t->solveJob;
+    tl_solveCancel(t);
+    job->sceneHeld = false;  // whatever's in the back scene arena is about to get written over
+    job->sceneAdopted = false;
+
+    if (!job->scratch.start) {
+        job->inputArena = snz_arenaInit(TL_SOLVE_INPUT_ARENA_SIZE, "tl solve input arena");
+        job->scratch = snz_arenaInit(TL_SOLVE_SCRATCH_SIZE, "tl solve scratch arena");
+        job->sceneArenas[0] = snz_arenaInit(TL_SOLVE_SCENE_ARENA_SIZE, "tl solve scene arena 0");
+        job->sceneArenas[1] = snz_arenaInit(TL_SOLVE_SCENE_ARENA_SIZE, "tl solve scene arena 1");
+    }
+    snz_arenaClear(&job->inputArena);
+    snz_arenaClear(&job->scratch);
+
+    bool ok = false;
+    job->liveOps = _tl_opsSchedule(t, targetOp, &job->inputArena, &ok);
+    if (!ok) {
+        return false;
+    }
+
+    // the ui keeps editing the live ops while this runs, so the thread gets copies of everything it reads
+    job->jobOps = (tl_OpPtrSlice){
+        .count = job->liveOps.count,
+        .elems = SNZ_ARENA_PUSH_ARR(&job->inputArena, job->liveOps.count, tl_Op*),
+    };
+    for (int64_t i = 0; i < job->liveOps.count; i++) {
+        tl_Op* live = job->liveOps.elems[i];
+        tl_Op* copy = SNZ_ARENA_PUSH(&job->inputArena, tl_Op);
+        *copy = *live;
+        copy->next = NULL;
+        if (live->kind == TL_OPK_SKETCH) {
+            copy->val.sketch = sk_sketchDuplicate(&live->val.sketch, &job->inputArena);
+        }
+        job->jobOps.elems[i] = copy;
+    }
+
+    SDL_AtomicSet(&job->cancel, 0);
+    SDL_AtomicSet(&job->done, 0);
+    SDL_AtomicSet(&job->promoted, 0);
+    job->jobs = (speculative && !t->speculate.useJobs) ? NULL : t->jobs;
+    job->promotedJobs = t->jobs;
+    job->recordStats = t->recordSolveStats;
+    job->cache = t->solveCache;
+    job->targetUid = targetOp ? targetOp->uniqueId : 0;
+    job->speculative = speculative;
+    job->lowPriority = speculative;
+    mesh_cancelToken = &job->cancel;
+    job->thread = SDL_CreateThread(_tl_solveThread, "tl solve", job);
+    SNZ_ASSERTF(job->thread != NULL, "creating solve thread failed: %s", SDL_GetError());
+    return true;
+}
+
+// kicks off a solve of targetOp on a background thread, canceling any that was running.
+// poll for the result with tl_solvePoll. When tl_solveSpeculate is already pre-solving targetOp, that one just keeps
+// going, and when it's already done and nothing changed since, it's scene gets swapped in on the very next poll.
+// A pre-solve that keeps going gets promoted: it's thread goes back to normal priority and moves whatever it
+// hasn't done yet onto t->jobs, the next time it's between ops.
+// false and nothing started if targetOp or it's deps have errors, see op->error
+bool tl_solveStart(tl_Timeline* t, tl_Op* targetOp) {
+    tl_SolveJob* job = &t->solveJob;
+    int64_t targetUid = targetOp ? targetOp->uniqueId : 0;
+    if (job->thread && job->speculative && job->targetUid == targetUid) {
+        job->speculative = false;
+        SDL_AtomicSet(&job->promoted, 1);
+        return true;
+    } else if (!job->thread && job->sceneHeld && job->targetUid == targetUid) {
+        job->sceneHeld = false;
+        snz_arenaClear(&job->inputArena);
+        if (_tl_opsUpToDate(t, targetOp, &job->inputArena)) {
+            job->sceneAdopted = true;
+            return true;
+        }
+    }
+    return _tl_solveJobStart(t, targetOp, false);
+}
+
+// call once a frame with whichever op the mouse is over, or null. Once the same op has been hovered for
+// t->speculate.dwellSeconds it gets solved on a low priority background thread, so that clicking it right after
+// doesn't have to wait (see tl_solveStart). Never starts while any other solve is running, and gets canceled if the
+// hover moves before it's done (anything it finished is kept, same as any cancel). Does nothing unless speculate.enabled.
+void tl_solveSpeculate(tl_Timeline* t, tl_Op* hovered, float dt) {
+    tl_SolveJob* job = &t->solveJob;
+    int64_t uid = hovered ? hovered->uniqueId : 0;
+    if (uid != t->speculate.hoveredUid) {
+        t->speculate.hoveredUid = uid;
+        t->speculate.hoveredTime = 0;
+        t->speculate.started = false;
+        if (job->thread && job->speculative) {
+            tl_solveCancel(t);
+        }
+    }
+    t->speculate.hoveredTime += dt;
+
+    if (!hovered || !t->speculate.enabled || t->speculate.started) {
+        return;
+    } else if (t->speculate.hoveredTime < t->speculate.dwellSeconds || job->thread) {
+        return;
+    }
+    t->speculate.started = true;  // even if it fails to start, errors won't fix themselves while hovering
+    _tl_solveJobStart(t, hovered, true);
+}
+
+// joins the solve thread if it's done. True when there's a scene that should be swapped in now.
+static bool _tl_solveCollect(tl_Timeline* t) {
+    tl_SolveJob* job = &t->solveJob;
+    if (job->sceneAdopted) {
+        job->sceneAdopted = false;
+        return true;
+    } else if (!job->thread || !SDL_AtomicGet(&job->done)) {
+        return false;
+    }
+    _tl_solveJobJoin(job);
+    if (job->speculative) {
+        job->sceneHeld = true;
+        return false;
+    }
+    return true;
+}
+
+// call once a frame, main thread only. When a solve has finished since the last call, this uploads it's render meshes,
+// swaps it into scene (freeing the old one's meshes) and returns true. Otherwise scene is left alone.
+bool tl_solvePoll(tl_Timeline* t, mesh_Scene* scene) {
+    tl_SolveJob* job = &t->solveJob;
+    if (!_tl_solveCollect(t)) {
+        return false;
+    }
+
+    mesh_sceneDeinitRenderMeshes(scene);
+    *scene = job->scene;
+    mesh_sceneUploadRenderMeshes(scene);
+    job->frontSceneIdx = !job->frontSceneIdx;
+    return true;
+}
+
+// pre-solves from tl_solveSpeculate don't count
+bool tl_solveRunning(const tl_Timeline* t) {
+    return t->solveJob.thread != NULL && !t->solveJob.speculative;
+}
+
+// frees everything the timeline allocated for itself, the op arena passed to init is left alone
+void tl_timelineDeinit(tl_Timeline* t) {
+    tl_solveCancel(t);
+    for (tl_Op* op = t->firstOp; op; op = op->next) {
+        if (op->solve.arena.start) {
+            snz_arenaDeinit(&op->solve.arena);
+        }
+        scache_mappingRelease(&op->solve.cacheMapping);
+    }
+    free(t->opTable.slots);
+    free(t->nodeGrid.entries);
+    free(t->nodeGrid.cells);
+    free(t->nodeGrid.dependents);
+    free(t->nodeGrid.moved);
+
+    tl_SolveJob* job = &t->solveJob;
+    if (job->scratch.start) {
+        snz_arenaDeinit(&job->inputArena);
+        snz_arenaDeinit(&job->scratch);
+        snz_arenaDeinit(&job->sceneArenas[0]);
+        snz_arenaDeinit(&job->sceneArenas[1]);
+    }
+    if (mesh_cancelToken == &job->cancel) {
+        mesh_cancelToken = NULL;
+    }
+    memset(t, 0, sizeof(*t));
+}
+
+// sketches as they go to disk, which is still the linked lists sketches used to be made of so old files read the same.
+// check + slot aren't saved, they're filled in by _tl_savedSketchValid for loading.
+typedef struct tl_SavedPoint tl_SavedPoint;
+struct tl_SavedPoint {
+    HMM_Vec2 pos;
+    tl_SavedPoint* next;
+    int64_t uniqueId;
+    uint64_t check;
+    int64_t slot;
+};
+
+typedef struct tl_SavedLine tl_SavedLine;
+struct tl_SavedLine {
+    tl_SavedPoint* p1;
+    tl_SavedPoint* p2;
+    tl_SavedLine* next;
+    int64_t uniqueId;
+    uint64_t check;
+    int64_t slot;
+};
+
+typedef struct tl_SavedConstraint tl_SavedConstraint;
+struct tl_SavedConstraint {
+    sk_ConstraintKind kind;
+    tl_SavedLine* line1;
+    tl_SavedLine* line2;
+    bool flipLine1;
+    bool flipLine2;
+    float value;
+    tl_SavedConstraint* nextAllocated;
+    int64_t uniqueId;
+    uint64_t check;
+    int64_t slot;
+};
+
+typedef struct {
+    tl_SavedPoint* firstPoint; // lists are in slot order
+    tl_SavedLine* firstLine;
+    tl_SavedConstraint* firstConstraint;
+    int64_t nextUniqueId;
+    tl_SavedPoint* originPt;
+    tl_SavedLine* originLine;
+    float originAngle;
+} tl_SavedSketch;
+
+// what actually goes to disk, see tl_timelineSpec. Ops get flattened into these instead of
+// being written directly because of the val union and all the solve/ui state that shouldn't be saved.
+typedef struct tl_SavedOp tl_SavedOp;
+struct tl_SavedOp {
+    tl_SavedOp* next;
+    int64_t uniqueId;
+    tl_OpKind kind;
+    HMM_Vec2 pos;
+
+    tl_OpArg* args;
+    int64_t argCount;
+    tl_SavedSketch* sketch; // null unless kind is sketch
+    mesh_Face* faces; // only for base geometry
+    int64_t faceCount;
+};
+
+// ser slices have to be of structs
+typedef struct {
+    int64_t uid;
+} tl_SavedUid;
+SNZ_SLICE(tl_SavedUid);
+
+// one record in a timeline file. The first record in a file is a snapshot of the whole timeline, every one after that
+// is an edit on top of the ones before it: ops in it replace whichever op had the same uid (or get added if none did),
+// and deletedUids get culled. The rest is always copied over whole. See tl_Journal.
+typedef struct {
+    tl_SavedOp* firstOp; // same order as the timelines list
+    tl_SavedUid* deletedUids;
+    int64_t deletedCount;
+    int64_t nextUniqueId;
+    int64_t activeOpUid; // zero for none
+    HMM_Vec2 camPos;
+    float camHeight;
+} tl_SavedTimeline;
+
+// adds everything tl_timelineWrite/Read need to the global ser spec, call between ser_begin and ser_end.
+// specArena should be the same one given to ser_begin, enum value lists go there.
+void tl_timelineSpec(snz_Arena* specArena) {
+    ser_addStruct(HMM_Vec2, false);
+    ser_addStructField(HMM_Vec2, ser_tBase(SER_TK_FLOAT32), X);
+    ser_addStructField(HMM_Vec2, ser_tBase(SER_TK_FLOAT32), Y);
+
+    ser_addStruct(HMM_Vec3, false);
+    ser_addStructField(HMM_Vec3, ser_tBase(SER_TK_FLOAT32), X);
+    ser_addStructField(HMM_Vec3, ser_tBase(SER_TK_FLOAT32), Y);
+    ser_addStructField(HMM_Vec3, ser_tBase(SER_TK_FLOAT32), Z);
+
+    ser_addStruct(geo_Tri, false);
+    ser_addStructField(geo_Tri, ser_tStruct(HMM_Vec3), a);
+    ser_addStructField(geo_Tri, ser_tStruct(HMM_Vec3), b);
+    ser_addStructField(geo_Tri, ser_tStruct(HMM_Vec3), c);
+
+    ser_addStruct(geo_TriSlice, false);
+    ser_addStructFieldSlice(geo_TriSlice, geo_Tri, elems, count);
+
+    SNZ_ARENA_ARR_BEGIN(specArena, ser_EnumValue);
+    ser_enumValuePush(specArena, MESH_GK_DOES_NOT_EXIST);
+    ser_enumValuePush(specArena, MESH_GK_CORNER);
+    ser_enumValuePush(specArena, MESH_GK_EDGE);
+    ser_enumValuePush(specArena, MESH_GK_FACE);
+    ser_addEnum(mesh_GeoKind, SNZ_ARENA_ARR_END(specArena, ser_EnumValue));
+
+    ser_addStruct(mesh_GeoID, true);
+    ser_addStructField(mesh_GeoID, ser_tEnum(mesh_GeoKind), geoKind);
+    ser_addStructField(mesh_GeoID, ser_tBase(SER_TK_INT64), opUniqueId);
+    ser_addStructField(mesh_GeoID, ser_tBase(SER_TK_INT64), baseNodeId);
+    ser_addStructField(mesh_GeoID, ser_tPtr(mesh_GeoID), diffGeo1);
+    ser_addStructField(mesh_GeoID, ser_tPtr(mesh_GeoID), diffGeo2);
+
+    ser_addStruct(mesh_Face, false);
+    ser_addStructField(mesh_Face, ser_tStruct(mesh_GeoID), id);
+    ser_addStructField(mesh_Face, ser_tStruct(geo_TriSlice), tris);
+
+    // only the parts of sketches that aren't redone by solving. ui + solver state comes back zeroed.
+    // tagged with the names of the sketch structs they used to be written straight from, so files stay the same
+    ser_addStructAs(tl_SavedPoint, sk_Point, true);
+    ser_addStructFieldAs(tl_SavedPoint, sk_Point, ser_tStruct(HMM_Vec2), pos);
+    ser_addStructFieldAs(tl_SavedPoint, sk_Point, ser_tPtr(sk_Point), next);
+    ser_addStructFieldAs(tl_SavedPoint, sk_Point, ser_tBase(SER_TK_INT64), uniqueId);
+
+    ser_addStructAs(tl_SavedLine, sk_Line, true);
+    ser_addStructFieldAs(tl_SavedLine, sk_Line, ser_tPtr(sk_Point), p1);
+    ser_addStructFieldAs(tl_SavedLine, sk_Line, ser_tPtr(sk_Point), p2);
+    ser_addStructFieldAs(tl_SavedLine, sk_Line, ser_tPtr(sk_Line), next);
+    ser_addStructFieldAs(tl_SavedLine, sk_Line, ser_tBase(SER_TK_INT64), uniqueId);
+
+    SNZ_ARENA_ARR_BEGIN(specArena, ser_EnumValue);
+    ser_enumValuePush(specArena, SK_CK_DISTANCE);
+    ser_enumValuePush(specArena, SK_CK_ANGLE);
+    ser_addEnum(sk_ConstraintKind, SNZ_ARENA_ARR_END(specArena, ser_EnumValue));
+
+    ser_addStructAs(tl_SavedConstraint, sk_Constraint, true);
+    ser_addStructFieldAs(tl_SavedConstraint, sk_Constraint, ser_tEnum(sk_ConstraintKind), kind);
+    ser_addStructFieldAs(tl_SavedConstraint, sk_Constraint, ser_tPtr(sk_Line), line1);
+    ser_addStructFieldAs(tl_SavedConstraint, sk_Constraint, ser_tPtr(sk_Line), line2);
+    ser_addStructFieldAs(tl_SavedConstraint, sk_Constraint, ser_tBase(SER_TK_UINT8), flipLine1);
+    ser_addStructFieldAs(tl_SavedConstraint, sk_Constraint, ser_tBase(SER_TK_UINT8), flipLine2);
+    ser_addStructFieldAs(tl_SavedConstraint, sk_Constraint, ser_tBase(SER_TK_FLOAT32), value);
+    ser_addStructFieldAs(tl_SavedConstraint, sk_Constraint, ser_tPtr(sk_Constraint), nextAllocated);
+    ser_addStructFieldAs(tl_SavedConstraint, sk_Constraint, ser_tBase(SER_TK_INT64), uniqueId);
+
+    ser_addStructAs(tl_SavedSketch, sk_Sketch, true);
+    ser_addStructFieldAs(tl_SavedSketch, sk_Sketch, ser_tPtr(sk_Point), firstPoint);
+    ser_addStructFieldAs(tl_SavedSketch, sk_Sketch, ser_tPtr(sk_Line), firstLine);
+    ser_addStructFieldAs(tl_SavedSketch, sk_Sketch, ser_tPtr(sk_Constraint), firstConstraint);
+    ser_addStructFieldAs(tl_SavedSketch, sk_Sketch, ser_tBase(SER_TK_INT64), nextUniqueId);
+    ser_addStructFieldAs(tl_SavedSketch, sk_Sketch, ser_tPtr(sk_Point), originPt);
+    ser_addStructFieldAs(tl_SavedSketch, sk_Sketch, ser_tPtr(sk_Line), originLine);
+    ser_addStructFieldAs(tl_SavedSketch, sk_Sketch, ser_tBase(SER_TK_FLOAT32), originAngle);
+
+    SNZ_ARENA_ARR_BEGIN(specArena, ser_EnumValue);
+    ser_enumValuePush(specArena, TL_OPAK_NONE);
+    ser_enumValuePush(specArena, TL_OPAK_NUMBER);
+    ser_enumValuePush(specArena, TL_OPAK_GEOID_CORNER);
+    ser_enumValuePush(specArena, TL_OPAK_GEOID_EDGE);
+    ser_enumValuePush(specArena, TL_OPAK_GEOID_FACE);
+    ser_addEnum(tl_OpArgKind, SNZ_ARENA_ARR_END(specArena, ser_EnumValue));
+
+    ser_addStruct(tl_OpArg, false);
+    ser_addStructField(tl_OpArg, ser_tEnum(tl_OpArgKind), kind);
+    ser_addStructField(tl_OpArg, ser_tBase(SER_TK_FLOAT32), number);
+    ser_addStructField(tl_OpArg, ser_tStruct(mesh_GeoID), geoId);
+
+    SNZ_ARENA_ARR_BEGIN(specArena, ser_EnumValue);
+    ser_enumValuePush(specArena, TL_OPK_NONE);
+    ser_enumValuePush(specArena, TL_OPK_SKETCH);
+    ser_enumValuePush(specArena, TL_OPK_BASE_GEOMETRY);
+    ser_enumValuePush(specArena, TL_OPK_EXTRUDE);
+    ser_enumValuePush(specArena, TL_OPK_LINEAR_PATTERN);
+    ser_enumValuePush(specArena, TL_OPK_CIRCULAR_PATTERN);
+    ser_addEnum(tl_OpKind, SNZ_ARENA_ARR_END(specArena, ser_EnumValue));
+
+    ser_addStruct(tl_SavedOp, true);
+    ser_addStructField(tl_SavedOp, ser_tPtr(tl_SavedOp), next);
+    ser_addStructField(tl_SavedOp, ser_tBase(SER_TK_INT64), uniqueId);
+    ser_addStructField(tl_SavedOp, ser_tEnum(tl_OpKind), kind);
+    ser_addStructField(tl_SavedOp, ser_tStruct(HMM_Vec2), pos);
+    ser_addStructFieldSlice(tl_SavedOp, tl_OpArg, args, argCount);
+    ser_addStructField(tl_SavedOp, ser_tPtr(sk_Sketch), sketch);
+    ser_addStructFieldSlice(tl_SavedOp, mesh_Face, faces, faceCount);
+
+    ser_addStruct(tl_SavedUid, false);
+    ser_addStructField(tl_SavedUid, ser_tBase(SER_TK_INT64), uid);
+
+    ser_addStruct(tl_SavedTimeline, false);
+    ser_addStructField(tl_SavedTimeline, ser_tPtr(tl_SavedOp), firstOp);
+    ser_addStructFieldSlice(tl_SavedTimeline, tl_SavedUid, deletedUids, deletedCount);
+    ser_addStructField(tl_SavedTimeline, ser_tBase(SER_TK_INT64), nextUniqueId);
+    ser_addStructField(tl_SavedTimeline, ser_tBase(SER_TK_INT64), activeOpUid);
+    ser_addStructField(tl_SavedTimeline, ser_tStruct(HMM_Vec2), camPos);
+    ser_addStructField(tl_SavedTimeline, ser_tBase(SER_TK_FLOAT32), camHeight);
+}
+
+// linked copy of sketch for writing, in scratch. lists go in slot order, which is also the order loading puts them back in
+static tl_SavedSketch* _tl_savedSketchFromSketch(const sk_Sketch* sketch, snz_Arena* scratch) {
+    tl_SavedSketch* out = SNZ_ARENA_PUSH(scratch, tl_SavedSketch);
+    out->nextUniqueId = sketch->nextUniqueId;
+    out->originAngle = sketch->originAngle;
+
+    // saved pts/lines by slot, for pointing lines + constraints at the saved versions
+    tl_SavedPoint** pts = SNZ_ARENA_PUSH_ARR(scratch, sketch->points.count, tl_SavedPoint*);
+    tl_SavedLine** lines = SNZ_ARENA_PUSH_ARR(scratch, sketch->lines.count, tl_SavedLine*);
+
+    tl_SavedPoint** nextPt = &out->firstPoint;
+    for (sk_Point* p = sk_sketchFirstPoint(sketch); p; p = sk_sketchNextPoint(sketch, p)) {
+        tl_SavedPoint* s = SNZ_ARENA_PUSH(scratch, tl_SavedPoint);
+        *s = (tl_SavedPoint){ .pos = p->pos, .uniqueId = p->uniqueId };
+        pts[p->slot] = s;
+        *nextPt = s;
+        nextPt = &s->next;
+    }
+    tl_SavedLine** nextLine = &out->firstLine;
+    for (sk_Line* l = sk_sketchFirstLine(sketch); l; l = sk_sketchNextLine(sketch, l)) {
+        tl_SavedLine* s = SNZ_ARENA_PUSH(scratch, tl_SavedLine);
+        *s = (tl_SavedLine){ .p1 = pts[l->p1->slot], .p2 = pts[l->p2->slot], .uniqueId = l->uniqueId };
+        lines[l->slot] = s;
+        *nextLine = s;
+        nextLine = &s->next;
+    }
+    tl_SavedConstraint** nextConstraint = &out->firstConstraint;
+    for (sk_Constraint* c = sk_sketchFirstConstraint(sketch); c; c = sk_sketchNextConstraint(sketch, c)) {
+        tl_SavedConstraint* s = SNZ_ARENA_PUSH(scratch, tl_SavedConstraint);
+        *s = (tl_SavedConstraint){
+            .kind = c->kind,
+            .line1 = c->line1 ? lines[c->line1->slot] : NULL,
+            .line2 = c->line2 ? lines[c->line2->slot] : NULL,
+            .flipLine1 = c->flipLine1,
+            .flipLine2 = c->flipLine2,
+            .value = c->value,
+            .uniqueId = c->uniqueId,
+        };
+        *nextConstraint = s;
+        nextConstraint = &s->nextAllocated;
+    }
+
+    out->originPt = sketch->originPt ? pts[sketch->originPt->slot] : NULL;
+    out->originLine = sketch->originLine ? lines[sketch->originLine->slot] : NULL;
+    return out;
+}
+
+// flattened view of op for writing, points into op for everything but sketches, which get copied into scratch
+static tl_SavedOp _tl_savedOpFromOp(tl_Op* op, snz_Arena* scratch) {
+    tl_SavedOp s = (tl_SavedOp){
+        .uniqueId = op->uniqueId,
+        .kind = op->kind,
+        .pos = op->ui.pos,
+        .args = op->args,
+        .argCount = TL_OP_ARG_MAX_COUNT,
+    };
+    if (op->kind == TL_OPK_SKETCH) {
+        s.sketch = _tl_savedSketchFromSketch(&op->val.sketch, scratch);
+    } else if (op->kind == TL_OPK_BASE_GEOMETRY) {
+        s.faces = op->val.baseGeometry.elems;
+        s.faceCount = op->val.baseGeometry.count;
+    }
+    return s;
+}
+
+// everything but the ops + deletes
+static tl_SavedTimeline _tl_savedTimelineHeader(const tl_Timeline* t) {
+    return (tl_SavedTimeline){
+        .nextUniqueId = t->nextUniqueId,
+        .activeOpUid = t->activeOp ? t->activeOp->uniqueId : 0,
+        .camPos = t->camPos,
+        .camHeight = t->camHeight,
+    };
+}
+
+// every op in t that isn't marked for delete, saved ops go in scratch
+static tl_SavedTimeline _tl_savedTimelineSnapshot(const tl_Timeline* t, snz_Arena* scratch) {
+    tl_SavedTimeline saved = _tl_savedTimelineHeader(t);
+    tl_SavedOp* lastSaved = NULL;
+    for (tl_Op* op = t->firstOp; op; op = op->next) {
+        if (op->markedForDeletion) {
+            continue;
+        }
+        tl_SavedOp* s = SNZ_ARENA_PUSH(scratch, tl_SavedOp);
+        *s = _tl_savedOpFromOp(op, scratch);
+        if (lastSaved) {
+            lastSaved->next = s;
+        } else {
+            saved.firstOp = s;
+        }
+        lastSaved = s;
+    }
+    return saved;
+}
+
+// everything a record would have in it for op, so unlike the solve hash this includes where the node is
+static uint64_t _tl_opSaveHash(const tl_Op* op) {
+    uint64_t hash = _tl_hashOpInputs(14695981039346656037ULL, op);
+    hash = _TL_HASH_VAL(hash, op->ui.pos.X);
+    hash = _TL_HASH_VAL(hash, op->ui.pos.Y);
+    return _tl_hashFinish(hash);
+}
+
+#define _TL_RECORD_MAGIC 0x31304c5452444441ULL  // "ADDRTL01" in a little endian file
+
+// goes in front of every record in a timeline file, followed by byteCount bytes of ser_write output for a tl_SavedTimeline
+// FIXME: written raw, so files only work between machines with the same endianness
+typedef struct {
+    uint64_t magic;
+    uint64_t byteCount;
+    uint64_t hash; // of the bytes after this, for catching records that got cut off by a crash halfway thru writing
+} _tl_RecordHeader;
+
+// hashes the next byteCount bytes of f, false if there weren't that many
+static bool _tl_fileHashBytes(FILE* f, int64_t byteCount, uint64_t* outHash) {
+    uint8_t buf[4096];
+    uint64_t hash = 14695981039346656037ULL;
+    while (byteCount > 0) {
+        int64_t chunk = SNZ_MIN(byteCount, (int64_t)sizeof(buf));
+        if (fread(buf, 1, chunk, f) != (size_t)chunk) {
+            return false;
+        }
+        hash = _tl_hashBytes(hash, buf, chunk);
+        byteCount -= chunk;
+    }
+    *outHash = _tl_hashFinish(hash);
+    return true;
+}
+
+// writes saved as a record wherever f is, f has to be open for reading too because the record gets read back to hash it.
+// Leaves f at the end of the record and flushed.
+static ser_WriteError _tl_recordWrite(FILE* f, tl_SavedTimeline* saved, snz_Arena* scratch, int64_t* outByteCount) {
+    int64_t start = ftell(f);
+    _tl_RecordHeader header = (_tl_RecordHeader){ .magic = _TL_RECORD_MAGIC };
+    if (fwrite(&header, sizeof(header), 1, f) != 1) {
+        return SER_WE_WRITE_FAILED;
+    }
+    ser_WriteError err = ser_write(f, tl_SavedTimeline, saved, scratch);
+    if (err != SER_WE_OK) {
+        return err;
+    }
+
+    int64_t end = ftell(f);
+    header.byteCount = end - start - sizeof(header);
+    fseek(f, start + sizeof(header), SEEK_SET);
+    if (!_tl_fileHashBytes(f, header.byteCount, &header.hash)) {
+        return SER_WE_WRITE_FAILED;
+    }
+
+    // header last, so a crash anywhere before here leaves a record that fails its check instead of a wrong one
+    fseek(f, start, SEEK_SET);
+    if (fwrite(&header, sizeof(header), 1, f) != 1) {
+        return SER_WE_WRITE_FAILED;
+    }
+    fseek(f, end, SEEK_SET);
+    if (fflush(f) != 0) {
+        return SER_WE_WRITE_FAILED;
+    }
+    *outByteCount = end - start;
+    return SER_WE_OK;
+}
+
+// makes sure the record that starts wherever f is was written all the way, without reading what's in it.
+// fileSize is to catch byte counts that go off the end. On anything but SER_RE_OK, f could be anywhere.
+static ser_ReadError _tl_recordCheck(FILE* f, int64_t fileSize, _tl_RecordHeader* outHeader) {
+    int64_t start = ftell(f);
+    _tl_RecordHeader header = { 0 };
+    if (fread(&header, sizeof(header), 1, f) != 1) {
+        return SER_RE_READ_FAILED;
+    }
+    int64_t maxByteCount = fileSize - start - (int64_t)sizeof(header);
+    if (header.magic != _TL_RECORD_MAGIC || header.byteCount > (uint64_t)maxByteCount) {
+        return SER_RE_GARBAGE_DATA;
+    }
+
+    uint64_t hash = 0;
+    if (!_tl_fileHashBytes(f, header.byteCount, &hash)) {
+        return SER_RE_READ_FAILED;
+    } else if (hash != header.hash) {
+        return SER_RE_GARBAGE_DATA;
+    }
+    *outHeader = header;
+    return SER_RE_OK;
+}
+
+// reads the record that starts wherever f is, fileSize is to catch byte counts that go off the end.
+// On anything but SER_RE_OK, f could be anywhere.
+static ser_ReadError _tl_recordRead(FILE* f, int64_t fileSize, snz_Arena* arena, snz_Arena* scratch, tl_SavedTimeline** out, int64_t* outByteCount) {
+    int64_t start = ftell(f);
+    _tl_RecordHeader header = { 0 };
+    ser_ReadError checkErr = _tl_recordCheck(f, fileSize, &header);
+    if (checkErr != SER_RE_OK) {
+        return checkErr;
+    }
+
+    fseek(f, start + sizeof(header), SEEK_SET);
+    ser_ReadError err = ser_readSized(f, tl_SavedTimeline, header.byteCount, arena, scratch, (void**)out);
+    if (err != SER_RE_OK) {
+        return err;
+    }
+    *outByteCount = sizeof(header) + header.byteCount;
+    fseek(f, start + *outByteCount, SEEK_SET);
+    return SER_RE_OK;
+}
+
+// bumped for each _tl_savedSketchValid, elts it has seen get stamped with it
+static uint64_t _tl_lastSavedSketchCheck;
+
+// false if anything in s points somewhere it can't, which ser doesn't check (ptrs can go to anything of the right type
+// in the file, including stuff in other sketches). Numbers every elt with the slot it's going to be loaded into.
+static bool _tl_savedSketchValid(const tl_SavedSketch* s) {
+    _tl_lastSavedSketchCheck++;
+    uint64_t check = _tl_lastSavedSketchCheck;
+
+    // anything already stamped means the list looped back on itself
+    int64_t count = 0;
+    for (tl_SavedPoint* p = s->firstPoint; p; p = p->next) {
+        if (p->check == check) {
+            return false;
+        }
+        p->check = check;
+        p->slot = count;
+        count++;
+    }
+
+    count = 0;
+    for (tl_SavedLine* l = s->firstLine; l; l = l->next) {
+        if (l->check == check || !l->p1 || !l->p2 || l->p1->check != check || l->p2->check != check) {
+            return false;
+        }
+        l->check = check;
+        l->slot = count;
+        count++;
+    }
+
+    count = 0;
+    for (tl_SavedConstraint* c = s->firstConstraint; c; c = c->nextAllocated) {
+        bool valid = c->check != check && c->line1 && c->line1->check == check;
+        if (c->kind == SK_CK_ANGLE) {
+            valid &= c->line2 && c->line2->check == check;
+        } else {
+            valid &= c->kind == SK_CK_DISTANCE;
+        }
+        if (!valid) {
+            return false;
+        }
+        c->check = check;
+        c->slot = count;
+        count++;
+    }
+    return s->originPt && s->originPt->check == check && s->originLine && s->originLine->check == check;
+}
+
+// s has to have been checked by _tl_savedSketchValid. everything goes back in the slot it was saved from.
+static sk_Sketch _tl_sketchFromSaved(const tl_SavedSketch* s, snz_Arena* arena) {
+    sk_Sketch out = (sk_Sketch){
+        .arena = arena,
+        .nextUniqueId = s->nextUniqueId,
+        .originAngle = s->originAngle,
+    };
+    for (tl_SavedPoint* sp = s->firstPoint; sp; sp = sp->next) {
+        sk_Point* p = sk_sketchAllocPointAt(&out, sp->slot);
+        p->pos = sp->pos;
+        p->uniqueId = sp->uniqueId;
+    }
+    for (tl_SavedLine* sl = s->firstLine; sl; sl = sl->next) {
+        sk_Line* l = sk_sketchAllocLineAt(&out, sl->slot);
+        l->p1 = sk_sketchPointAt(&out, sl->p1->slot);
+        l->p2 = sk_sketchPointAt(&out, sl->p2->slot);
+        l->uniqueId = sl->uniqueId;
+    }
+    for (tl_SavedConstraint* sc = s->firstConstraint; sc; sc = sc->nextAllocated) {
+        sk_Constraint* c = sk_sketchAllocConstraintAt(&out, sc->slot);
+        c->kind = sc->kind;
+        c->line1 = sk_sketchLineAt(&out, sc->line1->slot);
+        c->line2 = sc->kind == SK_CK_ANGLE ? sk_sketchLineAt(&out, sc->line2->slot) : NULL;
+        c->flipLine1 = sc->flipLine1;
+        c->flipLine2 = sc->flipLine2;
+        c->value = sc->value;
+        c->uniqueId = sc->uniqueId;
+    }
+    out.originPt = sk_sketchPointAt(&out, s->originPt->slot);
+    out.originLine = sk_sketchLineAt(&out, s->originLine->slot);
+    sk_sketchMarkChanged(&out);
+    return out;
+}
+
+// replaces everything about op that gets saved with what's in s, solve + ui state stay (solving sees the new hash)
+static void _tl_opLoadSaved(tl_Op* op, const tl_SavedOp* s, snz_Arena* arena) {
+    op->kind = s->kind;
+    op->ui.pos = s->pos;
+    memset(op->args, 0, sizeof(op->args));
+    for (int64_t i = 0; i < s->argCount; i++) {
+        op->args[i] = s->args[i];
+    }
+
+    memset(&op->val, 0, sizeof(op->val));
+    if (s->kind == TL_OPK_SKETCH) {
+        op->val.sketch = _tl_sketchFromSaved(s->sketch, arena);
+    } else if (s->kind == TL_OPK_BASE_GEOMETRY) {
+        op->val.baseGeometry = (mesh_FaceSlice){ .elems = s->faces, .count = s->faceCount };
+    }
+}
+
+// applies one record on top of t, anything new gets allocated in arena. Ops the record has in it are edited in place,
+// so pointers to them stay good. Replaced sketches/faces are just left in arena, FIXME: which only a fresh load gets back.
+// false if something in the record can't be right, t is left alone if so
+static bool _tl_timelineApplySaved(tl_Timeline* t, const tl_SavedTimeline* saved, snz_Arena* arena, snz_Arena* scratch) {
+    for (tl_SavedOp* s = saved->firstOp; s; s = s->next) {
+        bool valid = s->uniqueId > 0 && s->uniqueId < saved->nextUniqueId;
+        valid &= s->kind > TL_OPK_NONE && s->kind < TL_OPK_COUNT;
+        valid &= s->argCount <= TL_OP_ARG_MAX_COUNT;
+        valid &= (s->kind == TL_OPK_SKETCH) == (s->sketch != NULL);
+        valid &= s->sketch == NULL || _tl_savedSketchValid(s->sketch);
+        if (!valid) {
+            SNZ_LOGF("Timeline file had a bad op, uid: %" PRId64 ".", s->uniqueId);
+            return false;
+        }
+    }
+
+    // the record has ops in list order, so new ones get linked in reverse. Usually that's just pushing each on the front,
+    // but an undo can bring back an op older than ones already here
+    SNZ_ARENA_ARR_BEGIN(scratch, tl_Op*);
+    for (tl_SavedOp* s = saved->firstOp; s; s = s->next) {
+        tl_Op* op = tl_timelineGetOpByUID(t, s->uniqueId);
+        if (!op) {
+            op = SNZ_ARENA_PUSH(arena, tl_Op);
+            op->uniqueId = s->uniqueId;
+            _tl_opTableInsert(&t->opTable, op);
+            *SNZ_ARENA_PUSH(scratch, tl_Op*) = op;
+        }
+        _tl_opLoadSaved(op, s, arena);
+    }
+    // ops edited in place can have moved or changed deps
+    tl_nodeGridMarkStale(t);
+    tl_OpPtrSlice added = SNZ_ARENA_ARR_END_NAMED(scratch, tl_Op*, tl_OpPtrSlice);
+    for (int64_t i = added.count - 1; i >= 0; i--) {
+        _tl_timelineLinkOp(t, added.elems[i]);
+    }
+
+    for (int64_t i = 0; i < saved->deletedCount; i++) {
+        tl_Op* op = tl_timelineGetOpByUID(t, saved->deletedUids[i].uid);
+        if (op) {
+            op->markedForDeletion = true;
+        }
+    }
+    tl_timelineCullOpsMarkedForDelete(t);
+
+    t->nextUniqueId = saved->nextUniqueId;
+    t->activeOp = tl_timelineGetOpByUID(t, saved->activeOpUid);
+    t->camPos = saved->camPos;
+    t->camHeight = saved->camHeight;
+    return true;
+}
+
+// reads the snapshot at the start of f, then replays every record after it. Stops at the first record that's cut off or
+// doesn't check out, and keeps whatever came before it (outTailBad gets set). Only fails when the snapshot itself is bad.
+// out is only written to when this returns SER_RE_OK. scratch gets popped back after each record.
+static ser_ReadError _tl_timelineReadRecords(FILE* f, snz_Arena* arena, snz_Arena* scratch, tl_Timeline* out,
+                                             int64_t* outSnapshotBytes, int64_t* outRecordBytes, int64_t* outRecordCount, bool* outTailBad) {
+    fseek(f, 0, SEEK_END);
+    int64_t fileSize = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    tl_SavedTimeline* saved = NULL;
+    ser_ReadError err = _tl_recordRead(f, fileSize, arena, scratch, &saved, outSnapshotBytes);
+    if (err != SER_RE_OK) {
+        return err;
+    }
+    tl_Timeline t = tl_timelineInit(arena);
+    if (!_tl_timelineApplySaved(&t, saved, arena, scratch)) {
+        free(t.opTable.slots);
+        return SER_RE_GARBAGE_DATA;
+    }
+
+    *outRecordBytes = 0;
+    *outRecordCount = 0;
+    *outTailBad = false;
+    while (*outSnapshotBytes + *outRecordBytes < fileSize) {
+        int64_t scratchUsed = snz_arenaUsedBytes(scratch);
+        int64_t byteCount = 0;
+        err = _tl_recordRead(f, fileSize, arena, scratch, &saved, &byteCount);
+        if (err != SER_RE_OK || !_tl_timelineApplySaved(&t, saved, arena, scratch)) {
+            SNZ_LOGF("Timeline file had a bad record after %" PRId64 " good ones, dropping everything after. code: %d",
+                     *outRecordCount, err);
+            *outTailBad = true;
+            break;
+        }
+        *outRecordBytes += byteCount;
+        (*outRecordCount)++;
+        snz_arenaPop(scratch, snz_arenaUsedBytes(scratch) - scratchUsed);
+    }
+
+    *out = t;
+    return SER_RE_OK;
+}
+
+// snapshot of everything in t that isn't derived from solving, ops marked for delete are left out.
+// f has to be open for reading and writing ("w+b"), see _tl_recordWrite. tl_timelineSpec has to be in the global ser spec.
+ser_WriteError tl_timelineWrite(const tl_Timeline* t, FILE* f, snz_Arena* scratch) {
+    tl_SavedTimeline saved = _tl_savedTimelineSnapshot(t, scratch);
+    int64_t byteCount = 0;
+    return _tl_recordWrite(f, &saved, scratch, &byteCount);
+}
+
+// everything read (ops, sketch elts, base geometry) goes in arena, which is retained as the op arena of the new
+// timeline and the arena of every sketch in it. Nothing comes back solved. Journal records after the snapshot
+// get replayed, see tl_Journal.
+// out is only written to when this returns SER_RE_OK
+ser_ReadError tl_timelineRead(FILE* f, snz_Arena* arena, snz_Arena* scratch, tl_Timeline* out) {
+    int64_t snapshotBytes = 0, recordBytes = 0, recordCount = 0;
+    bool tailBad = false;
+    return _tl_timelineReadRecords(f, arena, scratch, out, &snapshotBytes, &recordBytes, &recordCount, &tailBad);
+}
+
+// the journal gets rewritten as one snapshot once the records after the snapshot are this many times bigger than it,
+// so any one save stays proportional to the edit and the file stays proportional to the timeline
+#define TL_JOURNAL_COMPACT_RATIO 2
+#define TL_JOURNAL_SCRATCH_BLOCK_SIZE 1000000
+
+/*
+TL_JOURNAL:
+keeps a timeline file up to date without rewriting the whole thing on every save. The file is a snapshot record
+followed by edit records (see tl_SavedTimeline), tl_journalAppend writes only the ops that changed since the last
+record + uids of ones that got deleted. Loading replays all of them, and a record that got cut off by a crash
+just gets dropped with everything after it.
+
+Ops remember what they looked like when they were last written in op->savedHash, which is what makes the append
+proportional to the edit. Finding the changes still hashes every op in memory, same as solving does.
+
+Compacting writes the new snapshot to path + ".tmp" and then swaps it in over path in one move. Opening picks up
+a temp file that was finished but never got moved (a crash right between the two), and throws out one that wasn't.
+*/
+typedef struct {
+    FILE* file; // open for read + write, null if the last compact failed
+    const char* path; // retained
+    snz_Arena scratch; // growable, so any size record can be built or read back. Cleared at the start of every call
+    _tl_OpTable savedOps; // uid of every op as of the last record, the op pointers in here are always null
+    tl_SavedTimeline savedHeader; // no ops or deletes, the rest as of the last record
+    int64_t snapshotBytes;
+    int64_t recordBytes; // everything after the snapshot
+    int64_t recordCount;
+} tl_Journal;
+
+// cleared, or made the first time thru
+static snz_Arena* _tl_journalScratch(tl_Journal* j) {
+    if (!j->scratch.start) {
+        j->scratch = snz_arenaInitGrowable(TL_JOURNAL_SCRATCH_BLOCK_SIZE, "tl journal scratch");
+    } else {
+        snz_arenaClear(&j->scratch);
+    }
+    return &j->scratch;
+}
+
+// puts from where to is, replacing whatever was there in one step. A crash leaves one or the other, never neither
+static bool _tl_fileReplace(const char* from, const char* to) {
+#ifdef _WIN32
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(from, to) == 0;  // already replaces atomically
+#endif
+}
+
+// all of ts ops are the saved versions after this
+static void _tl_journalMarkSaved(tl_Journal* j, tl_Timeline* t) {
+    free(j->savedOps.slots);
+    j->savedOps = (_tl_OpTable){ 0 };
+    for (tl_Op* op = t->firstOp; op; op = op->next) {
+        op->savedHash = _tl_opSaveHash(op);
+        _tl_opTableInsertSlot(&j->savedOps, (_tl_OpTableSlot){ .uid = op->uniqueId });
+    }
+    j->savedHeader = _tl_savedTimelineHeader(t);
+}
+
+// (re)writes the file at path as a snapshot of t, and points j at it. Goes thru a temp file so a crash while writing
+// never loses the old one. False + logs when it can't, j->file is null after that and appends fail until this works.
+// path is retained.
+bool tl_journalCreate(tl_Journal* j, const char* path, tl_Timeline* t) {
+    if (j->file) {
+        fclose(j->file);
+        j->file = NULL;
+    }
+    j->path = path;
+    snz_Arena* scratch = _tl_journalScratch(j);
+
+    const char* tempPath = snz_arenaFormatStr(scratch, "%s.tmp", path);
+    FILE* f = fopen(tempPath, "w+b");
+    if (!f) {
+        SNZ_LOGF("Opening timeline file to write at %s failed.", tempPath);
+        return false;
+    }
+    tl_SavedTimeline saved = _tl_savedTimelineSnapshot(t, scratch);
+    int64_t byteCount = 0;
+    ser_WriteError err = _tl_recordWrite(f, &saved, scratch, &byteCount);
+    fclose(f);
+    if (err != SER_WE_OK) {
+        SNZ_LOGF("Writing timeline snapshot to %s failed, code: %d", tempPath, err);
+        remove(tempPath);
+        return false;
+    }
+
+    if (!_tl_fileReplace(tempPath, path)) {
+        SNZ_LOGF("Moving timeline snapshot from %s to %s failed.", tempPath, path);
+        return false;
+    }
+    j->file = fopen(path, "r+b");
+    if (!j->file) {
+        SNZ_LOGF("Opening timeline file at %s failed.", path);
+        return false;
+    }
+    fseek(j->file, 0, SEEK_END);
+
+    j->snapshotBytes = byteCount;
+    j->recordBytes = 0;
+    j->recordCount = 0;
+    _tl_journalMarkSaved(j, t);
+    return true;
+}
+
+static bool _tl_journalShouldCompact(const tl_Journal* j) {
+    return j->recordBytes > j->snapshotBytes * TL_JOURNAL_COMPACT_RATIO;
+}
+
+// the temp file from a tl_journalCreate that crashed before moving it over path. If it's all there it's newer than
+// whatever is at path, so it gets moved there. If it got cut off it's thrown out.
+static void _tl_journalRecoverTemp(const char* path, snz_Arena* scratch) {
+    const char* tempPath = snz_arenaFormatStr(scratch, "%s.tmp", path);
+    FILE* f = fopen(tempPath, "rb");
+    if (!f) {
+        return;
+    }
+    fseek(f, 0, SEEK_END);
+    int64_t fileSize = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    _tl_RecordHeader header = { 0 };
+    bool complete = _tl_recordCheck(f, fileSize, &header) == SER_RE_OK;
+    complete &= (int64_t)(sizeof(header) + header.byteCount) == fileSize;  // never anything but the one snapshot
+    fclose(f);
+
+    if (complete && _tl_fileReplace(tempPath, path)) {
+        SNZ_LOGF("Recovered timeline file at %s from %s.", path, tempPath);
+    } else {
+        remove(tempPath);
+    }
+}
+
+// loads the timeline at path into out (see tl_timelineRead for arenas) and keeps it open for appending.
+// If the end of the file was bad or it's due for a compact, it gets rewritten as a snapshot right here.
+// j should be zeroed or closed, and is only usable when this returns SER_RE_OK. path is retained.
+ser_ReadError tl_journalOpen(tl_Journal* j, const char* path, snz_Arena* arena, tl_Timeline* out) {
+    *j = (tl_Journal){ .path = path };
+    snz_Arena* scratch = _tl_journalScratch(j);
+    _tl_journalRecoverTemp(path, scratch);
+    FILE* f = fopen(path, "r+b");
+    if (!f) {
+        snz_arenaDeinit(&j->scratch);
+        return SER_RE_READ_FAILED;
+    }
+
+    bool tailBad = false;
+    ser_ReadError err = _tl_timelineReadRecords(f, arena, scratch, out, &j->snapshotBytes, &j->recordBytes, &j->recordCount, &tailBad);
+    if (err != SER_RE_OK) {
+        fclose(f);
+        snz_arenaDeinit(&j->scratch);
+        return err;
+    }
+    j->file = f;
+
+    if (tailBad || _tl_journalShouldCompact(j)) {
+        // rewriting also throws out the bad tail, so nothing gets appended after garbage
+        tl_journalCreate(j, path, out);
+    } else {
+        fseek(f, j->snapshotBytes + j->recordBytes, SEEK_SET);
+        _tl_journalMarkSaved(j, out);
+    }
+    return SER_RE_OK;
+}
+
+// one op going into an append, saved has to be first so these link like tl_SavedOps
+typedef struct {
+    tl_SavedOp saved;
+    tl_Op* op;
+    uint64_t hash;
+} _tl_JournalChange;
+
+// appends a record of everything in t that changed since the last one, ops marked for deletion should be culled first.
+// The camera is left out unless includeCam is set, it changes too often to be worth a record by itself.
+// Compacts if the journal is due for it.
+// returns bytes appended, zero when nothing changed, -1 when writing failed (logged, the next append tries again)
+int64_t tl_journalAppend(tl_Journal* j, tl_Timeline* t, bool includeCam) {
+    if (!j->file) {
+        return -1;
+    }
+    snz_Arena* scratch = _tl_journalScratch(j);
+
+    tl_SavedTimeline record = _tl_savedTimelineHeader(t);
+    if (!includeCam) {
+        record.camPos = j->savedHeader.camPos;
+        record.camHeight = j->savedHeader.camHeight;
+    }
+    bool anyChanges = record.nextUniqueId != j->savedHeader.nextUniqueId;
+    anyChanges |= record.activeOpUid != j->savedHeader.activeOpUid;
+    anyChanges |= record.camHeight != j->savedHeader.camHeight;
+    anyChanges |= !HMM_EqV2(record.camPos, j->savedHeader.camPos);
+
+    _tl_JournalChange* lastChange = NULL;
+    for (tl_Op* op = t->firstOp; op; op = op->next) {
+        SNZ_ASSERTF(!op->markedForDeletion, "journal append with op %" PRId64 " still marked for deletion.", op->uniqueId);
+        uint64_t hash = _tl_opSaveHash(op);
+        if (hash == op->savedHash) {
+            continue;
+        }
+        _tl_JournalChange* change = SNZ_ARENA_PUSH(scratch, _tl_JournalChange);
+        *change = (_tl_JournalChange){ .saved = _tl_savedOpFromOp(op, scratch), .op = op, .hash = hash };
+        if (lastChange) {
+            lastChange->saved.next = &change->saved;
+        } else {
+            record.firstOp = &change->saved;
+        }
+        lastChange = change;
+    }
+
+    SNZ_ARENA_ARR_BEGIN(scratch, tl_SavedUid);
+    for (int64_t i = 0; i < j->savedOps.capacity; i++) {
+        int64_t uid = j->savedOps.slots[i].uid;
+        if (uid && !tl_timelineGetOpByUID(t, uid)) {
+            SNZ_ARENA_PUSH(scratch, tl_SavedUid)->uid = uid;
+        }
+    }
+    tl_SavedUidSlice deleted = SNZ_ARENA_ARR_END(scratch, tl_SavedUid);
+    record.deletedUids = deleted.elems;
+    record.deletedCount = deleted.count;
+
+    anyChanges |= record.firstOp != NULL || record.deletedCount > 0;
+    if (!anyChanges) {
+        return 0;
+    }
+
+    // anything after the last good record is from an append that failed partway
+    fseek(j->file, j->snapshotBytes + j->recordBytes, SEEK_SET);
+    int64_t byteCount = 0;
+    ser_WriteError err = _tl_recordWrite(j->file, &record, scratch, &byteCount);
+    if (err != SER_WE_OK) {
+        SNZ_LOGF("Appending to timeline journal at %s failed, code: %d", j->path, err);
+        return -1;
+    }
+    j->recordBytes += byteCount;
+    j->recordCount++;
+
+    for (int64_t i = 0; i < record.deletedCount; i++) {
+        _tl_opTableRemove(&j->savedOps, record.deletedUids[i].uid);
+    }
+    for (_tl_JournalChange* c = (_tl_JournalChange*)record.firstOp; c; c = (_tl_JournalChange*)c->saved.next) {
+        if (_tl_opTableFind(&j->savedOps, c->op->uniqueId) < 0) {
+            _tl_opTableInsertSlot(&j->savedOps, (_tl_OpTableSlot){ .uid = c->op->uniqueId });
+        }
+        c->op->savedHash = c->hash;
+    }
+    j->savedHeader = record;
+    j->savedHeader.firstOp = NULL;
+    j->savedHeader.deletedUids = NULL;
+    j->savedHeader.deletedCount = 0;
+
+    if (_tl_journalShouldCompact(j)) {
+        if (!tl_journalCreate(j, j->path, t)) {
+            return -1;
+        }
+    }
+    return byteCount;
+}
+
+void tl_journalClose(tl_Journal* j) {
+    if (j->file) {
+        fclose(j->file);
+    }
+    free(j->savedOps.slots);
+    if (j->scratch.start) {
+        snz_arenaDeinit(&j->scratch);
+    }
+    memset(j, 0, sizeof(*j));
+}
+
+static const mesh_Face* _tl_testTopFace(const tl_Op* op) {
+    const mesh_Face* out = NULL;
+    float maxY = -INFINITY;
+    for (int64_t i = 0; i < op->solve.faces->count; i++) {
+        const mesh_Face* f = &op->solve.faces->elems[i];
+        geo_Tri t = f->tris.elems[0];
+        if (geo_triNormal(t).Y > 0.99 && t.a.Y > maxY) {
+            maxY = t.a.Y;
+            out = f;
+        }
+    }
+    return out;
+}
+
+// branchCount cubes each extruded depth times, solved as they get pushed. Branches never meet.
+static void _tl_testPushBranches(tl_Timeline* tl, int branchCount, int depth, snz_Arena* scratch) {
+    for (int branch = 0; branch < branchCount; branch++) {
+        tl_Op* prev = tl_timelinePushBaseGeometry(tl, HMM_V2(0, 0), mesh_cube(tl->operationArena));
+        snz_arenaClear(scratch);
+        tl_solveOp(tl, prev, scratch);
+        for (int i = 0; i < depth; i++) {
+            tl_Op* op = tl_timelinePushExtrude(tl, HMM_V2(0, 0));
+            const mesh_Face* top = _tl_testTopFace(prev);
+            op->args[0] = (tl_OpArg){ .kind = TL_OPAK_GEOID_FACE, .geoId = *mesh_geoIdDuplicate(&top->id, tl->operationArena) };
+            op->args[1] = (tl_OpArg){ .kind = TL_OPAK_NUMBER, .number = 1 + branch };
+            snz_arenaClear(scratch);
+            tl_solveOp(tl, op, scratch);
+            prev = op;
+        }
+    }
+}
+
+// checksum of every vert in faces (weighted by where they are in the list), to compare two solves of the same thing
+static double _tl_testFacesSum(const mesh_FaceSlice* faces) {
+    double sum = faces->count;
+    for (int64_t i = 0; i < faces->count; i++) {
+        geo_TriSlice tris = faces->elems[i].tris;
+        for (int64_t j = 0; j < tris.count; j++) {
+            for (int k = 0; k < 3; k++) {
+                HMM_Vec3 v = tris.elems[j].elems[k];
+                sum += (j + 1) * (v.X + 2 * v.Y + 3 * v.Z);
+            }
+        }
+    }
+    return sum;
+}
+
+// everything that gets saved matches, in the same order. Doesn't look at solves.
+static bool _tl_testTimelinesMatch(tl_Timeline* a, tl_Timeline* b) {
+    bool correct = a->nextUniqueId == b->nextUniqueId;
+    correct &= (a->activeOp ? a->activeOp->uniqueId : 0) == (b->activeOp ? b->activeOp->uniqueId : 0);
+    tl_Op* opB = b->firstOp;
+    for (tl_Op* opA = a->firstOp; opA; opA = opA->next) {
+        if (!opB) {
+            return false;
+        }
+        correct &= opA->uniqueId == opB->uniqueId && opA->kind == opB->kind;
+        correct &= HMM_EqV2(opA->ui.pos, opB->ui.pos);
+        for (int i = 0; i < TL_OP_ARG_MAX_COUNT; i++) {
+            correct &= opA->args[i].kind == opB->args[i].kind && opA->args[i].number == opB->args[i].number;
+            correct &= opA->args[i].geoId.opUniqueId == opB->args[i].geoId.opUniqueId;
+        }
+        if (opA->kind == TL_OPK_SKETCH) {
+            sk_Point* pB = sk_sketchFirstPoint(&opB->val.sketch);
+            for (sk_Point* pA = sk_sketchFirstPoint(&opA->val.sketch); pA; pA = sk_sketchNextPoint(&opA->val.sketch, pA)) {
+                correct &= pB && pA->uniqueId == pB->uniqueId && pA->slot == pB->slot && HMM_EqV2(pA->pos, pB->pos);
+                pB = pB ? sk_sketchNextPoint(&opB->val.sketch, pB) : NULL;
+            }
+            correct &= pB == NULL;
+        } else if (opA->kind == TL_OPK_BASE_GEOMETRY) {
+            correct &= _tl_testFacesSum(&opA->val.baseGeometry) == _tl_testFacesSum(&opB->val.baseGeometry);
+        }
+        opB = opB->next;
+    }
+    return correct && opB == NULL;
+}
+
+// forgets every solve so the next one redoes everything
+static void _tl_testUnsolve(tl_Timeline* tl) {
+    for (tl_Op* op = tl->firstOp; op; op = op->next) {
+        op->solve.hash = 0;
+    }
+}
+
+// joins whatever solve is going once it's done, true if it had a scene that would have been swapped in
+static bool _tl_testWaitForSolve(tl_Timeline* tl) {
+    while (tl->solveJob.thread) {
+        if (_tl_solveCollect(tl)) {
+            return true;
+        }
+        SDL_Delay(1);
+    }
+    return _tl_solveCollect(tl);
+}
+
+// liang-barsky, true if any of the segment is inside the rect
+static bool _tl_testSegmentHitsRect(HMM_Vec2 a, HMM_Vec2 b, HMM_Vec2 min, HMM_Vec2 max) {
+    float tMin = 0;
+    float tMax = 1;
+    HMM_Vec2 d = HMM_Sub(b, a);
+    for (int ax = 0; ax < 2; ax++) {
+        if (d.Elements[ax] == 0) {
+            if (a.Elements[ax] < min.Elements[ax] || a.Elements[ax] > max.Elements[ax]) {
+                return false;
+            }
+            continue;
+        }
+        float t1 = (min.Elements[ax] - a.Elements[ax]) / d.Elements[ax];
+        float t2 = (max.Elements[ax] - a.Elements[ax]) / d.Elements[ax];
+        tMin = SNZ_MAX(tMin, SNZ_MIN(t1, t2));
+        tMax = SNZ_MIN(tMax, SNZ_MAX(t1, t2));
+    }
+    return tMin <= tMax;
+}
+
+// everything that should come out of a query on the rect has to, and nothing more than once
+static bool _tl_testNodeGridQueryCorrect(tl_Timeline* tl, HMM_Vec2 min, HMM_Vec2 max, snz_Arena* scratch) {
+    tl_OpPtrSlice found = tl_nodeGridQuery(tl, min, max, scratch);
+    bool correct = true;
+    for (int64_t i = 1; i < found.count; i++) {
+        correct &= found.elems[i - 1]->uniqueId > found.elems[i]->uniqueId;
+    }
+
+    HMM_Vec2 margin = HMM_V2(TL_NODE_GRID_MARGIN, TL_NODE_GRID_MARGIN);
+    for (tl_Op* op = tl->firstOp; op; op = op->next) {
+        bool shouldBeFound = _tl_testSegmentHitsRect(op->ui.pos, op->ui.pos, HMM_Sub(min, margin), HMM_Add(max, margin));
+        tl_Op* dependency = tl_timelineGetOpByUID(tl, op->args[0].geoId.opUniqueId);
+        if (dependency) {
+            shouldBeFound |= _tl_testSegmentHitsRect(op->ui.pos, dependency->ui.pos, min, max);
+        }
+        if (shouldBeFound) {
+            bool wasFound = false;
+            for (int64_t i = 0; i < found.count; i++) {
+                wasFound |= found.elems[i] == op;
+            }
+            correct &= wasFound;
+        }
+    }
+    return correct;
+}
+
+void tl_tests() {
+    snz_testPrintSection("timeline");
+
+    snz_Arena opArena = snz_arenaInit(100000000, "tl test op arena");
+    snz_Arena scratch = snz_arenaInit(100000000, "tl test scratch arena");
+    tl_Timeline tl = tl_timelineInit(&opArena);
+
+    // 50 ops, each extruding the top of the last by 1
+    const int opCount = 50;
+    tl_Op** ops = SNZ_ARENA_PUSH_ARR(&opArena, opCount, tl_Op*);
+    ops[0] = tl_timelinePushBaseGeometry(&tl, HMM_V2(0, 0), mesh_cube(&opArena));
+    clock_t start = clock();
+    tl_solveOp(&tl, ops[0], &scratch);
+    for (int i = 1; i < opCount; i++) {
+        ops[i] = tl_timelinePushExtrude(&tl, HMM_V2(0, 0));
+        const mesh_Face* top = _tl_testTopFace(ops[i - 1]);
+        ops[i]->args[0] = (tl_OpArg){ .kind = TL_OPAK_GEOID_FACE, .geoId = *mesh_geoIdDuplicate(&top->id, &opArena) };
+        ops[i]->args[1] = (tl_OpArg){ .kind = TL_OPAK_NUMBER, .number = 1 };
+        snz_arenaClear(&scratch);
+        tl_solveOp(&tl, ops[i], &scratch);
+    }
+    double fullTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+    float ogTopY = _tl_testTopFace(ops[opCount - 1])->tris.elems[0].a.Y;
+
+    {
+        snz_arenaClear(&scratch);
+        tl_solveOp(&tl, ops[opCount - 1], &scratch);
+        bool noneSolved = true;
+        for (int i = 0; i < opCount; i++) {
+            noneSolved &= ops[i]->solve.timesSolved == 1;
+        }
+        snz_testPrint(noneSolved, "unchanged timeline doesn't re-solve");
+    }
+
+    {
+        ops[opCount - 1]->args[1].number = 2;
+        snz_arenaClear(&scratch);
+        start = clock();
+        tl_solveOp(&tl, ops[opCount - 1], &scratch);
+        double editTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+        bool onlyLastSolved = ops[opCount - 1]->solve.timesSolved == 2;
+        for (int i = 0; i < opCount - 1; i++) {
+            onlyLastSolved &= ops[i]->solve.timesSolved == 1;
+        }
+        float newTopY = _tl_testTopFace(ops[opCount - 1])->tris.elems[0].a.Y;
+        snz_testPrint(onlyLastSolved && geo_floatEqual(newTopY, ogTopY + 1), "editing last op only re-solves it");
+        SNZ_LOGF("%d op timeline: building + solving each %.3fs, re-solve after editing the last %.3fs", opCount, fullTime, editTime);
+    }
+
+    {
+        int mid = opCount / 2;
+        ops[mid]->args[1].number = 2;
+        snz_arenaClear(&scratch);
+        tl_solveOp(&tl, ops[opCount - 1], &scratch);
+
+        bool correct = true;
+        for (int i = 0; i < opCount; i++) {
+            int64_t expected = 1 + (i >= mid) + (i == opCount - 1);
+            correct &= ops[i]->solve.timesSolved == expected;
+        }
+        float newTopY = _tl_testTopFace(ops[opCount - 1])->tris.elems[0].a.Y;
+        snz_testPrint(correct && geo_floatEqual(newTopY, ogTopY + 2), "editing a middle op re-solves everything after it");
+    }
+
+    tl_timelineDeinit(&tl);
+    snz_arenaClear(&opArena);
+
+    {
+        tl = tl_timelineInit(&opArena);
+        tl_Op* cube = tl_timelinePushBaseGeometry(&tl, HMM_V2(0, 0), mesh_cube(&opArena));
+        snz_arenaClear(&scratch);
+        tl_solveOp(&tl, cube, &scratch);
+
+        // 2 wide cube, 4 copies going up 3 at a time, so none of them touch
+        tl_Op* linear = tl_timelinePushPattern(&tl, HMM_V2(0, 0), TL_OPK_LINEAR_PATTERN);
+        const mesh_Face* top = _tl_testTopFace(cube);
+        linear->args[0] = (tl_OpArg){ .kind = TL_OPAK_GEOID_FACE, .geoId = *mesh_geoIdDuplicate(&top->id, &opArena) };
+        linear->args[1] = (tl_OpArg){ .kind = TL_OPAK_NUMBER, .number = 4 };
+        linear->args[2] = (tl_OpArg){ .kind = TL_OPAK_NUMBER, .number = 3 };
+        snz_arenaClear(&scratch);
+        bool correct = tl_solveOp(&tl, linear, &scratch);
+        correct &= linear->solve.instances->count == 4;
+        correct &= linear->solve.faces->count == 4 * 6;
+        correct &= geo_floatEqual(_tl_testTopFace(linear)->tris.elems[0].a.Y, 10);
+        correct &= cube->solve.timesSolved == 1;
+
+        // copies are the same shape as the original, but each one is a different face
+        const mesh_Face* topCopy = _tl_testTopFace(linear);
+        correct &= topCopy->id.opUniqueId == linear->uniqueId && topCopy->id.baseNodeId == 4;
+        correct &= _mesh_geoIdEqual(*topCopy->id.diffGeo1, top->id);
+
+        mesh_Scene scene = mesh_sceneInitInstanced(linear->solve.faces, linear->solve.tempGeo,
+                                                   cube->solve.faces, *linear->solve.instances, &scratch, &scratch);
+        correct &= scene.instances.count == 4 && scene.faces.count == 4 * 6;
+        correct &= scene.lodVerts[0].count == 12 * 3;
+        snz_testPrint(correct, "linear pattern solves the source once and keeps render verts for one copy");
+
+        // overlapping now, should come out the same as unioning every copy one at a time
+        linear->args[2].number = 1.5f;
+        snz_arenaClear(&scratch);
+        correct = tl_solveOp(&tl, linear, &scratch);
+        correct &= cube->solve.timesSolved == 1 && linear->solve.timesSolved == 2;
+        mesh_FaceSlice expected = *cube->solve.faces;
+        for (int i = 1; i < 4; i++) {
+            mesh_FaceSlice copy = mesh_facesDuplicate(*cube->solve.faces, &opArena);
+            mesh_facesTranslate(copy, HMM_V3(0, 1.5f * i, 0));
+            expected = csg_facesUnion(&expected, &copy, &opArena, &scratch);
+        }
+        double areaDiff = 0;
+        for (int64_t i = 0; i < linear->solve.faces->count; i++) {
+            for (int64_t j = 0; j < linear->solve.faces->elems[i].tris.count; j++) {
+                areaDiff += geo_triArea(linear->solve.faces->elems[i].tris.elems[j]);
+            }
+        }
+        for (int64_t i = 0; i < expected.count; i++) {
+            for (int64_t j = 0; j < expected.elems[i].tris.count; j++) {
+                areaDiff -= geo_triArea(expected.elems[i].tris.elems[j]);
+            }
+        }
+        correct &= fabs(areaDiff) < 0.001;
+        snz_testPrint(correct, "overlapping linear pattern matches unioning each copy");
+
+        // half turn around one of the vertical edges, only the edge touches
+        tl_Op* circular = tl_timelinePushPattern(&tl, HMM_V2(0, 0), TL_OPK_CIRCULAR_PATTERN);
+        const mesh_Edge* axis = NULL;
+        for (const mesh_Edge* e = cube->solve.tempGeo->firstEdge; e; e = e->next) {
+            HMM_Vec3 a = e->points.elems[0];
+            HMM_Vec3 b = e->points.elems[e->points.count - 1];
+            if (geo_floatEqual(a.X, 1) && geo_floatEqual(a.Z, 1) && geo_floatEqual(b.X, 1) && geo_floatEqual(b.Z, 1)) {
+                axis = e;
+            }
+        }
+        circular->args[0] = (tl_OpArg){ .kind = TL_OPAK_GEOID_EDGE, .geoId = *mesh_geoIdDuplicate(&axis->id, &opArena) };
+        circular->args[1] = (tl_OpArg){ .kind = TL_OPAK_NUMBER, .number = 2 };
+        circular->args[2] = (tl_OpArg){ .kind = TL_OPAK_NUMBER, .number = 180 };
+        snz_arenaClear(&scratch);
+        correct = tl_solveOp(&tl, circular, &scratch);
+        geo_AABB bounds = geo_aabbEmpty();
+        for (int64_t i = 0; i < circular->solve.faces->count; i++) {
+            geo_AABB faceBounds = geo_aabbFromTris(circular->solve.faces->elems[i].tris);
+            geo_aabbAddPt(&bounds, faceBounds.min);
+            geo_aabbAddPt(&bounds, faceBounds.max);
+        }
+        correct &= circular->solve.faces->count == 2 * 6;
+        correct &= geo_v3Equal(bounds.min, HMM_V3(-1, -1, -1)) && geo_v3Equal(bounds.max, HMM_V3(3, 1, 3));
+        snz_testPrint(correct, "circular pattern turns copies around an edge");
+
+        tl_timelineDeinit(&tl);
+        snz_arenaClear(&opArena);
+    }
+
+    {
+        tl = tl_timelineInit(&opArena);
+        // a <- b <- c, d <-> e, e <- f, missing <- g <- h
+        tl_Op* a = tl_timelinePushBaseGeometry(&tl, HMM_V2(0, 0), mesh_cube(&opArena));
+        tl_Op* chain[7] = { 0 };
+        for (int i = 0; i < 7; i++) {
+            chain[i] = tl_timelinePushExtrude(&tl, HMM_V2(0, 0));
+            chain[i]->args[1] = (tl_OpArg){ .kind = TL_OPAK_NUMBER, .number = 1 };
+        }
+        tl_Op* b = chain[0], * c = chain[1], * d = chain[2], * e = chain[3], * f = chain[4], * g = chain[5], * h = chain[6];
+        tl_Op* deps[][2] = { { b, a }, { c, b }, { d, e }, { e, d }, { f, e }, { h, g } };
+        for (int i = 0; i < 6; i++) {
+            deps[i][0]->args[0] = (tl_OpArg){ .kind = TL_OPAK_GEOID_FACE, .geoId = { .geoKind = MESH_GK_FACE, .opUniqueId = deps[i][1]->uniqueId } };
+        }
+        g->args[0] = (tl_OpArg){ .kind = TL_OPAK_GEOID_FACE, .geoId = { .geoKind = MESH_GK_FACE, .opUniqueId = 9999 } };
+
+        snz_arenaClear(&scratch);
+        bool ok = false;
+        tl_OpPtrSlice order = _tl_opsSchedule(&tl, c, &scratch, &ok);
+        bool correct = ok && order.count == 3 && order.elems[0] == a && order.elems[1] == b && order.elems[2] == c;
+        snz_testPrint(correct, "schedule orders deps first");
+
+        snz_arenaClear(&scratch);
+        tl_timelineCheckDependencies(&tl, &scratch);
+        correct = !a->error.kind && !b->error.kind && !c->error.kind;
+        correct &= d->error.kind == TL_OPEK_CYCLE && e->error.kind == TL_OPEK_CYCLE;
+        correct &= f->error.kind == TL_OPEK_DEP_HAS_ERROR && f->error.argIdx == 0;
+        correct &= g->error.kind == TL_OPEK_MISSING_DEP && g->error.argIdx == 0;
+        correct &= h->error.kind == TL_OPEK_DEP_HAS_ERROR;
+        snz_testPrint(correct, "schedule errors on cycles & missing deps");
+
+        snz_arenaClear(&scratch);
+        correct = !tl_solveOp(&tl, f, &scratch) && f->solve.timesSolved == 0 && d->solve.timesSolved == 0;
+        snz_arenaClear(&scratch);
+        correct &= !tl_solveOp(&tl, h, &scratch) && h->solve.timesSolved == 0;
+        snz_testPrint(correct, "ops with dependency errors don't solve");
+        tl_timelineDeinit(&tl);
+        snz_arenaClear(&opArena);
+    }
+
+    {
+        tl = tl_timelineInit(&opArena);
+        _tl_testPushBranches(&tl, 4, 4, &scratch);
+        int64_t opCount = 0;
+        for (tl_Op* op = tl.firstOp; op; op = op->next) {
+            opCount++;
+        }
+        int64_t* serialFaceCounts = SNZ_ARENA_PUSH_ARR(&opArena, opCount, int64_t);
+        float* serialTopYs = SNZ_ARENA_PUSH_ARR(&opArena, opCount, float);
+        int64_t i = 0;
+        for (tl_Op* op = tl.firstOp; op; op = op->next, i++) {
+            serialFaceCounts[i] = op->solve.faces->count;
+            serialTopYs[i] = _tl_testTopFace(op)->tris.elems[0].a.Y;
+        }
+
+        job_System* jobs = job_systemInit(3, 100000000);
+        tl.jobs = jobs;
+        _tl_testUnsolve(&tl);
+        snz_arenaClear(&scratch);
+        bool correct = tl_solveOp(&tl, NULL, &scratch);
+        i = 0;
+        for (tl_Op* op = tl.firstOp; op; op = op->next, i++) {
+            correct &= op->solve.timesSolved == 2 && op->solve.hash != 0;
+            correct &= op->solve.faces->count == serialFaceCounts[i];
+            correct &= geo_floatEqual(_tl_testTopFace(op)->tris.elems[0].a.Y, serialTopYs[i]);
+        }
+        snz_testPrint(correct, "wide solve on jobs matches serial");
+
+        {
+            // firstOp is the last op pushed, so the end of the last branch
+            const mesh_FaceSlice** facesBefore = SNZ_ARENA_PUSH_ARR(&opArena, opCount, const mesh_FaceSlice*);
+            i = 0;
+            for (tl_Op* op = tl.firstOp; op; op = op->next, i++) {
+                facesBefore[i] = op->solve.faces;
+            }
+            tl.firstOp->args[1].number += 1;
+            snz_arenaClear(&scratch);
+            correct = tl_solveOp(&tl, NULL, &scratch);
+            correct &= tl.firstOp->solve.timesSolved == 3;
+            i = 0;
+            for (tl_Op* op = tl.firstOp->next; op; op = op->next) {
+                i++;
+                correct &= op->solve.faces == facesBefore[i] && op->solve.timesSolved == 2;
+                correct &= op->solve.faces->count == serialFaceCounts[i];
+            }
+            snz_testPrint(correct, "re-solving one op leaves everyone elses memory alone");
+        }
+
+        {
+            bool correct = true;
+            for (tl_Op* op = tl.firstOp; op; op = op->next) {
+                correct &= !op->solve.stats.valid;
+            }
+            tl.recordSolveStats = true;
+            _tl_testUnsolve(&tl);
+            snz_arenaClear(&scratch);
+            tl_solveOp(&tl, NULL, &scratch);
+            for (tl_Op* op = tl.firstOp; op; op = op->next) {
+                int64_t triCount = 0;
+                for (int64_t j = 0; j < op->solve.faces->count; j++) {
+                    triCount += op->solve.faces->elems[j].tris.count;
+                }
+                correct &= op->solve.stats.valid && op->solve.stats.seconds > 0;
+                correct &= op->solve.stats.faceCount == op->solve.faces->count && op->solve.stats.triCount == triCount;
+                correct &= op->solve.stats.bytes > 0;
+            }
+            snz_testPrint(correct, "solve stats only recorded when asked for");
+        }
+
+        tl_timelineDeinit(&tl);
+        job_systemDeinit(jobs);
+        snz_arenaClear(&opArena);
+    }
+
+    {
+        tl = tl_timelineInit(&opArena);
+        tl.speculate.enabled = true;
+        _tl_testPushBranches(&tl, 2, 3, &scratch);
+        _tl_testUnsolve(&tl);
+        tl_Op* target = tl.firstOp;  // end of the last branch
+        tl_Op* other = tl.firstOp->next->next->next->next;  // end of the first one
+
+        tl_solveSpeculate(&tl, target, 0);
+        bool correct = tl.solveJob.thread == NULL;
+        tl_solveSpeculate(&tl, target, TL_SPECULATE_DWELL_SECONDS);
+        correct &= tl.solveJob.thread != NULL && tl.solveJob.speculative;
+        correct &= !_tl_testWaitForSolve(&tl) && tl.solveJob.sceneHeld;
+        correct &= target->solve.timesSolved == 2 && other->solve.timesSolved == 1;
+        correct &= tl_solveStart(&tl, target) && tl.solveJob.thread == NULL && _tl_solveCollect(&tl);
+        correct &= target->solve.timesSolved == 2;
+        snz_testPrint(correct, "hovered op gets pre-solved and adopted on start");
+
+        tl_solveSpeculate(&tl, other, 0);
+        tl_solveSpeculate(&tl, other, TL_SPECULATE_DWELL_SECONDS);
+        correct = !_tl_testWaitForSolve(&tl) && tl.solveJob.sceneHeld && other->solve.timesSolved == 2;
+        other->args[1].number += 1;
+        correct &= tl_solveStart(&tl, other) && tl.solveJob.thread != NULL && !tl.solveJob.speculative;
+        correct &= _tl_testWaitForSolve(&tl) && other->solve.timesSolved == 3;
+        snz_testPrint(correct, "pre-solved op that changed after gets solved again");
+
+        _tl_testUnsolve(&tl);
+        tl_solveStart(&tl, target);
+        tl_solveSpeculate(&tl, NULL, 0);
+        tl_solveSpeculate(&tl, other, TL_SPECULATE_DWELL_SECONDS);
+        correct = !tl.solveJob.speculative && tl.solveJob.targetUid == target->uniqueId;
+        correct &= _tl_testWaitForSolve(&tl);
+        tl_solveSpeculate(&tl, other, 0);  // now that nothing else is going
+        correct &= tl.solveJob.thread != NULL && tl.solveJob.speculative && tl.solveJob.targetUid == other->uniqueId;
+        tl_solveSpeculate(&tl, NULL, 0);
+        correct &= tl.solveJob.thread == NULL && !tl.solveJob.sceneHeld;
+        snz_testPrint(correct, "pre-solves wait on real solves and stop when the hover moves");
+
+        // clicked while it's still going, so the rest of it should be on jobs at normal priority
+        job_System* jobs = job_systemInit(2, 1000000);
+        tl.jobs = jobs;
+        _tl_testUnsolve(&tl);
+        tl_solveSpeculate(&tl, NULL, 0);
+        tl_solveSpeculate(&tl, target, TL_SPECULATE_DWELL_SECONDS);
+        correct = tl.solveJob.thread != NULL && tl.solveJob.speculative && tl.solveJob.jobs == NULL;
+        correct &= tl_solveStart(&tl, target) && !tl.solveJob.speculative;
+        correct &= _tl_testWaitForSolve(&tl) && !tl.solveJob.lowPriority;
+        snz_testPrint(correct, "pre-solve gets promoted when started for real");
+        tl_solveCancel(&tl);
+        tl.jobs = NULL;
+        job_systemDeinit(jobs);
+
+        tl_timelineDeinit(&tl);
+        snz_arenaClear(&opArena);
+    }
+
+    {
+        scache_Cache cache = { 0 };
+        scache_init(&cache, "testing/tlsolvecache", INT64_MAX);
+        for (int64_t i = cache.entryCount - 1; i >= 0; i--) {  // fresh every time
+            char path[SCACHE_PATH_MAX] = { 0 };
+            _scache_filePath(&cache, cache.entries[i].key, path);
+            remove(path);
+            _scache_entryRemove(&cache, &cache.entries[i]);
+        }
+
+        // solved once w/o the cache, then again with it to fill it up
+        tl = tl_timelineInit(&opArena);
+        _tl_testPushBranches(&tl, 2, 3, &scratch);
+        tl.solveCache = &cache;
+        _tl_testUnsolve(&tl);
+        snz_arenaClear(&scratch);
+        bool correct = tl_solveOp(&tl, NULL, &scratch);
+        correct &= cache.stats.stores == 6 && cache.stats.hits == 0;
+
+        // built the same way again like it was loaded in another run, everything but the cubes should come from the cache
+        tl_Timeline other = tl_timelineInit(&opArena);
+        other.solveCache = &cache;
+        _tl_testPushBranches(&other, 2, 3, &scratch);
+        correct &= cache.stats.hits == 6 && cache.stats.stores == 6;
+        for (tl_Op* a = tl.firstOp, *b = other.firstOp; a && b; a = a->next, b = b->next) {
+            bool fromCache = a->kind == TL_OPK_EXTRUDE;
+            correct &= b->solve.timesSolved == (fromCache ? 0 : 1);
+            correct &= (b->solve.cacheMapping.data != NULL) == fromCache;
+            correct &= _tl_testFacesSum(a->solve.faces) == _tl_testFacesSum(b->solve.faces);
+            correct &= a->solve.cacheKey == b->solve.cacheKey;
+        }
+
+        // changing the first extrude of a branch has to miss for it + everything after it
+        tl_timelineGetOpByUID(&other, 2)->args[1].number = 7;
+        snz_arenaClear(&scratch);
+        correct &= tl_solveOp(&other, NULL, &scratch);
+        correct &= cache.stats.hits == 6 && cache.stats.stores == 9;
+        snz_testPrint(correct, "solve cache skips extrudes already solved in another timeline");
+
+        tl_timelineDeinit(&other);
+        tl_timelineDeinit(&tl);
+        scache_deinit(&cache);
+        snz_arenaClear(&opArena);
+    }
+
+    {
+        tl = tl_timelineInit(&opArena);
+        for (int i = 0; i < 1000; i++) {
+            tl_timelinePushExtrude(&tl, HMM_V2(0, 0));
+        }
+        for (tl_Op* op = tl.firstOp; op; op = op->next) {
+            op->markedForDeletion = op->uniqueId % 3 == 0;
+        }
+        tl_timelineCullOpsMarkedForDelete(&tl);
+        tl_timelinePushExtrude(&tl, HMM_V2(0, 0));
+
+        bool correct = tl.opTable.count == 1000 - 333 + 1;
+        for (int64_t uid = 1; uid <= 1001; uid++) {
+            tl_Op* op = tl_timelineGetOpByUID(&tl, uid);
+            bool shouldExist = uid == 1001 || uid % 3 != 0;
+            correct &= shouldExist ? (op && op->uniqueId == uid) : (op == NULL);
+        }
+        correct &= tl_timelineGetOpByUID(&tl, 0) == NULL;
+        snz_testPrint(correct, "op uid table after pushes and deletes");
+        tl_timelineDeinit(&tl);
+    }
+
+    {
+        srand(3);
+        tl = tl_timelineInit(&opArena);
+        for (int i = 0; i < 2000; i++) {
+            HMM_Vec2 pos = HMM_V2((float)(rand() % 100000 - 50000), (float)(rand() % 100000 - 50000));
+            tl_Op* op = tl_timelinePushExtrude(&tl, pos);
+            if (i > 0 && rand() % 2) {
+                op->args[0] = (tl_OpArg){ .kind = TL_OPAK_GEOID_FACE, .geoId.opUniqueId = 1 + rand() % i };
+            }
+        }
+
+        bool correct = true;
+        for (int round = 0; round < 3; round++) {
+            tl_nodeGridUpdate(&tl);
+            for (int i = 0; i < 100; i++) {
+                HMM_Vec2 min = HMM_V2((float)(rand() % 100000 - 50000), (float)(rand() % 100000 - 50000));
+                HMM_Vec2 size = HMM_V2((float)(rand() % 5000), (float)(rand() % 5000));
+                correct &= _tl_testNodeGridQueryCorrect(&tl, min, HMM_Add(min, size), &scratch);
+                snz_arenaClear(&scratch);
+            }
+            correct &= _tl_testNodeGridQueryCorrect(&tl, HMM_V2(-1e7, -1e7), HMM_V2(1e7, 1e7), &scratch);
+            correct &= tl_nodeGridQuery(&tl, HMM_V2(-1e7, -1e7), HMM_V2(1e7, 1e7), &scratch).count == tl.opTable.count;
+            snz_arenaClear(&scratch);
+
+            // moving + deleting some should get picked up on the next update
+            for (tl_Op* op = tl.firstOp; op; op = op->next) {
+                if (rand() % 10 == 0) {
+                    op->ui.pos = HMM_Add(op->ui.pos, HMM_V2((float)(rand() % 2000 - 1000), (float)(rand() % 2000 - 1000)));
+                    tl_nodeGridOpMoved(&tl, op);
+                } else if (rand() % 50 == 0) {
+                    op->markedForDeletion = true;
+                }
+            }
+            tl_timelineCullOpsMarkedForDelete(&tl);
+        }
+
+        tl_Op* hovered = tl.firstOp;
+        hovered->ui.inter.hovered = true;
+        tl_nodeGridUpdate(&tl);
+        tl.nodeGrid.mousePos = HMM_Add(hovered->ui.pos, HMM_V2(40, -40));
+        correct &= tl_timelineHoveredOp(&tl) == hovered;
+        tl.nodeGrid.mousePos = HMM_Add(hovered->ui.pos, HMM_V2(TL_NODE_GRID_CELL_SIZE * 3, 0));
+        correct &= tl_timelineHoveredOp(&tl) == NULL;
+        snz_testPrint(correct, "node grid finds everything in view and what's hovered");
+        tl_timelineDeinit(&tl);
+        snz_arenaClear(&opArena);
+    }
+
+    {
+        srand(4);
+        tl = tl_timelineInit(&opArena);
+        for (int i = 0; i < 2000; i++) {
+            HMM_Vec2 pos = HMM_V2((float)(rand() % 100000 - 50000), (float)(rand() % 100000 - 50000));
+            tl_Op* op = tl_timelinePushExtrude(&tl, pos);
+            if (i > 0) {
+                op->args[0] = (tl_OpArg){ .kind = TL_OPAK_GEOID_FACE, .geoId.opUniqueId = 1 + rand() % i };
+            }
+        }
+        tl_nodeGridUpdate(&tl);
+
+        bool correct = true;
+        for (int round = 0; round < 20; round++) {
+            // dragging a few, w/ lines going both in and out of them
+            for (int i = 0; i < 5; i++) {
+                tl_Op* op = tl_timelineGetOpByUID(&tl, 1 + rand() % 2000);
+                op->ui.pos = HMM_Add(op->ui.pos, HMM_V2((float)(rand() % 4000 - 2000), (float)(rand() % 4000 - 2000)));
+                tl_nodeGridOpMoved(&tl, op);
+            }
+            int64_t usedBefore = tl.nodeGrid.entryEnd;
+            tl_nodeGridUpdate(&tl);
+            correct &= !tl.nodeGrid.stale && tl.nodeGrid.movedCount == 0;
+            // refiled entries come off the free list
+            correct &= tl.nodeGrid.entryEnd - usedBefore < 1000;
+            for (int i = 0; i < 20; i++) {
+                HMM_Vec2 min = HMM_V2((float)(rand() % 100000 - 50000), (float)(rand() % 100000 - 50000));
+                HMM_Vec2 size = HMM_V2((float)(rand() % 5000), (float)(rand() % 5000));
+                correct &= _tl_testNodeGridQueryCorrect(&tl, min, HMM_Add(min, size), &scratch);
+                snz_arenaClear(&scratch);
+            }
+        }
+        correct &= _tl_testNodeGridQueryCorrect(&tl, HMM_V2(-1e7, -1e7), HMM_V2(1e7, 1e7), &scratch);
+        snz_arenaClear(&scratch);
+
+        // same entries as filing everything from scratch
+        int64_t incrementalCount = tl.nodeGrid.entryCount;
+        tl_nodeGridMarkStale(&tl);
+        tl_nodeGridUpdate(&tl);
+        correct &= incrementalCount == tl.nodeGrid.entryCount;
+
+        // nothing moved, nothing happens
+        int64_t firstFree = tl.nodeGrid.firstFreeEntry;
+        int64_t entryEnd = tl.nodeGrid.entryEnd;
+        int64_t firstEntry = tl.firstOp->ui.gridFirstEntry;
+        tl_nodeGridUpdate(&tl);
+        correct &= firstFree == tl.nodeGrid.firstFreeEntry && entryEnd == tl.nodeGrid.entryEnd;
+        correct &= firstEntry == tl.firstOp->ui.gridFirstEntry;
+        snz_testPrint(correct, "node grid refiles just the ops that moved");
+        tl_timelineDeinit(&tl);
+        snz_arenaClear(&opArena);
+    }
+
+    {
+        snz_Arena specArena = snz_arenaInit(100000, "tl test spec arena");
+        snz_Arena loadArena = snz_arenaInit(10000000, "tl test load arena");
+        ser_begin(&specArena);
+        tl_timelineSpec(&specArena);
+        ser_end();
+
+        snz_arenaClear(&opArena);
+        tl = tl_timelineInit(&opArena);
+        _tl_testPushBranches(&tl, 2, 3, &scratch);
+        sk_Sketch sketch = sk_sketchInit(&opArena);
+        sk_Point* p3 = sk_sketchAddPoint(&sketch, HMM_V2(0, 1));
+        sk_sketchAddLine(&sketch, sketch.originLine->p2, p3);
+        sk_sketchAddLine(&sketch, p3, sketch.originPt);
+        sk_sketchAddConstraintDistance(&sketch, sketch.originLine, 2);
+        tl.activeOp = tl_timelinePushSketch(&tl, HMM_V2(10, 20), sketch);
+        snz_arenaClear(&scratch);
+        tl_solveOp(&tl, NULL, &scratch);
+
+        FILE* f = fopen("testing/timeline.adder", "w+b");
+        ser_WriteError writeErr = tl_timelineWrite(&tl, f, &scratch);
+        fclose(f);
+
+        tl_Timeline loaded = { 0 };
+        f = fopen("testing/timeline.adder", "rb");
+        ser_ReadError readErr = tl_timelineRead(f, &loadArena, &scratch, &loaded);
+        fclose(f);
+
+        bool correct = writeErr == SER_WE_OK && readErr == SER_RE_OK;
+        if (correct) {
+            snz_arenaClear(&scratch);
+            correct &= tl_solveOp(&loaded, NULL, &scratch);
+            correct &= loaded.nextUniqueId == tl.nextUniqueId;
+            correct &= loaded.activeOp && loaded.activeOp->uniqueId == tl.activeOp->uniqueId;
+            tl_Op* loadedOp = loaded.firstOp;
+            for (tl_Op* op = tl.firstOp; op; op = op->next) {
+                correct &= loadedOp && loadedOp->uniqueId == op->uniqueId;
+                correct &= loadedOp && _tl_testFacesSum(loadedOp->solve.faces) == _tl_testFacesSum(op->solve.faces);
+                loadedOp = loadedOp ? loadedOp->next : NULL;
+            }
+            correct &= loadedOp == NULL;
+            tl_timelineDeinit(&loaded);
+        }
+        snz_testPrint(correct, "timeline to and from file");
+
+        {
+            const char* path = "testing/journal.adder";
+            tl_Journal j = { 0 };
+            snz_arenaClear(&scratch);
+            correct = tl_journalCreate(&j, path, &tl);
+            int64_t snapshotBytes = j.snapshotBytes;
+
+            // firstOp is the sketch, the one after is the end of the last branch
+            tl_Op* lastExtrude = tl.firstOp->next;
+            tl_Op* midExtrude = lastExtrude->next;
+            int64_t appended[6] = { 0 };
+            lastExtrude->ui.pos = HMM_V2(5, 5);
+            appended[0] = tl_journalAppend(&j, &tl, false);
+            midExtrude->args[1].number = 7;
+            appended[1] = tl_journalAppend(&j, &tl, false);
+            sk_sketchAddPoint(&tl.activeOp->val.sketch, HMM_V2(3, 4));
+            appended[2] = tl_journalAppend(&j, &tl, false);
+            tl_Op* pushed = tl_timelinePushExtrude(&tl, HMM_V2(1, 2));
+            const mesh_Face* top = _tl_testTopFace(midExtrude);
+            pushed->args[0] = (tl_OpArg){ .kind = TL_OPAK_GEOID_FACE, .geoId = *mesh_geoIdDuplicate(&top->id, &opArena) };
+            pushed->args[1] = (tl_OpArg){ .kind = TL_OPAK_NUMBER, .number = 3 };
+            appended[3] = tl_journalAppend(&j, &tl, false);
+            lastExtrude->markedForDeletion = true;
+            tl_timelineCullOpsMarkedForDelete(&tl);
+            appended[4] = tl_journalAppend(&j, &tl, false);
+            appended[5] = tl_journalAppend(&j, &tl, false);
+            tl_journalClose(&j);
+
+            for (int i = 0; i < 5; i++) {
+                correct &= appended[i] > 0 && appended[i] < snapshotBytes / 2;
+            }
+            correct &= appended[5] == 0;
+
+            snz_arenaClear(&loadArena);
+            snz_arenaClear(&scratch);
+            ser_ReadError err = tl_journalOpen(&j, path, &loadArena, &loaded);
+            correct &= err == SER_RE_OK && j.recordCount == 5;
+            if (err == SER_RE_OK) {
+                correct &= _tl_testTimelinesMatch(&tl, &loaded);
+                _tl_testUnsolve(&tl);
+                snz_arenaClear(&scratch);
+                tl_solveOp(&tl, NULL, &scratch);
+                snz_arenaClear(&scratch);
+                tl_solveOp(&loaded, NULL, &scratch);
+                tl_Op* loadedOp = loaded.firstOp;
+                for (tl_Op* op = tl.firstOp; op && loadedOp; op = op->next, loadedOp = loadedOp->next) {
+                    correct &= (op->solve.faces == NULL) == (loadedOp->solve.faces == NULL);
+                    if (op->solve.faces && loadedOp->solve.faces) {
+                        correct &= _tl_testFacesSum(op->solve.faces) == _tl_testFacesSum(loadedOp->solve.faces);
+                    }
+                }
+                tl_journalClose(&j);
+                tl_timelineDeinit(&loaded);
+            }
+            snz_testPrint(correct, "timeline journal appends only edits and replays them");
+
+            // cut the last record off partway, like a crash while appending
+            snz_arenaClear(&scratch);
+            correct = tl_journalCreate(&j, path, &tl);
+            HMM_Vec2 posBefore = pushed->ui.pos;
+            pushed->ui.pos = HMM_V2(77, 77);
+            int64_t lastBytes = tl_journalAppend(&j, &tl, false);
+            int64_t fileSize = j.snapshotBytes + j.recordBytes;
+            correct &= lastBytes > 0 && j.recordCount == 1;
+            tl_journalClose(&j);
+            if (correct) {
+                f = fopen(path, "rb");
+                char* bytes = SNZ_ARENA_PUSH_ARR(&scratch, fileSize, char);
+                correct &= fread(bytes, 1, fileSize, f) == (size_t)fileSize;
+                fclose(f);
+                f = fopen(path, "wb");
+                fwrite(bytes, 1, fileSize - lastBytes / 2, f);
+                fclose(f);
+            }
+
+            pushed->ui.pos = posBefore;
+            snz_arenaClear(&loadArena);
+            snz_arenaClear(&scratch);
+            correct &= tl_journalOpen(&j, path, &loadArena, &loaded) == SER_RE_OK;
+            correct &= _tl_testTimelinesMatch(&tl, &loaded);
+            correct &= j.recordCount == 0 && j.file != NULL;  // should've been compacted away
+            tl_journalClose(&j);
+            tl_timelineDeinit(&loaded);
+            snz_testPrint(correct, "timeline journal drops a torn last record");
+
+            // a compact that crashed after the temp file was done, but before it got moved over
+            const char* tempPath = "testing/journal.adder.tmp";
+            correct = tl_journalCreate(&j, path, &tl);
+            tl_journalClose(&j);
+            pushed->ui.pos = HMM_V2(55, 55);
+            snz_arenaClear(&scratch);
+            f = fopen(tempPath, "w+b");
+            correct &= f && tl_timelineWrite(&tl, f, &scratch) == SER_WE_OK;
+            fclose(f);
+            snz_arenaClear(&loadArena);
+            correct &= tl_journalOpen(&j, path, &loadArena, &loaded) == SER_RE_OK;
+            correct &= _tl_testTimelinesMatch(&tl, &loaded);
+            tl_journalClose(&j);
+            tl_timelineDeinit(&loaded);
+            f = fopen(tempPath, "rb");
+            correct &= f == NULL;  // moved or removed either way
+            if (f) {
+                fclose(f);
+            }
+            snz_testPrint(correct, "timeline journal recovers a finished temp file");
+
+            // and one that crashed partway thru writing it, which has to lose to what's at path
+            pushed->ui.pos = posBefore;
+            snz_arenaClear(&scratch);
+            f = fopen(tempPath, "w+b");
+            correct = f && tl_timelineWrite(&tl, f, &scratch) == SER_WE_OK;
+            int64_t tempSize = ftell(f);
+            fclose(f);
+            if (correct) {
+                f = fopen(tempPath, "rb");
+                char* bytes = SNZ_ARENA_PUSH_ARR(&scratch, tempSize, char);
+                correct &= fread(bytes, 1, tempSize, f) == (size_t)tempSize;
+                fclose(f);
+                f = fopen(tempPath, "wb");
+                fwrite(bytes, 1, tempSize / 2, f);
+                fclose(f);
+            }
+            pushed->ui.pos = HMM_V2(55, 55);
+            snz_arenaClear(&loadArena);
+            correct &= tl_journalOpen(&j, path, &loadArena, &loaded) == SER_RE_OK;
+            correct &= _tl_testTimelinesMatch(&tl, &loaded);
+            tl_journalClose(&j);
+            tl_timelineDeinit(&loaded);
+            f = fopen(tempPath, "rb");
+            correct &= f == NULL;
+            if (f) {
+                fclose(f);
+            }
+            snz_testPrint(correct, "timeline journal throws out a torn temp file");
+        }
+
+        tl_timelineDeinit(&tl);
+        ser_reset();
+        snz_arenaDeinit(&specArena);
+        snz_arenaDeinit(&loadArena);
+    }
+
+    snz_arenaDeinit(&opArena);
+    snz_arenaDeinit(&scratch);
+}
+
+// 10k ops, each referencing the one before it, then a wide timeline solved with and without jobs. Not run at startup.
+void tl_bench() {
+    snz_Arena opArena = snz_arenaInit(100000000, "tl bench op arena");
+    tl_Timeline tl = tl_timelineInit(&opArena);
+
+    const int64_t opCount = 10000;
+    clock_t start = clock();
+    for (int64_t i = 0; i < opCount; i++) {
+        tl_Op* op = tl_timelinePushExtrude(&tl, HMM_V2(0, 0));
+        op->args[0] = (tl_OpArg){
+            .kind = TL_OPAK_GEOID_FACE,
+            .geoId = { .geoKind = MESH_GK_FACE, .opUniqueId = op->uniqueId - 1 },
+        };
+    }
+    double pushTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    snz_Arena scratch = snz_arenaInit(100000000, "tl bench scratch arena");
+    start = clock();
+    bool ok = false;
+    tl_OpPtrSlice order = _tl_opsSchedule(&tl, tl.firstOp, &scratch, &ok);
+    double scheduleTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+    SNZ_ASSERT(order.count == opCount, "bench schedule was missing ops.");
+    snz_arenaDeinit(&scratch);
+
+    start = clock();
+    int64_t found = 0;
+    for (tl_Op* op = tl.firstOp; op; op = op->next) {
+        found += tl_timelineGetOpByUID(&tl, op->args[0].geoId.opUniqueId) != NULL;
+    }
+    double lookupTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    // every arg of every op gets looked up in here
+    start = clock();
+    for (tl_Op* op = tl.firstOp; op; op = op->next) {
+        op->markedForDeletion = op->uniqueId % 2 == 0;
+    }
+    tl_timelineCullOpsMarkedForDelete(&tl);
+    double cullTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    SNZ_LOGF("%" PRId64 " ops: push %.4fs, scheduling a solve of all %.4fs, resolving every ref %.4fs (%" PRId64 " found), culling half %.4fs",
+             opCount, pushTime, scheduleTime, lookupTime, found, cullTime);
+
+    tl_timelineDeinit(&tl);
+    snz_arenaClear(&opArena);
+
+    {
+        // independent branches, solved serially then spread over every core. Wall time, not cpu time.
+        const int branchCount = 32;
+        const int depth = 6;
+        snz_Arena scratch = snz_arenaInit(TL_SOLVE_SCRATCH_SIZE, "tl bench scratch arena");
+        tl = tl_timelineInit(&opArena);
+        _tl_testPushBranches(&tl, branchCount, depth, &scratch);
+
+        _tl_testUnsolve(&tl);
+        snz_arenaClear(&scratch);
+        uint64_t startTick = SDL_GetPerformanceCounter();
+        tl_solveOp(&tl, NULL, &scratch);
+        double serialTime = (double)(SDL_GetPerformanceCounter() - startTick) / SDL_GetPerformanceFrequency();
+
+        int threadCount = SNZ_MIN(SDL_GetCPUCount() - 1, JOB_MAX_WORKERS - 1);
+        job_System* jobs = job_systemInit(threadCount, TL_SOLVE_SCRATCH_SIZE / 4);
+        tl.jobs = jobs;
+        _tl_testUnsolve(&tl);
+        snz_arenaClear(&scratch);
+        startTick = SDL_GetPerformanceCounter();
+        tl_solveOp(&tl, NULL, &scratch);
+        double wideTime = (double)(SDL_GetPerformanceCounter() - startTick) / SDL_GetPerformanceFrequency();
+
+        SNZ_LOGF("%d branches of %d extrudes: serial solve %.3fs, wide solve on %d workers %.3fs (%.1fx)",
+                 branchCount, depth, serialTime, jobs->workerCount, wideTime, serialTime / wideTime);
+        tl_timelineDeinit(&tl);
+        job_systemDeinit(jobs);
+        snz_arenaDeinit(&scratch);
+    }
+    snz_arenaDeinit(&opArena);
+}
+
+// a big timeline saved as one snapshot vs edits to it appended to the journal, then loaded back with every edit
+// replayed vs loaded from a plain snapshot. Wall time. Not run at startup.
+void tl_journalBench() {
+    snz_Arena specArena = snz_arenaInit(100000, "tl journal bench spec arena");
+    ser_begin(&specArena);
+    tl_timelineSpec(&specArena);
+    ser_end();
+
+    snz_Arena opArena = snz_arenaInitGrowable(100000000, "tl journal bench op arena");
+    snz_Arena loadArena = snz_arenaInitGrowable(100000000, "tl journal bench load arena");
+    snz_Arena scratch = snz_arenaInit(TL_SOLVE_SCRATCH_SIZE, "tl journal bench scratch arena");
+    tl_Timeline tl = tl_timelineInit(&opArena);
+
+    const int sketchCount = 500;
+    const int pointCount = 200;
+    tl_Op** sketchOps = SNZ_ARENA_PUSH_ARR(&opArena, sketchCount, tl_Op*);
+    for (int i = 0; i < sketchCount; i++) {
+        sk_Sketch sketch = sk_sketchInit(&opArena);
+        sk_Point* prev = sketch.originPt;
+        for (int j = 0; j < pointCount; j++) {
+            float angle = (float)j / pointCount * 2 * HMM_PI32;
+            sk_Point* p = sk_sketchAddPoint(&sketch, HMM_V2(cosf(angle) * (i + 1), sinf(angle) * (i + 1)));
+            sk_sketchAddLine(&sketch, prev, p);
+            prev = p;
+        }
+        sketchOps[i] = tl_timelinePushSketch(&tl, HMM_V2(i * 10, 0), sketch);
+    }
+
+    const char* path = "testing/journalBench.adder";
+    tl_Journal journal = { 0 };
+    uint64_t startTick = SDL_GetPerformanceCounter();
+    bool ok = tl_journalCreate(&journal, path, &tl);
+    double snapshotTime = (double)(SDL_GetPerformanceCounter() - startTick) / SDL_GetPerformanceFrequency();
+    SNZ_ASSERT(ok, "journal bench snapshot failed.");
+    int64_t snapshotBytes = journal.snapshotBytes;
+
+    // each edit drags one point in one sketch, what an autosave after a drag would see
+    const int editCount = 400;
+    double appendTime = 0;
+    int64_t appendBytes = 0;
+    for (int i = 0; i < editCount; i++) {
+        tl_Op* op = sketchOps[(i * 7919) % sketchCount];
+        sk_sketchFirstPoint(&op->val.sketch)->pos.X += 1;
+        snz_arenaClear(&scratch);
+        startTick = SDL_GetPerformanceCounter();
+        int64_t bytes = tl_journalAppend(&journal, &tl, false);
+        appendTime += (double)(SDL_GetPerformanceCounter() - startTick) / SDL_GetPerformanceFrequency();
+        SNZ_ASSERT(bytes > 0, "journal bench append failed.");
+        appendBytes += bytes;
+    }
+    SNZ_ASSERT(journal.recordCount == editCount, "journal bench compacted partway thru.");
+    tl_journalClose(&journal);
+
+    tl_Timeline loaded = { 0 };
+    snz_arenaClear(&scratch);
+    startTick = SDL_GetPerformanceCounter();
+    ser_ReadError err = tl_journalOpen(&journal, path, &loadArena, &loaded);
+    double replayTime = (double)(SDL_GetPerformanceCounter() - startTick) / SDL_GetPerformanceFrequency();
+    SNZ_ASSERT(err == SER_RE_OK && journal.recordCount == editCount, "journal bench replay failed.");
+    tl_journalClose(&journal);
+    tl_timelineDeinit(&loaded);
+    snz_arenaClear(&loadArena);
+
+    snz_arenaClear(&scratch);
+    FILE* f = fopen(path, "w+b");
+    tl_timelineWrite(&tl, f, &scratch);
+    fclose(f);
+    snz_arenaClear(&scratch);
+    startTick = SDL_GetPerformanceCounter();
+    f = fopen(path, "rb");
+    err = tl_timelineRead(f, &loadArena, &scratch, &loaded);
+    fclose(f);
+    double snapshotLoadTime = (double)(SDL_GetPerformanceCounter() - startTick) / SDL_GetPerformanceFrequency();
+    SNZ_ASSERT(err == SER_RE_OK, "journal bench snapshot load failed.");
+    tl_timelineDeinit(&loaded);
+
+    SNZ_LOGF("%d sketches of %d points: snapshot %.4fs (%" PRId64 " bytes), %d one point edits appended avg %.5fs (%" PRId64 " bytes avg)",
+             sketchCount, pointCount, snapshotTime, snapshotBytes, editCount, appendTime / editCount, appendBytes / editCount);
+    SNZ_LOGF("loading w/ %d records replayed %.4fs, loading just a snapshot %.4fs", editCount, replayTime, snapshotLoadTime);
+
+    tl_timelineDeinit(&tl);
+    ser_reset();
+    snz_arenaDeinit(&scratch);
+    snz_arenaDeinit(&loadArena);
+    snz_arenaDeinit(&opArena);
+    snz_arenaDeinit(&specArena);
 }
@@ -15,6 +15,36 @@ float _tl_radiusOfNode(tl_Op* op, float sound) {
     return 60 + (10 * op->ui.sel.hoverAnim) + (20 * sound); // FIXME: why are these big on load??
 }
 
+// 1.2k, 3.4m etc.
+static const char* _tl_formatCount(snz_Arena* scratch, double count, const char* unit) {
+    if (count >= 1000000) {
+        return snz_arenaFormatStr(scratch, "%.1fm %s", count / 1000000, unit);
+    } else if (count >= 1000) {
+        return snz_arenaFormatStr(scratch, "%.1fk %s", count / 1000, unit);
+    }
+    return snz_arenaFormatStr(scratch, "%.0f %s", count, unit);
+}
+
+// time/size text under a node, heat is 0-1 for how slow this is compared to the slowest op
+static void _tl_buildNodeStats(const tl_Op* op, float radius, snz_Arena* scratch) {
+    const char* lines[] = {
+        snz_arenaFormatStr(scratch, "%.1fms%s, %s", op->solve.stats.seconds * 1000,
+                           op->solve.stats.fromCache ? " (cached)" : "",
+                           _tl_formatCount(scratch, (double)op->solve.stats.bytes, "bytes")),
+        snz_arenaFormatStr(scratch, "%s, %s",
+                           _tl_formatCount(scratch, (double)op->solve.stats.faceCount, "faces"),
+                           _tl_formatCount(scratch, (double)op->solve.stats.triCount, "tris")),
+    };
+    HMM_Vec2 pos = HMM_Add(op->ui.pos, HMM_V2(-radius, radius + ui_padding));
+    for (int i = 0; i < 2; i++) {
+        snzu_boxNewF("stats %d", i);
+        snzu_boxSetDisplayStr(&ui_lightLabelFont, ui_colorText, lines[i]);
+        snzu_boxSetStart(pos);
+        snzu_boxSetSizeFitText(0);
+        pos.Y = snzu_boxGetEnd().Y;
+    }
+}
+
 // returns mouse position in world space and a vp matrix to use ending the instances frame
 // mouse panel should be the input to send to the instance at the end of the frame
 void tl_build(tl_Timeline* timeline, snz_Arena* scratch, HMM_Vec2 panelSize, HMM_Vec2 mousePosInPanel, float sound, HMM_Vec2* outMousePos, HMM_Mat4* outVP) {
@@ -28,6 +58,8 @@ void tl_build(tl_Timeline* timeline, snz_Arena* scratch, HMM_Vec2 panelSize, HMM
 
 
     HMM_Mat4 vp = { 0 };
+    HMM_Vec2 viewMin = { 0 };  // world space corners of the panel
+    HMM_Vec2 viewMax = { 0 };
     {  // calculate out values + camera things
         timeline->camHeight += inter->mouseScrollY * (timeline->camHeight) * 0.05;
 
@@ -54,6 +86,12 @@ void tl_build(tl_Timeline* timeline, snz_Arena* scratch, HMM_Vec2 panelSize, HMM
 
         HMM_Mat4 vpInverse = HMM_InvGeneral(vp);
         HMM_Vec2 mousePos = _tl_pixelToWorldSpace(mousePosInPanel, panelSize, vpInverse);
+        timeline->nodeGrid.mousePos = mousePos;
+
+        HMM_Vec2 cornerA = _tl_pixelToWorldSpace(HMM_V2(0, 0), panelSize, vpInverse);
+        HMM_Vec2 cornerB = _tl_pixelToWorldSpace(panelSize, panelSize, vpInverse);
+        viewMin = HMM_V2(SNZ_MIN(cornerA.X, cornerB.X), SNZ_MIN(cornerA.Y, cornerB.Y));
+        viewMax = HMM_V2(SNZ_MAX(cornerA.X, cornerB.X), SNZ_MAX(cornerA.Y, cornerB.Y));
 
         *outVP = vp;
         *outMousePos = mousePos;
@@ -71,6 +109,12 @@ void tl_build(tl_Timeline* timeline, snz_Arena* scratch, HMM_Vec2 panelSize, HMM
             HMM_Vec2 dragMin = HMM_V2(SNZ_MIN(inter->mousePosGlobal.X, region->dragOrigin.X), SNZ_MIN(inter->mousePosGlobal.Y, region->dragOrigin.Y));
             HMM_Vec2 dragMax = HMM_V2(SNZ_MAX(inter->mousePosGlobal.X, region->dragOrigin.X), SNZ_MAX(inter->mousePosGlobal.Y, region->dragOrigin.Y));
             for (tl_Op* op = timeline->firstOp; op; op = op->next) {
+                // off screen last frame means no box, so nothing wrote to inter
+                if (!op->ui.built) {
+                    op->ui.inter = (snzu_Interaction){ 0 };
+                }
+                op->ui.built = false;
+
                 bool inDragZone = false;
                 if (dragMin.X < op->ui.pos.X && dragMax.X > op->ui.pos.X) {
                     if (dragMin.Y < op->ui.pos.Y && dragMax.Y > op->ui.pos.Y) {
@@ -122,6 +166,7 @@ void tl_build(tl_Timeline* timeline, snz_Arena* scratch, HMM_Vec2 panelSize, HMM
                 for (tl_Op* op = timeline->firstOp; op; op = op->next) {
                     if (op->ui.sel.selected) {
                         op->ui.pos = HMM_Add(op->ui.pos, diff);
+                        tl_nodeGridOpMoved(timeline, op);
                     }
                 }
             } else if (sc_getActiveCommand() == scc_timelineRotate) {
@@ -152,6 +197,7 @@ void tl_build(tl_Timeline* timeline, snz_Arena* scratch, HMM_Vec2 panelSize, HMM
                         pos = HMM_RotateV2(pos, angleDiff);
                         pos = HMM_Add(pos, *centerOfMass);
                         op->ui.pos = pos;
+                        tl_nodeGridOpMoved(timeline, op);
                     }
                 }
             } // end rotate mode check
@@ -159,25 +205,54 @@ void tl_build(tl_Timeline* timeline, snz_Arena* scratch, HMM_Vec2 panelSize, HMM
             *prevMouse = inter->mousePosGlobal;
         } // end rotate/move mode check
 
-        for (tl_Op* op = timeline->firstOp; op; op = op->next) {
-            snzu_boxNew(snz_arenaFormatStr(scratch, "%p", op));
-            uint64_t flags = SNZU_IF_HOVER | SNZU_IF_MOUSE_BUTTONS;
-            if (inRotateOrMoveMode) {
-                flags |= SNZU_IF_ALLOW_EVENT_FALLTHROUGH;
+        double maxSolveSeconds = 0;
+        if (timeline->recordSolveStats) {
+            for (tl_Op* op = timeline->firstOp; op; op = op->next) {
+                maxSolveSeconds = SNZ_MAX(maxSolveSeconds, op->solve.stats.seconds);
             }
-            snzu_boxSetInteractionOutput(&op->ui.inter, flags);
-
-            HMM_Vec4 textColor = HMM_Lerp(ui_colorText, op->ui.sel.selectionAnim, ui_colorAccent);
-            SNZ_ASSERTF(op->kind > TL_OPK_NONE && op->kind < TL_OPK_COUNT, "op kind out of bounds. was: %d", op->kind);
-            snzu_boxSetDisplayStr(&ui_labelFont, textColor, tl_opKindNames[op->kind]);
+        }
 
+        // only ops with a node or dep line on screen get anything built, after any moves above so it's this frames spots.
+        // Cheap when nothing moved, see tl_nodeGridOpMoved
+        tl_nodeGridUpdate(timeline);
+        tl_OpPtrSlice visibleOps = tl_nodeGridQuery(timeline, viewMin, viewMax, scratch);
+        for (int64_t visibleIdx = 0; visibleIdx < visibleOps.count; visibleIdx++) {
+            tl_Op* op = visibleOps.elems[visibleIdx];
             float radius = _tl_radiusOfNode(op, sound);
-            snzu_boxSetCornerRadius(radius);
-            snzu_boxSetStart(HMM_Sub(op->ui.pos, HMM_V2(radius, radius)));
-            snzu_boxSetEnd(HMM_Add(op->ui.pos, HMM_V2(radius, radius)));
-
-            snzu_boxSetColor(ui_colorTransparentPanel);
-            snzu_boxSetBorder(ui_borderThickness, textColor);
+            HMM_Vec2 nodeMin = HMM_Sub(op->ui.pos, HMM_V2(radius, radius));
+            HMM_Vec2 nodeMax = HMM_Add(op->ui.pos, HMM_V2(radius, radius));
+            bool nodeVisible = nodeMax.X > viewMin.X && nodeMin.X < viewMax.X && nodeMax.Y > viewMin.Y && nodeMin.Y < viewMax.Y;
+
+            if (nodeVisible) {
+                op->ui.built = true;
+                snzu_boxNew(snz_arenaFormatStr(scratch, "%p", (void*)op));
+                uint64_t flags = SNZU_IF_HOVER | SNZU_IF_MOUSE_BUTTONS;
+                if (inRotateOrMoveMode) {
+                    flags |= SNZU_IF_ALLOW_EVENT_FALLTHROUGH;
+                }
+                snzu_boxSetInteractionOutput(&op->ui.inter, flags);
+
+                HMM_Vec4 textColor = HMM_Lerp(ui_colorText, op->ui.sel.selectionAnim, ui_colorAccent);
+                SNZ_ASSERTF(op->kind > TL_OPK_NONE && op->kind < TL_OPK_COUNT, "op kind out of bounds. was: %d", op->kind);
+                snzu_boxSetDisplayStr(&ui_labelFont, textColor, tl_opKindNames[op->kind]);
+
+                snzu_boxSetCornerRadius(radius);
+                snzu_boxSetStart(nodeMin);
+                snzu_boxSetEnd(nodeMax);
+
+                snzu_boxSetColor(ui_colorTransparentPanel);
+                snzu_boxSetBorder(ui_borderThickness, op->error.kind ? ui_colorErr : textColor);
+
+                if (timeline->recordSolveStats && op->solve.stats.valid) {
+                    float heat = maxSolveSeconds > 0 ? (float)(op->solve.stats.seconds / maxSolveSeconds) : 0;
+                    HMM_Vec4 hot = ui_colorErr;
+                    hot.A = ui_colorTransparentPanel.A;
+                    snzu_boxSetColor(HMM_Lerp(ui_colorTransparentPanel, heat, hot));
+                    snzu_boxScope() {
+                        _tl_buildNodeStats(op, radius, scratch);
+                    }
+                }
+            }
 
             // dep lines
             for (int i = 0; i < TL_OP_ARG_MAX_COUNT; i++) {
@@ -186,7 +261,9 @@ void tl_build(tl_Timeline* timeline, snz_Arena* scratch, HMM_Vec2 panelSize, HMM
                 if (!expectedKinds) {
                     continue;
                 } else if (!argKind) {
-                    snzu_boxSetBorder(ui_borderThickness, ui_colorErr);
+                    if (nodeVisible) {
+                        snzu_boxSetBorder(ui_borderThickness, ui_colorErr);
+                    }
                     continue;
                 }
 
@@ -196,6 +273,15 @@ void tl_build(tl_Timeline* timeline, snz_Arena* scratch, HMM_Vec2 panelSize, HMM
                 }
 
                 tl_Op* dependency = tl_timelineGetOpByUID(timeline, op->args[i].geoId.opUniqueId);
+                if (!dependency) {
+                    continue;  // border's already red from op->error
+                }
+                HMM_Vec2 lineMin = HMM_V2(SNZ_MIN(op->ui.pos.X, dependency->ui.pos.X), SNZ_MIN(op->ui.pos.Y, dependency->ui.pos.Y));
+                HMM_Vec2 lineMax = HMM_V2(SNZ_MAX(op->ui.pos.X, dependency->ui.pos.X), SNZ_MAX(op->ui.pos.Y, dependency->ui.pos.Y));
+                if (lineMax.X < viewMin.X || lineMin.X > viewMax.X || lineMax.Y < viewMin.Y || lineMin.Y > viewMax.Y) {
+                    continue;  // op came up for its node or a different line
+                }
+
                 HMM_Vec4 pts[2] = { 0 };
                 pts[0].XY = op->ui.pos;
                 pts[1].XY = dependency->ui.pos;
@@ -211,7 +297,7 @@ void tl_build(tl_Timeline* timeline, snz_Arena* scratch, HMM_Vec2 panelSize, HMM
                 snzr_drawLine(pts, 2, ui_colorText, ui_borderThickness, vp);
             }
 
-            if (op == timeline->activeOp) {
+            if (nodeVisible && op == timeline->activeOp) {
                 snzu_boxSetColor(ui_colorTransparentAccent);
             }
         }
@@ -274,6 +360,7 @@ void tl_argbarBuild(tl_Timeline* t, tl_Op* op, tl_Op** focusOverride) {
             if (expectedKinds & t->takenArgSignal.kind) {
                 // FIXME: error indicator
                 op->args[*selectedArgIdx] = t->takenArgSignal;
+                tl_nodeGridMarkStale(t);
                 (*selectedArgIdx)++;
                 // FIXME: assert geokind of geoid matches that of arg kind
                 // FIXME: NO CIRCULAR DEPS!!
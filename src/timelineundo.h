@@ -0,0 +1,1013 @@
+#pragma once
+
+#include <stdlib.h>
+
+#include "sketches2.h"
+#include "snooze.h"
+#include "timeline.h"
+
+/*
+TLU:
+undo/redo for the timeline. Every commit makes a new state, which is a persistent map from op uid to an immutable
+version of that op. Sketches inside of those are the same thing again, one map each for points, lines and constraints.
+Anything that didn't change since the last state is shared with it, so a commit only allocates the ops/elements that
+are different + the few map nodes above them, instead of a copy of the whole timeline.
+
+Finding what changed hashes every op in the timeline, same as the journal does (see _tlu_opHash), and only the sketches
+that came out different get walked element by element.
+
+Undoing diffs the two states maps (shared subtrees get skipped) and writes just the ops that differ back into the live
+timeline. Ops that don't exist in the target state get marked for deletion and left for the usual cull, ops that come
+back keep the uid they had. Uids never go backwards, so geo refs to something that got undone still break like they
+would have from a delete.
+
+The camera, selection, and which op is active aren't part of any of this.
+
+Everything lives in one growable arena. When that goes over the budget the oldest states get dropped, and whatever is
+left is copied into a fresh arena (shared nodes stay shared, see the forward pointers) so the memory actually comes back.
+*/
+
+#define TLU_ARENA_BLOCK_SIZE 1000000
+
+// bits of the uid each level of a map takes
+#define _TLU_MAP_BITS 4
+#define _TLU_MAP_WIDTH (1 << _TLU_MAP_BITS)
+
+typedef struct _tlu_MapNode _tlu_MapNode;
+struct _tlu_MapNode {
+    _tlu_MapNode* forward; // only used while compacting, see _tlu_historyDropOldest
+    void* slots[_TLU_MAP_WIDTH]; // child nodes, or values on the bottom level
+};
+
+// uid -> version, never edited once a node is made. Setting copies the path down to the key and nothing else.
+typedef struct {
+    _tlu_MapNode* root; // null when empty
+    int64_t depth; // levels of nodes, the map can hold keys below 16^depth
+    int64_t count;
+} _tlu_Map;
+
+SNZ_SLICE_NAMED(void*, _tlu_PtrSlice);
+
+// every version struct starts with this
+typedef struct {
+    void* forward; // only used while compacting, see _tlu_historyDropOldest
+    int64_t uid;
+} _tlu_VersionHeader;
+
+// slots are where the elt was in the sketches pool, restores put it back in the same one. Keeps iteration order thru undos.
+typedef struct {
+    _tlu_VersionHeader header;
+    int64_t slot;
+    HMM_Vec2 pos;
+} _tlu_PointVersion;
+
+typedef struct {
+    _tlu_VersionHeader header;
+    int64_t slot;
+    int64_t p1Uid;
+    int64_t p2Uid;
+} _tlu_LineVersion;
+
+typedef struct {
+    _tlu_VersionHeader header;
+    int64_t slot;
+    sk_ConstraintKind kind;
+    int64_t line1Uid; // zero for none
+    int64_t line2Uid;
+    bool flipLine1;
+    bool flipLine2;
+    float value;
+} _tlu_ConstraintVersion;
+
+typedef struct {
+    _tlu_VersionHeader header; // uid of the op
+    uint64_t hash; // _tlu_sketchHash of the sketch this came from
+    _tlu_Map points;
+    _tlu_Map lines;
+    _tlu_Map constraints;
+    int64_t nextUniqueId;
+    int64_t originPtUid;
+    int64_t originLineUid;
+    float originAngle;
+} _tlu_SketchVersion;
+
+typedef struct {
+    _tlu_VersionHeader header;
+    uint64_t hash; // _tlu_opHash of the op this came from
+    tl_OpKind kind;
+    HMM_Vec2 pos;
+    tl_OpArg args[TL_OP_ARG_MAX_COUNT]; // geo ids are deep copies in the history arena
+    mesh_FaceSlice baseGeometry; // not copied, base geometry never changes after being pushed
+    const _tlu_SketchVersion* sketch; // null unless kind is sketch
+} _tlu_OpVersion;
+
+typedef struct {
+    _tlu_Map ops; // uid -> _tlu_OpVersion
+} _tlu_State;
+
+typedef struct {
+    snz_Arena arena; // every version + map node, gets swapped out for a fresh one on compaction
+    _tlu_State* states; // oldest first, malloced
+    int64_t stateCount;
+    int64_t stateCapacity;
+    int64_t currentIdx; // the state the timeline was in as of the last commit/undo/redo, -1 before the first commit
+    int64_t budgetBytes; // when the arena goes over this it gets cut down to half of it, see _tlu_historyTrim
+    int64_t droppedCount; // states thrown out for the budget so far
+} tlu_History;
+
+tlu_History tlu_historyInit(int64_t budgetBytes) {
+    return (tlu_History){
+        .arena = snz_arenaInitGrowable(TLU_ARENA_BLOCK_SIZE, "undo history arena"),
+        .currentIdx = -1,
+        .budgetBytes = budgetBytes,
+    };
+}
+
+void tlu_historyDeinit(tlu_History* h) {
+    snz_arenaDeinit(&h->arena);
+    free(h->states);
+    memset(h, 0, sizeof(*h));
+}
+
+static int64_t _tlu_mapKeyLimit(int64_t depth) {
+    SNZ_ASSERTF(depth * _TLU_MAP_BITS < 63, "undo map too deep: %" PRId64, depth);
+    return (int64_t)1 << (depth * _TLU_MAP_BITS);
+}
+
+// null if key isn't in m
+static void* _tlu_mapGet(_tlu_Map m, int64_t key) {
+    if (!m.root || key < 0 || key >= _tlu_mapKeyLimit(m.depth)) {
+        return NULL;
+    }
+    _tlu_MapNode* n = m.root;
+    for (int64_t level = m.depth - 1; level > 0; level--) {
+        n = n->slots[(key >> (level * _TLU_MAP_BITS)) & (_TLU_MAP_WIDTH - 1)];
+        if (!n) {
+            return NULL;
+        }
+    }
+    return n->slots[key & (_TLU_MAP_WIDTH - 1)];
+}
+
+static _tlu_MapNode* _tlu_mapNodeSet(const _tlu_MapNode* n, int64_t level, int64_t key, void* val, void** outOld, snz_Arena* arena) {
+    _tlu_MapNode* new = SNZ_ARENA_PUSH(arena, _tlu_MapNode);
+    if (n) {
+        *new = *n;
+        new->forward = NULL;
+    }
+    int64_t idx = (key >> (level * _TLU_MAP_BITS)) & (_TLU_MAP_WIDTH - 1);
+    if (level == 0) {
+        *outOld = new->slots[idx];
+        new->slots[idx] = val;
+    } else {
+        new->slots[idx] = _tlu_mapNodeSet(new->slots[idx], level - 1, key, val, outOld, arena);
+    }
+    return new;
+}
+
+// val of null removes key, new nodes go in arena and the old ones are left alone
+// FIXME: removing never frees up nodes that end up empty
+static void _tlu_mapSet(_tlu_Map* m, int64_t key, void* val, snz_Arena* arena) {
+    SNZ_ASSERTF(key > 0, "undo map key has to be a uid, was: %" PRId64, key);
+    if (!val && !_tlu_mapGet(*m, key)) {
+        return;
+    }
+
+    if (!m->root) {
+        m->depth = 1;
+    }
+    while (key >= _tlu_mapKeyLimit(m->depth)) {
+        if (m->root) {
+            _tlu_MapNode* newRoot = SNZ_ARENA_PUSH(arena, _tlu_MapNode);
+            newRoot->slots[0] = m->root;
+            m->root = newRoot;
+        }
+        m->depth++;
+    }
+
+    void* old = NULL;
+    m->root = _tlu_mapNodeSet(m->root, m->depth - 1, key, val, &old, arena);
+    m->count += (val != NULL) - (old != NULL);
+}
+
+static void _tlu_mapNodeCollect(const _tlu_MapNode* n, int64_t level, snz_Arena* arena) {
+    for (int64_t i = 0; i < _TLU_MAP_WIDTH; i++) {
+        if (!n->slots[i]) {
+            continue;
+        } else if (level == 0) {
+            *SNZ_ARENA_PUSH(arena, void*) = n->slots[i];
+        } else {
+            _tlu_mapNodeCollect(n->slots[i], level - 1, arena);
+        }
+    }
+}
+
+// every value in m, in key order
+static _tlu_PtrSlice _tlu_mapCollect(_tlu_Map m, snz_Arena* scratch) {
+    SNZ_ARENA_ARR_BEGIN(scratch, void*);
+    if (m.root) {
+        _tlu_mapNodeCollect(m.root, m.depth - 1, scratch);
+    }
+    return SNZ_ARENA_ARR_END_NAMED(scratch, void*, _tlu_PtrSlice);
+}
+
+// root of m as if it were depth levels deep, the extra levels go in scratch
+static const _tlu_MapNode* _tlu_mapRootAtDepth(_tlu_Map m, int64_t depth, snz_Arena* scratch) {
+    const _tlu_MapNode* root = m.root;
+    if (!root) {
+        return NULL;
+    }
+    for (int64_t d = m.depth; d < depth; d++) {
+        _tlu_MapNode* wrap = SNZ_ARENA_PUSH(scratch, _tlu_MapNode);
+        wrap->slots[0] = (void*)root;
+        root = wrap;
+    }
+    return root;
+}
+
+static void _tlu_mapNodeDiff(const _tlu_MapNode* a, const _tlu_MapNode* b, int64_t level, int64_t keyPrefix, snz_Arena* out) {
+    if (a == b) {
+        return;
+    }
+    for (int64_t i = 0; i < _TLU_MAP_WIDTH; i++) {
+        void* slotA = a ? a->slots[i] : NULL;
+        void* slotB = b ? b->slots[i] : NULL;
+        if (slotA == slotB) {
+            continue;
+        }
+        int64_t key = (keyPrefix << _TLU_MAP_BITS) | i;
+        if (level == 0) {
+            *SNZ_ARENA_PUSH(out, int64_t) = key;
+        } else {
+            _tlu_mapNodeDiff(slotA, slotB, level - 1, key, out);
+        }
+    }
+}
+
+// every key where a and b have different values, in order. Anything the two share gets skipped without looking in it.
+static int64_tSlice _tlu_mapDiff(_tlu_Map a, _tlu_Map b, snz_Arena* scratch) {
+    int64_t depth = SNZ_MAX(a.depth, b.depth);
+    const _tlu_MapNode* rootA = _tlu_mapRootAtDepth(a, depth, scratch);
+    const _tlu_MapNode* rootB = _tlu_mapRootAtDepth(b, depth, scratch);
+    SNZ_ARENA_ARR_BEGIN(scratch, int64_t);
+    if (depth > 0) {
+        _tlu_mapNodeDiff(rootA, rootB, depth - 1, 0, scratch);
+    }
+    return SNZ_ARENA_ARR_END(scratch, int64_t);
+}
+
+// takes out every val in m whose uid isn't marked in live
+static void _tlu_mapRemoveDead(_tlu_Map* m, const bool* live, int64_t liveCount, snz_Arena* arena, snz_Arena* scratch) {
+    _tlu_PtrSlice vals = _tlu_mapCollect(*m, scratch);
+    for (int64_t i = 0; i < vals.count; i++) {
+        int64_t uid = ((_tlu_VersionHeader*)vals.elems[i])->uid;
+        if (uid >= liveCount || !live[uid]) {
+            _tlu_mapSet(m, uid, NULL, arena);
+        }
+    }
+}
+
+static mesh_GeoID _tlu_geoIdCopy(const mesh_GeoID* id, snz_Arena* arena) {
+    mesh_GeoID out = *id;
+    if (out.diffGeo1) {
+        out.diffGeo1 = mesh_geoIdDuplicate(out.diffGeo1, arena);
+    }
+    if (out.diffGeo2) {
+        out.diffGeo2 = mesh_geoIdDuplicate(out.diffGeo2, arena);
+    }
+    return out;
+}
+
+// _tl_hashSketch leaves out which elts are the origin, these need them
+static uint64_t _tlu_hashSketchOrigin(uint64_t hash, const sk_Sketch* sketch) {
+    int64_t originIds[2] = {
+        sketch->originPt ? sketch->originPt->uniqueId : 0,
+        sketch->originLine ? sketch->originLine->uniqueId : 0,
+    };
+    return _TL_HASH_VAL(hash, originIds);
+}
+
+static uint64_t _tlu_sketchHash(const sk_Sketch* sketch) {
+    uint64_t hash = _tl_hashSketch(14695981039346656037ULL, sketch);
+    return _tl_hashFinish(_tlu_hashSketchOrigin(hash, sketch));
+}
+
+// everything about op that the history keeps, two ops that hash the same get the same version
+static uint64_t _tlu_opHash(const tl_Op* op) {
+    uint64_t hash = _tl_opSaveHash(op);
+    if (op->kind == TL_OPK_SKETCH) {
+        hash = _tlu_hashSketchOrigin(hash, &op->val.sketch);
+    }
+    return _tl_hashFinish(hash);
+}
+
+// vec2s/floats are compared as bytes so that whatever comes back from an undo hashes the same as what went in
+#define _TLU_BYTES_EQ(a, b) (memcmp(&(a), &(b), sizeof(a)) == 0)
+
+// old if nothing in the sketch changed since it was made, otherwise a new version sharing everything that didn't
+static const _tlu_SketchVersion* _tlu_sketchVersionMake(int64_t opUid, const sk_Sketch* sketch, const _tlu_SketchVersion* old, snz_Arena* arena, snz_Arena* scratch) {
+    uint64_t hash = _tlu_sketchHash(sketch);
+    if (old && old->hash == hash) {
+        return old;
+    }
+
+    _tlu_SketchVersion* v = SNZ_ARENA_PUSH(arena, _tlu_SketchVersion);
+    if (old) {
+        *v = *old;
+    }
+    v->header = (_tlu_VersionHeader){ .uid = opUid };
+    v->hash = hash;
+    v->nextUniqueId = sketch->nextUniqueId;
+    v->originPtUid = sketch->originPt ? sketch->originPt->uniqueId : 0;
+    v->originLineUid = sketch->originLine ? sketch->originLine->uniqueId : 0;
+    v->originAngle = sketch->originAngle;
+
+    int64_t scratchStart = snz_arenaUsedBytes(scratch);
+    // points, lines and constraints all come out of the same uid counter, so one array covers them all
+    bool* live = SNZ_ARENA_PUSH_ARR(scratch, sketch->nextUniqueId, bool);
+
+    int64_t count = 0;
+    for (sk_Point* p = sk_sketchFirstPoint(sketch); p; p = sk_sketchNextPoint(sketch, p)) {
+        SNZ_ASSERTF(p->uniqueId > 0 && p->uniqueId < sketch->nextUniqueId, "bad sketch point uid: %" PRId64, p->uniqueId);
+        live[p->uniqueId] = true;
+        count++;
+        const _tlu_PointVersion* o = _tlu_mapGet(v->points, p->uniqueId);
+        if (o && o->slot == p->slot && _TLU_BYTES_EQ(o->pos, p->pos)) {
+            continue;
+        }
+        _tlu_PointVersion* new = SNZ_ARENA_PUSH(arena, _tlu_PointVersion);
+        *new = (_tlu_PointVersion){ .header.uid = p->uniqueId, .slot = p->slot, .pos = p->pos };
+        _tlu_mapSet(&v->points, p->uniqueId, new, arena);
+    }
+    if (v->points.count != count) {
+        _tlu_mapRemoveDead(&v->points, live, sketch->nextUniqueId, arena, scratch);
+    }
+
+    count = 0;
+    for (sk_Line* l = sk_sketchFirstLine(sketch); l; l = sk_sketchNextLine(sketch, l)) {
+        SNZ_ASSERTF(l->uniqueId > 0 && l->uniqueId < sketch->nextUniqueId, "bad sketch line uid: %" PRId64, l->uniqueId);
+        live[l->uniqueId] = true;
+        count++;
+        _tlu_LineVersion line = (_tlu_LineVersion){
+            .header.uid = l->uniqueId,
+            .slot = l->slot,
+            .p1Uid = l->p1->uniqueId,
+            .p2Uid = l->p2->uniqueId,
+        };
+        const _tlu_LineVersion* o = _tlu_mapGet(v->lines, l->uniqueId);
+        if (o && o->slot == line.slot && o->p1Uid == line.p1Uid && o->p2Uid == line.p2Uid) {
+            continue;
+        }
+        _tlu_LineVersion* new = SNZ_ARENA_PUSH(arena, _tlu_LineVersion);
+        *new = line;
+        _tlu_mapSet(&v->lines, l->uniqueId, new, arena);
+    }
+    if (v->lines.count != count) {
+        _tlu_mapRemoveDead(&v->lines, live, sketch->nextUniqueId, arena, scratch);
+    }
+
+    count = 0;
+    for (sk_Constraint* c = sk_sketchFirstConstraint(sketch); c; c = sk_sketchNextConstraint(sketch, c)) {
+        SNZ_ASSERTF(c->uniqueId > 0 && c->uniqueId < sketch->nextUniqueId, "bad sketch constraint uid: %" PRId64, c->uniqueId);
+        live[c->uniqueId] = true;
+        count++;
+        _tlu_ConstraintVersion con = (_tlu_ConstraintVersion){
+            .header.uid = c->uniqueId,
+            .slot = c->slot,
+            .kind = c->kind,
+            .line1Uid = c->line1 ? c->line1->uniqueId : 0,
+            .line2Uid = c->line2 ? c->line2->uniqueId : 0,
+            .flipLine1 = c->flipLine1,
+            .flipLine2 = c->flipLine2,
+            .value = c->value,
+        };
+        const _tlu_ConstraintVersion* o = _tlu_mapGet(v->constraints, c->uniqueId);
+        if (o && o->slot == con.slot && o->kind == con.kind && o->line1Uid == con.line1Uid && o->line2Uid == con.line2Uid &&
+            o->flipLine1 == con.flipLine1 && o->flipLine2 == con.flipLine2 && _TLU_BYTES_EQ(o->value, con.value)) {
+            continue;
+        }
+        _tlu_ConstraintVersion* new = SNZ_ARENA_PUSH(arena, _tlu_ConstraintVersion);
+        *new = con;
+        _tlu_mapSet(&v->constraints, c->uniqueId, new, arena);
+    }
+    if (v->constraints.count != count) {
+        _tlu_mapRemoveDead(&v->constraints, live, sketch->nextUniqueId, arena, scratch);
+    }
+
+    snz_arenaPop(scratch, snz_arenaUsedBytes(scratch) - scratchStart);
+    return v;
+}
+
+static const _tlu_OpVersion* _tlu_opVersionMake(const tl_Op* op, uint64_t hash, const _tlu_OpVersion* old, snz_Arena* arena, snz_Arena* scratch) {
+    _tlu_OpVersion* v = SNZ_ARENA_PUSH(arena, _tlu_OpVersion);
+    *v = (_tlu_OpVersion){
+        .header.uid = op->uniqueId,
+        .hash = hash,
+        .kind = op->kind,
+        .pos = op->ui.pos,
+    };
+    for (int64_t i = 0; i < TL_OP_ARG_MAX_COUNT; i++) {
+        v->args[i] = op->args[i];
+        v->args[i].geoId = _tlu_geoIdCopy(&op->args[i].geoId, arena);
+    }
+
+    if (op->kind == TL_OPK_SKETCH) {
+        v->sketch = _tlu_sketchVersionMake(op->uniqueId, &op->val.sketch, old ? old->sketch : NULL, arena, scratch);
+    } else if (op->kind == TL_OPK_BASE_GEOMETRY) {
+        v->baseGeometry = op->val.baseGeometry;
+    }
+    return v;
+}
+
+static void* _tlu_versionCopy(void* val, int64_t size, snz_Arena* arena) {
+    if (!val) {
+        return NULL;
+    }
+    _tlu_VersionHeader* header = (_tlu_VersionHeader*)val;
+    if (header->forward) {
+        return header->forward;
+    }
+    void* new = snz_arenaPush(arena, size, 1);
+    memcpy(new, val, size);
+    ((_tlu_VersionHeader*)new)->forward = NULL;
+    header->forward = new;
+    return new;
+}
+
+typedef void* (*_tlu_CopyFunc)(void* val, snz_Arena* arena);
+
+// copies whatever hasn't been copied yet, and leaves forward pointers in the old nodes so anything shared stays shared
+static _tlu_MapNode* _tlu_mapNodeCopy(_tlu_MapNode* n, int64_t level, _tlu_CopyFunc copyVal, snz_Arena* arena) {
+    if (!n) {
+        return NULL;
+    } else if (n->forward) {
+        return n->forward;
+    }
+    _tlu_MapNode* new = SNZ_ARENA_PUSH(arena, _tlu_MapNode);
+    n->forward = new;
+    for (int64_t i = 0; i < _TLU_MAP_WIDTH; i++) {
+        if (level == 0) {
+            new->slots[i] = copyVal(n->slots[i], arena);
+        } else {
+            new->slots[i] = _tlu_mapNodeCopy(n->slots[i], level - 1, copyVal, arena);
+        }
+    }
+    return new;
+}
+
+static void _tlu_mapCopy(_tlu_Map* m, _tlu_CopyFunc copyVal, snz_Arena* arena) {
+    m->root = _tlu_mapNodeCopy(m->root, m->depth - 1, copyVal, arena);
+}
+
+static void* _tlu_pointVersionCopy(void* val, snz_Arena* arena) {
+    return _tlu_versionCopy(val, sizeof(_tlu_PointVersion), arena);
+}
+
+static void* _tlu_lineVersionCopy(void* val, snz_Arena* arena) {
+    return _tlu_versionCopy(val, sizeof(_tlu_LineVersion), arena);
+}
+
+static void* _tlu_constraintVersionCopy(void* val, snz_Arena* arena) {
+    return _tlu_versionCopy(val, sizeof(_tlu_ConstraintVersion), arena);
+}
+
+static const _tlu_SketchVersion* _tlu_sketchVersionCopy(const _tlu_SketchVersion* v, snz_Arena* arena) {
+    if (!v || v->header.forward) {
+        return v ? v->header.forward : NULL;
+    }
+    _tlu_SketchVersion* new = _tlu_versionCopy((void*)v, sizeof(*v), arena);
+    _tlu_mapCopy(&new->points, _tlu_pointVersionCopy, arena);
+    _tlu_mapCopy(&new->lines, _tlu_lineVersionCopy, arena);
+    _tlu_mapCopy(&new->constraints, _tlu_constraintVersionCopy, arena);
+    return new;
+}
+
+static void* _tlu_opVersionCopy(void* val, snz_Arena* arena) {
+    _tlu_OpVersion* v = (_tlu_OpVersion*)val;
+    if (!v || v->header.forward) {
+        return v ? v->header.forward : NULL;
+    }
+    _tlu_OpVersion* new = _tlu_versionCopy(v, sizeof(*v), arena);
+    for (int64_t i = 0; i < TL_OP_ARG_MAX_COUNT; i++) {
+        new->args[i].geoId = _tlu_geoIdCopy(&v->args[i].geoId, arena);
+    }
+    new->sketch = _tlu_sketchVersionCopy(v->sketch, arena);
+    return new;
+}
+
+// throws out the dropCount oldest states, and moves everything the rest use to a new arena
+static void _tlu_historyDropOldest(tlu_History* h, int64_t dropCount) {
+    SNZ_ASSERTF(dropCount >= 0 && dropCount <= h->currentIdx, "can't drop %" PRId64 " undo states, current is %" PRId64, dropCount, h->currentIdx);
+    h->stateCount -= dropCount;
+    memmove(h->states, h->states + dropCount, sizeof(*h->states) * h->stateCount);
+    h->currentIdx -= dropCount;
+    h->droppedCount += dropCount;
+
+    snz_Arena arena = snz_arenaInitGrowable(TLU_ARENA_BLOCK_SIZE, "undo history arena");
+    for (int64_t i = 0; i < h->stateCount; i++) {
+        _tlu_mapCopy(&h->states[i].ops, _tlu_opVersionCopy, &arena);
+    }
+    snz_arenaDeinit(&h->arena);
+    h->arena = arena;
+}
+
+// only call with current as the newest state
+static void _tlu_historyTrim(tlu_History* h) {
+    if (snz_arenaUsedBytes(&h->arena) <= h->budgetBytes) {
+        return;
+    }
+
+    // first pass just clears out redo branches that got dropped, which could be enough by itself
+    int64_t dropCount = 0;
+    while (true) {
+        _tlu_historyDropOldest(h, dropCount);
+        if (snz_arenaUsedBytes(&h->arena) <= h->budgetBytes / 2 || h->currentIdx == 0) {
+            break;
+        }
+        dropCount = SNZ_MAX(h->currentIdx / 4, 1);
+    }
+}
+
+// makes a new state from anything in t that's different from the current one, false if nothing was.
+// Redo states past the current one get dropped when this makes a new state.
+// ops marked for deletion are left out, so cull before this.
+// FIXME: hashes every op in t to find the changes, some change tracking would let this skip most of them
+bool tlu_commit(tlu_History* h, tl_Timeline* t, snz_Arena* scratch) {
+    _tlu_Map prevOps = h->currentIdx >= 0 ? h->states[h->currentIdx].ops : (_tlu_Map){ 0 };
+    _tlu_Map ops = prevOps;
+    bool changed = h->currentIdx < 0;
+
+    int64_t liveCount = 0;
+    for (tl_Op* op = t->firstOp; op; op = op->next) {
+        if (op->markedForDeletion) {
+            continue;
+        }
+        liveCount++;
+        uint64_t hash = _tlu_opHash(op);
+        const _tlu_OpVersion* old = _tlu_mapGet(prevOps, op->uniqueId);
+        if (old && old->hash == hash) {
+            continue;
+        }
+        const _tlu_OpVersion* v = _tlu_opVersionMake(op, hash, old, &h->arena, scratch);
+        _tlu_mapSet(&ops, op->uniqueId, (void*)v, &h->arena);
+        changed = true;
+    }
+
+    if (ops.count != liveCount) {
+        int64_t scratchStart = snz_arenaUsedBytes(scratch);
+        _tlu_PtrSlice vals = _tlu_mapCollect(ops, scratch);
+        for (int64_t i = 0; i < vals.count; i++) {
+            int64_t uid = ((_tlu_VersionHeader*)vals.elems[i])->uid;
+            tl_Op* op = tl_timelineGetOpByUID(t, uid);
+            if (!op || op->markedForDeletion) {
+                _tlu_mapSet(&ops, uid, NULL, &h->arena);
+                changed = true;
+            }
+        }
+        snz_arenaPop(scratch, snz_arenaUsedBytes(scratch) - scratchStart);
+    }
+
+    if (!changed) {
+        return false;
+    }
+
+    h->stateCount = h->currentIdx + 1;
+    if (h->stateCount >= h->stateCapacity) {
+        h->stateCapacity = SNZ_MAX(h->stateCapacity * 2, 64);
+        h->states = realloc(h->states, sizeof(*h->states) * h->stateCapacity);
+        SNZ_ASSERT(h->states, "undo state realloc failed.");
+    }
+    h->states[h->stateCount] = (_tlu_State){ .ops = ops };
+    h->stateCount++;
+    h->currentIdx++;
+    _tlu_historyTrim(h);
+    return true;
+}
+
+// makes sketch match v, elts that are in both keep their memory so pointers to them stay good.
+// any that aren't in v get freed, same as a delete. New ones go back in the slot they were in when v was made.
+static void _tlu_sketchRestore(sk_Sketch* sketch, const _tlu_SketchVersion* v, snz_Arena* scratch) {
+    int64_t scratchStart = snz_arenaUsedBytes(scratch);
+    int64_t uidCount = SNZ_MAX(sketch->nextUniqueId, v->nextUniqueId);
+
+    sk_Point** points = SNZ_ARENA_PUSH_ARR(scratch, uidCount, sk_Point*);
+    sk_Line** lines = SNZ_ARENA_PUSH_ARR(scratch, uidCount, sk_Line*);
+    sk_Constraint** constraints = SNZ_ARENA_PUSH_ARR(scratch, uidCount, sk_Constraint*);
+    const _tlu_PointVersion** pointVersions = SNZ_ARENA_PUSH_ARR(scratch, uidCount, const _tlu_PointVersion*);
+    const _tlu_LineVersion** lineVersions = SNZ_ARENA_PUSH_ARR(scratch, uidCount, const _tlu_LineVersion*);
+    const _tlu_ConstraintVersion** constraintVersions = SNZ_ARENA_PUSH_ARR(scratch, uidCount, const _tlu_ConstraintVersion*);
+
+    _tlu_PtrSlice vals = _tlu_mapCollect(v->points, scratch);
+    for (int64_t i = 0; i < vals.count; i++) {
+        const _tlu_PointVersion* pv = vals.elems[i];
+        pointVersions[pv->header.uid] = pv;
+    }
+    vals = _tlu_mapCollect(v->lines, scratch);
+    for (int64_t i = 0; i < vals.count; i++) {
+        const _tlu_LineVersion* lv = vals.elems[i];
+        lineVersions[lv->header.uid] = lv;
+    }
+    vals = _tlu_mapCollect(v->constraints, scratch);
+    for (int64_t i = 0; i < vals.count; i++) {
+        const _tlu_ConstraintVersion* cv = vals.elems[i];
+        constraintVersions[cv->header.uid] = cv;
+    }
+
+    // keep whatever's in both, free the rest. elts never move while alive so the slots should always match,
+    // but one that doesn't gets freed + put back where v has it instead of landing on top of something else
+    for (sk_Point* p = sk_sketchFirstPoint(sketch); p; p = sk_sketchNextPoint(sketch, p)) {
+        const _tlu_PointVersion* pv = pointVersions[p->uniqueId];
+        if (pv && pv->slot == p->slot) {
+            points[p->uniqueId] = p;
+        } else {
+            sk_sketchFreePoint(sketch, p);
+        }
+    }
+    for (sk_Line* l = sk_sketchFirstLine(sketch); l; l = sk_sketchNextLine(sketch, l)) {
+        const _tlu_LineVersion* lv = lineVersions[l->uniqueId];
+        if (lv && lv->slot == l->slot) {
+            lines[l->uniqueId] = l;
+        } else {
+            sk_sketchFreeLine(sketch, l);
+        }
+    }
+    for (sk_Constraint* c = sk_sketchFirstConstraint(sketch); c; c = sk_sketchNextConstraint(sketch, c)) {
+        const _tlu_ConstraintVersion* cv = constraintVersions[c->uniqueId];
+        if (cv && cv->slot == c->slot) {
+            constraints[c->uniqueId] = c;
+        } else {
+            sk_sketchFreeConstraint(sketch, c);
+        }
+    }
+
+    // write versions in, every pt has to exist before lines can point at them and the same for lines -> constraints
+    for (int64_t uid = 1; uid < uidCount; uid++) {
+        const _tlu_PointVersion* pv = pointVersions[uid];
+        if (!pv) {
+            continue;
+        } else if (!points[uid]) {
+            points[uid] = sk_sketchAllocPointAt(sketch, pv->slot);
+            points[uid]->uniqueId = uid;
+        }
+        points[uid]->pos = pv->pos;
+    }
+    for (int64_t uid = 1; uid < uidCount; uid++) {
+        const _tlu_LineVersion* lv = lineVersions[uid];
+        if (!lv) {
+            continue;
+        } else if (!lines[uid]) {
+            lines[uid] = sk_sketchAllocLineAt(sketch, lv->slot);
+            lines[uid]->uniqueId = uid;
+        }
+        lines[uid]->p1 = points[lv->p1Uid];
+        lines[uid]->p2 = points[lv->p2Uid];
+        SNZ_ASSERTF(lines[uid]->p1 && lines[uid]->p2, "undo line %" PRId64 " is missing a point.", uid);
+    }
+    sketch->lineTable.built = false;  // new + rewired lines aren't in it, gets rebuilt on the next add
+    for (int64_t uid = 1; uid < uidCount; uid++) {
+        const _tlu_ConstraintVersion* cv = constraintVersions[uid];
+        if (!cv) {
+            continue;
+        } else if (!constraints[uid]) {
+            constraints[uid] = sk_sketchAllocConstraintAt(sketch, cv->slot);
+            constraints[uid]->uniqueId = uid;
+        }
+        sk_Constraint* c = constraints[uid];
+        c->kind = cv->kind;
+        c->line1 = cv->line1Uid ? lines[cv->line1Uid] : NULL;
+        c->line2 = cv->line2Uid ? lines[cv->line2Uid] : NULL;
+        c->flipLine1 = cv->flipLine1;
+        c->flipLine2 = cv->flipLine2;
+        c->value = cv->value;
+    }
+
+    sketch->originPt = v->originPtUid ? points[v->originPtUid] : NULL;
+    sketch->originLine = v->originLineUid ? lines[v->originLineUid] : NULL;
+    sketch->originAngle = v->originAngle;
+    sketch->nextUniqueId = uidCount;
+    sk_sketchMarkChanged(sketch);
+
+    snz_arenaPop(scratch, snz_arenaUsedBytes(scratch) - scratchStart);
+}
+
+// solve + ui state is left alone, solving sees the new hash
+static void _tlu_opRestore(tl_Timeline* t, tl_Op* op, const _tlu_OpVersion* v, snz_Arena* scratch) {
+    op->markedForDeletion = false;
+    op->ui.pos = v->pos;
+    tl_nodeGridMarkStale(t);
+    for (int64_t i = 0; i < TL_OP_ARG_MAX_COUNT; i++) {
+        op->args[i] = v->args[i];
+        op->args[i].geoId = _tlu_geoIdCopy(&v->args[i].geoId, t->operationArena);
+    }
+
+    if (v->kind == TL_OPK_SKETCH) {
+        if (op->kind != TL_OPK_SKETCH) {
+            // same as a sketch loaded from a file, FIXME: gets its own arena when ops get free lists
+            op->val.sketch = (sk_Sketch){ .arena = t->operationArena, .nextUniqueId = 1 };
+        }
+        _tlu_sketchRestore(&op->val.sketch, v->sketch, scratch);
+    } else if (v->kind == TL_OPK_BASE_GEOMETRY) {
+        op->val.baseGeometry = v->baseGeometry;
+    }
+    op->kind = v->kind;
+    SNZ_ASSERTF(_tlu_opHash(op) == v->hash, "undo restore of op %" PRId64 " didn't match what was saved.", op->uniqueId);
+}
+
+// writes every op that differs between the current state and targetIdx back into t
+static void _tlu_historyMoveTo(tlu_History* h, tl_Timeline* t, int64_t targetIdx, snz_Arena* scratch) {
+    _tlu_Map from = h->states[h->currentIdx].ops;
+    _tlu_Map to = h->states[targetIdx].ops;
+
+    int64_t scratchStart = snz_arenaUsedBytes(scratch);
+    int64_tSlice changedUids = _tlu_mapDiff(from, to, scratch);
+    for (int64_t i = 0; i < changedUids.count; i++) {
+        int64_t uid = changedUids.elems[i];
+        const _tlu_OpVersion* v = _tlu_mapGet(to, uid);
+        tl_Op* op = tl_timelineGetOpByUID(t, uid);
+        if (!v) {
+            if (op) {
+                op->markedForDeletion = true;
+            }
+            continue;
+        }
+
+        if (!op) {
+            op = SNZ_ARENA_PUSH(t->operationArena, tl_Op);
+            op->uniqueId = uid;
+            _tl_opTableInsert(&t->opTable, op);
+            _tl_timelineLinkOp(t, op);
+        }
+        _tlu_opRestore(t, op, v, scratch);
+    }
+    snz_arenaPop(scratch, snz_arenaUsedBytes(scratch) - scratchStart);
+    h->currentIdx = targetIdx;
+}
+
+// commits anything pending first, so that it can be redone. false when there's nothing to undo.
+// ops that go away are only marked for deletion, t needs a cull after this.
+bool tlu_undo(tlu_History* h, tl_Timeline* t, snz_Arena* scratch) {
+    tlu_commit(h, t, scratch);
+    if (h->currentIdx <= 0) {
+        return false;
+    }
+    _tlu_historyMoveTo(h, t, h->currentIdx - 1, scratch);
+    return true;
+}
+
+// false when there's nothing to redo, which includes when t had changes that weren't commited yet (those win)
+// same as undo, t needs a cull after.
+bool tlu_redo(tlu_History* h, tl_Timeline* t, snz_Arena* scratch) {
+    tlu_commit(h, t, scratch);
+    if (h->currentIdx + 1 >= h->stateCount) {
+        return false;
+    }
+    _tlu_historyMoveTo(h, t, h->currentIdx + 1, scratch);
+    return true;
+}
+
+// everything the history keeps about t, in list order
+static uint64_t _tlu_testTimelineHash(tl_Timeline* t) {
+    uint64_t hash = 14695981039346656037ULL;
+    int64_t lastUid = INT64_MAX;
+    for (tl_Op* op = t->firstOp; op; op = op->next) {
+        if (op->markedForDeletion) {
+            continue;
+        } else if (op->uniqueId >= lastUid) {
+            return 0;  // list out of order, never matches anything
+        }
+        lastUid = op->uniqueId;
+        uint64_t opHash = _tlu_opHash(op);
+        hash = _TL_HASH_VAL(hash, op->uniqueId);
+        hash = _TL_HASH_VAL(hash, opHash);
+    }
+    return _tl_hashFinish(hash);
+}
+
+static tl_Op* _tlu_testRandomOp(tl_Timeline* t, bool sketchOnly) {
+    int64_t count = 0;
+    for (tl_Op* op = t->firstOp; op; op = op->next) {
+        count += !sketchOnly || op->kind == TL_OPK_SKETCH;
+    }
+    if (count == 0) {
+        return NULL;
+    }
+    int64_t idx = rand() % count;
+    for (tl_Op* op = t->firstOp; op; op = op->next) {
+        if (sketchOnly && op->kind != TL_OPK_SKETCH) {
+            continue;
+        } else if (idx == 0) {
+            return op;
+        }
+        idx--;
+    }
+    return NULL;
+}
+
+static sk_Line* _tlu_testRandomLine(sk_Sketch* sketch) {
+    int64_t count = 0;
+    for (sk_Line* l = sk_sketchFirstLine(sketch); l; l = sk_sketchNextLine(sketch, l)) {
+        count++;
+    }
+    int64_t idx = rand() % count;
+    for (sk_Line* l = sk_sketchFirstLine(sketch); l; l = sk_sketchNextLine(sketch, l)) {
+        if (idx == 0) {
+            return l;
+        }
+        idx--;
+    }
+    return NULL;
+}
+
+static float _tlu_testRandomFloat() {
+    return (float)(rand() % 2000) / 10.0f - 100;
+}
+
+// one random edit on t, culled + cleared the same way main does between frames
+static void _tlu_testRandomEdit(tl_Timeline* t, snz_Arena* arena) {
+    tl_Op* sketchOp = _tlu_testRandomOp(t, true);
+    sk_Sketch* sketch = sketchOp ? &sketchOp->val.sketch : NULL;
+    int kind = rand() % 10;
+    if (!sketch && kind >= 4) {
+        kind = 0;
+    }
+
+    if (kind == 0) {
+        tl_timelinePushSketch(t, HMM_V2(_tlu_testRandomFloat(), _tlu_testRandomFloat()), sk_sketchInit(arena));
+    } else if (kind == 1) {
+        tl_Op* dep = _tlu_testRandomOp(t, false);
+        tl_Op* op = tl_timelinePushExtrude(t, HMM_V2(_tlu_testRandomFloat(), 0));
+        mesh_GeoID face = (mesh_GeoID){ .geoKind = MESH_GK_FACE, .opUniqueId = dep->uniqueId, .baseNodeId = rand() % 10 };
+        mesh_GeoID diff = (mesh_GeoID){ .geoKind = MESH_GK_FACE, .opUniqueId = dep->uniqueId, .diffGeo1 = &face };
+        op->args[0] = (tl_OpArg){ .kind = TL_OPAK_GEOID_FACE, .geoId = *mesh_geoIdDuplicate(&diff, arena) };
+        op->args[1] = (tl_OpArg){ .kind = TL_OPAK_NUMBER, .number = _tlu_testRandomFloat() };
+    } else if (kind == 2) {
+        tl_Op* op = _tlu_testRandomOp(t, false);
+        op->ui.pos = HMM_V2(_tlu_testRandomFloat(), _tlu_testRandomFloat());
+    } else if (kind == 3) {
+        tl_Op* op = _tlu_testRandomOp(t, false);
+        if (op->kind != TL_OPK_BASE_GEOMETRY) {
+            op->markedForDeletion = true;
+        }
+    } else if (kind <= 5) {
+        sk_Point* p1 = sk_sketchAddPoint(sketch, HMM_V2(_tlu_testRandomFloat(), _tlu_testRandomFloat()));
+        sk_Point* p2 = sk_sketchFirstPoint(sketch);
+        if (p2 == p1) {
+            p2 = sk_sketchNextPoint(sketch, p2);
+        }
+        if (rand() % 2) {
+            p2 = sk_sketchAddPoint(sketch, HMM_V2(_tlu_testRandomFloat(), _tlu_testRandomFloat()));
+        }
+        sk_Line* l = sk_sketchAddLine(sketch, p1, p2);
+        if (rand() % 2) {
+            sk_sketchAddConstraintDistance(sketch, l, _tlu_testRandomFloat());
+        }
+    } else if (kind == 6) {
+        sk_Line* l = _tlu_testRandomLine(sketch);
+        l->pts[rand() % 2]->pos = HMM_V2(_tlu_testRandomFloat(), _tlu_testRandomFloat());
+    } else if (kind == 7) {
+        sk_Line* a = _tlu_testRandomLine(sketch);
+        sk_Line* b = _tlu_testRandomLine(sketch);
+        if (a != b) {
+            sk_sketchAddConstraintAngle(sketch, a, rand() % 2, b, rand() % 2, _tlu_testRandomFloat());
+        } else if (sk_sketchFirstConstraint(sketch)) {
+            sk_sketchFirstConstraint(sketch)->value = _tlu_testRandomFloat();
+        }
+    } else if (kind == 8) {
+        _tlu_testRandomLine(sketch)->markedForDelete = true;
+    } else {
+        sk_sketchSetOrigin(sketch, _tlu_testRandomLine(sketch), rand() % 2, _tlu_testRandomFloat());
+    }
+
+    if (sketch) {
+        sk_sketchClearElementsMarkedForDelete(sketch);
+    }
+    tl_timelineCullOpsMarkedForDelete(t);
+}
+
+void tlu_tests() {
+    snz_testPrintSection("undo");
+    srand(1);
+
+    snz_Arena arena = snz_arenaInitGrowable(10000000, "tlu test arena");
+    snz_Arena scratch = snz_arenaInit(100000000, "tlu test scratch");
+
+    // hash of the timeline at every state, by how many states came before it (including dropped ones)
+    const int64_t maxStates = 20000;
+    uint64_t* hashes = SNZ_ARENA_PUSH_ARR(&arena, maxStates, uint64_t);
+
+    {
+        tl_Timeline t = tl_timelineInit(&arena);
+        tlu_History h = tlu_historyInit(1000000000);
+        tl_timelinePushBaseGeometry(&t, HMM_V2(0, 0), mesh_cube(&arena));
+        tl_timelinePushSketch(&t, HMM_V2(100, 0), sk_sketchInit(&arena));
+        tlu_commit(&h, &t, &scratch);
+        hashes[0] = _tlu_testTimelineHash(&t);
+
+        for (int64_t i = 0; i < 3000; i++) {
+            _tlu_testRandomEdit(&t, &arena);
+            if (tlu_commit(&h, &t, &scratch)) {
+                hashes[h.currentIdx] = _tlu_testTimelineHash(&t);
+            }
+        }
+        int64_t newest = h.currentIdx;
+
+        bool ok = newest > 2500;
+        while (tlu_undo(&h, &t, &scratch)) {
+            tl_timelineCullOpsMarkedForDelete(&t);
+            ok &= _tlu_testTimelineHash(&t) == hashes[h.currentIdx];
+        }
+        ok &= h.currentIdx == 0;
+        while (tlu_redo(&h, &t, &scratch)) {
+            tl_timelineCullOpsMarkedForDelete(&t);
+            ok &= _tlu_testTimelineHash(&t) == hashes[h.currentIdx];
+        }
+        ok &= h.currentIdx == newest;
+        snz_testPrint(ok, "undo + redo thru thousands of random edits hits every state");
+
+        ok = true;
+        for (int64_t i = 0; i < 3000; i++) {
+            int kind = rand() % 4;
+            if (kind == 0) {
+                tlu_undo(&h, &t, &scratch);
+            } else if (kind == 1) {
+                tlu_redo(&h, &t, &scratch);
+            } else {
+                _tlu_testRandomEdit(&t, &arena);
+                if (tlu_commit(&h, &t, &scratch)) {
+                    hashes[h.currentIdx] = _tlu_testTimelineHash(&t);
+                    ok &= h.currentIdx + 1 == h.stateCount;
+                }
+            }
+            tl_timelineCullOpsMarkedForDelete(&t);
+            ok &= _tlu_testTimelineHash(&t) == hashes[h.currentIdx];
+        }
+        snz_testPrint(ok, "random undos, redos and edits always land on a state");
+
+        tlu_historyDeinit(&h);
+        tl_timelineDeinit(&t);
+    }
+
+    {
+        tl_Timeline t = tl_timelineInit(&arena);
+        tlu_History h = tlu_historyInit(1000000000);
+        sk_Sketch* sketch = &tl_timelinePushSketch(&t, HMM_V2(0, 0), sk_sketchInit(&arena))->val.sketch;
+        sk_Point* last = sketch->originPt;
+        for (int64_t i = 0; i < 5000; i++) {
+            sk_Point* p = sk_sketchAddPoint(sketch, HMM_V2(i, i % 7));
+            sk_Line* l = sk_sketchAddLine(sketch, last, p);
+            if (i % 3 == 0) {
+                sk_sketchAddConstraintDistance(sketch, l, 1);
+            }
+            last = p;
+        }
+        tlu_commit(&h, &t, &scratch);
+        int64_t fullBytes = snz_arenaUsedBytes(&h.arena);
+
+        sk_Point* moved = sk_sketchPointAt(sketch, 4);  // the one added with i = 2
+        moved->pos.X += 1;
+        tlu_commit(&h, &t, &scratch);
+        int64_t editBytes = snz_arenaUsedBytes(&h.arena) - fullBytes;
+        snz_testPrint(editBytes < 2000 && editBytes * 500 < fullBytes, "moving one point in a big sketch only adds a few nodes");
+
+        tlu_undo(&h, &t, &scratch);
+        bool ok = moved->pos.X == 2;
+        tlu_redo(&h, &t, &scratch);
+        ok &= moved->pos.X == 3;
+        snz_testPrint(ok, "undo + redo on a big sketch");
+
+        tlu_historyDeinit(&h);
+        tl_timelineDeinit(&t);
+    }
+
+    {
+        tl_Timeline t = tl_timelineInit(&arena);
+        const int64_t budget = 1000000;
+        tlu_History h = tlu_historyInit(budget);
+        tl_timelinePushBaseGeometry(&t, HMM_V2(0, 0), mesh_cube(&arena));
+        tl_timelinePushSketch(&t, HMM_V2(100, 0), sk_sketchInit(&arena));
+        tlu_commit(&h, &t, &scratch);
+        hashes[0] = _tlu_testTimelineHash(&t);
+
+        bool ok = true;
+        for (int64_t i = 0; i < 3000; i++) {
+            _tlu_testRandomEdit(&t, &arena);
+            if (tlu_commit(&h, &t, &scratch)) {
+                hashes[h.currentIdx + h.droppedCount] = _tlu_testTimelineHash(&t);
+            }
+            ok &= snz_arenaUsedBytes(&h.arena) <= budget;
+        }
+        ok &= h.droppedCount > 0;
+        while (tlu_undo(&h, &t, &scratch)) {
+            tl_timelineCullOpsMarkedForDelete(&t);
+            ok &= _tlu_testTimelineHash(&t) == hashes[h.currentIdx + h.droppedCount];
+        }
+        ok &= h.currentIdx == 0 && h.stateCount > 1;
+        snz_testPrint(ok, "history stays under budget and the states left still undo right");
+
+        tlu_historyDeinit(&h);
+        tl_timelineDeinit(&t);
+    }
+
+    snz_arenaDeinit(&scratch);
+    snz_arenaDeinit(&arena);
+}
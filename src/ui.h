@@ -271,12 +271,12 @@ typedef struct {
 // FIXME: testing to make sure the null char at the end works
 
 static void _ui_textAreaAssertValid(ui_TextArea* text) {
-    SNZ_ASSERTF(text->charCount >= 0, "textarea charCount out of bounds. was: %lld", text->charCount);
-    SNZ_ASSERTF(text->charCount < UI_TEXTAREA_MAX_CHARS, "textarea charCount out of bounds. was: %lld", text->charCount);
-    SNZ_ASSERTF(text->cursorPos >= 0, "textarea cursor out of bounds. was: %lld", text->cursorPos);
-    SNZ_ASSERTF(text->cursorPos <= text->charCount, "textarea cursor out of bounds. was: %lld", text->cursorPos);
-    SNZ_ASSERTF(text->selectionStart >= -1, "textarea selection start out of bounds. was: %lld", text->selectionStart);
-    SNZ_ASSERTF(text->selectionStart <= text->charCount, "textarea selection start out of bounds. was: %lld", text->selectionStart);
+    SNZ_ASSERTF(text->charCount >= 0, "textarea charCount out of bounds. was: %" PRId64, text->charCount);
+    SNZ_ASSERTF(text->charCount < UI_TEXTAREA_MAX_CHARS, "textarea charCount out of bounds. was: %" PRId64, text->charCount);
+    SNZ_ASSERTF(text->cursorPos >= 0, "textarea cursor out of bounds. was: %" PRId64, text->cursorPos);
+    SNZ_ASSERTF(text->cursorPos <= text->charCount, "textarea cursor out of bounds. was: %" PRId64, text->cursorPos);
+    SNZ_ASSERTF(text->selectionStart >= -1, "textarea selection start out of bounds. was: %" PRId64, text->selectionStart);
+    SNZ_ASSERTF(text->selectionStart <= text->charCount, "textarea selection start out of bounds. was: %" PRId64, text->selectionStart);
     SNZ_ASSERT(text->font != NULL, "text area font was NULL");
 }
 
@@ -412,7 +412,7 @@ void ui_textAreaInit(ui_TextArea* area, const char* str) {
         uint64_t len = strlen(str);
         SNZ_ASSERTF(
             len < UI_TEXTAREA_MAX_CHARS - 1,
-            "Initializing text area failed. Too many chars in str. were %llu, expected less than %d.",
+            "Initializing text area failed. Too many chars in str. were %" PRIu64 ", expected less than %d.",
             len, UI_TEXTAREA_MAX_CHARS - 1);
         area->charCount = len;
         strcpy(area->chars, str);